@@ -0,0 +1,65 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkString.h"
+#include "include/effects/SkImageFilters.h"
+#include "tools/DecodeUtils.h"
+
+// A frosted glass pill over a full screen background, drawn once per frame. When the background is
+// static, the raster backend can reuse the previous frame's blurred backdrop instead of blurring it
+// again. The moving variant shifts the background every frame so that it never can.
+class BackdropBlurBench : public Benchmark {
+public:
+    explicit BackdropBlurBench(bool moving)
+            : fMoving(moving)
+            , fName(SkStringPrintf("backdrop_blur_pill_%s", moving ? "moving" : "static")) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kRaster; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkISize onGetSize() override { return {1024, 768}; }
+
+    void onDelayedSetup() override {
+        fBackground = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        fBlur = SkImageFilters::Blur(20, 20, nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRRect pill = SkRRect::MakeRectXY(SkRect::MakeXYWH(312, 600, 400, 96), 48, 48);
+        for (int i = 0; i < loops; ++i) {
+            const float offset = fMoving ? (i % 2) : 0;
+            canvas->drawImageRect(fBackground, SkRect::MakeXYWH(offset, 0, 1024, 768),
+                                  SkSamplingOptions());
+
+            canvas->save();
+            canvas->clipRRect(pill, true);
+            canvas->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, fBlur.get(), 0));
+            canvas->drawColor(0x40FFFFFF);
+            canvas->restore();
+            canvas->restore();
+        }
+    }
+
+private:
+    const bool            fMoving;
+    const SkString        fName;
+    sk_sp<SkImage>        fBackground;
+    sk_sp<SkImageFilter>  fBlur;
+};
+
+DEF_BENCH(return new BackdropBlurBench(false);)
+DEF_BENCH(return new BackdropBlurBench(true);)
@@ -95,6 +95,10 @@ public:
                              skia_private::TArray<SkString>* keys,
                              skia_private::TArray<double>* values) {}
 
+    // Measurements other than time, such as memory use, to report for the last run.
+    virtual void getMetrics(skia_private::TArray<SkString>* keys,
+                            skia_private::TArray<double>* values) {}
+
     // Replaces the GrRecordingContext's dmsaaStats() with a single frame of this benchmark.
     virtual bool getDMSAAStats(GrRecordingContext*) { return false; }
 
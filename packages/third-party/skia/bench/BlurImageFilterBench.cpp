@@ -8,6 +8,8 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
@@ -61,17 +63,19 @@ static sk_sp<SkImage> make_checkerboard(int width, int height) {
 class BlurImageFilterBench : public Benchmark {
 public:
     BlurImageFilterBench(SkScalar sigmaX, SkScalar sigmaY,  bool small, bool cropped,
-                         bool expanded)
+                         bool expanded, bool threaded = false)
       : fIsSmall(small)
       , fIsCropped(cropped)
       , fIsExpanded(expanded)
+      , fIsThreaded(threaded)
       , fInitialized(false)
       , fSigmaX(sigmaX)
       , fSigmaY(sigmaY) {
-        fName.printf("blur_image_filter_%s%s%s_%.2f_%.2f",
+        fName.printf("blur_image_filter_%s%s%s%s_%.2f_%.2f",
                      fIsSmall ? "small" : "large",
                      fIsCropped ? "_cropped" : "",
                      fIsExpanded ? "_expanded" : "",
+                     fIsThreaded ? "_threaded" : "",
                      sigmaX, sigmaY);
         SkASSERT(!fIsExpanded || fIsCropped); // never want expansion w/o cropping
     }
@@ -87,6 +91,21 @@ protected:
                                               fIsSmall ? FILTER_HEIGHT_SMALL : FILTER_HEIGHT_LARGE);
             fInitialized = true;
         }
+        if (fIsThreaded && !fExecutor) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fIsThreaded) {
+            SkGraphics::SetRasterExecutor(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fIsThreaded) {
+            SkGraphics::SetRasterExecutor(nullptr);
+        }
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -117,8 +136,10 @@ private:
     bool fIsSmall;
     bool fIsCropped;
     bool fIsExpanded;
+    bool fIsThreaded;
     bool fInitialized;
     sk_sp<SkImage> fCheckerboard;
+    std::unique_ptr<SkExecutor> fExecutor;
     SkScalar fSigmaX, fSigmaY;
     using INHERITED = Benchmark;
 };
@@ -161,3 +182,14 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, 0, false, false, false, true);)
+DEF_BENCH(return new BlurImageFilterBench(0, BLUR_SIGMA_LARGE, false, false, false, true);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_SMALL, BLUR_SIGMA_SMALL, false, false, false,
+                                          true);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false,
+                                          true);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false,
+                                          true);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, false,
+                                          true);)
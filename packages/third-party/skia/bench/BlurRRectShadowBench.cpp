@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBlurTypes.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+
+// Draws a page of 200 cards with blurred shadows, each a slightly different size, the way a list
+// of material cards is painted. With the analytic path every shadow is evaluated directly; the
+// mask variant draws the same shapes as paths, which blurs a new mask for every card.
+class BlurRRectShadowBench : public Benchmark {
+public:
+    BlurRRectShadowBench(SkScalar cornerRadius, bool asPath)
+        : fCornerRadius(cornerRadius)
+        , fAsPath(asPath)
+        , fName(SkStringPrintf("blurrrect_shadow_cards_%s_%s",
+                               cornerRadius > 0 ? "rrect" : "rect",
+                               asPath ? "mask" : "analytic")) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kRaster; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(SkColorSetARGB(0x40, 0, 0, 0));
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 6));
+
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < 200; ++i) {
+                const SkRect card = SkRect::MakeXYWH(16 + (i % 4) * 160,
+                                                     16 + (i / 4) * 12,
+                                                     120 + (i % 7),
+                                                     72 + (i % 5));
+                const SkRRect rrect = SkRRect::MakeRectXY(card, fCornerRadius, fCornerRadius);
+                if (fAsPath) {
+                    canvas->drawPath(SkPath::RRect(rrect), paint);
+                } else {
+                    canvas->drawRRect(rrect, paint);
+                }
+            }
+        }
+    }
+
+private:
+    SkScalar fCornerRadius;
+    bool     fAsPath;
+    SkString fName;
+};
+
+DEF_BENCH(return new BlurRRectShadowBench(0, false);)
+DEF_BENCH(return new BlurRRectShadowBench(12, false);)
+DEF_BENCH(return new BlurRRectShadowBench(12, true);)
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/encode/SkPngEncoder.h"
+#include "src/base/SkAutoMalloc.h"
+#include "tools/Resources.h"
+
+#include <memory>
+
+// A 16-bit RGB PNG of mandrill_512.png. An opaque F16 source is written as 16-bit RGB.
+static sk_sp<SkData> make_png16() {
+    std::unique_ptr<SkCodec> codec =
+            SkCodec::MakeFromData(GetResourceAsData("images/mandrill_512.png"));
+    if (!codec) {
+        return nullptr;
+    }
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(codec->getInfo().makeColorType(kRGBA_F16_SkColorType)
+                                               .makeAlphaType(kOpaque_SkAlphaType)) ||
+        codec->getPixels(bitmap.pixmap()) != SkCodec::kSuccess) {
+        return nullptr;
+    }
+    SkDynamicMemoryWStream stream;
+    if (!SkPngEncoder::Encode(&stream, bitmap.pixmap(), {})) {
+        return nullptr;
+    }
+    return stream.detachAsData();
+}
+
+// Decodes into a color space other than the image's, so that every row is color transformed. RGB,
+// RGBA and 16-bit PNG rows are swizzled, sampled and transformed in one pass, with procs
+// specialized for sample sizes 1, 2 and 4 but not 3. The palette case builds its color table once
+// per decode, and the 16-bit case is a 16-bit RGB PNG made from mandrill_512.png. Sample sizes
+// above 1 decode through SkSampledCodec (or the JPEG codec's own scaling).
+class CodecXformBench : public Benchmark {
+public:
+    CodecXformBench(const char* name, const char* resource, SkColorType colorType, int sampleSize)
+            : fResource(resource), fColorType(colorType), fSampleSize(sampleSize) {
+        fName.printf("codec_xform_%s_%s_sample%d", name,
+                     colorType == kRGBA_F16_SkColorType ? "f16" : "8888", sampleSize);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        if (fResource) {
+            fData = GetResourceAsData(fResource);
+        } else {
+            fData = make_png16();
+        }
+        SkASSERT(fData);
+
+        std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(fData);
+        SkASSERT(codec);
+        fInfo = SkImageInfo::Make(codec->getSampledDimensions(fSampleSize), fColorType,
+                                  kPremul_SkAlphaType,
+                                  SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                        SkNamedGamut::kDisplayP3));
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = fSampleSize;
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(fData);
+            SkAssertResult(SkCodec::kSuccess == codec->getAndroidPixels(
+                    fInfo, fPixelStorage.get(), fInfo.minRowBytes(), &options));
+        }
+    }
+
+private:
+    SkString      fName;
+    const char*   fResource;
+    SkColorType   fColorType;
+    int           fSampleSize;
+    sk_sp<SkData> fData;
+    SkImageInfo   fInfo;
+    SkAutoMalloc  fPixelStorage;
+};
+
+#define CODEC_XFORM_BENCHES(name, resource, colorType)                         \
+    DEF_BENCH(return new CodecXformBench(name, resource, colorType, 1);)       \
+    DEF_BENCH(return new CodecXformBench(name, resource, colorType, 2);)       \
+    DEF_BENCH(return new CodecXformBench(name, resource, colorType, 3);)       \
+    DEF_BENCH(return new CodecXformBench(name, resource, colorType, 4);)
+
+CODEC_XFORM_BENCHES("png_rgb", "images/mandrill_512.png", kN32_SkColorType)
+CODEC_XFORM_BENCHES("png_rgb", "images/mandrill_512.png", kRGBA_F16_SkColorType)
+CODEC_XFORM_BENCHES("png_rgba", "images/yellow_rose.png", kN32_SkColorType)
+CODEC_XFORM_BENCHES("png_rgba", "images/yellow_rose.png", kRGBA_F16_SkColorType)
+CODEC_XFORM_BENCHES("png_palette", "images/index8.png", kN32_SkColorType)
+CODEC_XFORM_BENCHES("png_palette", "images/index8.png", kRGBA_F16_SkColorType)
+CODEC_XFORM_BENCHES("png_rgb16", nullptr, kN32_SkColorType)
+CODEC_XFORM_BENCHES("png_rgb16", nullptr, kRGBA_F16_SkColorType)
+CODEC_XFORM_BENCHES("jpeg", "images/mandrill_512_q075.jpg", kN32_SkColorType)
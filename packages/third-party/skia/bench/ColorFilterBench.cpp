@@ -17,6 +17,7 @@
 #include "tools/DecodeUtils.h"
 #include "tools/Resources.h"
 
+#include <cmath>
 #include <functional>
 
 static constexpr char kRuntimeNone_GPU_SRC[] = R"(
@@ -181,6 +182,27 @@ static constexpr float kColorMatrix[] = {
     0.3f, 0.0f, 0.3f, 0.3f, 0.0f,
 };
 
+// A 33^3 grading table, the common size for .cube files: a contrast curve with warmed highlights.
+static sk_sp<SkColorFilter> make_lut_3d(SkColorFilters::Lut3DInterpolation interpolation) {
+    constexpr int kSize = 33;
+    sk_sp<SkData> lut = SkData::MakeUninitialized(sizeof(float) * 3 * kSize * kSize * kSize);
+    float* entries = static_cast<float*>(lut->writable_data());
+    for (int b = 0; b < kSize; ++b) {
+        for (int g = 0; g < kSize; ++g) {
+            for (int r = 0; r < kSize; ++r) {
+                const float rgb[3] = {r / (kSize - 1.f), g / (kSize - 1.f), b / (kSize - 1.f)};
+                const float luma = 0.2126f * rgb[0] + 0.7152f * rgb[1] + 0.0722f * rgb[2];
+                const float warm[3] = {0.06f * luma, 0.02f * luma, -0.05f * luma};
+                for (int c = 0; c < 3; ++c) {
+                    const float v = rgb[c] * rgb[c] * (3 - 2 * rgb[c]);
+                    *entries++ = std::fmin(std::fmax(v + warm[c], 0.f), 1.f);
+                }
+            }
+        }
+    }
+    return SkColorFilters::Lut3D(std::move(lut), kSize, interpolation);
+}
+
 } // namespace
 
 DEF_BENCH( return new ColorFilterBench("none",
@@ -201,6 +223,22 @@ DEF_BENCH( return new ColorFilterBench("compose_src",
     []() { return SkColorFilters::Compose(SkColorFilters::Blend(0x80808080, SkBlendMode::kSrc),
                                           SkColorFilters::Blend(0x80808080, SkBlendMode::kSrc));
     }); )
+DEF_BENCH( return new ColorFilterBench("compose_theme",
+    []() {
+        // A chain a theming system might build: tint, dim and fade. Compose folds it into a
+        // single matrix.
+        static constexpr float kDim[] = {
+            0.8f, 0.0f, 0.0f, 0.0f, 0.1f,
+            0.0f, 0.8f, 0.0f, 0.0f, 0.1f,
+            0.0f, 0.0f, 0.8f, 0.0f, 0.1f,
+            0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+        };
+        return SkColorFilters::Compose(
+                make_grayscale(),
+                SkColorFilters::Compose(
+                        SkColorFilters::Matrix(kDim),
+                        SkColorFilters::Blend(0x80000000, SkBlendMode::kDstIn)));
+    }); )
 DEF_BENCH( return new ColorFilterBench("lerp_src",
     []() { return SkColorFilters::Lerp(0.3f,
                                        SkColorFilters::Blend(0x80808080, SkBlendMode::kSrc),
@@ -221,6 +259,17 @@ DEF_BENCH( return new ColorFilterBench("overdraw", []() {
 DEF_BENCH( return new ColorFilterBench("gaussian", []() {
     return SkColorFilterPriv::MakeGaussian();
 }); )
+DEF_BENCH( return new ColorFilterBench("lut3d_trilinear", []() {
+    return make_lut_3d(SkColorFilters::Lut3DInterpolation::kTrilinear);
+}); )
+DEF_BENCH( return new ColorFilterBench("lut3d_tetrahedral", []() {
+    return make_lut_3d(SkColorFilters::Lut3DInterpolation::kTetrahedral);
+}); )
+DEF_BENCH( return new ColorFilterBench("lut3d_matrix", []() {
+    // The grayscale matrix folds into the table, so this should cost the same as the LUT alone.
+    return make_lut_3d(SkColorFilters::Lut3DInterpolation::kTetrahedral)
+            ->makeComposed(make_grayscale());
+}); )
 
 #if defined(SK_GANESH)
 DEF_BENCH( return new ColorFilterBench("src_runtime", []() {
@@ -7,13 +7,20 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
 #include "tools/DecodeUtils.h"
 
+#include <memory>
+
 // Like other Benchmark subclasses, Encoder benchmarks are run by:
 // nanobench --match ^Encode_
 //
@@ -134,3 +141,60 @@ DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 6), "PNG", kRGB_565_SkColorT
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kAll, 6), "PNG", kRGB_565_SkColorType))
 
 #undef PNG
+
+// Encodes a 4K image with the bands of SkPngEncoder::Options::fExecutor spread over a pool of
+// `threads` threads, or serially when `threads` is zero. The name carries the megapixels of the
+// image, so the reported time per encode gives the throughput in megapixels per second.
+class ParallelPngEncodeBench : public Benchmark {
+public:
+    ParallelPngEncodeBench(int threads, int zlibLevel)
+        : fThreads(threads)
+        , fZLibLevel(zlibLevel)
+        , fName(threads > 0 ? SkStringPrintf("Encode_PNG_%d_8.3MP_threads%d", zlibLevel, threads)
+                            : SkStringPrintf("Encode_PNG_%d_8.3MP_serial", zlibLevel)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        // Tile a photograph over the image so it compresses like a screenshot of real content.
+        sk_sp<SkImage> tile = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        SkASSERT_RELEASE(tile);
+        fBitmap.allocN32Pixels(3840, 2160);
+        SkPaint paint;
+        paint.setShader(tile->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat,
+                                         SkSamplingOptions()));
+        SkCanvas(fBitmap).drawPaint(paint);
+
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fZLibLevel = fZLibLevel;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, fBitmap.pixmap(), opts));
+            SkASSERT(dst.bytesWritten() > 0);
+        }
+    }
+
+private:
+    const int                   fThreads;
+    const int                   fZLibLevel;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new ParallelPngEncodeBench(0, 6))
+DEF_BENCH(return new ParallelPngEncodeBench(1, 6))
+DEF_BENCH(return new ParallelPngEncodeBench(2, 6))
+DEF_BENCH(return new ParallelPngEncodeBench(4, 6))
+DEF_BENCH(return new ParallelPngEncodeBench(8, 6))
+DEF_BENCH(return new ParallelPngEncodeBench(0, 1))
+DEF_BENCH(return new ParallelPngEncodeBench(4, 1))
@@ -6,12 +6,29 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkShader.h"
 #include "include/effects/SkImageFilters.h"
+#include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilterTypes.h"
 #include "tools/DecodeUtils.h"
 #include "tools/Resources.h"
 
+#include <memory>
+
+// Reports the most memory that the intermediate images of CPU image filters held during the run.
+static void get_scratch_metrics(size_t peakBytes,
+                                skia_private::TArray<SkString>* keys,
+                                skia_private::TArray<double>* values) {
+    keys->push_back(SkString("peak_scratch_mb"));
+    values->push_back(peakBytes / (1024.0 * 1024.0));
+}
+
 #if defined(SK_GANESH)
 #include "include/gpu/ganesh/GrRecordingContext.h"
 #include "include/gpu/ganesh/SkImageGanesh.h"
@@ -52,17 +69,118 @@ protected:
         // artificially improved performance. Ganesh will not because it uses a cache per filter
         // call, so only within-DAG cache hits are measured (as desired). skbug.com/40040590 wants to move
         // raster backend to the same pattern, which will make the benchmark executions fair again.
+        skif::ResetRasterScratchPeak();
         for (int j = 0; j < loops; j++) {
             canvas->drawRect(rect, paint);
         }
+        fPeakScratchBytes = skif::ResetRasterScratchPeak();
+    }
+
+    void getMetrics(skia_private::TArray<SkString>* keys,
+                    skia_private::TArray<double>* values) override {
+        get_scratch_metrics(fPeakScratchBytes, keys, values);
     }
 
 private:
     static const int kNumInputs = 5;
+    size_t fPeakScratchBytes = 0;
 
     using INHERITED = Benchmark;
 };
 
+// A chain of blurs, a color matrix and a drop shadow, merged with its source, on a 4096x4096
+// image, as when exporting a poster. The chain is evaluated over the whole image at once, in
+// tiles under a 64 MB scratch limit, and in tiles on a thread pool under the same limit. The
+// image filter cache is purged every loop, so each evaluation starts from nothing.
+class ImageFilterDAGPosterBench : public Benchmark {
+public:
+    enum class Mode { kWhole, kTiled, kTiledThreaded };
+
+    explicit ImageFilterDAGPosterBench(Mode mode)
+            : fMode(mode)
+            , fName(SkStringPrintf("image_filter_dag_poster_%s",
+                                   mode == Mode::kWhole   ? "whole"
+                                   : mode == Mode::kTiled ? "tiled"
+                                                          : "tiled_threaded")) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImage> tile = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        SkASSERT_RELEASE(tile);
+        SkBitmap poster;
+        poster.allocN32Pixels(4096, 4096);
+        SkPaint paint;
+        paint.setShader(tile->makeShader(SkTileMode::kMirror, SkTileMode::kMirror,
+                                         SkSamplingOptions()));
+        SkCanvas(poster).drawPaint(paint);
+        poster.setImmutable();
+        fImage = poster.asImage();
+
+        constexpr float kSepia[20] = {0.393f, 0.769f, 0.189f, 0, 0,
+                                      0.349f, 0.686f, 0.168f, 0, 0,
+                                      0.272f, 0.534f, 0.131f, 0, 0,
+                                      0,      0,      0,      1, 0};
+        sk_sp<SkImageFilter> chain = SkImageFilters::Blur(6, 6, nullptr);
+        chain = SkImageFilters::ColorFilter(SkColorFilters::Matrix(kSepia), std::move(chain));
+        chain = SkImageFilters::DropShadow(12, 12, 8, 8, SK_ColorBLACK, std::move(chain));
+        chain = SkImageFilters::Blur(2, 2, std::move(chain));
+        fFilter = SkImageFilters::Merge(std::move(chain), nullptr);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fMode != Mode::kWhole) {
+            fPrevScratchLimit = SkGraphics::SetImageFilterScratchLimit(64 << 20);
+        }
+        if (fMode == Mode::kTiledThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+            fPrevExecutor = SkGraphics::SetRasterExecutor(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fMode != Mode::kWhole) {
+            SkGraphics::SetImageFilterScratchLimit(fPrevScratchLimit);
+        }
+        if (fMode == Mode::kTiledThreaded) {
+            SkGraphics::SetRasterExecutor(fPrevExecutor);
+            fExecutor.reset();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeSize(fImage->dimensions());
+        SkIRect outSubset;
+        SkIPoint offset;
+
+        skif::ResetRasterScratchPeak();
+        for (int j = 0; j < loops; j++) {
+            SkImageFilterCache::Get()->purge();
+            sk_sp<SkImage> image = SkImages::MakeWithFilter(fImage, fFilter.get(), subset, subset,
+                                                            &outSubset, &offset);
+        }
+        fPeakScratchBytes = skif::ResetRasterScratchPeak();
+    }
+
+    void getMetrics(skia_private::TArray<SkString>* keys,
+                    skia_private::TArray<double>* values) override {
+        get_scratch_metrics(fPeakScratchBytes, keys, values);
+    }
+
+private:
+    const Mode fMode;
+    const SkString fName;
+    sk_sp<SkImage> fImage;
+    sk_sp<SkImageFilter> fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+    size_t fPrevScratchLimit = 0;
+    SkExecutor* fPrevExecutor = nullptr;
+    size_t fPeakScratchBytes = 0;
+};
+
 class ImageMakeWithFilterDAGBench : public Benchmark {
 public:
     ImageMakeWithFilterDAGBench() {}
@@ -182,5 +300,8 @@ private:
 
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
+DEF_BENCH(return new ImageFilterDAGPosterBench(ImageFilterDAGPosterBench::Mode::kWhole);)
+DEF_BENCH(return new ImageFilterDAGPosterBench(ImageFilterDAGPosterBench::Mode::kTiled);)
+DEF_BENCH(return new ImageFilterDAGPosterBench(ImageFilterDAGPosterBench::Mode::kTiledThreaded);)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
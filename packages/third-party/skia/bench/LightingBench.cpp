@@ -6,9 +6,13 @@
  */
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPoint3.h"
 #include "include/effects/SkImageFilters.h"
 
+#include <memory>
+
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
 #define FILTER_WIDTH_LARGE  SkIntToScalar(256)
@@ -207,6 +211,49 @@ private:
     using INHERITED = LightingBaseBench;
 };
 
+// Draws the large point lit diffuse and spot lit specular filters with the CPU lighting kernel
+// split across a thread pool.
+class LightingThreadedBench : public LightingBaseBench {
+public:
+    LightingThreadedBench(bool specular) : INHERITED(false), fSpecular(specular) { }
+
+protected:
+    const char* onGetName() override {
+        return fSpecular ? "lightingspotlitspecular_large_threaded"
+                         : "lightingpointlitdiffuse_large_threaded";
+    }
+
+    void onDelayedSetup() override {
+        if (!fExecutor) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        SkGraphics::SetRasterExecutor(fExecutor.get());
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkGraphics::SetRasterExecutor(nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        if (fSpecular) {
+            draw(loops, canvas, SkImageFilters::SpotLitSpecular(
+                    GetSpotLocation(), GetSpotTarget(), GetSpotExponent(), GetCutoffAngle(),
+                    GetWhite(), GetSurfaceScale(), GetKs(), GetShininess(), nullptr));
+        } else {
+            draw(loops, canvas, SkImageFilters::PointLitDiffuse(
+                    GetPointLocation(), GetWhite(), GetSurfaceScale(), GetKd(), nullptr));
+        }
+    }
+
+private:
+    bool fSpecular;
+    std::unique_ptr<SkExecutor> fExecutor;
+    using INHERITED = LightingBaseBench;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new LightingPointLitDiffuseBench(true); )
@@ -221,3 +268,5 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+DEF_BENCH( return new LightingThreadedBench(false); )
+DEF_BENCH( return new LightingThreadedBench(true); )
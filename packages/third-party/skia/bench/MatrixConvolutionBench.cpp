@@ -6,6 +6,8 @@
  */
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTileMode.h"
@@ -14,14 +16,37 @@
 
 #include "tools/ToolUtils.h"
 
+#include <memory>
+
 class MatrixConvolutionBench : public Benchmark {
 public:
+    enum class Kernel { kSmall, kBig, kSeparable };
+
     MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
-        : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+        : MatrixConvolutionBench(bigKernel ? Kernel::kBig : Kernel::kSmall, tileMode,
+                                 convolveAlpha, /*threaded=*/false) {}
+
+    MatrixConvolutionBench(Kernel kernelType, SkTileMode tileMode, bool convolveAlpha,
+                           bool threaded)
+        : fName(SkStringPrintf("matrixconvolution_%s%s%s%s",
+                               kernelType == Kernel::kBig         ? "bigKernel_"
+                               : kernelType == Kernel::kSeparable ? "separableKernel_"
+                                                                  : "",
                                ToolUtils::tilemode_name(tileMode),
-                               convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
+                               convolveAlpha ? "" : "_noConvolveAlpha",
+                               threaded ? "_threaded" : ""))
+        , fThreaded(threaded) {
+        if (kernelType == Kernel::kSeparable) {
+            // A 9x9 binomial blur, the outer product of two rows of Pascal's triangle.
+            const SkScalar row[9] = {1, 8, 28, 56, 70, 56, 28, 8, 1};
+            SkScalar kernel[81];
+            for (int i = 0; i < 81; i++) {
+                kernel[i] = row[i / 9] * row[i % 9];
+            }
+            fFilter = SkImageFilters::MatrixConvolution({9, 9}, kernel, 1 / 65536.f, 0,
+                                                        {4, 4}, tileMode, convolveAlpha,
+                                                        nullptr);
+        } else if (kernelType == Kernel::kBig) {
             SkISize kernelSize = SkISize::Make(9, 9);
             SkScalar kernel[81];
             for (int i = 0; i < 81; i++) {
@@ -53,6 +78,24 @@ protected:
         return fName.c_str();
     }
 
+    void onDelayedSetup() override {
+        if (fThreaded && !fExecutor) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fThreaded) {
+            SkGraphics::SetRasterExecutor(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fThreaded) {
+            SkGraphics::SetRasterExecutor(nullptr);
+        }
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint;
         this->setupPaint(&paint);
@@ -70,6 +113,8 @@ protected:
 private:
     sk_sp<SkImageFilter> fFilter;
     SkString fName;
+    bool fThreaded;
+    std::unique_ptr<SkExecutor> fExecutor;
 
     using INHERITED = Benchmark;
 };
@@ -85,3 +130,10 @@ DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
 DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
 DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
 DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+
+using Kernel = MatrixConvolutionBench::Kernel;
+constexpr SkTileMode kDecal = SkTileMode::kDecal;
+DEF_BENCH( return new MatrixConvolutionBench(Kernel::kSeparable, kDecal, true, false); )
+DEF_BENCH( return new MatrixConvolutionBench(Kernel::kSeparable, kDecal, false, false); )
+DEF_BENCH( return new MatrixConvolutionBench(Kernel::kBig, kDecal, true, true); )
+DEF_BENCH( return new MatrixConvolutionBench(Kernel::kSeparable, kDecal, true, true); )
@@ -7,15 +7,20 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/base/SkRandom.h"
 
+#include <memory>
+
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
+#define LARGE   SkIntToScalar(64)
 
 enum MorphologyType {
     kErode_MT,
@@ -30,18 +35,24 @@ static const char* gStyleName[] = {
 class MorphologyBench : public Benchmark {
     SkScalar       fRadius;
     MorphologyType fStyle;
+    bool           fThreaded;
     SkString       fName;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MorphologyBench(SkScalar rad, MorphologyType style) {
+    MorphologyBench(SkScalar rad, MorphologyType style, bool threaded = false) {
         fRadius = rad;
         fStyle = style;
+        fThreaded = threaded;
         const char* name = rad > 0 ? gStyleName[style] : "none";
         if (SkScalarFraction(rad) != 0) {
             fName.printf("morph_%.2f_%s", rad, name);
         } else {
             fName.printf("morph_%d_%s", SkScalarRoundToInt(rad), name);
         }
+        if (fThreaded) {
+            fName.append("_threaded");
+        }
     }
 
 protected:
@@ -49,6 +60,24 @@ protected:
         return fName.c_str();
     }
 
+    void onDelayedSetup() override {
+        if (fThreaded && !fExecutor) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fThreaded) {
+            SkGraphics::SetRasterExecutor(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fThreaded) {
+            SkGraphics::SetRasterExecutor(nullptr);
+        }
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint;
         this->setupPaint(&paint);
@@ -93,3 +122,9 @@ DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
 DEF_BENCH( return new MorphologyBench(0, kErode_MT); )
+
+DEF_BENCH( return new MorphologyBench(LARGE, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(LARGE, kDilate_MT); )
+
+DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT, true); )
+DEF_BENCH( return new MorphologyBench(LARGE, kDilate_MT, true); )
@@ -6,14 +6,20 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathBuilder.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/pathops/SkPathOps.h"
 #include "include/private/base/SkTArray.h"
+#include "modules/bentleyottmann/include/PolygonOps.h"
 #include "src/base/SkRandom.h"
 
+#include <cmath>
+#include <memory>
+#include <optional>
+
 class PathOpsBench : public Benchmark {
     SkString    fName;
     SkPath      fPath1, fPath2;
@@ -93,6 +99,134 @@ static SkPath makerects() {
 }
 DEF_BENCH( return new PathOpsSimplifyBench("rects", makerects()); )
 
+// Many small overlapping polygons, like the features of a map layer.
+static SkPath makepolygons(SkRandom* rand, int count) {
+    SkPathBuilder builder;
+    for (int i = 0; i < count; ++i) {
+        const SkPoint center = {rand->nextRangeF(0, 1000), rand->nextRangeF(0, 1000)};
+        const float radius = rand->nextRangeF(2, 20);
+        const int sides = 3 + rand->nextULessThan(6);
+        for (int j = 0; j < sides; ++j) {
+            const float angle = j * 2 * SK_ScalarPI / sides + rand->nextRangeF(0, 0.5f);
+            const SkPoint p = center + SkVector{std::cos(angle), std::sin(angle)} * radius;
+            if (j == 0) {
+                builder.moveTo(p);
+            } else {
+                builder.lineTo(p);
+            }
+        }
+        builder.close();
+    }
+    return builder.detach();
+}
+
+// Compares SkPathOps with the snap rounded polygon backend in modules/bentleyottmann. Without an
+// op the polygons of the first path are unioned with Simplify.
+class PolygonOpsBench : public Benchmark {
+    SkString                fName;
+    std::optional<SkPathOp> fOp;
+    int                     fCount;
+    bool                    fPolygonBackend;
+    SkPath                  fPath1, fPath2;
+
+public:
+    PolygonOpsBench(const char suffix[], std::optional<SkPathOp> op, int count, bool polygonBackend)
+            : fOp(op), fCount(count), fPolygonBackend(polygonBackend) {
+        fName.printf("pathops_polygons_%s_%d_%s", suffix, count,
+                     polygonBackend ? "bentleyottmann" : "skpathops");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fPath1 = makepolygons(&rand, fCount);
+        fPath2 = makepolygons(&rand, fCount);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            if (fPolygonBackend) {
+                std::ignore = fOp ? bentleyottmann::polygon_op(fPath1, fPath2, *fOp)
+                                  : bentleyottmann::polygon_simplify(fPath1);
+            } else {
+                std::ignore = fOp ? Op(fPath1, fPath2, *fOp) : Simplify(fPath1);
+            }
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new PolygonOpsBench("union", std::nullopt, 100, false); )
+DEF_BENCH( return new PolygonOpsBench("union", std::nullopt, 100, true); )
+DEF_BENCH( return new PolygonOpsBench("union", std::nullopt, 3000, false); )
+DEF_BENCH( return new PolygonOpsBench("union", std::nullopt, 3000, true); )
+DEF_BENCH( return new PolygonOpsBench("sect", kIntersect_SkPathOp, 1000, false); )
+DEF_BENCH( return new PolygonOpsBench("sect", kIntersect_SkPathOp, 1000, true); )
+
+// Resolves a builder of many small rects and ovals, like the footprints of a map, either with
+// resolve() or with resolve(SkExecutor&) on a thread pool.
+class BuilderBench : public Benchmark {
+    SkString                     fName;
+    SkPathOp                     fOp;
+    int                          fCount;
+    std::unique_ptr<SkExecutor>  fExecutor;
+    skia_private::TArray<SkPath> fPaths;
+
+public:
+    BuilderBench(const char suffix[], SkPathOp op, int count, bool parallel)
+            : fOp(op), fCount(count) {
+        fName.printf("pathops_builder_%s_%d_%s", suffix, count, parallel ? "parallel" : "serial");
+        if (parallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        const float size = 10 * std::sqrt(static_cast<float>(fCount));
+        for (int i = 0; i < fCount; ++i) {
+            const SkRect r = SkRect::MakeXYWH(rand.nextRangeF(0, size), rand.nextRangeF(0, size),
+                                              rand.nextRangeF(2, 12), rand.nextRangeF(2, 12));
+            fPaths.push_back(i & 1 ? SkPath::Oval(r) : SkPath::Rect(r));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkOpBuilder builder;
+            for (const SkPath& path : fPaths) {
+                builder.add(path, fOp);
+            }
+            std::ignore = fExecutor ? builder.resolve(*fExecutor) : builder.resolve();
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new BuilderBench("union", kUnion_SkPathOp, 2000, false); )
+DEF_BENCH( return new BuilderBench("union", kUnion_SkPathOp, 2000, true); )
+DEF_BENCH( return new BuilderBench("xor", kXOR_SkPathOp, 500, false); )
+DEF_BENCH( return new BuilderBench("xor", kXOR_SkPathOp, 500, true); )
+
 #include "include/core/SkPathBuilder.h"
 
 template <size_t N> struct ArrayPath {
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
+#include "tools/DecodeUtils.h"
+
+#include <memory>
+#include <vector>
+
+// Rescales a 12 megapixel photo to the 2048, 1024, 512 and 256 wide variants an upload server
+// might store, with SkImage::rescaleAndReadPixels. The variants are either made in one call,
+// sharing their intermediate levels, or in a call each, and either on this thread or striped
+// across a thread pool.
+class RescaleBench : public Benchmark {
+public:
+    RescaleBench(bool oneCall, bool threaded)
+            : fOneCall(oneCall)
+            , fThreaded(threaded)
+            , fName(SkStringPrintf("Rescale_12MP_4sizes_%s_%s",
+                                   oneCall ? "shared" : "separate",
+                                   threaded ? "threaded" : "serial")) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImage> tile = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        SkASSERT_RELEASE(tile);
+        SkBitmap photo;
+        photo.allocN32Pixels(4032, 3024, /*isOpaque=*/true);
+        SkPaint paint;
+        paint.setShader(tile->makeShader(SkTileMode::kMirror, SkTileMode::kMirror,
+                                         SkSamplingOptions()));
+        SkCanvas(photo).drawPaint(paint);
+        photo.setImmutable();
+        fPhoto = photo.asImage();
+
+        for (int width = 2048; width >= 256; width /= 2) {
+            fVariants.emplace_back().allocPixels(
+                    fPhoto->imageInfo().makeWH(width, width * 3024 / 4032));
+            fPixmaps.push_back(fVariants.back().pixmap());
+        }
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect srcRect = SkIRect::MakeSize(fPhoto->dimensions());
+        while (loops-- > 0) {
+            if (fOneCall) {
+                SkAssertResult(fPhoto->rescaleAndReadPixels(fPixmaps,
+                                                            srcRect,
+                                                            SkImage::RescaleGamma::kSrc,
+                                                            SkImage::RescaleMode::kRepeatedLinear,
+                                                            fExecutor.get()));
+                continue;
+            }
+            for (const SkPixmap& pixmap : fPixmaps) {
+                SkAssertResult(fPhoto->rescaleAndReadPixels({&pixmap, 1},
+                                                            srcRect,
+                                                            SkImage::RescaleGamma::kSrc,
+                                                            SkImage::RescaleMode::kRepeatedLinear,
+                                                            fExecutor.get()));
+            }
+        }
+    }
+
+private:
+    const bool                  fOneCall;
+    const bool                  fThreaded;
+    const SkString              fName;
+    sk_sp<SkImage>              fPhoto;
+    std::vector<SkBitmap>       fVariants;
+    std::vector<SkPixmap>       fPixmaps;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new RescaleBench(/*oneCall=*/false, /*threaded=*/false))
+DEF_BENCH(return new RescaleBench(/*oneCall=*/true, /*threaded=*/false))
+DEF_BENCH(return new RescaleBench(/*oneCall=*/true, /*threaded=*/true))
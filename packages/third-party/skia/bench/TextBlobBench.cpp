@@ -14,6 +14,7 @@
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/utils/SkTextBlobCache.h"
 #include "src/base/SkRandom.h"
 #include "tools/Resources.h"
 #include "tools/ToolUtils.h"
@@ -24,19 +25,16 @@
  */
 class SkTextBlobBench : public Benchmark {
 public:
-    SkTextBlobBench() {}
+    explicit SkTextBlobBench(size_t slabSize = 0) : fBuilder(slabSize) {}
 
     void onDelayedSetup() override {
         fFont.setTypeface(ToolUtils::CreatePortableTypeface("serif", SkFontStyle()));
         fFont.setSubpixel(true);
 
-        // This text seems representative in both length and letter frequency.
-        const char* text = "Keep your sentences short, but not overly so.";
-
-        fGlyphs.resize(fFont.countText(text, strlen(text), SkTextEncoding::kUTF8));
+        fGlyphs.resize(fFont.countText(kText, strlen(kText), SkTextEncoding::kUTF8));
         fXPos.resize(fGlyphs.size());
 
-        fFont.textToGlyphs(text, strlen(text), SkTextEncoding::kUTF8, fGlyphs);
+        fFont.textToGlyphs(kText, strlen(kText), SkTextEncoding::kUTF8, fGlyphs);
         fFont.getXPos(fGlyphs, fXPos);
     }
 
@@ -48,9 +46,14 @@ public:
         return fBuilder.make();
     }
 
+protected:
+    // This text seems representative in both length and letter frequency.
+    static constexpr char kText[] = "Keep your sentences short, but not overly so.";
+
+    SkFont              fFont;
+
 private:
     SkTextBlobBuilder   fBuilder;
-    SkFont              fFont;
     SkTDArray<SkGlyphID> fGlyphs;
     SkTDArray<SkScalar> fXPos;
 
@@ -109,3 +112,59 @@ class TextBlobMakeBench : public SkTextBlobBench {
     }
 };
 DEF_BENCH( return new TextBlobMakeBench(); )
+
+class TextBlobMakeSlabBench : public SkTextBlobBench {
+public:
+    TextBlobMakeSlabBench() : SkTextBlobBench(16 * 1024) {}
+
+private:
+    const char* onGetName() override {
+        return "TextBlobMakeSlabBench";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            for (int inner = 0; inner < 1000; ++inner) {
+                this->makeBlob();
+            }
+        }
+    }
+};
+DEF_BENCH( return new TextBlobMakeSlabBench(); )
+
+/*
+ * Makes the same blob from text every frame, either converting the text each time or interning
+ * the blob in an SkTextBlobCache.
+ */
+class TextBlobFromTextBench : public SkTextBlobBench {
+public:
+    explicit TextBlobFromTextBench(bool useCache) : fUseCache(useCache) {}
+
+private:
+    const char* onGetName() override {
+        return fUseCache ? "TextBlobFromTextCachedBench" : "TextBlobFromTextBench";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            for (int inner = 0; inner < 1000; ++inner) {
+                sk_sp<SkTextBlob> blob =
+                        fUseCache ? fCache.findOrMake(kText, fFont)
+                                  : SkTextBlob::MakeFromString(kText, fFont);
+            }
+        }
+    }
+
+    const bool      fUseCache;
+    SkTextBlobCache fCache;
+};
+DEF_BENCH( return new TextBlobFromTextBench(false); )
+DEF_BENCH( return new TextBlobFromTextBench(true); )
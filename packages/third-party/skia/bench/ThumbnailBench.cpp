@@ -0,0 +1,96 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkEncodedImageFormat.h"
+#include "include/codec/SkThumbnail.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkEncoder.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkPngEncoder.h"
+#include "tools/DecodeUtils.h"
+
+#include <memory>
+
+// Makes a 256x192 PNG thumbnail of a 12 megapixel photo, end to end from the encoded photo.
+//
+// The streaming bench uses SkThumbnail::Encode, which decodes at a reduced scale where the codec
+// allows it and never holds more than a few rows. The full bench is the pipeline it replaces:
+// decode the whole image, SkPixmap::scalePixels, then encode.
+class ThumbnailBench : public Benchmark {
+public:
+    ThumbnailBench(SkEncodedImageFormat format, bool streaming)
+        : fFormat(format)
+        , fStreaming(streaming)
+        , fName(SkStringPrintf("Thumbnail_%s_12MP_%s",
+                               format == SkEncodedImageFormat::kJPEG ? "JPEG" : "PNG",
+                               streaming ? "streaming" : "full")) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImage> tile = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        SkASSERT_RELEASE(tile);
+        SkBitmap photo;
+        photo.allocN32Pixels(4032, 3024, /*isOpaque=*/true);
+        SkPaint paint;
+        paint.setShader(tile->makeShader(SkTileMode::kMirror, SkTileMode::kMirror,
+                                         SkSamplingOptions()));
+        SkCanvas(photo).drawPaint(paint);
+
+        SkDynamicMemoryWStream stream;
+        if (fFormat == SkEncodedImageFormat::kJPEG) {
+            SkAssertResult(SkJpegEncoder::Encode(&stream, photo.pixmap(), {}));
+        } else {
+            SkAssertResult(SkPngEncoder::Encode(&stream, photo.pixmap(), {}));
+        }
+        fEncoded = stream.detachAsData();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        constexpr SkISize kSize = {256, 192};
+        while (loops-- > 0) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fEncoded);
+            SkNullWStream dst;
+            if (fStreaming) {
+                SkAssertResult(SkThumbnail::Encode(
+                        codec.get(), kSize, &dst, [](SkWStream* stream, const SkPixmap& src) {
+                            return SkPngEncoder::Make(stream, src, {});
+                        }));
+            } else {
+                SkBitmap full, thumbnail;
+                full.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+                SkAssertResult(SkCodec::kSuccess == codec->getPixels(full.pixmap()));
+                thumbnail.allocPixels(full.info().makeDimensions(kSize));
+                SkAssertResult(full.pixmap().scalePixels(
+                        thumbnail.pixmap(), SkSamplingOptions(SkCubicResampler::Mitchell())));
+                SkAssertResult(SkPngEncoder::Encode(&dst, thumbnail.pixmap(), {}));
+            }
+        }
+    }
+
+private:
+    const SkEncodedImageFormat fFormat;
+    const bool                 fStreaming;
+    const SkString             fName;
+    sk_sp<SkData>              fEncoded;
+};
+
+DEF_BENCH(return new ThumbnailBench(SkEncodedImageFormat::kJPEG, true))
+DEF_BENCH(return new ThumbnailBench(SkEncodedImageFormat::kJPEG, false))
+DEF_BENCH(return new ThumbnailBench(SkEncodedImageFormat::kPNG, true))
+DEF_BENCH(return new ThumbnailBench(SkEncodedImageFormat::kPNG, false))
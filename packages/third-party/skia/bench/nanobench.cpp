@@ -1560,6 +1560,7 @@ int main(int argc, char** argv) {
 
             TArray<SkString> keys;
             TArray<double> values;
+            bench->getMetrics(&keys, &values);
             if (configs[i].backend == Benchmark::Backend::kGanesh) {
                 if (FLAGS_gpuStatsDump) {
                     // TODO cache stats
@@ -1605,7 +1606,7 @@ int main(int argc, char** argv) {
             log.endArray(); // samples
             benchStream.fillCurrentMetrics(log);
             if (!keys.empty()) {
-                // dump to json, only SKPBench currently returns valid keys / values
+                // dump to json, from getMetrics() and, with --gpuStatsDump, SKPBench
                 SkASSERT(keys.size() == values.size());
                 for (int j = 0; j < keys.size(); j++) {
                     log.appendMetric(keys[j].c_str(), values[j]);
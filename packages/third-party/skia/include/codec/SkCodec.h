@@ -31,6 +31,7 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -341,6 +342,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -384,6 +386,16 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into tasks that run on this executor,
+         *  and waits for them before returning. The result is the same as a decode without it.
+         *
+         *  Currently only used by JPEG images that are held in memory and whose entropy-coded
+         *  data is divided by restart markers at MCU row boundaries. Other images are decoded
+         *  on the calling thread.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
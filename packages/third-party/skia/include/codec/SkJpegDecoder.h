@@ -42,6 +42,29 @@ inline std::unique_ptr<SkCodec> Decode(sk_sp<SkData> data,
     return Decode(sk_sp<const SkData>(static_cast<const SkData*>(data.release())), result, ctx);
 }
 
+/**
+ *  Returns an index of the entropy-coded data of a sequential JPEG, with a checkpoint at the
+ *  start of every mcuRowsPerCheckpoint rows of MCUs (an MCU row is 8 or 16 rows of pixels).
+ *  Building the index reads all of the image's data once. The index can be stored next to the
+ *  image and passed to DecodeWithTileIndex().
+ *
+ *  Returns nullptr if the data is not a sequential Huffman-coded JPEG, e.g. if it is
+ *  progressive.
+ */
+SK_API sk_sp<SkData> MakeTileIndex(const SkData& data, int mcuRowsPerCheckpoint = 4);
+
+/**
+ *  Like Decode(), but if tileIndex was made from data by MakeTileIndex(), the codec supports
+ *  SkCodec::Options::fSubset in getPixels(). A subset is decoded from the checkpoint above it,
+ *  so its decode time depends on the size of the subset and the spacing of the checkpoints,
+ *  but not on how far down the image it is.
+ *
+ *  A tileIndex that was not made from data is ignored.
+ */
+SK_API std::unique_ptr<SkCodec> DecodeWithTileIndex(sk_sp<const SkData> data,
+                                                    const SkData& tileIndex,
+                                                    SkCodec::Result*);
+
 inline constexpr SkCodecs::Decoder Decoder() {
     return { "jpeg", IsJpeg, Decode };
 }
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThumbnail_DEFINED
+#define SkThumbnail_DEFINED
+
+#include "include/core/SkSize.h"
+#include "include/private/base/SkAPI.h"
+
+#include <functional>
+#include <memory>
+
+class SkCodec;
+class SkEncoder;
+class SkPixmap;
+class SkWStream;
+
+namespace SkThumbnail {
+
+/**
+ *  Makes the encoder that writes a thumbnail to |dst|. |src| describes the thumbnail: its rows
+ *  are passed to SkEncoder::encodeRows(const SkPixmap&) as they are made, and its own pixels are
+ *  never read. For example:
+ *
+ *      [](SkWStream* dst, const SkPixmap& src) { return SkPngEncoder::Make(dst, src, {}); }
+ */
+using EncoderFactory =
+        std::function<std::unique_ptr<SkEncoder>(SkWStream* dst, const SkPixmap& src)>;
+
+/**
+ *  Decodes the image of |codec| resized to |dstSize| and encodes it to |dst|, without holding the
+ *  full decoded image. The codec decodes scanlines at the smallest scale it supports natively
+ *  (such as JPEG's DCT scaling) that still covers |dstSize|. A separable Mitchell filter then
+ *  resamples them, keeping only the few rows under the filter, and each output row is encoded as
+ *  soon as it is complete. Memory therefore grows with the width of the image, not its area.
+ *
+ *  Images whose rows cannot be decoded in order from top to bottom, such as interlaced GIFs, are
+ *  decoded in full first.
+ *
+ *  The thumbnail is N32, premultiplied unless the image is opaque, in the color space of the
+ *  image. The encoded origin is not applied. Returns false if decoding or encoding fails.
+ */
+SK_API bool Encode(SkCodec* codec, SkISize dstSize, SkWStream* dst, const EncoderFactory&);
+
+}  // namespace SkThumbnail
+
+#endif  // SkThumbnail_DEFINED
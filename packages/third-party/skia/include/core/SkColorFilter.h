@@ -20,6 +20,7 @@
 class SkColorMatrix;
 class SkColorSpace;
 class SkColorTable;
+class SkData;
 
 enum class SkBlendMode;
 struct SkDeserialProcs;
@@ -143,6 +144,23 @@ public:
      */
     static sk_sp<SkColorFilter> Lighting(SkColor mul, SkColor add);
 
+    enum class Lut3DInterpolation { kTrilinear, kTetrahedral };
+
+    /**
+     *  Create a colorfilter that maps unpremultiplied RGB through a 3D lookup table, as used for
+     *  color grading. |lut| holds size*size*size RGB triples of floats, with red varying fastest
+     *  and blue slowest (the order of .cube files), so the entry for grid point (r, g, b) starts
+     *  at float 3 * (r + size * (g + size * b)). Inputs are clamped to [0, 1] and interpolated
+     *  between the nearest grid points; alpha is unchanged. Tetrahedral interpolation reads 4
+     *  entries per pixel instead of 8 and is the usual choice for grading LUTs.
+     *
+     *  The table is shared, not copied. Returns nullptr if size is not in [2, 256] or if |lut|
+     *  is too small.
+     */
+    static sk_sp<SkColorFilter> Lut3D(sk_sp<SkData> lut,
+                                      int size,
+                                      Lut3DInterpolation = Lut3DInterpolation::kTetrahedral);
+
 private:
     SkColorFilters() = delete;
 };
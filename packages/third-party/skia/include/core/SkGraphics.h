@@ -9,6 +9,7 @@
 #define SkGraphics_DEFINED
 
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkAPI.h"
 
 #include <cstddef>
@@ -16,9 +17,11 @@
 #include <memory>
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkOpenTypeSVGDecoder;
 class SkTraceMemoryDump;
+class SkTypeface;
 
 class SK_API SkGraphics {
 public:
@@ -69,6 +72,23 @@ public:
      */
     static int SetFontCacheCountLimit(int count);
 
+    /**
+     *  Write the glyph metrics, images and paths of the most recently used strikes
+     *  in the font cache, up to about byteBudget bytes, to the file at path. A
+     *  later process can load them with LoadFontCacheFromFile to start with warm
+     *  strikes. Returns false if the file could not be written.
+     */
+    static bool SaveFontCacheToFile(const char path[], size_t byteBudget);
+
+    /**
+     *  Add the strikes saved by SaveFontCacheToFile for any of the given typefaces
+     *  to the font cache, and return the number of strikes added. The file is
+     *  memory mapped and ignored unless it is intact and was written by the same
+     *  Skia milestone. Call this before drawing text with these typefaces.
+     */
+    static int LoadFontCacheFromFile(const char path[],
+                                     SkSpan<const sk_sp<SkTypeface>> typefaces);
+
     /**
      *  Return the current limit to the number of entries in the typeface cache.
      *  A cache "entry" is associated with each typeface.
@@ -115,6 +135,16 @@ public:
      */
     static void PurgeResourceCache();
 
+    /**
+     *  For memory pressure: purge the resource cache until it uses no more than targetBytes,
+     *  least valuable entries first. Blur and shadow masks go before other derived data such
+     *  as mipmaps, and those before decoded images. Entries that are in use are kept, so the
+     *  cache may stay above the target. The limit is not changed.
+     *
+     *  Returns the bytes the cache uses afterwards.
+     */
+    static size_t PurgeResourceCacheToTarget(size_t targetBytes);
+
     /**
      *  When the cachable entry is very lage (e.g. a large scaled bitmap), adding it to the cache
      *  can cause most/all of the existing entries to be purged. To avoid the, the client can set
@@ -126,6 +156,53 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  When enabled, the image filter cache keys results on the transform without its whole-pixel
+     *  translation, so a filtered layer or image that has only moved by whole pixels, such as a
+     *  shadowed card in a scrolling list, reuses its cached result at the new offset. Filters
+     *  whose output depends on their absolute position, such as runtime shader filters, are still
+     *  keyed exactly. Disabled by default. Returns the previous setting.
+     *
+     *  The setting is atomic and read each time an image filter is evaluated, so it may be changed
+     *  while other threads draw. Results cached under either setting stay valid under the other.
+     */
+    static bool SetImageFilterCacheTranslationInvariant(bool enabled);
+
+    /**
+     *  Limit the memory that the intermediate images of one CPU image filter evaluation hold at
+     *  once, and return the previous limit. An image filter whose output is too large for its
+     *  filters' intermediates to fit is evaluated in tiles, which are assembled into the output.
+     *  Deep filter chains on very large layers then hold a few tile-sized intermediates instead of
+     *  several full-size ones; the tiles are not kept in the image filter cache. The output itself
+     *  is not counted. Zero, the default, evaluates every image filter over its whole output.
+     *
+     *  The limit is atomic and read once when a draw starts evaluating an image filter, so it may
+     *  be changed while other threads draw; evaluations already running keep the old limit.
+     */
+    static size_t SetImageFilterScratchLimit(size_t bytes);
+
+    /**
+     *  Return the executor set by SetRasterExecutor(), or nullptr if there is none.
+     */
+    static SkExecutor* GetRasterExecutor();
+
+    /**
+     *  Set an executor that the CPU backend splits work across, and return the previous executor.
+     *  The font cache rasterizes the images of many uncached glyphs of a run on it, Gaussian blurs
+     *  of 8888 and A8 images split their passes across it, image filters evaluated in tiles (see
+     *  SetImageFilterScratchLimit()) run several tiles on it at once, sharing the scratch limit,
+     *  and morphology, matrix convolution and lighting image filters split their pixels across it.
+     *  The results are identical to running on the drawing thread, which is what happens with
+     *  nullptr (the default).
+     *
+     *  The executor is atomic and read once when each of these operations starts, so it may be
+     *  changed while other threads draw; operations already running keep the executor they read. It
+     *  is not owned, and must outlive every draw that may have read it. This work nests, and waits
+     *  by borrowing work from the executor, so it must allow borrowing, as the thread pools of
+     *  SkExecutor do by default.
+     */
+    static SkExecutor* SetRasterExecutor(SkExecutor* executor);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
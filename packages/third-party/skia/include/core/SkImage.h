@@ -13,6 +13,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkAPI.h"
 
 #include <cstddef>
@@ -24,6 +25,7 @@ class GrDirectContext;
 class SkBitmap;
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageGenerator;
@@ -637,6 +639,29 @@ public:
                                    ReadPixelsCallback callback,
                                    ReadPixelsContext context) const;
 
+    /** Reads srcRect of the image and rescales it into each of dsts, synchronously on the CPU, the
+        same way asyncRescaleAndReadPixels() does. Each pixmap in dsts sets the size and the
+        color type, alpha type, and color space of one output.
+
+        All outputs come from a single read of the image. They are made largest first, each
+        starting from the smallest intermediate level already made that covers it, so producing
+        several sizes at once costs little more than producing the largest. If executor is not
+        null, each rescaling pass is split into stripes of rows that run on it in parallel.
+
+        @param dsts            destination pixmaps, each with its own size and info
+        @param srcRect         subrectangle of image to read
+        @param rescaleGamma    controls whether rescaling is done in the image's gamma or whether
+                               the source data is transformed to a linear gamma before rescaling.
+        @param rescaleMode     controls the technique (and cost) of the rescaling
+        @param executor        runs the stripes of each pass, or nullptr to run on this thread
+        @return                true if every pixmap in dsts was written
+    */
+    bool rescaleAndReadPixels(SkSpan<const SkPixmap> dsts,
+                              const SkIRect& srcRect,
+                              RescaleGamma rescaleGamma,
+                              RescaleMode rescaleMode,
+                              SkExecutor* executor = nullptr) const;
+
     /**
         Similar to asyncRescaleAndReadPixels but performs an additional conversion to YUV. The
         RGB->YUV conversion is controlled by 'yuvColorSpace'. The YUV data is returned as three
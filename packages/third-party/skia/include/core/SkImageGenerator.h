@@ -85,6 +85,17 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes());
     }
 
+    /**
+     *  Return a size that approximately supports the desired scale factor, and that getPixels()
+     *  can decode to directly, usually faster than decoding the full image. For example, a JPEG
+     *  can be decoded at 1/8, 2/8, ... of its size.
+     *
+     *  The default returns the dimensions of getInfo(): the generator does not scale.
+     */
+    SkISize getScaledDimensions(float desiredScale) const {
+        return this->onGetScaledDimensions(desiredScale);
+    }
+
     /**
      *  If decoding to YUV is supported, this returns true. Otherwise, this
      *  returns false and the caller will ignore output parameter yuvaPixmapInfo.
@@ -123,6 +134,7 @@ protected:
 #endif
     struct Options {};
     virtual bool onGetPixels(const SkImageInfo&, void*, size_t, const Options&) { return false; }
+    virtual SkISize onGetScaledDimensions(float) const { return fInfo.dimensions(); }
     virtual bool onIsValid(SkRecorder*) const { return true; }
     virtual bool onIsProtected() const { return false; }
     virtual bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
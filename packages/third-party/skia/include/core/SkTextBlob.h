@@ -301,6 +301,9 @@ private:
 
     static unsigned ScalarsPerGlyph(GlyphPositioning pos);
 
+    // Storage shared by the blobs of an SkTextBlobBuilder made with a slab size.
+    struct Slab;
+
     using PurgeDelegate = void (*)(uint32_t blobID, uint32_t cacheID);
 
     // Call when this blob is part of the key to a cache entry. This allows the cache
@@ -342,6 +345,17 @@ public:
     */
     SkTextBlobBuilder();
 
+    /** Constructs empty SkTextBlobBuilder whose blobs are placed in shared allocations of
+        slabSize bytes instead of each having its own, and which keeps its run storage between
+        blobs. This suits making many small blobs, such as labels, that are released at about
+        the same time: an allocation is freed only when all of its blobs have been deleted.
+        Blobs larger than slabSize are allocated on their own.
+
+        @param slabSize  size of each shared allocation, in bytes
+        @return          empty SkTextBlobBuilder
+    */
+    explicit SkTextBlobBuilder(size_t slabSize);
+
     /** Deletes data allocated internally by SkTextBlobBuilder.
     */
     ~SkTextBlobBuilder();
@@ -536,6 +550,7 @@ public:
 
 private:
     void reserve(size_t size);
+    uint8_t* detachStorage();
     void allocInternal(const SkFont& font, SkTextBlob::GlyphPositioning positioning,
                        int count, int textBytes, SkPoint offset, const SkRect* bounds);
     bool mergeRun(const SkFont& font, SkTextBlob::GlyphPositioning positioning,
@@ -558,6 +573,9 @@ private:
     size_t                 fLastRun; // index into fStorage
 
     RunBuffer              fCurrentRunBuffer;
+
+    size_t                 fSlabSize;
+    SkTextBlob::Slab*      fSlab;
 };
 
 #endif // SkTextBlob_DEFINED
@@ -43,12 +43,37 @@ public:
      */
     bool encodeRows(int numRows);
 
+    /**
+     *  Encode the rows of |rows| as the next rows of the image, instead of reading them from the
+     *  src the encoder was made with. |rows| must have the width and color info of that src, and
+     *  may hold as little as one row. Returns false if it does not match the src, or if it holds
+     *  more rows than remain.
+     *
+     *  This lets an image be encoded as it is produced without ever holding all of it. When every
+     *  row is passed this way, the pixels of the src given to the encoder are never read.
+     *
+     *  Not supported by encoders made from SkYUVAPixmaps, for which this returns false without
+     *  encoding anything.
+     */
+    bool encodeRows(const SkPixmap& rows);
+
     virtual ~SkEncoder() {}
 
 protected:
 
     virtual bool onEncodeRows(int numRows) = 0;
 
+    /**
+     *  Returns whether the encoder reads its rows through srcRowAddr(), so that they may be passed
+     *  to encodeRows(const SkPixmap&).
+     */
+    virtual bool onSupportsRowPixmaps() const { return true; }
+
+    /**
+     *  Returns the address of row |y| of the image, which must be one of the rows being encoded.
+     */
+    const void* srcRowAddr(int y) const;
+
     SkEncoder(const SkPixmap& src, size_t storageBytes)
         : fSrc(src)
         , fCurrRow(0)
@@ -58,6 +83,11 @@ protected:
     const SkPixmap&        fSrc;
     int                    fCurrRow;
     skia_private::AutoTMalloc<uint8_t> fStorage;
+
+private:
+    // The rows passed to encodeRows(const SkPixmap&), the first of which is row fRowsTop.
+    const SkPixmap*        fRows = nullptr;
+    int                    fRowsTop = 0;
 };
 
 #endif
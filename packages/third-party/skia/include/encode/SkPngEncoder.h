@@ -20,6 +20,7 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -90,6 +91,19 @@ struct Options {
      */
     const SkPixmap* fGainmap = nullptr;
     const SkGainmapInfo* fGainmapInfo = nullptr;
+
+    /**
+     *  If non-null, Encode() splits large images into bands of rows that are filtered and
+     *  compressed independently on this executor, then joined into a single zlib stream.
+     *  Each band is compressed with the end of the previous band as its dictionary, so the
+     *  output is slightly larger than a serial encode but decodes to the same pixels.
+     *
+     *  When more than one filter is allowed, the filter of each row is picked by the same
+     *  heuristic as libpng, the smallest sum of the absolute values of the filtered bytes.
+     *
+     *  Small images, and encoders made by Make(), are encoded serially.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
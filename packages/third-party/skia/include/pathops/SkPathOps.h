@@ -8,12 +8,14 @@
 #define SkPathOps_DEFINED
 
 #include "include/core/SkPath.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTDArray.h"
 
 #include <optional>
 
+class SkExecutor;
 struct SkRect;
 
 // FIXME: move everything below into the SkPath class
@@ -129,6 +131,18 @@ public:
       */
     std::optional<SkPath> resolve();
 
+    /** Like resolve(), but when every operand is a union, or every operand after the first is an
+        xor, and no path has an inverse fill type, many operands are resolved in parallel.
+        Nearby paths are grouped and each group is resolved on executor. The group results are
+        then merged pairwise, and contours that do not come near the other side of a merge are
+        passed through untouched. The result covers the same area as resolve(), though its
+        contours may be in a different order.
+
+        @param executor Runs the groups and merges.
+        @return result The product of the operands, {} on failure.
+      */
+    std::optional<SkPath> resolve(SkExecutor& executor);
+
     // DEPRECATED
     bool resolve(SkPath* result) {
         if (auto res = this->resolve()) {
@@ -144,6 +158,7 @@ private:
 
     static bool FixWinding(SkPath* path);
     static void ReversePath(SkPath* path);
+    static std::optional<SkPath> Resolve(SkSpan<SkPath> paths, SkSpan<const SkPathOp> ops);
     void reset();
 };
 
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextBlobCache_DEFINED
+#define SkTextBlobCache_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypes.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+class SkFont;
+class SkTextBlob;
+class SkTraceMemoryDump;
+
+/**
+ *  SkTextBlobCache interns the blobs made from UTF-8 text, so text that does not change between
+ *  frames, such as labels, is converted to glyphs and positions only once. Blobs are looked up by
+ *  their text, font and positioning, and the least recently used are dropped when the cache grows
+ *  beyond its byte limit. The blobs are immutable and may be kept after they leave the cache.
+ *
+ *  The blobs share slabs of up to 16KB, and at most an eighth of the byte limit. A slab is freed
+ *  only when all of its blobs are, so the cache counts every slab that holds one of its blobs in
+ *  full against the limit, as well as the slab it is filling.
+ *
+ *  The cache is thread safe.
+ */
+class SK_API SkTextBlobCache {
+public:
+    /** How the glyphs of a blob are positioned. Positions are computed from the glyph advances.
+     */
+    enum class Positioning {
+        kDefault,     //!< one offset for the run, as made by SkTextBlobBuilder::allocRun()
+        kHorizontal,  //!< an x position per glyph, as made by SkTextBlobBuilder::allocRunPosH()
+        kFull,        //!< a point per glyph, as made by SkTextBlob::MakeFromText()
+    };
+
+    static constexpr size_t kDefaultByteLimit = 2 * 1024 * 1024;
+
+    explicit SkTextBlobCache(size_t byteLimit = kDefaultByteLimit);
+    ~SkTextBlobCache();
+
+    SkTextBlobCache(const SkTextBlobCache&) = delete;
+    SkTextBlobCache& operator=(const SkTextBlobCache&) = delete;
+
+    /** Returns the cached blob for the text, font and positioning, making and caching it first
+        if needed. Returns nullptr if the text has no glyphs.
+     */
+    sk_sp<SkTextBlob> findOrMake(const char utf8[], size_t byteLength, const SkFont& font,
+                                 Positioning positioning = Positioning::kFull);
+
+    sk_sp<SkTextBlob> findOrMake(const char string[], const SkFont& font,
+                                 Positioning positioning = Positioning::kFull) {
+        return this->findOrMake(string, strlen(string), font, positioning);
+    }
+
+    /** Sets the byte limit and returns the previous one. Blobs are dropped until the cache fits.
+     */
+    size_t setByteLimit(size_t byteLimit);
+    size_t getByteLimit() const;
+    size_t getTotalBytesUsed() const;
+    int count() const;
+
+    void purgeAll();
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> fImpl;
+};
+
+#endif
@@ -0,0 +1,36 @@
+// Copyright 2025 Google LLC
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#ifndef PolygonOps_DEFINED
+#define PolygonOps_DEFINED
+
+#include "include/core/SkPath.h"
+#include "include/pathops/SkPathOps.h"
+
+#include <optional>
+
+namespace bentleyottmann {
+
+// A polygon backend for the boolean operations in SkPathOps. These have the same signatures as
+// Op() and Simplify(), but instead of intersecting curves exactly they work on polygons:
+// * Curves are flattened to lines that stay within tolerance of the curve.
+// * All the points are snap rounded to a fixed grid. The grid is 1/1024 of a unit unless the
+//   paths are too large for that to be exact, in which case it is the finest power of two that is.
+// * A single sweep over the rounded edges assigns winding numbers, and the edges between regions
+//   that are inside and outside the result are chained into contours.
+//
+// Because every crossing is rounded to a grid point, the result is robust even on very large
+// inputs of nearly coincident edges, and it is much faster than SkPathOps on polygons. The
+// result only contains lines, and its vertices are within a grid cell of the exact answer.
+//
+// The result has kWinding fill type, or kInverseWinding if it is unbounded. Returns nullopt if
+// either path has a non-finite point.
+std::optional<SkPath> polygon_op(const SkPath& one, const SkPath& two, SkPathOp op,
+                                 float tolerance = 0.25f);
+
+// Returns a path with no self intersections that covers the same area as path.
+std::optional<SkPath> polygon_simplify(const SkPath& path, float tolerance = 0.25f);
+
+}  // namespace bentleyottmann
+
+#endif  // PolygonOps_DEFINED
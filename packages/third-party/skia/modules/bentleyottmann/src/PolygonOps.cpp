@@ -0,0 +1,597 @@
+// Copyright 2025 Google LLC
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#include "modules/bentleyottmann/include/PolygonOps.h"
+
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkSpan.h"
+#include "include/private/base/SkTo.h"
+#include "modules/bentleyottmann/include/Point.h"
+#include "modules/bentleyottmann/include/Segment.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace bentleyottmann {
+namespace {
+
+// The finest grid is 1/2^kMaxGridShift of a unit.
+constexpr int kMaxGridShift = 10;
+
+// Rounded coordinates are at most 2^kMaxMagnitudeLog2. The pixel tests double the coordinates,
+// and the cross products of their differences still fit in an int64_t.
+constexpr int kMaxMagnitudeLog2 = 24;
+
+constexpr int kMaxCurveSegments = 1024;
+
+// The cells of the grid used to find nearby edges are made coarse enough that no edge covers more
+// than this many in either direction.
+constexpr int64_t kMaxCellsPerAxis = 4096;
+
+// The winding number of each operand.
+using Winding = std::array<int32_t, 2>;
+
+Winding operator+(const Winding& w0, const Winding& w1) {
+    return {w0[0] + w1[0], w0[1] + w1[1]};
+}
+
+// An edge directed from segment.p0 to segment.p1, which changes the winding numbers by winding
+// when it is crossed from its left to its right.
+struct Edge {
+    Segment segment;
+    Winding winding;
+};
+
+int64_t orient(Point o, Point a, Point b) {
+    return int64_t{a.x - o.x} * (b.y - o.y) - int64_t{a.y - o.y} * (b.x - o.x);
+}
+
+// The sweep order of points as one integer, which is much quicker to sort by.
+uint64_t order(Point p) {
+    return uint64_t{static_cast<uint32_t>(p.y) ^ 0x80000000u} << 32 |
+           (static_cast<uint32_t>(p.x) ^ 0x80000000u);
+}
+
+int sign(int64_t v) {
+    return (v > 0) - (v < 0);
+}
+
+// -- Flattening -----------------------------------------------------------------------------------
+// Wang's formula: the number of lines needed to stay within tolerance of a curve whose control
+// points have second differences scaled by the degree term to secondDifference.
+int segment_count(float secondDifference, float tolerance) {
+    const float n = std::ceil(std::sqrt(secondDifference / tolerance));
+    return n < kMaxCurveSegments ? std::max(static_cast<int>(n), 1) : kMaxCurveSegments;
+}
+
+void flatten(const SkPath& path, float tolerance, std::vector<std::vector<SkPoint>>* contours) {
+    SkPath::Iter iter(path, /*forceClose=*/true);
+    while (auto rec = iter.next()) {
+        SkSpan<const SkPoint> pts = rec->fPoints;
+        switch (rec->fVerb) {
+            case SkPathVerb::kMove:
+                contours->push_back({pts[0]});
+                break;
+            case SkPathVerb::kLine:
+                contours->back().push_back(pts[1]);
+                break;
+            case SkPathVerb::kQuad:
+            case SkPathVerb::kConic: {
+                // A conic is flattened like a quad, with more lines as its weight grows.
+                const float w = rec->fVerb == SkPathVerb::kConic ? rec->conicWeight() : 1;
+                const SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+                const int n = segment_count(0.25f * std::max(w, 1.f) * dd.length(), tolerance);
+                for (int i = 1; i <= n; ++i) {
+                    const float t = static_cast<float>(i) / n, u = 1 - t;
+                    const float a = u * u, b = 2 * w * u * t, c = t * t, d = a + b + c;
+                    contours->back().push_back(
+                            {(a * pts[0].fX + b * pts[1].fX + c * pts[2].fX) / d,
+                             (a * pts[0].fY + b * pts[1].fY + c * pts[2].fY) / d});
+                }
+                break;
+            }
+            case SkPathVerb::kCubic: {
+                const SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2],
+                               dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+                const int n =
+                        segment_count(0.75f * std::max(dd0.length(), dd1.length()), tolerance);
+                for (int i = 1; i <= n; ++i) {
+                    const float t = static_cast<float>(i) / n, u = 1 - t;
+                    const float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+                    contours->back().push_back(
+                            {a * pts[0].fX + b * pts[1].fX + c * pts[2].fX + d * pts[3].fX,
+                             a * pts[0].fY + b * pts[1].fY + c * pts[2].fY + d * pts[3].fY});
+                }
+                break;
+            }
+            case SkPathVerb::kClose:
+                break;
+        }
+    }
+}
+
+// Rounds the closed polygons to the grid and appends their edges to edges.
+void round_edges(const std::vector<std::vector<SkPoint>>& contours,
+                 double scale,
+                 int operand,
+                 std::vector<Edge>* edges) {
+    std::vector<Point> points;
+    for (const std::vector<SkPoint>& contour : contours) {
+        points.clear();
+        for (SkPoint p : contour) {
+            const Point rounded = {static_cast<int32_t>(std::lround(p.fX * scale)),
+                                   static_cast<int32_t>(std::lround(p.fY * scale))};
+            if (points.empty() || rounded != points.back()) {
+                points.push_back(rounded);
+            }
+        }
+        while (points.size() > 1 && points.back() == points.front()) {
+            points.pop_back();
+        }
+        if (points.size() < 2) {
+            continue;
+        }
+        for (size_t i = 0; i < points.size(); ++i) {
+            Edge edge = {{points[i], points[(i + 1) % points.size()]}, {0, 0}};
+            edge.winding[operand] = 1;
+            edges->push_back(edge);
+        }
+    }
+}
+
+// -- Grid -----------------------------------------------------------------------------------------
+// A uniform grid of square cells used to find the edges and points near an edge.
+class Grid {
+public:
+    explicit Grid(const std::vector<Edge>& edges) {
+        int64_t extentSum = 0;
+        int32_t left = INT32_MAX, top = INT32_MAX, right = INT32_MIN, bottom = INT32_MIN;
+        for (const Edge& edge : edges) {
+            auto [l, t, r, b] = edge.segment.bounds();
+            extentSum += std::max(r - l, b - t);
+            left = std::min(left, l);
+            top = std::min(top, t);
+            right = std::max(right, r);
+            bottom = std::max(bottom, b);
+        }
+        // Cells about twice the size of an average edge, so most edges are in only a few cells,
+        // but no larger than needed for about one edge per cell where the edges are crowded.
+        const int64_t span = edges.empty()
+                                     ? 0
+                                     : std::max(int64_t{right} - left, int64_t{bottom} - top);
+        const int64_t average = edges.empty() ? 0 : extentSum / SkToS64(edges.size());
+        const int64_t crowded = static_cast<int64_t>(span / std::sqrt(edges.size() + 1.0));
+        const int64_t size = std::min(2 * average, crowded);
+        fShift = 1;
+        while ((int64_t{1} << fShift) < size || (span >> fShift) > kMaxCellsPerAxis) {
+            fShift++;
+        }
+    }
+
+    uint64_t key(Point p) const { return Key(p.x >> fShift, p.y >> fShift); }
+
+    // Calls fn with the key of every cell that is within a unit of the segment.
+    template <typename Fn>
+    void forEachCell(const Segment& segment, Fn&& fn) const {
+        constexpr int64_t kPad = 1;
+        const Point upper = segment.upper(), lower = segment.lower();
+        const bool horizontal = upper.y == lower.y;
+        const double dxdy = horizontal ? 0 : double(lower.x - upper.x) / (lower.y - upper.y);
+        for (int64_t row = (upper.y - kPad) >> fShift; row <= (lower.y + kPad) >> fShift; ++row) {
+            // The part of the segment within kPad of this row.
+            const int64_t y0 = std::max((row << fShift) - kPad, int64_t{upper.y}),
+                          y1 = std::min(((row + 1) << fShift) + kPad, int64_t{lower.y});
+            double x0 = upper.x + (y0 - upper.y) * dxdy,
+                   x1 = horizontal ? lower.x : upper.x + (y1 - upper.y) * dxdy;
+            if (x1 < x0) {
+                std::swap(x0, x1);
+            }
+            const int64_t first = (static_cast<int64_t>(std::floor(x0)) - kPad) >> fShift,
+                          last = (static_cast<int64_t>(std::ceil(x1)) + kPad) >> fShift;
+            for (int64_t column = first; column <= last; ++column) {
+                fn(Key(column, row));
+            }
+        }
+    }
+
+private:
+    static uint64_t Key(int64_t column, int64_t row) {
+        return (uint64_t{static_cast<uint32_t>(row)} << 32) | static_cast<uint32_t>(column);
+    }
+
+    int fShift;
+};
+
+// -- Snap rounding --------------------------------------------------------------------------------
+// Writes the centers of the pixels nearest to v to out and returns how many there are. Both pixels
+// are used when v is too close to the boundary between them to be sure of the rounding.
+int nearest_pixels(double v, int32_t out[2]) {
+    constexpr double kEpsilon = 1e-6;
+    const double rounded = std::floor(v + 0.5);
+    const double fraction = v + 0.5 - rounded;
+    out[0] = static_cast<int32_t>(rounded);
+    if (fraction < kEpsilon) {
+        out[1] = out[0] - 1;
+        return 2;
+    }
+    if (fraction > 1 - kEpsilon) {
+        out[1] = out[0] + 1;
+        return 2;
+    }
+    return 1;
+}
+
+// If the interiors of s0 and s1 cross, then add the pixel containing the crossing to hot.
+void add_crossing(const Segment& s0, const Segment& s1, std::vector<Point>* hot) {
+    if (no_intersection_by_bounding_box(s0, s1)) {
+        return;
+    }
+    const int64_t d0 = orient(s0.p0, s0.p1, s1.p0), d1 = orient(s0.p0, s0.p1, s1.p1);
+    if (sign(d0) * sign(d1) >= 0) {
+        return;
+    }
+    const int64_t d2 = orient(s1.p0, s1.p1, s0.p0), d3 = orient(s1.p0, s1.p1, s0.p1);
+    if (sign(d2) * sign(d3) >= 0) {
+        return;
+    }
+
+    // The orientation is linear along s0, and it is zero at the crossing.
+    const double t = static_cast<double>(d2) / (static_cast<double>(d2) - static_cast<double>(d3));
+    int32_t xs[2], ys[2];
+    const int xCount = nearest_pixels(s0.p0.x + t * (s0.p1.x - s0.p0.x), xs),
+              yCount = nearest_pixels(s0.p0.y + t * (s0.p1.y - s0.p0.y), ys);
+    for (int i = 0; i < xCount; ++i) {
+        for (int j = 0; j < yCount; ++j) {
+            hot->push_back({xs[i], ys[j]});
+        }
+    }
+}
+
+// The hot pixels are the pixels that contain a vertex or a crossing of two edges.
+std::vector<Point> find_hot_pixels(const std::vector<Edge>& edges, const Grid& grid) {
+    std::vector<Point> hot;
+    std::vector<std::pair<uint64_t, uint32_t>> cells;
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        hot.push_back(edges[i].segment.p0);
+        hot.push_back(edges[i].segment.p1);
+        grid.forEachCell(edges[i].segment, [&](uint64_t key) { cells.push_back({key, i}); });
+    }
+
+    // Edges that cross share the cell that contains the crossing.
+    std::sort(cells.begin(), cells.end());
+    for (size_t begin = 0, end; begin < cells.size(); begin = end) {
+        for (end = begin + 1; end < cells.size() && cells[end].first == cells[begin].first;) {
+            end++;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = i + 1; j < end; ++j) {
+                add_crossing(edges[cells[i].second].segment, edges[cells[j].second].segment, &hot);
+            }
+        }
+    }
+
+    std::sort(hot.begin(), hot.end(), [](Point p0, Point p1) { return order(p0) < order(p1); });
+    hot.erase(std::unique(hot.begin(), hot.end()), hot.end());
+    return hot;
+}
+
+// Does the segment touch the closed pixel around h? Everything is doubled to keep the corners of
+// the pixel on integers.
+bool touches(const Segment& segment, Point h) {
+    const int64_t x0 = 2 * int64_t{segment.p0.x}, y0 = 2 * int64_t{segment.p0.y},
+                  x1 = 2 * int64_t{segment.p1.x}, y1 = 2 * int64_t{segment.p1.y},
+                  hx = 2 * int64_t{h.x}, hy = 2 * int64_t{h.y};
+    if (std::max(x0, x1) < hx - 1 || std::min(x0, x1) > hx + 1 ||
+        std::max(y0, y1) < hy - 1 || std::min(y0, y1) > hy + 1) {
+        return false;
+    }
+
+    // The line through the segment misses the pixel if all its corners are on one side.
+    int positive = 0, negative = 0;
+    for (int64_t cx : {hx - 1, hx + 1}) {
+        for (int64_t cy : {hy - 1, hy + 1}) {
+            const int64_t side = (x1 - x0) * (cy - y0) - (y1 - y0) * (cx - x0);
+            positive += side > 0;
+            negative += side < 0;
+        }
+    }
+    return positive < 4 && negative < 4;
+}
+
+// Splits each edge into pieces that pass through the center of every hot pixel the edge touches,
+// in order along the edge.
+std::vector<Edge> reroute(const std::vector<Edge>& edges,
+                          const std::vector<Point>& hot,
+                          const Grid& grid) {
+    std::vector<std::pair<uint64_t, Point>> cells(hot.size());
+    for (size_t i = 0; i < hot.size(); ++i) {
+        cells[i] = {grid.key(hot[i]), hot[i]};
+    }
+    std::sort(cells.begin(), cells.end(),
+              [](const auto& c0, const auto& c1) { return c0.first < c1.first; });
+
+    std::vector<Edge> pieces;
+    pieces.reserve(edges.size());
+    std::vector<std::pair<int64_t, Point>> along;
+    for (const Edge& edge : edges) {
+        const Point p0 = edge.segment.p0, p1 = edge.segment.p1, d = p1 - p0;
+        along.clear();
+        grid.forEachCell(edge.segment, [&](uint64_t key) {
+            auto h = std::lower_bound(cells.begin(), cells.end(), key,
+                                      [](const auto& cell, uint64_t k) { return cell.first < k; });
+            for (; h != cells.end() && h->first == key; ++h) {
+                const Point p = h->second;
+                if (p != p0 && p != p1 && touches(edge.segment, p)) {
+                    const Point v = p - p0;
+                    along.push_back({int64_t{v.x} * d.x + int64_t{v.y} * d.y, p});
+                }
+            }
+        });
+        std::sort(along.begin(), along.end(), [](const auto& a0, const auto& a1) {
+            return a0.first != a1.first ? a0.first < a1.first
+                                        : order(a0.second) < order(a1.second);
+        });
+
+        Point from = p0;
+        for (const auto& [_, p] : along) {
+            pieces.push_back({{from, p}, edge.winding});
+            from = p;
+        }
+        pieces.push_back({{from, p1}, edge.winding});
+    }
+    return pieces;
+}
+
+// Points every edge down the sweep, then sorts the edges and combines the coincident ones. Edges
+// that do not change the winding are dropped.
+void merge(std::vector<Edge>* edges) {
+    for (Edge& edge : *edges) {
+        if (order(edge.segment.p1) < order(edge.segment.p0)) {
+            std::swap(edge.segment.p0, edge.segment.p1);
+            edge.winding = {-edge.winding[0], -edge.winding[1]};
+        }
+    }
+    auto key = [](const Edge& e) {
+        return std::make_pair(order(e.segment.p0), order(e.segment.p1));
+    };
+    std::sort(edges->begin(), edges->end(),
+              [&](const Edge& e0, const Edge& e1) { return key(e0) < key(e1); });
+
+    size_t count = 0;
+    for (size_t i = 0; i < edges->size();) {
+        Edge merged = (*edges)[i++];
+        for (; i < edges->size() && key((*edges)[i]) == key(merged); ++i) {
+            merged.winding = merged.winding + (*edges)[i].winding;
+        }
+        if (merged.segment.p0 != merged.segment.p1 && merged.winding != Winding{0, 0}) {
+            (*edges)[count++] = merged;
+        }
+    }
+    edges->resize(count);
+}
+
+// -- Sweep ----------------------------------------------------------------------------------------
+struct Rule {
+    SkPathFillType fillTypes[2];
+    SkPathOp op;
+
+    bool inside(const Winding& w) const {
+        bool in[2];
+        for (int i = 0; i < 2; ++i) {
+            in[i] = SkPathFillType_IsEvenOdd(fillTypes[i]) ? (w[i] & 1) : w[i] != 0;
+            in[i] = in[i] != SkPathFillType_IsInverse(fillTypes[i]);
+        }
+        switch (op) {
+            case kDifference_SkPathOp:        return in[0] && !in[1];
+            case kIntersect_SkPathOp:         return in[0] && in[1];
+            case kUnion_SkPathOp:             return in[0] || in[1];
+            case kXOR_SkPathOp:               return in[0] != in[1];
+            case kReverseDifference_SkPathOp: return !in[0] && in[1];
+        }
+        return false;
+    }
+};
+
+// An edge crossing the sweep line, kept small because the sweep line is a sorted vector.
+struct ActiveEdge {
+    uint32_t index;
+    // The winding to the right of the edge.
+    Winding right;
+};
+
+// Is the segment left of p on the sweep line through p? A horizontal segment lies along the sweep
+// line, and is left of p if it ends before p.
+bool left_of_point(const Segment& s, Point p) {
+    if (s.p0.y == s.p1.y) {
+        return s.p1.x < p.x;
+    }
+    return int64_t{p.x - s.p0.x} * (s.p1.y - s.p0.y) > int64_t{s.p1.x - s.p0.x} * (p.y - s.p0.y);
+}
+
+// Sweeps down the merged edges, which only meet at their end points, and returns the edges that
+// separate the inside of the result from the outside. Each is directed so the inside is on its
+// right, giving the inside a winding of one more than the outside.
+std::vector<Segment> sweep(std::vector<Edge> edges, const Rule& rule) {
+    // The edges that start at a point are sorted from left to right below it.
+    std::sort(edges.begin(), edges.end(), [](const Edge& e0, const Edge& e1) {
+        if (e0.segment.p0 != e1.segment.p0) {
+            return order(e0.segment.p0) < order(e1.segment.p0);
+        }
+        return compare_slopes(e0.segment, e1.segment) < 0;
+    });
+
+    std::vector<Point> events;
+    events.reserve(2 * edges.size());
+    for (const Edge& edge : edges) {
+        events.push_back(edge.segment.p0);
+        events.push_back(edge.segment.p1);
+    }
+    std::sort(events.begin(), events.end(),
+              [](Point p0, Point p1) { return order(p0) < order(p1); });
+    events.erase(std::unique(events.begin(), events.end()), events.end());
+
+    std::vector<Segment> result;
+    std::vector<ActiveEdge> active, starting;
+    size_t next = 0;
+    for (Point p : events) {
+        auto begin = std::lower_bound(active.begin(), active.end(), p,
+                                      [&](const ActiveEdge& a, Point point) {
+                                          return left_of_point(edges[a.index].segment, point);
+                                      });
+        auto end = begin;
+        while (end != active.end() && edges[end->index].segment.p1 == p) {
+            ++end;
+        }
+
+        Winding winding = begin != active.begin() ? (begin - 1)->right : Winding{0, 0};
+        starting.clear();
+        for (; next < edges.size() && edges[next].segment.p0 == p; ++next) {
+            const Edge& edge = edges[next];
+            const bool leftInside = rule.inside(winding);
+            winding = winding + edge.winding;
+            starting.push_back({static_cast<uint32_t>(next), winding});
+            if (leftInside != rule.inside(winding)) {
+                result.push_back(leftInside ? Segment{edge.segment.p1, edge.segment.p0}
+                                            : edge.segment);
+            }
+        }
+
+        begin = active.erase(begin, end);
+        active.insert(begin, starting.begin(), starting.end());
+    }
+    return result;
+}
+
+// -- Output ---------------------------------------------------------------------------------------
+// Can b be dropped from a, b, c because it is on the way from a to c?
+bool is_redundant(Point a, Point b, Point c) {
+    const Point ab = b - a, bc = c - b;
+    return orient(a, b, c) == 0 && int64_t{ab.x} * bc.x + int64_t{ab.y} * bc.y > 0;
+}
+
+SkPath build_path(std::vector<Segment> segments, double scale, bool inverse) {
+    std::sort(segments.begin(), segments.end(), [](const Segment& s0, const Segment& s1) {
+        return std::make_pair(order(s0.p0), order(s0.p1)) <
+               std::make_pair(order(s1.p0), order(s1.p1));
+    });
+
+    SkPathBuilder builder(inverse ? SkPathFillType::kInverseWinding : SkPathFillType::kWinding);
+    std::vector<bool> used(segments.size());
+    std::vector<Point> contour;
+    for (size_t first = 0; first < segments.size(); ++first) {
+        if (used[first]) {
+            continue;
+        }
+
+        // Follow the edges until they come back to the start. At a vertex where the result
+        // touches itself any unused edge will do.
+        contour.clear();
+        for (size_t current = first;;) {
+            used[current] = true;
+            contour.push_back(segments[current].p0);
+            const Point to = segments[current].p1;
+            if (to == segments[first].p0) {
+                break;
+            }
+            auto it = std::lower_bound(
+                    segments.begin(), segments.end(), to,
+                    [](const Segment& s, Point p) { return order(s.p0) < order(p); });
+            for (; it != segments.end() && it->p0 == to && used[it - segments.begin()]; ++it) {}
+            if (it == segments.end() || it->p0 != to) {
+                break;
+            }
+            current = it - segments.begin();
+        }
+
+        size_t count = 0;
+        for (Point p : contour) {
+            while (count >= 2 && is_redundant(contour[count - 2], contour[count - 1], p)) {
+                count--;
+            }
+            contour[count++] = p;
+        }
+        contour.resize(count);
+        while (contour.size() >= 3 &&
+               is_redundant(contour[contour.size() - 2], contour.back(), contour.front())) {
+            contour.pop_back();
+        }
+        while (contour.size() >= 3 &&
+               is_redundant(contour.back(), contour.front(), contour[1])) {
+            contour.erase(contour.begin());
+        }
+        if (contour.size() < 3) {
+            continue;
+        }
+
+        const double invScale = 1 / scale;
+        for (size_t i = 0; i < contour.size(); ++i) {
+            const SkPoint p = {static_cast<float>(contour[i].x * invScale),
+                               static_cast<float>(contour[i].y * invScale)};
+            if (i == 0) {
+                builder.moveTo(p);
+            } else {
+                builder.lineTo(p);
+            }
+        }
+        builder.close();
+    }
+    return builder.detach();
+}
+
+}  // namespace
+
+std::optional<SkPath> polygon_op(const SkPath& one, const SkPath& two, SkPathOp op,
+                                 float tolerance) {
+    if (!one.isFinite() || !two.isFinite() || !(tolerance > 0)) {
+        return std::nullopt;
+    }
+
+    std::vector<std::vector<SkPoint>> contours[2];
+    flatten(one, tolerance, &contours[0]);
+    flatten(two, tolerance, &contours[1]);
+
+    float maxAbs = 0;
+    for (const auto& operand : contours) {
+        for (const std::vector<SkPoint>& contour : operand) {
+            for (SkPoint p : contour) {
+                maxAbs = std::max({maxAbs, std::abs(p.fX), std::abs(p.fY)});
+            }
+        }
+    }
+    if (!std::isfinite(maxAbs)) {
+        return std::nullopt;
+    }
+
+    // Use the finest grid that keeps the rounded coordinates below 2^kMaxMagnitudeLog2.
+    const int shift =
+            maxAbs > 0 ? std::min(kMaxGridShift, kMaxMagnitudeLog2 - 1 - std::ilogb(maxAbs))
+                       : kMaxGridShift;
+    const double scale = std::ldexp(1.0, shift);
+
+    std::vector<Edge> edges;
+    round_edges(contours[0], scale, 0, &edges);
+    round_edges(contours[1], scale, 1, &edges);
+
+    // After snap rounding, the pieces of the edges only meet at their end points or coincide.
+    // A piece cannot pass through the center of a hot pixel without ending there, because the
+    // edge it came from would have touched that pixel.
+    const Grid grid(edges);
+    edges = reroute(edges, find_hot_pixels(edges, grid), grid);
+    merge(&edges);
+
+    const Rule rule = {{one.getFillType(), two.getFillType()}, op};
+    return build_path(sweep(std::move(edges), rule), scale, rule.inside({0, 0}));
+}
+
+std::optional<SkPath> polygon_simplify(const SkPath& path, float tolerance) {
+    return polygon_op(path, SkPath(), kUnion_SkPathOp, tolerance);
+}
+
+}  // namespace bentleyottmann
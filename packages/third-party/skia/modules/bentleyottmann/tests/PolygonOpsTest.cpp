@@ -0,0 +1,193 @@
+// Copyright 2025 Google LLC
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#include "modules/bentleyottmann/include/PolygonOps.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "src/base/SkRandom.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace bentleyottmann;
+
+static bool apply(SkPathOp op, bool one, bool two) {
+    switch (op) {
+        case kDifference_SkPathOp:        return one && !two;
+        case kIntersect_SkPathOp:         return one && two;
+        case kUnion_SkPathOp:             return one || two;
+        case kXOR_SkPathOp:               return one != two;
+        case kReverseDifference_SkPathOp: return !one && two;
+    }
+    return false;
+}
+
+// The distance from p to the nearest line of a polygon path.
+static float distance_to_edges(const SkPath& path, SkPoint p) {
+    float distance = std::numeric_limits<float>::max();
+    SkPath::Iter iter(path, /*forceClose=*/true);
+    while (auto rec = iter.next()) {
+        if (rec->fVerb == SkPathVerb::kLine) {
+            const SkPoint a = rec->fPoints[0];
+            const SkVector ab = rec->fPoints[1] - a;
+            const float t = std::clamp((p - a).dot(ab) / std::max(ab.dot(ab), 1e-12f), 0.f, 1.f);
+            distance = std::min(distance, (p - (a + ab * t)).length());
+        }
+    }
+    return distance;
+}
+
+// Checks the result against the operands on a lattice of points. Points near an edge are skipped
+// because rounding to the grid may move the edges a little.
+static void check_op(skiatest::Reporter* r, const SkPath& one, const SkPath& two, SkPathOp op) {
+    std::optional<SkPath> result = polygon_op(one, two, op);
+    REPORTER_ASSERT(r, result.has_value());
+    if (!result) {
+        return;
+    }
+    const SkRect bounds = SkRect::Make(one.getBounds().roundOut()).makeOutset(1, 1);
+    for (float y = bounds.fTop + 0.1f; y < bounds.fBottom; y += 0.53f) {
+        for (float x = bounds.fLeft + 0.2f; x < bounds.fRight; x += 0.47f) {
+            const SkPoint p = {x, y};
+            if (distance_to_edges(one, p) < 0.01f || distance_to_edges(two, p) < 0.01f) {
+                continue;
+            }
+            const bool expected = apply(op, one.contains(x, y), two.contains(x, y));
+            REPORTER_ASSERT(r, result->contains(x, y) == expected,
+                            "op %d at (%g, %g)", static_cast<int>(op), x, y);
+        }
+    }
+}
+
+static SkPath random_polygons(SkRandom* rand, int count) {
+    SkPathBuilder builder;
+    for (int i = 0; i < count; ++i) {
+        const int sides = 3 + rand->nextULessThan(6);
+        for (int j = 0; j < sides; ++j) {
+            const SkPoint p = {rand->nextRangeF(0, 20), rand->nextRangeF(0, 20)};
+            if (j == 0) {
+                builder.moveTo(p);
+            } else {
+                builder.lineTo(p);
+            }
+        }
+        builder.close();
+    }
+    return builder.detach();
+}
+
+DEF_TEST(BO_PolygonOpsRects, r) {
+    const SkPath one = SkPath::Rect({0, 0, 10, 10}),
+                 two = SkPath::Rect({5, 5, 15, 15}, SkPathDirection::kCCW);
+    for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+        check_op(r, one, two, static_cast<SkPathOp>(op));
+    }
+
+    std::optional<SkPath> result = polygon_op(one, two, kUnion_SkPathOp);
+    REPORTER_ASSERT(r, result && result->countPoints() == 8);
+    REPORTER_ASSERT(r, result && result->getBounds() == SkRect::MakeLTRB(0, 0, 15, 15));
+
+    result = polygon_op(one, two, kIntersect_SkPathOp);
+    REPORTER_ASSERT(r, result && result->countPoints() == 4);
+    REPORTER_ASSERT(r, result && result->getBounds() == SkRect::MakeLTRB(5, 5, 10, 10));
+
+    // Disjoint operands intersect to nothing.
+    result = polygon_op(one, SkPath::Rect({20, 20, 30, 30}), kIntersect_SkPathOp);
+    REPORTER_ASSERT(r, result && result->isEmpty());
+}
+
+DEF_TEST(BO_PolygonOpsRandom, r) {
+    SkRandom rand;
+    for (int i = 0; i < 20; ++i) {
+        SkPath one = random_polygons(&rand, 1 + rand.nextULessThan(3)),
+               two = random_polygons(&rand, 1 + rand.nextULessThan(3));
+        if (i & 1) {
+            one.setFillType(SkPathFillType::kEvenOdd);
+        }
+        if (i % 5 == 0) {
+            two.setFillType(SkPathFillType::kInverseWinding);
+        }
+        for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+            check_op(r, one, two, static_cast<SkPathOp>(op));
+        }
+    }
+}
+
+DEF_TEST(BO_PolygonOpsSimplify, r) {
+    // The squares of a grid share their sides, and union into one square.
+    SkPathBuilder builder;
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            builder.addRect(SkRect::MakeXYWH(x, y, 1, 1));
+        }
+    }
+    std::optional<SkPath> result = polygon_simplify(builder.detach());
+    REPORTER_ASSERT(r, result && result->countPoints() == 4);
+    REPORTER_ASSERT(r, result && result->getBounds() == SkRect::MakeWH(8, 8));
+
+    // A pentagram covers its center with the winding fill type, but not with even-odd.
+    for (int i = 0; i < 5; ++i) {
+        const float angle = i * 4 * SK_ScalarPI / 5;
+        const SkPoint p = {100 * std::sin(angle), -100 * std::cos(angle)};
+        if (i == 0) {
+            builder.moveTo(p);
+        } else {
+            builder.lineTo(p);
+        }
+    }
+    SkPath star = builder.close().detach();
+    result = polygon_simplify(star);
+    REPORTER_ASSERT(r, result && result->contains(0, 0));
+    REPORTER_ASSERT(r, result && result->getFillType() == SkPathFillType::kWinding);
+    star.setFillType(SkPathFillType::kEvenOdd);
+    result = polygon_simplify(star);
+    REPORTER_ASSERT(r, result && !result->contains(0, 0) && result->contains(0, -90));
+
+    // An inverse path simplifies to an inverse path.
+    star.setFillType(SkPathFillType::kInverseWinding);
+    result = polygon_simplify(star);
+    REPORTER_ASSERT(r, result && result->isInverseFillType());
+    REPORTER_ASSERT(r, result && !result->contains(0, 0) && result->contains(200, 200));
+}
+
+DEF_TEST(BO_PolygonOpsCurves, r) {
+    // Curves are flattened to within the tolerance.
+    const SkPath circle = SkPath::Circle(0, 0, 10);
+    for (float tolerance : {1.f, 0.25f, 0.01f}) {
+        std::optional<SkPath> result = polygon_simplify(circle, tolerance);
+        REPORTER_ASSERT(r, result.has_value());
+        if (!result) {
+            continue;
+        }
+        for (int i = 0; i < 64; ++i) {
+            const float angle = i * SK_ScalarPI / 32;
+            const SkVector direction = {std::cos(angle), std::sin(angle)};
+            const SkPoint inside = direction * (10 - tolerance - 0.01f),
+                          outside = direction * (10 + 0.01f);
+            REPORTER_ASSERT(r, result->contains(inside.fX, inside.fY));
+            REPORTER_ASSERT(r, !result->contains(outside.fX, outside.fY));
+        }
+    }
+}
+
+DEF_TEST(BO_PolygonOpsLimits, r) {
+    // Large coordinates use a coarser grid.
+    std::optional<SkPath> result = polygon_op(SkPath::Rect({-1e7f, -1e7f, 1e7f, 1e7f}),
+                                              SkPath::Rect({0, 0, 2e7f, 2e7f}),
+                                              kIntersect_SkPathOp);
+    REPORTER_ASSERT(r, result && result->getBounds() == SkRect::MakeWH(1e7f, 1e7f));
+
+    // Non-finite paths fail.
+    const SkPath infinite = SkPath::Polygon(
+            {{0, 0}, {std::numeric_limits<float>::infinity(), 0}, {0, 1}}, /*isClosed=*/true);
+    REPORTER_ASSERT(r, !polygon_op(infinite, SkPath::Rect({0, 0, 1, 1}), kUnion_SkPathOp));
+    REPORTER_ASSERT(r, !polygon_simplify(infinite));
+
+    // So does a tolerance that is not positive.
+    REPORTER_ASSERT(r, !polygon_simplify(SkPath::Rect({0, 0, 1, 1}), 0));
+}
@@ -4,9 +4,11 @@
 
 #include "include/private/base/SkMutex.h"
 #include "src/core/SkLRUCache.h"
+#include <cstddef>
+#include <cstdint>
 #include <functional>  // std::function
 
-#define PARAGRAPH_CACHE_STATS
+class SkTraceMemoryDump;
 
 namespace skia {
 namespace textlayout {
@@ -17,6 +19,18 @@ class ParagraphCacheValue;
 
 class ParagraphCache {
 public:
+    // Budget for the shaped results kept by the cache (runs, clusters, ICU data).
+    static constexpr size_t kDefaultByteLimit = 8 * 1024 * 1024;
+
+    struct Stats {
+        uint64_t fRequests = 0;     // findParagraph calls while the cache is on
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        uint64_t fInsertions = 0;
+        uint64_t fEvictions = 0;    // entries dropped to stay within the byte limit
+        uint64_t fSkipped = 0;      // paragraphs not cached (text editing, over budget)
+    };
+
     ParagraphCache();
     ~ParagraphCache();
 
@@ -25,13 +39,27 @@ public:
     bool updateParagraph(ParagraphImpl* paragraph);
     bool findParagraph(ParagraphImpl* paragraph);
 
+    // Sets the byte budget, evicting the least recently used entries if needed.
+    // Returns the previous limit.
+    size_t setByteLimit(size_t newLimit);
+    size_t getByteLimit() const;
+    size_t getTotalBytesUsed() const;
+
+    Stats getStats() const;
+    void resetStats();
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const;
+
     // For testing
     void setChecker(std::function<void(ParagraphImpl* impl, const char*, bool)> checker) {
         fChecker = std::move(checker);
     }
     void printStatistics();
     void turnOn(bool value) { fCacheIsOn = value; }
-    int count() { return fLRUCacheMap.count(); }
+    int count() {
+        SkAutoMutexExclusive lock(fParagraphMutex);
+        return fLRUCacheMap.count();
+    }
 
     bool isPossiblyTextEditing(ParagraphImpl* paragraph);
 
@@ -40,25 +68,29 @@ public:
     struct Entry;
     void updateFrom(const ParagraphImpl* paragraph, Entry* entry);
     void updateTo(ParagraphImpl* paragraph, const Entry* entry);
+    void purgeToLimit(size_t limit);
 
      mutable SkMutex fParagraphMutex;
      std::function<void(ParagraphImpl* impl, const char*, bool)> fChecker;
 
-    static const int kMaxEntries = 128;
-
     struct KeyHash {
         uint32_t operator()(const ParagraphCacheKey& key) const;
     };
 
-    SkLRUCache<ParagraphCacheKey, std::unique_ptr<Entry>, KeyHash> fLRUCacheMap;
+    // Called by the LRU map for every entry it removes so the byte count stays in sync.
+    struct PurgeCB {
+        void operator()(void* context,
+                        const ParagraphCacheKey& key,
+                        const std::unique_ptr<Entry>* entry) const;
+    };
+
+    SkLRUCache<ParagraphCacheKey, std::unique_ptr<Entry>, KeyHash, PurgeCB> fLRUCacheMap;
     bool fCacheIsOn;
     ParagraphCacheValue* fLastCachedValue;
 
-#ifdef PARAGRAPH_CACHE_STATS
-    int fTotalRequests;
-    int fCacheMisses;
-    int fHashMisses; // cache hit but hash table missed
-#endif
+    size_t fTotalBytesUsed;
+    size_t fByteLimit;
+    Stats fStats;
 };
 
 }  // namespace textlayout
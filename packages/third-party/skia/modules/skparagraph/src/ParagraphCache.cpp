@@ -1,6 +1,8 @@
 // Copyright 2019 Google LLC.
+#include <limits>
 #include <memory>
 
+#include "include/core/SkTraceMemoryDump.h"
 #include "modules/skparagraph/include/FontArguments.h"
 #include "modules/skparagraph/include/ParagraphCache.h"
 #include "modules/skparagraph/src/ParagraphImpl.h"
@@ -26,6 +28,18 @@ namespace {
         return x == y || (x != x && y != y);
     }
 
+    template <typename T, bool MEM_MOVE>
+    size_t arrayBytes(const TArray<T, MEM_MOVE>& array) {
+        return sizeof(T) * array.capacity();
+    }
+
+    template <typename T>
+    size_t arrayBytes(const std::vector<T>& array) {
+        return sizeof(T) * array.capacity();
+    }
+
+    constexpr char kParagraphCacheDumpName[] = "skia/sk_paragraph_cache";
+
 }  // namespace
 
 class ParagraphCacheKey {
@@ -35,7 +49,9 @@ public:
         , fPlaceholders(paragraph->fPlaceholders)
         , fTextStyles(paragraph->fTextStyles)
         , fParagraphStyle(paragraph->paragraphStyle()) {
-        fHash = computeHash();
+        // The hash only depends on the paragraph input, so compute it once per paragraph
+        fHash = paragraph->fCacheKeyHash.has_value() ? *paragraph->fCacheKeyHash
+                                                     : this->computeHash();
     }
 
     ParagraphCacheKey(const ParagraphCacheKey& other) = default;
@@ -55,6 +71,10 @@ public:
 
     const SkString& text() const { return fText; }
 
+    size_t memoryUsage() const {
+        return fText.size() + arrayBytes(fPlaceholders) + arrayBytes(fTextStyles);
+    }
+
 private:
     static uint32_t mix(uint32_t hash, uint32_t data);
     uint32_t computeHash() const;
@@ -80,6 +100,24 @@ public:
         , fHasWhitespacesInside(paragraph->fHasWhitespacesInside)
         , fTrailingSpaces(paragraph->fTrailingSpaces) { }
 
+    // An estimate of the heap memory owned by this value; the byte budget is based on it.
+    size_t memoryUsage() const {
+        size_t bytes = sizeof(*this) + fKey.memoryUsage();
+        bytes += arrayBytes(fRuns);
+        for (auto& run : fRuns) {
+            // Glyph data is shared between copies of a run, but the cache keeps it alive
+            bytes += arrayBytes(run.fGlyphs) + arrayBytes(run.fPositions) +
+                     arrayBytes(run.fOffsets) + arrayBytes(run.fClusterIndexes) +
+                     arrayBytes(run.fJustificationShifts);
+        }
+        bytes += arrayBytes(fClusters);
+        bytes += arrayBytes(fClustersIndexFromCodeUnit);
+        bytes += arrayBytes(fCodeUnitProperties);
+        bytes += arrayBytes(fWords);
+        bytes += arrayBytes(fBidiRegions);
+        return bytes;
+    }
+
     // Input == key
     ParagraphCacheKey fKey;
 
@@ -234,20 +272,30 @@ bool ParagraphCacheKey::operator==(const ParagraphCacheKey& other) const {
 
 struct ParagraphCache::Entry {
 
-    Entry(ParagraphCacheValue* value) : fValue(value) {}
+    Entry(ParagraphCacheValue* value) : fValue(value), fBytes(value->memoryUsage()) {}
     std::unique_ptr<ParagraphCacheValue> fValue;
+    size_t fBytes;
 };
 
+void ParagraphCache::PurgeCB::operator()(void* context,
+                                         const ParagraphCacheKey&,
+                                         const std::unique_ptr<Entry>* entry) const {
+    auto cache = static_cast<ParagraphCache*>(context);
+    SkASSERT(cache->fTotalBytesUsed >= (*entry)->fBytes);
+    cache->fTotalBytesUsed -= (*entry)->fBytes;
+    if (cache->fLastCachedValue == (*entry)->fValue.get()) {
+        cache->fLastCachedValue = nullptr;
+    }
+}
+
 ParagraphCache::ParagraphCache()
     : fChecker([](ParagraphImpl* impl, const char*, bool){ })
-    , fLRUCacheMap(kMaxEntries)
+    // The map is bounded by bytes (see purgeToLimit), not by the number of entries
+    , fLRUCacheMap(std::numeric_limits<int>::max(), this)
     , fCacheIsOn(true)
     , fLastCachedValue(nullptr)
-#ifdef PARAGRAPH_CACHE_STATS
-    , fTotalRequests(0)
-    , fCacheMisses(0)
-    , fHashMisses(0)
-#endif
+    , fTotalBytesUsed(0)
+    , fByteLimit(kDefaultByteLimit)
 { }
 
 ParagraphCache::~ParagraphCache() { }
@@ -273,12 +321,16 @@ void ParagraphCache::updateTo(ParagraphImpl* paragraph, const Entry* entry) {
 }
 
 void ParagraphCache::printStatistics() {
+    Stats stats = this->getStats();
     SkDebugf("--- Paragraph Cache ---\n");
-    SkDebugf("Total requests: %d\n", fTotalRequests);
-    SkDebugf("Cache misses: %d\n", fCacheMisses);
-    SkDebugf("Cache miss %%: %f\n", (fTotalRequests > 0) ? 100.f * fCacheMisses / fTotalRequests : 0.f);
-    int cacheHits = fTotalRequests - fCacheMisses;
-    SkDebugf("Hash miss %%: %f\n", (cacheHits > 0) ? 100.f * fHashMisses / cacheHits : 0.f);
+    SkDebugf("Total requests: %llu\n", (unsigned long long)stats.fRequests);
+    SkDebugf("Cache misses: %llu\n", (unsigned long long)stats.fMisses);
+    SkDebugf("Cache miss %%: %f\n",
+             (stats.fRequests > 0) ? 100.f * stats.fMisses / stats.fRequests : 0.f);
+    SkDebugf("Insertions: %llu\n", (unsigned long long)stats.fInsertions);
+    SkDebugf("Evictions: %llu\n", (unsigned long long)stats.fEvictions);
+    SkDebugf("Skipped: %llu\n", (unsigned long long)stats.fSkipped);
+    SkDebugf("Bytes used: %zu of %zu\n", this->getTotalBytesUsed(), this->getByteLimit());
     SkDebugf("---------------------\n");
 }
 
@@ -288,34 +340,77 @@ void ParagraphCache::abandon() {
 
 void ParagraphCache::reset() {
     SkAutoMutexExclusive lock(fParagraphMutex);
-#ifdef PARAGRAPH_CACHE_STATS
-    fTotalRequests = 0;
-    fCacheMisses = 0;
-    fHashMisses = 0;
-#endif
+    fStats = Stats();
     fLRUCacheMap.reset();
     fLastCachedValue = nullptr;
+    fTotalBytesUsed = 0;
+}
+
+size_t ParagraphCache::setByteLimit(size_t newLimit) {
+    SkAutoMutexExclusive lock(fParagraphMutex);
+    size_t prevLimit = fByteLimit;
+    fByteLimit = newLimit;
+    this->purgeToLimit(fByteLimit);
+    return prevLimit;
+}
+
+size_t ParagraphCache::getByteLimit() const {
+    SkAutoMutexExclusive lock(fParagraphMutex);
+    return fByteLimit;
+}
+
+size_t ParagraphCache::getTotalBytesUsed() const {
+    SkAutoMutexExclusive lock(fParagraphMutex);
+    return fTotalBytesUsed;
+}
+
+ParagraphCache::Stats ParagraphCache::getStats() const {
+    SkAutoMutexExclusive lock(fParagraphMutex);
+    return fStats;
+}
+
+void ParagraphCache::resetStats() {
+    SkAutoMutexExclusive lock(fParagraphMutex);
+    fStats = Stats();
+}
+
+void ParagraphCache::dumpMemoryStatistics(SkTraceMemoryDump* dump) const {
+    SkAutoMutexExclusive lock(fParagraphMutex);
+    dump->dumpNumericValue(kParagraphCacheDumpName, "size", "bytes", fTotalBytesUsed);
+    dump->dumpNumericValue(kParagraphCacheDumpName, "budget_size", "bytes", fByteLimit);
+    dump->dumpNumericValue(kParagraphCacheDumpName, "entry_count", "objects",
+                           fLRUCacheMap.count());
+    dump->dumpNumericValue(kParagraphCacheDumpName, "hit_count", "objects", fStats.fHits);
+    dump->dumpNumericValue(kParagraphCacheDumpName, "miss_count", "objects", fStats.fMisses);
+    dump->dumpNumericValue(kParagraphCacheDumpName, "eviction_count", "objects",
+                           fStats.fEvictions);
+    dump->setMemoryBacking(kParagraphCacheDumpName, "malloc", nullptr);
+}
+
+void ParagraphCache::purgeToLimit(size_t limit) {
+    while (fTotalBytesUsed > limit && fLRUCacheMap.count() > 0) {
+        fLRUCacheMap.removeLeastRecentlyUsed();
+        ++fStats.fEvictions;
+    }
 }
 
 bool ParagraphCache::findParagraph(ParagraphImpl* paragraph) {
     if (!fCacheIsOn) {
         return false;
     }
-#ifdef PARAGRAPH_CACHE_STATS
-    ++fTotalRequests;
-#endif
     SkAutoMutexExclusive lock(fParagraphMutex);
+    ++fStats.fRequests;
     ParagraphCacheKey key(paragraph);
+    paragraph->fCacheKeyHash = key.hash();
     std::unique_ptr<Entry>* entry = fLRUCacheMap.find(key);
 
     if (!entry) {
         // We have a cache miss
-#ifdef PARAGRAPH_CACHE_STATS
-        ++fCacheMisses;
-#endif
+        ++fStats.fMisses;
         fChecker(paragraph, "missingParagraph", true);
         return false;
     }
+    ++fStats.fHits;
     updateTo(paragraph, entry->get());
     fChecker(paragraph, "foundParagraph", true);
     return true;
@@ -325,21 +420,28 @@ bool ParagraphCache::updateParagraph(ParagraphImpl* paragraph) {
     if (!fCacheIsOn) {
         return false;
     }
-#ifdef PARAGRAPH_CACHE_STATS
-    ++fTotalRequests;
-#endif
     SkAutoMutexExclusive lock(fParagraphMutex);
 
     ParagraphCacheKey key(paragraph);
+    paragraph->fCacheKeyHash = key.hash();
     std::unique_ptr<Entry>* entry = fLRUCacheMap.find(key);
     if (!entry) {
-        // isTooMuchMemoryWasted(paragraph) not needed for now
         if (isPossiblyTextEditing(paragraph)) {
             // Skip this paragraph
+            ++fStats.fSkipped;
             return false;
         }
         ParagraphCacheValue* value = new ParagraphCacheValue(std::move(key), paragraph);
-        fLRUCacheMap.insert(value->fKey, std::make_unique<Entry>(value));
+        auto newEntry = std::make_unique<Entry>(value);
+        if (newEntry->fBytes > fByteLimit) {
+            // A single paragraph that does not fit would flush the whole cache
+            ++fStats.fSkipped;
+            return false;
+        }
+        this->purgeToLimit(fByteLimit - newEntry->fBytes);
+        fTotalBytesUsed += newEntry->fBytes;
+        fLRUCacheMap.insert(value->fKey, std::move(newEntry));
+        ++fStats.fInsertions;
         fChecker(paragraph, "addedParagraph", true);
         fLastCachedValue = value;
         return true;
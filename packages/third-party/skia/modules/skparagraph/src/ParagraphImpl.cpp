@@ -1090,6 +1090,7 @@ void ParagraphImpl::updateFontSize(size_t from, size_t to, SkScalar fontSize) {
   for (auto& textStyle : fTextStyles) {
     textStyle.fStyle.setFontSize(fontSize);
   }
+  fCacheKeyHash.reset();
 
   fState = std::min(fState, kIndexed);
   fOldWidth = 0;
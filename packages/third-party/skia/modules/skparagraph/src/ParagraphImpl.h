@@ -29,6 +29,7 @@
 #include "src/core/SkTHash.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -183,6 +184,7 @@ public:
         if (fState > kIndexed) {
             fState = kIndexed;
         }
+        fCacheKeyHash.reset();
     }
 
     int32_t unresolvedGlyphs() override;
@@ -267,6 +269,7 @@ private:
     skia_private::TArray<Block, true> fTextStyles; // TODO: take out only the font stuff
     skia_private::TArray<Placeholder, true> fPlaceholders;
     SkString fText;
+    std::optional<uint32_t> fCacheKeyHash;  // ParagraphCache key hash of the input above
 
     // Internal structures
     InternalState fState;
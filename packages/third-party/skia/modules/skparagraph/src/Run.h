@@ -173,6 +173,7 @@ private:
     friend class TextLine;
     friend class InternalLineMetrics;
     friend class ParagraphCache;
+    friend class ParagraphCacheValue;
     friend class OneLineShaper;
 
     ParagraphImpl* fOwner;
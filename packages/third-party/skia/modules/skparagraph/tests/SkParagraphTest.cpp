@@ -5485,6 +5485,65 @@ UNIX_ONLY_TEST(SkParagraph_CacheText, reporter) {
     test("text3", 2, false);
 }
 
+UNIX_ONLY_TEST(SkParagraph_CacheByteLimit, reporter) {
+    ParagraphCache cache;
+    cache.turnOn(true);
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+
+    ParagraphStyle paragraph_style;
+    paragraph_style.turnHintingOff();
+
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setColor(SK_ColorBLACK);
+
+    auto test = [&](const char* text) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(text, strlen(text));
+        builder.pop();
+        auto paragraph = builder.Build();
+
+        auto impl = static_cast<ParagraphImpl*>(paragraph.get());
+        if (!cache.findParagraph(impl)) {
+            cache.updateParagraph(impl);
+        }
+    };
+
+    test("text1");
+    test("text2");
+    test("text1");
+    REPORTER_ASSERT(reporter, cache.count() == 2);
+    ParagraphCache::Stats stats = cache.getStats();
+    REPORTER_ASSERT(reporter, stats.fRequests == 3);
+    REPORTER_ASSERT(reporter, stats.fHits == 1);
+    REPORTER_ASSERT(reporter, stats.fMisses == 2);
+    REPORTER_ASSERT(reporter, stats.fInsertions == 2);
+    REPORTER_ASSERT(reporter, stats.fEvictions == 0);
+
+    // Shrinking the budget evicts the least recently used paragraph ("text2")
+    size_t used = cache.getTotalBytesUsed();
+    REPORTER_ASSERT(reporter, used > 0);
+    REPORTER_ASSERT(reporter, cache.setByteLimit(used - 1) == ParagraphCache::kDefaultByteLimit);
+    REPORTER_ASSERT(reporter, cache.count() == 1);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() < used);
+    REPORTER_ASSERT(reporter, cache.getStats().fEvictions == 1);
+    test("text1");
+    REPORTER_ASSERT(reporter, cache.getStats().fHits == 2);
+
+    // Paragraphs larger than the whole budget are not cached
+    cache.setByteLimit(1);
+    REPORTER_ASSERT(reporter, cache.count() == 0);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+    test("text3");
+    REPORTER_ASSERT(reporter, cache.count() == 0);
+    REPORTER_ASSERT(reporter, cache.getStats().fSkipped == 1);
+
+    cache.resetStats();
+    REPORTER_ASSERT(reporter, cache.getStats().fRequests == 0);
+}
+
 UNIX_ONLY_TEST(SkParagraph_CacheFonts, reporter) {
     ParagraphCache cache;
     cache.turnOn(true);
@@ -18,10 +18,12 @@
 #include "include/private/base/SkMutex.h"
 #include "src/core/SkTHash.h"
 
+#include <cstddef>
 #include <memory>
 
 class SkAnimCodecPlayer;
 class SkCodec;
+class SkExecutor;
 class SkImage;
 
 namespace skresources {
@@ -108,6 +110,22 @@ public:
     static sk_sp<MultiFrameImageAsset> Make(std::unique_ptr<SkCodec>,
                                             ImageDecodeStrategy = ImageDecodeStrategy::kLazyDecode);
 
+    struct PlaybackOptions {
+        // When set, the frames following the last requested one are decoded ahead of time on
+        // this executor, which must outlive the asset.
+        SkExecutor* fExecutor = nullptr;
+        // How many frames to decode ahead.
+        int fPrefetchFrames = 2;
+        // Decoded frames are dropped, least recently used first, once they take more than this
+        // many bytes. Frames that later frames are decoded on top of are kept longest. Zero
+        // keeps every frame.
+        size_t fFrameCacheBytes = 0;
+    };
+    static sk_sp<MultiFrameImageAsset> Make(sk_sp<SkData>, ImageDecodeStrategy,
+                                            const PlaybackOptions&);
+    static sk_sp<MultiFrameImageAsset> Make(std::unique_ptr<SkCodec>, ImageDecodeStrategy,
+                                            const PlaybackOptions&);
+
     bool isMultiFrame() override;
 
     // Animation duration, in ms.
@@ -115,6 +133,10 @@ public:
 
     sk_sp<SkImage> getFrame(float t) override;
 
+    // Returns true if the frame for time t is already decoded, so getFrame(t) will not decode.
+    // Also starts decoding ahead from t, when there is an executor.
+    bool isFrameReady(float t);
+
 private:
     explicit MultiFrameImageAsset(std::unique_ptr<SkAnimCodecPlayer>, ImageDecodeStrategy);
 
@@ -21,7 +21,9 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -29,16 +31,28 @@
 #include <utility>
 #include <vector>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec)
+        : SkAnimCodecPlayer(std::move(codec), Options()) {}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, const Options& options)
+        : fCodec(std::move(codec)), fOptions(options) {
     fImageInfo = fCodec->getInfo();
+    fDimensions = SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())
+                          ? SkISize{fImageInfo.height(), fImageInfo.width()}
+                          : fImageInfo.dimensions();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
+    fLastUse.resize(fFrameInfos.size());
+    fIsRequired.resize(fFrameInfos.size());
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
     for (auto& f : fFrameInfos) {
         dur += f.fDuration;
         f.fDuration = dur;
+        if (f.fRequiredFrame != SkCodec::kNoFrame) {
+            fIsRequired[f.fRequiredFrame] = true;
+        }
     }
     fTotalDuration = dur;
 
@@ -48,28 +62,93 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
         fImages.clear();
         fImages.push_back(SkImages::DeferredFromGenerator(
                 SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        fDimensions = fImages.front() ? fImages.front()->dimensions() : SkISize::MakeEmpty();
+    } else if (fOptions.fExecutor && fOptions.fPrefetchFrames > 0) {
+        fPrefetchTasks = std::make_unique<SkTaskGroup>(*fOptions.fExecutor);
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    if (fPrefetchTasks) {
+        fPrefetchTasks->wait();
+    }
+}
 
-SkISize SkAnimCodecPlayer::dimensions() const {
-    if (!fCodec) {
-        auto image = fImages.front();
-        return image ? image->dimensions() : SkISize::MakeEmpty();
+sk_sp<SkImage> SkAnimCodecPlayer::findFrame(int index) const {
+    if (fImages[index]) {
+        fLastUse[index] = ++fUseCount;
     }
-    if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
-        return { fImageInfo.height(), fImageInfo.width() };
+    return fImages[index];
+}
+
+void SkAnimCodecPlayer::addFrame(int index, sk_sp<SkImage> image) {
+    SkASSERT(!fImages[index]);
+    fCachedBytes += image->imageInfo().computeMinByteSize();
+    fImages[index] = std::move(image);
+    fLastUse[index] = ++fUseCount;
+
+    if (!fOptions.fFrameCacheBytes) {
+        return;
+    }
+
+    // Drop the least recently used frames that nothing is decoded on top of first, then the
+    // least recently used of the rest. The frame just added, the current frame and the frames
+    // being decoded ahead of it stay.
+    const int count = SkToInt(fImages.size());
+    const int ahead = fPrefetchTasks ? fOptions.fPrefetchFrames : 0;
+    while (fCachedBytes > fOptions.fFrameCacheBytes) {
+        int victim = -1;
+        for (int i = 0; i < count; ++i) {
+            if (!fImages[i] || i == index || (i - fCurrIndex + count) % count <= ahead) {
+                continue;
+            }
+            if (victim < 0 || std::make_pair(fIsRequired[i], fLastUse[i]) <
+                              std::make_pair(fIsRequired[victim], fLastUse[victim])) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            break;
+        }
+        fCachedBytes -= fImages[victim]->imageInfo().computeMinByteSize();
+        fImages[victim].reset();
     }
-    return { fImageInfo.width(), fImageInfo.height() };
 }
 
-sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
-    SkASSERT((unsigned)index < fFrameInfos.size());
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index) {
+    // Walk back to the newest frame this one can be decoded on top of: either one that is cached,
+    // or one that needs nothing underneath. Then decode forward, caching each frame on the way.
+    std::vector<int> chain;
+    sk_sp<SkImage> image;
+    for (int i = index;;) {
+        chain.push_back(i);
+        const int requiredFrame = fFrameInfos[i].fRequiredFrame;
+        if (requiredFrame == SkCodec::kNoFrame) {
+            break;
+        }
+        {
+            SkAutoMutexExclusive lock(fCacheMutex);
+            image = this->findFrame(requiredFrame);
+        }
+        if (image) {
+            break;
+        }
+        i = requiredFrame;
+    }
 
-    if (fImages[index]) {
-        return fImages[index];
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        image = this->decodeFrameOnto(*it, image);
+        if (!image) {
+            return nullptr;
+        }
+        SkAutoMutexExclusive lock(fCacheMutex);
+        this->addFrame(*it, image);
     }
+    return image;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrameOnto(int index, const sk_sp<SkImage>& requiredImage) {
+    SkASSERT((unsigned)index < fFrameInfos.size());
 
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
@@ -90,9 +169,8 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     if (fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType && imageInfo.isOpaque()) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
-    const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
+    if (requiredImage) {
+        SkASSERT(fFrameInfos[index].fRequiredFrame != SkCodec::kNoFrame);
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
@@ -105,7 +183,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
             canvas->concat(*originMatrix.invert());
         }
         canvas->drawImage(requiredImage, 0, 0, SkSamplingOptions(), &paint);
-        opts.fPriorFrame = requiredFrame;
+        opts.fPriorFrame = fFrameInfos[index].fRequiredFrame;
     }
 
     if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
@@ -123,15 +201,90 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    return image;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        if (auto image = this->findFrame(index)) {
+            return image;
+        }
+    }
+
+    SkAutoMutexExclusive lock(fDecodeMutex);
+    {
+        // It may have been decoded ahead while we waited.
+        SkAutoMutexExclusive cacheLock(fCacheMutex);
+        if (auto image = this->findFrame(index)) {
+            return image;
+        }
+    }
+    return this->decodeFrame(index);
+}
+
+void SkAnimCodecPlayer::schedulePrefetch() {
+    if (!fPrefetchTasks) {
+        return;
+    }
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        if (fPrefetching) {
+            // The running task picks up the new current frame.
+            return;
+        }
+        fPrefetching = true;
+    }
+    fPrefetchTasks->add([this] { this->prefetch(); });
+}
+
+void SkAnimCodecPlayer::prefetch() {
+    const int count = SkToInt(fFrameInfos.size());
+    for (;;) {
+        int next = -1;
+        {
+            SkAutoMutexExclusive lock(fCacheMutex);
+            for (int ahead = 1; ahead <= fOptions.fPrefetchFrames && next < 0; ++ahead) {
+                const int index = (fCurrIndex + ahead) % count;
+                if (!fImages[index]) {
+                    next = index;
+                }
+            }
+            if (next < 0) {
+                fPrefetching = false;
+                return;
+            }
+        }
+
+        SkAutoMutexExclusive lock(fDecodeMutex);
+        bool cached;
+        {
+            SkAutoMutexExclusive cacheLock(fCacheMutex);
+            cached = fImages[next] != nullptr;
+        }
+        if (!cached && !this->decodeFrame(next)) {
+            // Leave the frame to getFrame(), which will report the error.
+            SkAutoMutexExclusive cacheLock(fCacheMutex);
+            fPrefetching = false;
+            return;
+        }
+    }
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
-    SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
+    int index;
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
+        if (!fTotalDuration) {
+            return fImages.front();
+        }
+        index = fCurrIndex;
+    }
 
-    return fTotalDuration > 0
-        ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+    auto frame = this->getFrameAt(index);
+    this->schedulePrefetch();
+    return frame;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
@@ -145,7 +298,20 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                   [](const SkCodec::FrameInfo& info, uint32_t msec) {
                                       return (uint32_t)info.fDuration <= msec;
                                   });
-    int prevIndex = fCurrIndex;
-    fCurrIndex = lower - fFrameInfos.begin();
-    return fCurrIndex != prevIndex;
+    int prevIndex;
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        prevIndex = fCurrIndex;
+        fCurrIndex = lower - fFrameInfos.begin();
+        if (fCurrIndex == prevIndex) {
+            return false;
+        }
+    }
+    this->schedulePrefetch();
+    return true;
+}
+
+bool SkAnimCodecPlayer::isFrameReady() const {
+    SkAutoMutexExclusive lock(fCacheMutex);
+    return !fTotalDuration || fImages[fCurrIndex] != nullptr;
 }
@@ -12,16 +12,35 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+class SkExecutor;
 class SkImage;
+class SkTaskGroup;
 
 class SkAnimCodecPlayer {
 public:
+    struct Options {
+        // When set, the frames after the current one are decoded ahead of time on this executor,
+        // which must outlive the player.
+        SkExecutor* fExecutor = nullptr;
+
+        // How many frames after the current one to decode ahead.
+        int fPrefetchFrames = 2;
+
+        // Decoded frames are dropped once they take more than this many bytes, recently used
+        // frames and frames that other frames are decoded on top of last. Zero keeps every frame.
+        size_t fFrameCacheBytes = 0;
+    };
+
     explicit SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, const Options&);
     ~SkAnimCodecPlayer();
 
     /**
@@ -34,7 +53,7 @@ public:
     /**
      *  Return the size of the image(s) that will be returned by getFrame().
      */
-    SkISize dimensions() const;
+    SkISize dimensions() const { return fDimensions; }
 
     /**
      *  Returns the total duration of the animation in milliseconds. Returns 0 for a single-frame
@@ -51,16 +70,49 @@ public:
      */
     bool seek(uint32_t msec);
 
+    /**
+     *  Returns true if the current frame is already decoded, so getFrame() will not decode.
+     *  With an executor, this becomes true as frames are decoded ahead in the background.
+     */
+    bool isFrameReady() const;
 
 private:
+    // Returns the frame if it is cached, marking it as recently used.
+    sk_sp<SkImage> findFrame(int index) const SK_REQUIRES(fCacheMutex);
+    void addFrame(int index, sk_sp<SkImage>) SK_REQUIRES(fCacheMutex);
+
+    // Decodes the frame, and any frames it is decoded on top of that are not cached.
+    sk_sp<SkImage> decodeFrame(int index) SK_REQUIRES(fDecodeMutex);
+    sk_sp<SkImage> decodeFrameOnto(int index, const sk_sp<SkImage>& requiredImage)
+            SK_REQUIRES(fDecodeMutex);
+
+    sk_sp<SkImage> getFrameAt(int index);
+
+    void schedulePrefetch();
+    void prefetch();
+
+    // Only used while holding fDecodeMutex, once constructed.
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
+    SkISize                         fDimensions;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
-    int                             fCurrIndex = 0;
+    // Whether some other frame is decoded on top of each frame.
+    std::vector<bool>               fIsRequired;
     uint32_t                        fTotalDuration;
+    const Options                   fOptions;
 
-    sk_sp<SkImage> getFrameAt(int index);
+    mutable SkMutex fDecodeMutex;
+    mutable SkMutex fCacheMutex;
+
+    std::vector<sk_sp<SkImage>>     fImages SK_GUARDED_BY(fCacheMutex);
+    // The use count of each frame when it was last used, for picking frames to drop.
+    mutable std::vector<uint64_t>   fLastUse SK_GUARDED_BY(fCacheMutex);
+    mutable uint64_t                fUseCount SK_GUARDED_BY(fCacheMutex) = 0;
+    size_t                          fCachedBytes SK_GUARDED_BY(fCacheMutex) = 0;
+    int                             fCurrIndex SK_GUARDED_BY(fCacheMutex) = 0;
+    bool                            fPrefetching SK_GUARDED_BY(fCacheMutex) = false;
+
+    std::unique_ptr<SkTaskGroup>    fPrefetchTasks;
 };
 
 #endif
@@ -122,6 +122,28 @@ sk_sp<MultiFrameImageAsset> MultiFrameImageAsset::Make(std::unique_ptr<SkCodec>
             std::make_unique<SkAnimCodecPlayer>(std::move(codec)), strat));
 }
 
+sk_sp<MultiFrameImageAsset> MultiFrameImageAsset::Make(sk_sp<SkData> data,
+                                                       ImageDecodeStrategy strat,
+                                                       const PlaybackOptions& options) {
+    if (auto codec = SkCodec::MakeFromData(std::move(data))) {
+        return Make(std::move(codec), strat, options);
+    }
+
+    return nullptr;
+}
+
+sk_sp<MultiFrameImageAsset> MultiFrameImageAsset::Make(std::unique_ptr<SkCodec> codec,
+                                                       ImageDecodeStrategy strat,
+                                                       const PlaybackOptions& options) {
+    SkASSERT(codec);
+    SkAnimCodecPlayer::Options playerOptions;
+    playerOptions.fExecutor        = options.fExecutor;
+    playerOptions.fPrefetchFrames  = options.fPrefetchFrames;
+    playerOptions.fFrameCacheBytes = options.fFrameCacheBytes;
+    return sk_sp<MultiFrameImageAsset>(new MultiFrameImageAsset(
+            std::make_unique<SkAnimCodecPlayer>(std::move(codec), playerOptions), strat));
+}
+
 MultiFrameImageAsset::MultiFrameImageAsset(std::unique_ptr<SkAnimCodecPlayer> player,
                                            ImageDecodeStrategy strat)
         : fPlayer(std::move(player)), fStrategy(strat) {
@@ -182,6 +204,11 @@ sk_sp<SkImage> MultiFrameImageAsset::getFrame(float t) {
     return fCachedFrame;
 }
 
+bool MultiFrameImageAsset::isFrameReady(float t) {
+    fPlayer->seek(static_cast<uint32_t>(t * 1000));
+    return fPlayer->isFrameReady();
+}
+
 sk_sp<FileResourceProvider> FileResourceProvider::Make(SkString base_dir, ImageDecodeStrategy strat) {
     return sk_isdir(base_dir.c_str()) ? sk_sp<FileResourceProvider>(new FileResourceProvider(
                                                 std::move(base_dir), strat))
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkUnicode_cached_DEFINED
+#define SkUnicode_cached_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "modules/skunicode/include/SkUnicode.h"
+
+namespace SkUnicodes::Cached {
+
+struct Options {
+    // Number of results kept for each memoized query, in least recently used order.
+    int fEntryLimit = 1024;
+    // Analyze text made only of ASCII letters, digits, spaces and line feeds with a
+    // table-driven scanner instead of calling the wrapped SkUnicode.
+    bool fAsciiFastPath = true;
+};
+
+/**
+ *  Returns an SkUnicode that forwards to `unicode`, but memoizes the results of
+ *  computeCodeUnitFlags (UTF-8), getWords and getBidiRegions by text and locale
+ *  (or direction). Identical labels are therefore analyzed only once.
+ */
+SKUNICODE_API sk_sp<SkUnicode> Make(sk_sp<SkUnicode> unicode, const Options& options = Options());
+
+}  // namespace SkUnicodes::Cached
+
+#endif  // SkUnicode_cached_DEFINED
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "modules/skunicode/include/SkUnicode_cached.h"
+
+#include "include/core/SkString.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkTArray.h"
+#include "modules/skunicode/include/SkUnicode.h"
+#include "src/base/SkBitmaskEnum.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkLRUCache.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace skia_private;
+
+namespace {
+
+// The ASCII fast path only accepts characters whose line, word and grapheme break
+// behavior does not depend on context beyond the neighboring character:
+//   - letters and digits (UAX #14 AL/NU, UAX #29 ALetter/Numeric) never break between each other
+//   - spaces (SP, WSegSpace) stick together and allow a line break after them
+//   - line feeds (LF) force a break after them and are their own word
+// Everything else (punctuation, tabs, CR, non-ASCII) goes through the wrapped SkUnicode.
+enum AsciiClass : uint8_t {
+    kOther = 0,
+    kAlnum,
+    kSpace,
+    kLineFeed,
+};
+
+struct AsciiClassTable {
+    constexpr AsciiClassTable() : fClass() {
+        for (int c = '0'; c <= '9'; ++c) { fClass[c] = kAlnum; }
+        for (int c = 'A'; c <= 'Z'; ++c) { fClass[c] = kAlnum; }
+        for (int c = 'a'; c <= 'z'; ++c) { fClass[c] = kAlnum; }
+        fClass[' '] = kSpace;
+        fClass['\n'] = kLineFeed;
+    }
+    uint8_t operator[](char c) const { return fClass[(uint8_t)c]; }
+
+    uint8_t fClass[256];
+};
+constexpr AsciiClassTable kAsciiClasses;
+
+bool is_simple_ascii(const char utf8[], int utf8Units) {
+    int i = 0;
+    for (; i + 16 <= utf8Units; i += 16) {
+        auto c = skvx::byte16::Load(utf8 + i);
+        auto lower = c | 0x20;  // folds 'A'..'Z' onto 'a'..'z' without creating new matches
+        auto accepted = ((lower >= 'a') & (lower <= 'z')) |
+                        ((c >= '0') & (c <= '9')) |
+                        (c == ' ') | (c == '\n');
+        if (!skvx::all(accepted)) {
+            return false;
+        }
+    }
+    for (; i < utf8Units; ++i) {
+        if (kAsciiClasses[utf8[i]] == kOther) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Matches what ICU reports for the simple ASCII subset: every code unit starts a grapheme,
+// soft line breaks at the text ends and after spaces (but not before a line feed), and
+// hard line breaks after line feeds.
+void ascii_code_unit_flags(const char utf8[], int utf8Units,
+                           TArray<SkUnicode::CodeUnitFlags, true>* results) {
+    results->clear();
+    results->push_back_n(utf8Units + 1, SkUnicode::kGraphemeStart);
+    (*results)[0] |= SkUnicode::kSoftLineBreakBefore;
+    (*results)[utf8Units] |= SkUnicode::kSoftLineBreakBefore;
+
+    uint8_t prev = kOther;
+    for (int i = 0; i < utf8Units; ++i) {
+        const uint8_t cls = kAsciiClasses[utf8[i]];
+        switch (cls) {
+            case kSpace:
+                (*results)[i] |= SkUnicode::kPartOfIntraWordBreak |
+                                 SkUnicode::kPartOfWhiteSpaceBreak;
+                break;
+            case kLineFeed:
+                (*results)[i] |= SkUnicode::kPartOfIntraWordBreak |
+                                 SkUnicode::kPartOfWhiteSpaceBreak |
+                                 SkUnicode::kControl;
+                (*results)[i + 1] |= SkUnicode::kSoftLineBreakBefore |
+                                     SkUnicode::kHardLineBreakBefore;
+                break;
+            default:
+                if (prev == kSpace) {
+                    (*results)[i] |= SkUnicode::kSoftLineBreakBefore;
+                }
+                break;
+        }
+        prev = cls;
+    }
+}
+
+// Word boundaries fall between runs of letters/digits and runs of spaces, and around line feeds.
+// ASCII code units and UTF-16 code units coincide, so these are also the UTF-16 positions.
+void ascii_words(const char utf8[], int utf8Units, std::vector<SkUnicode::Position>* results) {
+    results->emplace_back(0);
+    for (int i = 1; i < utf8Units; ++i) {
+        const uint8_t prev = kAsciiClasses[utf8[i - 1]];
+        const uint8_t cls = kAsciiClasses[utf8[i]];
+        if (prev != cls || cls == kLineFeed) {
+            results->emplace_back(i);
+        }
+    }
+    results->emplace_back(utf8Units);
+}
+
+class CacheKey {
+public:
+    CacheKey(uint32_t option, const char* locale, const char utf8[], int utf8Units)
+            : fOption(option)
+            , fLocale(locale ? locale : "")
+            , fText(utf8, utf8Units) {
+        fHash = SkChecksum::Hash32(fText.c_str(), fText.size(), fOption);
+        fHash = SkChecksum::Hash32(fLocale.c_str(), fLocale.size(), fHash);
+    }
+
+    bool operator==(const CacheKey& that) const {
+        return fHash == that.fHash &&
+               fOption == that.fOption &&
+               fText == that.fText &&
+               fLocale == that.fLocale;
+    }
+
+    struct Hash {
+        uint32_t operator()(const CacheKey& key) const { return key.fHash; }
+    };
+
+private:
+    uint32_t fOption;
+    SkString fLocale;
+    SkString fText;
+    uint32_t fHash;
+};
+
+class SkUnicode_cached : public SkUnicode {
+public:
+    SkUnicode_cached(sk_sp<SkUnicode> unicode, const SkUnicodes::Cached::Options& options)
+            : fUnicode(std::move(unicode))
+            , fAsciiFastPath(options.fAsciiFastPath)
+            , fCodeUnitFlags(options.fEntryLimit)
+            , fWords(options.fEntryLimit)
+            , fBidiRegions(options.fEntryLimit) {}
+
+    ~SkUnicode_cached() override = default;
+
+    SkString toUpper(const SkString& str) override { return fUnicode->toUpper(str); }
+    SkString toUpper(const SkString& str, const char* locale) override {
+        return fUnicode->toUpper(str, locale);
+    }
+
+    bool isControl(SkUnichar utf8) override { return fUnicode->isControl(utf8); }
+    bool isWhitespace(SkUnichar utf8) override { return fUnicode->isWhitespace(utf8); }
+    bool isSpace(SkUnichar utf8) override { return fUnicode->isSpace(utf8); }
+    bool isTabulation(SkUnichar utf8) override { return fUnicode->isTabulation(utf8); }
+    bool isHardBreak(SkUnichar utf8) override { return fUnicode->isHardBreak(utf8); }
+    bool isEmoji(SkUnichar utf8) override { return fUnicode->isEmoji(utf8); }
+    bool isEmojiComponent(SkUnichar utf8) override { return fUnicode->isEmojiComponent(utf8); }
+    bool isEmojiModifierBase(SkUnichar utf8) override {
+        return fUnicode->isEmojiModifierBase(utf8);
+    }
+    bool isEmojiModifier(SkUnichar utf8) override { return fUnicode->isEmojiModifier(utf8); }
+    bool isRegionalIndicator(SkUnichar utf8) override {
+        return fUnicode->isRegionalIndicator(utf8);
+    }
+    bool isIdeographic(SkUnichar utf8) override { return fUnicode->isIdeographic(utf8); }
+
+    std::unique_ptr<SkBidiIterator> makeBidiIterator(const uint16_t text[], int count,
+                                                     SkBidiIterator::Direction dir) override {
+        return fUnicode->makeBidiIterator(text, count, dir);
+    }
+    std::unique_ptr<SkBidiIterator> makeBidiIterator(const char text[], int count,
+                                                     SkBidiIterator::Direction dir) override {
+        return fUnicode->makeBidiIterator(text, count, dir);
+    }
+    std::unique_ptr<SkBreakIterator> makeBreakIterator(const char locale[],
+                                                       BreakType breakType) override {
+        return fUnicode->makeBreakIterator(locale, breakType);
+    }
+    std::unique_ptr<SkBreakIterator> makeBreakIterator(BreakType breakType) override {
+        return fUnicode->makeBreakIterator(breakType);
+    }
+
+    bool getBidiRegions(const char utf8[],
+                        int utf8Units,
+                        TextDirection dir,
+                        std::vector<BidiRegion>* results) override {
+        // Simple ASCII text has no strong right-to-left characters, so a left-to-right
+        // paragraph is a single level 0 region.
+        if (fAsciiFastPath && dir == TextDirection::kLTR && utf8Units > 0 &&
+            is_simple_ascii(utf8, utf8Units)) {
+            results->emplace_back(0, utf8Units, 0);
+            return true;
+        }
+
+        CacheKey key((uint32_t)dir, nullptr, utf8, utf8Units);
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (auto found = fBidiRegions.find(key)) {
+                results->insert(results->end(), found->begin(), found->end());
+                return true;
+            }
+        }
+
+        std::vector<BidiRegion> regions;
+        if (!fUnicode->getBidiRegions(utf8, utf8Units, dir, &regions)) {
+            return false;
+        }
+        results->insert(results->end(), regions.begin(), regions.end());
+
+        SkAutoMutexExclusive lock(fMutex);
+        fBidiRegions.insert_or_update(std::move(key), std::move(regions));
+        return true;
+    }
+
+    bool getWords(const char utf8[], int utf8Units, const char* locale,
+                  std::vector<Position>* results) override {
+        if (fAsciiFastPath && utf8Units > 0 && is_simple_ascii(utf8, utf8Units)) {
+            ascii_words(utf8, utf8Units, results);
+            return true;
+        }
+
+        CacheKey key(0, locale, utf8, utf8Units);
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (auto found = fWords.find(key)) {
+                results->insert(results->end(), found->begin(), found->end());
+                return true;
+            }
+        }
+
+        std::vector<Position> words;
+        if (!fUnicode->getWords(utf8, utf8Units, locale, &words)) {
+            return false;
+        }
+        results->insert(results->end(), words.begin(), words.end());
+
+        SkAutoMutexExclusive lock(fMutex);
+        fWords.insert_or_update(std::move(key), std::move(words));
+        return true;
+    }
+
+    bool getUtf8Words(const char utf8[],
+                      int utf8Units,
+                      const char* locale,
+                      std::vector<Position>* results) override {
+        return fUnicode->getUtf8Words(utf8, utf8Units, locale, results);
+    }
+
+    bool getSentences(const char utf8[],
+                      int utf8Units,
+                      const char* locale,
+                      std::vector<Position>* results) override {
+        return fUnicode->getSentences(utf8, utf8Units, locale, results);
+    }
+
+    bool computeCodeUnitFlags(char utf8[], int utf8Units, bool replaceTabs,
+                              TArray<SkUnicode::CodeUnitFlags, true>* results) override {
+        if (fAsciiFastPath && utf8Units > 0 && is_simple_ascii(utf8, utf8Units)) {
+            ascii_code_unit_flags(utf8, utf8Units, results);
+            return true;
+        }
+
+        // The key must be made before the wrapped SkUnicode replaces tabs in the text
+        CacheKey key(replaceTabs, nullptr, utf8, utf8Units);
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (auto found = fCodeUnitFlags.find(key)) {
+                *results = *found;
+                if (replaceTabs) {
+                    for (int i = 0; i < utf8Units; ++i) {
+                        if (hasTabulationFlag((*results)[i])) {
+                            utf8[i] = ' ';
+                        }
+                    }
+                }
+                return true;
+            }
+        }
+
+        if (!fUnicode->computeCodeUnitFlags(utf8, utf8Units, replaceTabs, results)) {
+            return false;
+        }
+
+        SkAutoMutexExclusive lock(fMutex);
+        fCodeUnitFlags.insert_or_update(std::move(key), *results);
+        return true;
+    }
+
+    bool computeCodeUnitFlags(char16_t utf16[], int utf16Units, bool replaceTabs,
+                              TArray<SkUnicode::CodeUnitFlags, true>* results) override {
+        return fUnicode->computeCodeUnitFlags(utf16, utf16Units, replaceTabs, results);
+    }
+
+    void reorderVisual(const BidiLevel runLevels[],
+                       int levelsCount,
+                       int32_t logicalFromVisual[]) override {
+        fUnicode->reorderVisual(runLevels, levelsCount, logicalFromVisual);
+    }
+
+private:
+    const sk_sp<SkUnicode> fUnicode;
+    const bool fAsciiFastPath;
+
+    SkMutex fMutex;
+    SkLRUCache<CacheKey, TArray<CodeUnitFlags, true>, CacheKey::Hash> fCodeUnitFlags;
+    SkLRUCache<CacheKey, std::vector<Position>, CacheKey::Hash> fWords;
+    SkLRUCache<CacheKey, std::vector<BidiRegion>, CacheKey::Hash> fBidiRegions;
+};
+
+}  // namespace
+
+namespace SkUnicodes::Cached {
+sk_sp<SkUnicode> Make(sk_sp<SkUnicode> unicode, const Options& options) {
+    if (!unicode) {
+        return nullptr;
+    }
+    return sk_make_sp<SkUnicode_cached>(std::move(unicode), options);
+}
+}  // namespace SkUnicodes::Cached
@@ -13,6 +13,7 @@
 #include "tests/Test.h"
 
 #include "modules/skunicode/include/SkUnicode.h"
+#include "modules/skunicode/include/SkUnicode_cached.h"
 
 #if defined(SK_UNICODE_ICU_IMPLEMENTATION)
 #include "modules/skunicode/include/SkUnicode_icu.h"
@@ -27,6 +28,8 @@
 #include "modules/skunicode/include/SkUnicode_client.h"
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #ifdef SK_UNICODE_ICU_IMPLEMENTATION
@@ -366,3 +369,77 @@ UNIX_ONLY_TEST(SkUnicode_ICU4X_Ideographic, reporter) {
     SkUnicode_Ideographic(icu.get(), reporter);
 }
 #endif
+
+#if defined(SK_UNICODE_ICU_IMPLEMENTATION)
+UNIX_ONLY_TEST(SkUnicode_Cached_MatchesICU, reporter) {
+    auto icu = SkUnicodes::ICU::Make();
+    if (!icu) {
+        REPORTER_ASSERT(reporter, icu);
+        return;
+    }
+
+    SkUnicodes::Cached::Options noFastPath;
+    noFastPath.fAsciiFastPath = false;
+    sk_sp<SkUnicode> cachedUnicodes[] = {
+        SkUnicodes::Cached::Make(icu),              // ASCII fast path + memoization
+        SkUnicodes::Cached::Make(icu, noFastPath),  // memoization only
+    };
+
+    const char* texts[] = {
+        "Hello world",
+        "  leading and trailing spaces  ",
+        "line one\nline two\n\n 3 4\n",
+        "0123456789 abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+        "punctuation, (brackets) and \"quotes\" - 3.1415926",
+        "tabs\tand\ttabs",
+        "\xd8\xa7\xd9\x84\xd8\xb9\xd8\xb1\xd8\xa8\xd9\x8a\xd8\xa9 mixed",
+        "\xe4\xb8\xad\xe6\x96\x87 text",
+    };
+
+    for (auto& cached : cachedUnicodes) {
+        // Every text is analyzed twice so that the second pass is served from the cache
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const char* text : texts) {
+                SkString expectedText(text);
+                SkString actualText(text);
+                TArray<SkUnicode::CodeUnitFlags, true> expectedFlags, actualFlags;
+                REPORTER_ASSERT(reporter, icu->computeCodeUnitFlags(
+                        expectedText.data(), expectedText.size(), true, &expectedFlags));
+                REPORTER_ASSERT(reporter, cached->computeCodeUnitFlags(
+                        actualText.data(), actualText.size(), true, &actualFlags));
+                REPORTER_ASSERT(reporter, expectedFlags.size() == actualFlags.size(), "%s", text);
+                for (int i = 0; i < std::min(expectedFlags.size(), actualFlags.size()); ++i) {
+                    REPORTER_ASSERT(reporter, expectedFlags[i] == actualFlags[i],
+                                    "'%s' [%d]: %x != %x", text, i,
+                                    expectedFlags[i], actualFlags[i]);
+                }
+                // Tabs must be replaced on cache hits as well
+                REPORTER_ASSERT(reporter, expectedText == actualText, "%s", text);
+
+                std::vector<SkUnicode::Position> expectedWords, actualWords;
+                REPORTER_ASSERT(reporter,
+                                icu->getWords(text, strlen(text), "en", &expectedWords));
+                REPORTER_ASSERT(reporter,
+                                cached->getWords(text, strlen(text), "en", &actualWords));
+                REPORTER_ASSERT(reporter, expectedWords == actualWords, "%s", text);
+
+                for (auto dir : {SkUnicode::TextDirection::kLTR, SkUnicode::TextDirection::kRTL}) {
+                    std::vector<SkUnicode::BidiRegion> expectedRegions, actualRegions;
+                    REPORTER_ASSERT(reporter, icu->getBidiRegions(
+                            text, strlen(text), dir, &expectedRegions));
+                    REPORTER_ASSERT(reporter, cached->getBidiRegions(
+                            text, strlen(text), dir, &actualRegions));
+                    REPORTER_ASSERT(reporter, expectedRegions.size() == actualRegions.size());
+                    for (size_t i = 0;
+                         i < std::min(expectedRegions.size(), actualRegions.size()); ++i) {
+                        REPORTER_ASSERT(reporter,
+                                        expectedRegions[i].start == actualRegions[i].start &&
+                                        expectedRegions[i].end == actualRegions[i].end &&
+                                        expectedRegions[i].level == actualRegions[i].level);
+                    }
+                }
+            }
+        }
+    }
+}
+#endif
@@ -506,8 +506,11 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     }
 
     // FIXME: Support subsets somehow? Note that this works for SkWebpCodec
-    // because it supports arbitrary scaling/subset combinations.
-    if (!this->dimensionsSupported(info.dimensions())) {
+    // because it supports arbitrary scaling/subset combinations. A subset that
+    // is not scaled has already been checked by onGetValidSubset().
+    const bool unscaledSubset =
+            options->fSubset && info.dimensions() == options->fSubset->size();
+    if (!unscaledSubset && !this->dimensionsSupported(info.dimensions())) {
         return kInvalidScale;
     }
 
@@ -108,6 +108,24 @@ public:
                                   bool forColorTable,
                                   skcms_PixelFormat* outFormat);
 
+    // What SkCodec::applyColorXform() passes to skcms besides the pixels. The source is always
+    // unpremultiplied; its format is left to the caller, which may read the encoded pixels in a
+    // different layout than the codec's own transform does.
+    struct ColorXform {
+        const skcms_ICCProfile* fSrcProfile;
+        skcms_PixelFormat       fDstFormat;
+        skcms_AlphaFormat       fDstAlphaFormat;
+        const skcms_ICCProfile* fDstProfile;
+    };
+
+    static ColorXform GetColorXform(const SkCodec* codec) {
+        SkASSERT(codec && codec->colorXform());
+        return {codec->fEncodedInfo.profile(),
+                codec->fDstXformFormat,
+                codec->fDstXformAlphaFormat,
+                codec->fDstProfile};
+    }
+
     // FIXME: Consider sharing with dm, nanbench, and tools.
     static float GetScaleFromSampleSize(int sampleSize) { return 1.0f / ((float)sampleSize); }
 
@@ -12,9 +12,11 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/core/SkYUVAInfo.h"
@@ -24,19 +26,25 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegDecoderMgr.h"
+#include "src/codec/SkJpegEntropyIndex.h"
 #include "src/codec/SkJpegMetadataDecoderImpl.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegSegmentScan.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 using namespace skia_private;
 
@@ -490,8 +498,16 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
                                          const Options& options,
                                          int* rowsDecoded) {
     if (options.fSubset) {
-        // Subsets are not supported.
-        return kUnimplemented;
+        // Subsets are only supported with an entropy index.
+        if (!fEntropyIndex) {
+            return kUnimplemented;
+        }
+        return this->decodeIndexedSubset(dstInfo, dst, dstRowBytes, options, rowsDecoded);
+    }
+
+    if (options.fExecutor &&
+        this->decodeRestartIntervalsInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
     }
 
     // Get a pointer to the decompress info since we will use it quite frequently
@@ -570,6 +586,406 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    if (options.fSubset) {
+        // Callers fall back to scanline decoding, which can crop.
+        return kUnimplemented;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    // A stream with a memory base already holds all of its data, so there is nothing to wait for.
+    if (!this->stream()->getMemoryBase()) {
+        fDecoderMgr->setSuspending();
+    }
+
+    // jpeg_start_decompress() may suspend, so it is left to onIncrementalDecode(). The output
+    // dimensions are all that the swizzler and storage need.
+    dinfo->buffered_image = dinfo->progressive_mode;
+    jpeg_calc_output_dimensions(dinfo);
+    SkASSERT(1 == dinfo->rec_outbuf_height);
+
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().colorProfile(),
+                                            this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+
+    if (!this->allocateStorage(dstInfo)) {
+        return kInternalError;
+    }
+
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fStartedDecompress = false;
+    fInOutputPass = false;
+    fLastCompletedScan = 0;
+    fLastOutputScan = 0;
+    fIncrementalRowsDecoded = 0;
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const SkImageInfo& dstInfo = this->dstInfo();
+    const int height = dstInfo.height();
+
+    // SkSampledCodec may have set the swizzler to sample rows after startIncrementalDecode().
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int sampledHeight = SkCodecPriv::GetSampledDimension(height, sampleY);
+    auto rowsOutput = [&](int scanline) {
+        const int startY = SkCodecPriv::GetStartCoord(sampleY);
+        return scanline > startY ? std::min((scanline - startY - 1) / sampleY + 1, sampledHeight)
+                                 : 0;
+    };
+    auto reportRows = [&]() {
+        fIncrementalRowsDecoded =
+                std::max(fIncrementalRowsDecoded, rowsOutput(dinfo->output_scanline));
+        if (rowsDecoded) {
+            *rowsDecoded = fIncrementalRowsDecoded;
+        }
+    };
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        reportRows();
+        return fDecoderMgr->returnFailure("setjmp", kErrorInInput);
+    }
+
+    // Reads the rest of the rows of the current output pass. Returns false if libjpeg suspends
+    // first. Rows that the sampler leaves out are skipped, or read into the swizzler's source
+    // row.
+    auto readRemainingRows = [&](Result* result) {
+        *result = kSuccess;
+        while (dinfo->output_scanline < (JDIMENSION)height) {
+            const int y = dinfo->output_scanline;
+            int rows = 0;
+            if (sampleY == 1) {
+                *result = this->readRows(dstInfo,
+                                         SkTAddOffset<void>(fIncrementalDst,
+                                                            y * fIncrementalRowBytes),
+                                         fIncrementalRowBytes, height - y, this->options(),
+                                         &rows);
+            } else if (SkCodecPriv::IsCoordNecessary(y, sampleY, sampledHeight)) {
+                const int dstY = SkCodecPriv::GetDstCoord(y, sampleY);
+                *result = this->readRows(dstInfo,
+                                         SkTAddOffset<void>(fIncrementalDst,
+                                                            dstY * fIncrementalRowBytes),
+                                         fIncrementalRowBytes, 1, this->options(), &rows);
+            } else if (!dinfo->buffered_image && this->stream()->getMemoryBase()) {
+                // Skipping is cheaper than decoding, but cannot suspend.
+                int skip = 1;
+                while (y + skip < height &&
+                       !SkCodecPriv::IsCoordNecessary(y + skip, sampleY, sampledHeight)) {
+                    skip++;
+                }
+                rows = jpeg_skip_scanlines(dinfo, skip);
+            } else {
+                JSAMPLE* skipped = fSwizzleSrcRow;
+                rows = jpeg_read_scanlines(dinfo, &skipped, 1);
+            }
+            if (*result != kSuccess || rows == 0) {
+                break;
+            }
+        }
+        return dinfo->output_scanline == (JDIMENSION)height;
+    };
+
+    Result result = kSuccess;
+    for (;;) {
+        if (!fStartedDecompress) {
+            fStartedDecompress = jpeg_start_decompress(dinfo);
+        }
+
+        if (fStartedDecompress && !dinfo->buffered_image) {
+            if (readRemainingRows(&result)) {
+                return kSuccess;
+            }
+        } else if (fStartedDecompress) {
+            // Output each newly completed scan over the previous one, until the input suspends.
+            for (;;) {
+                if (!fInOutputPass) {
+                    // Take in everything available, so that the pass shows the latest scan.
+                    while (!jpeg_input_complete(dinfo)) {
+                        // Call the progress monitor hook if present, to prevent decoder from
+                        // hanging.
+                        if (dinfo->progress) {
+                            dinfo->progress->progress_monitor((j_common_ptr)dinfo);
+                        }
+                        const int res = jpeg_consume_input(dinfo);
+                        if (res == JPEG_SUSPENDED) {
+                            break;
+                        }
+                        if (res == JPEG_SCAN_COMPLETED) {
+                            fLastCompletedScan = dinfo->input_scan_number;
+                        }
+                    }
+                    int scan = jpeg_input_complete(dinfo) ? dinfo->input_scan_number
+                                                          : fLastCompletedScan;
+                    if (scan == 0) {
+                        // Until the first scan is complete, show its rows as they arrive.
+                        scan = dinfo->input_scan_number;
+                    }
+                    if (scan <= fLastOutputScan) {
+                        if (jpeg_input_complete(dinfo)) {
+                            return kSuccess;
+                        }
+                        break;
+                    }
+                    if (!jpeg_start_output(dinfo, scan)) {
+                        break;
+                    }
+                    fInOutputPass = true;
+                }
+                if (!readRemainingRows(&result) || !jpeg_finish_output(dinfo)) {
+                    break;
+                }
+                fInOutputPass = false;
+                fLastOutputScan = dinfo->output_scan_number;
+            }
+        }
+
+        if (result != kSuccess) {
+            reportRows();
+            return fDecoderMgr->returnFailure("readRows", kErrorInInput);
+        }
+        reportRows();
+        if (!fDecoderMgr->readAvailableInput()) {
+            return kIncompleteInput;
+        }
+    }
+}
+
+// Bands are small enough to keep every thread busy, but large enough that decoding the restart
+// intervals on either side of each band, for the upsampler's context, costs little.
+static constexpr int kMaxRestartBands = 32;
+
+bool SkJpegCodec::decodeRestartIntervalsInParallel(const SkImageInfo& dstInfo, void* dst,
+                                                   size_t rowBytes, const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (!options.fExecutor || options.fSubset || dstInfo.dimensions() != this->dimensions() ||
+        dinfo->progressive_mode || dinfo->restart_interval == 0) {
+        return false;
+    }
+
+    // The bands are decoded from copies of the encoded data, so it must be in memory.
+    SkStream* stream = this->stream();
+    if (!stream->hasLength() || !stream->getMemoryBase()) {
+        return false;
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(stream->getMemoryBase());
+    const size_t length = stream->getLength();
+
+    // A band must be whole MCU rows, so an interval must be whole rows, or a row whole intervals.
+    const int width = dinfo->image_width;
+    const int height = dinfo->image_height;
+    const int mcuWidth = dinfo->num_components == 1 ? DCTSIZE : dinfo->max_h_samp_factor * DCTSIZE;
+    const int mcuHeight = dinfo->num_components == 1 ? DCTSIZE : dinfo->max_v_samp_factor * DCTSIZE;
+    const int mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+    const int mcuRows = (height + mcuHeight - 1) / mcuHeight;
+    const int mcusPerInterval = dinfo->restart_interval;
+    int intervalsPerUnit, rowsPerUnit;
+    if (mcusPerInterval % mcusPerRow == 0) {
+        intervalsPerUnit = 1;
+        rowsPerUnit = mcusPerInterval / mcusPerRow * mcuHeight;
+    } else if (mcusPerRow % mcusPerInterval == 0) {
+        intervalsPerUnit = mcusPerRow / mcusPerInterval;
+        rowsPerUnit = mcuHeight;
+    } else {
+        return false;
+    }
+    const int64_t intervalCount =
+            ((int64_t)mcusPerRow * mcuRows + mcusPerInterval - 1) / mcusPerInterval;
+    const int unitCount = (height + rowsPerUnit - 1) / rowsPerUnit;
+    if (unitCount < 2) {
+        return false;
+    }
+
+    // Find the frame header, the single scan and its restart markers.
+    SkJpegSegmentScanner scanner;
+    scanner.onBytes(data, length);
+    if (!scanner.isDone()) {
+        return false;
+    }
+    const SkJpegSegment* frame = nullptr;
+    const SkJpegSegment* scan = nullptr;
+    std::vector<size_t> restartOffsets;
+    size_t endOffset = 0;
+    for (const SkJpegSegment& segment : scanner.getSegments()) {
+        if (segment.marker == kJpegMarkerStartOfFrameBaseline ||
+            segment.marker == kJpegMarkerStartOfFrameExtended) {
+            if (frame) {
+                return false;
+            }
+            frame = &segment;
+        } else if (segment.marker == kJpegMarkerStartOfScan) {
+            if (scan) {
+                return false;
+            }
+            scan = &segment;
+        } else if (segment.marker >= kJpegMarkerRestart0 && segment.marker <= kJpegMarkerRestart7 &&
+                   scan) {
+            restartOffsets.push_back(segment.offset);
+        } else if (segment.marker == kJpegMarkerEndOfImage) {
+            endOffset = segment.offset;
+        } else if (scan) {
+            // Another scan, or a marker such as DefineNumberOfLines, follows the entropy-coded
+            // data.
+            return false;
+        }
+    }
+    // The frame header holds the precision, followed by the height and width.
+    constexpr size_t kHeightOffset = kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize + 1;
+    if (!frame || !scan || frame->offset > scan->offset ||
+        frame->parameterLength < kJpegSegmentParameterLengthSize + 5 ||
+        data[frame->offset + kHeightOffset] != (height >> 8) ||
+        data[frame->offset + kHeightOffset + 1] != (height & 0xFF) ||
+        (int64_t)restartOffsets.size() != intervalCount - 1) {
+        return false;
+    }
+
+    const size_t headerSize = scan->offset + kJpegMarkerCodeSize + scan->parameterLength;
+    auto intervalStart = [&](int interval) {
+        return interval == 0 ? headerSize : restartOffsets[interval - 1] + kJpegMarkerCodeSize;
+    };
+    auto intervalEnd = [&](int interval) {
+        return interval == intervalCount - 1 ? endOffset : restartOffsets[interval];
+    };
+
+    const int unitsPerBand = (unitCount + kMaxRestartBands - 1) / kMaxRestartBands;
+    const int bandCount = (unitCount + unitsPerBand - 1) / unitsPerBand;
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup tasks(*options.fExecutor);
+    tasks.batch(bandCount, [&](int band) {
+        // Fancy upsampling of subsampled chroma reads the rows above and below, so each band is
+        // decoded with the unit on either side of it, and only its own rows are kept.
+        const int firstUnit = band * unitsPerBand;
+        const int lastUnit = std::min(firstUnit + unitsPerBand, unitCount);
+        const int firstDecodedUnit = std::max(firstUnit - 1, 0);
+        const int lastDecodedUnit = std::min(lastUnit + 1, unitCount);
+        const int firstInterval = firstDecodedUnit * intervalsPerUnit;
+        const int lastInterval = (int)std::min<int64_t>(lastDecodedUnit * intervalsPerUnit,
+                                                        intervalCount);
+
+        const int top = firstUnit * rowsPerUnit;
+        const int rows = std::min(lastUnit * rowsPerUnit, height) - top;
+        const int decodedTop = firstDecodedUnit * rowsPerUnit;
+        const int decodedHeight = std::min(lastDecodedUnit * rowsPerUnit, height) - decodedTop;
+
+        // The band is a JPEG of its own: the header, with the frame's height patched, then the
+        // entropy-coded data of its intervals, with the restart markers renumbered from RST0.
+        const size_t entropyStart = intervalStart(firstInterval);
+        const size_t entropySize = intervalEnd(lastInterval - 1) - entropyStart;
+        sk_sp<SkData> bandData =
+                SkData::MakeUninitialized(headerSize + entropySize + kJpegMarkerCodeSize);
+        uint8_t* bytes = static_cast<uint8_t*>(bandData->writable_data());
+        memcpy(bytes, data, headerSize);
+        bytes[frame->offset + kHeightOffset] = decodedHeight >> 8;
+        bytes[frame->offset + kHeightOffset + 1] = decodedHeight & 0xFF;
+        memcpy(bytes + headerSize, data + entropyStart, entropySize);
+        for (int interval = firstInterval; interval < lastInterval - 1; interval++) {
+            const size_t markerOffset = restartOffsets[interval] - entropyStart + headerSize;
+            bytes[markerOffset + 1] = kJpegMarkerRestart0 + ((interval - firstInterval) & 7);
+        }
+        bytes[headerSize + entropySize] = 0xFF;
+        bytes[headerSize + entropySize + 1] = kJpegMarkerEndOfImage;
+
+        Result result;
+        std::unique_ptr<SkCodec> codec =
+                MakeFromStream(std::make_unique<SkMemoryStream>(std::move(bandData)), &result);
+        if (!codec) {
+            failed = true;
+            return;
+        }
+        Options bandOptions;
+        bandOptions.fZeroInitialized = options.fZeroInitialized;
+        if (codec->startScanlineDecode(dstInfo.makeDimensions(codec->dimensions()),
+                                       &bandOptions) != kSuccess ||
+            !codec->skipScanlines(top - decodedTop) ||
+            codec->getScanlines(SkTAddOffset<void>(dst, top * rowBytes), rows, rowBytes) != rows) {
+            failed = true;
+        }
+    });
+    tasks.wait();
+    return !failed;
+}
+
+SkCodec::Result SkJpegCodec::decodeIndexedSubset(const SkImageInfo& dstInfo, void* dst,
+                                                 size_t rowBytes, const Options& options,
+                                                 int* rowsDecoded) {
+    // Bands are decoded at full size, so a subset can't be scaled. getPixels() lets scaled
+    // subsets through for codecs that support them.
+    const SkIRect& subset = *options.fSubset;
+    if (dstInfo.dimensions() != subset.size()) {
+        return kInvalidScale;
+    }
+
+    SkStream* stream = this->stream();
+    SkASSERT(stream->hasLength() && stream->getMemoryBase());
+    const SkSpan<const uint8_t> data(static_cast<const uint8_t*>(stream->getMemoryBase()),
+                                     stream->getLength());
+
+    int rowsToSkip;
+    sk_sp<SkData> band = fEntropyIndex->makeBand(data, subset.top(), subset.bottom(), &rowsToSkip);
+    if (!band) {
+        return kInternalError;
+    }
+    Result result;
+    std::unique_ptr<SkCodec> codec = MakeFromStream(SkMemoryStream::Make(std::move(band)), &result);
+    if (!codec) {
+        return result;
+    }
+
+    // The band is as wide as the image, so it is cropped by a scanline decode. Like the rows,
+    // the crop includes an MCU on either side, so the columns are upsampled as in a full decode.
+    const int mcuWidth = fEntropyIndex->mcuWidth();
+    const int cropLeft = std::max(subset.left() - mcuWidth, 0);
+    const int cropRight = std::min(subset.right() + mcuWidth, codec->dimensions().width());
+    const SkIRect crop = SkIRect::MakeLTRB(cropLeft, 0, cropRight, codec->dimensions().height());
+    Options bandOptions;
+    bandOptions.fZeroInitialized = options.fZeroInitialized;
+    bandOptions.fSubset = &crop;
+    result = codec->startScanlineDecode(dstInfo.makeDimensions(codec->dimensions()), &bandOptions);
+    if (result != kSuccess) {
+        return result;
+    }
+    if (!codec->skipScanlines(rowsToSkip)) {
+        *rowsDecoded = 0;
+        return kIncompleteInput;
+    }
+
+    const size_t bytesPerPixel = dstInfo.bytesPerPixel();
+    AutoTMalloc<uint8_t> row(crop.width() * bytesPerPixel);
+    for (int y = 0; y < subset.height(); y++) {
+        if (codec->getScanlines(row.get(), 1, crop.width() * bytesPerPixel) != 1) {
+            *rowsDecoded = y;
+            return kIncompleteInput;
+        }
+        memcpy(SkTAddOffset<void>(dst, y * rowBytes),
+               row.get() + (subset.left() - cropLeft) * bytesPerPixel,
+               subset.width() * bytesPerPixel);
+    }
+    return kSuccess;
+}
+
+bool SkJpegCodec::onGetValidSubset(SkIRect* desiredSubset) const {
+    return fEntropyIndex && SkIRect::MakeSize(this->dimensions()).contains(*desiredSubset);
+}
+
+void SkJpegCodec::setEntropyIndex(std::unique_ptr<SkJpegEntropyIndex> index) {
+    SkASSERT(!index || (this->stream()->hasLength() && this->stream()->getMemoryBase()));
+    fEntropyIndex = std::move(index);
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
@@ -1019,4 +1435,28 @@ std::unique_ptr<SkCodec> Decode(sk_sp<const SkData> data,
     return Decode(SkMemoryStream::Make(std::move(data)), outResult, nullptr);
 }
 
+sk_sp<SkData> MakeTileIndex(const SkData& data, int mcuRowsPerCheckpoint) {
+    std::unique_ptr<SkJpegEntropyIndex> index = SkJpegEntropyIndex::Make(
+            SkSpan(data.bytes(), data.size()), mcuRowsPerCheckpoint);
+    return index ? index->serialize() : nullptr;
+}
+
+std::unique_ptr<SkCodec> DecodeWithTileIndex(sk_sp<const SkData> data,
+                                             const SkData& tileIndex,
+                                             SkCodec::Result* outResult) {
+    if (!data) {
+        if (outResult) {
+            *outResult = SkCodec::kInvalidInput;
+        }
+        return nullptr;
+    }
+    std::unique_ptr<SkJpegEntropyIndex> index = SkJpegEntropyIndex::Deserialize(
+            tileIndex, SkSpan(data->bytes(), data->size()));
+    std::unique_ptr<SkCodec> codec = Decode(std::move(data), outResult, nullptr);
+    if (codec && index) {
+        static_cast<SkJpegCodec*>(codec.get())->setEntropyIndex(std::move(index));
+    }
+    return codec;
+}
+
 }  // namespace SkJpegDecoder
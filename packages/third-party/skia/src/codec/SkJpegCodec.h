@@ -23,6 +23,7 @@
 #include <memory>
 
 class JpegDecoderMgr;
+class SkJpegEntropyIndex;
 class SkSampler;
 class SkStream;
 class SkSwizzler;
@@ -46,6 +47,13 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    /*
+     * Enables subset decodes, which start at the index's checkpoint above the subset.
+     * The index must have been made from the data of this codec's stream, which must be in
+     * memory.
+     */
+    void setEntropyIndex(std::unique_ptr<SkJpegEntropyIndex> index);
+
 protected:
 
     /*
@@ -59,6 +67,16 @@ protected:
     Result onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, const Options&,
             int*) override;
 
+    /*
+     * Incremental decoding. libjpeg suspends when the stream runs dry, and picks up where it
+     * stopped on the next call. Progressive images are decoded in buffered-image mode: each scan
+     * is output over the previous one once it is complete, so the whole image appears at low
+     * quality early on and is refined in place.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                    const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
     bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
                          SkYUVAPixmapInfo*) const override;
 
@@ -72,6 +90,8 @@ protected:
 
     bool onDimensionsSupported(const SkISize&) override;
 
+    bool onGetValidSubset(SkIRect* desiredSubset) const override;
+
     bool conversionSupported(const SkImageInfo&, bool, bool) override;
 
     bool onGetGainmapCodec(SkGainmapInfo* info, std::unique_ptr<SkCodec>* gainmapCodec) override;
@@ -107,6 +127,23 @@ private:
     Result readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                   const Options&, int* rowsDecoded);
 
+    /*
+     * Decodes the image in bands of rows, concurrently on options.fExecutor. Each band is made of
+     * whole restart intervals, and is decoded by its own codec from a copy of the header
+     * followed by the band's entropy-coded data.
+     *
+     * Returns false if the image cannot be divided this way, or a band fails to decode. The
+     * caller should then decode the image serially.
+     */
+    bool decodeRestartIntervalsInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                          const Options&);
+
+    /*
+     * Decodes options.fSubset from a band of rows written by fEntropyIndex.
+     */
+    Result decodeIndexedSubset(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                               const Options&, int* rowsDecoded);
+
     /*
      * Scanline decoding.
      */
@@ -133,6 +170,17 @@ private:
 
     std::unique_ptr<SkSwizzler> fSwizzler;
 
+    std::unique_ptr<SkJpegEntropyIndex> fEntropyIndex;
+
+    // The state of an incremental decode.
+    void*  fIncrementalDst = nullptr;
+    size_t fIncrementalRowBytes = 0;
+    bool   fStartedDecompress = false;
+    bool   fInOutputPass = false;     // Progressive only: between start and finish output.
+    int    fLastCompletedScan = 0;    // Progressive only: the last scan taken in completely.
+    int    fLastOutputScan = 0;       // Progressive only: the scan of the last completed pass.
+    int    fIncrementalRowsDecoded = 0;
+
     friend class SkRawCodec;
 };
 
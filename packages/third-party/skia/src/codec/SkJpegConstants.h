@@ -20,6 +20,15 @@ static constexpr uint8_t kJpegMarkerEndOfImage = 0xD9;
 // The header of a JPEG file is the data in all segments before the first StartOfScan.
 static constexpr uint8_t kJpegMarkerStartOfScan = 0xDA;
 
+// The StartOfFrame markers of baseline and extended sequential Huffman-coded images.
+static constexpr uint8_t kJpegMarkerStartOfFrameBaseline = 0xC0;
+static constexpr uint8_t kJpegMarkerStartOfFrameExtended = 0xC1;
+
+// When a DefineRestartInterval segment is present, the entropy-coded data of a scan is divided into
+// intervals by the restart markers RST0 through RST7, which repeat modulo eight.
+static constexpr uint8_t kJpegMarkerRestart0 = 0xD0;
+static constexpr uint8_t kJpegMarkerRestart7 = 0xD7;
+
 // Metadata and auxiliary images are stored in the APP1 through APP15 markers.
 static constexpr uint8_t kJpegMarkerAPP0 = 0xE0;
 
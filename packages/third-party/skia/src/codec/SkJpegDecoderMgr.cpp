@@ -16,6 +16,7 @@
 #endif
 
 #include <jpeglib.h>
+#include <algorithm>
 #include <cstddef>
 #include <utility>
 
@@ -92,6 +93,48 @@ SkJpegSourceMgr* JpegDecoderMgr::getSourceMgr() {
     return fSrcMgr.fSourceMgr.get();
 }
 
+void JpegDecoderMgr::setSuspending() {
+    if (fSrcMgr.fSuspending) {
+        return;
+    }
+    fSrcMgr.fSuspending = true;
+    if (fSrcMgr.next_input_byte) {
+        fSrcMgr.fSuspendedInput.assign(fSrcMgr.next_input_byte,
+                                       fSrcMgr.next_input_byte + fSrcMgr.bytes_in_buffer);
+    }
+    fSrcMgr.next_input_byte = fSrcMgr.fSuspendedInput.data();
+    fSrcMgr.bytes_in_buffer = fSrcMgr.fSuspendedInput.size();
+}
+
+bool JpegDecoderMgr::readAvailableInput() {
+    if (!fSrcMgr.fSuspending) {
+        // All of the input was there from the start.
+        return false;
+    }
+    // libjpeg never backs up past next_input_byte, so the bytes before it can go.
+    std::vector<uint8_t>& input = fSrcMgr.fSuspendedInput;
+    input.erase(input.begin(), input.end() - fSrcMgr.bytes_in_buffer);
+
+    // Each suspension costs libjpeg a restart of the MCU it was in, so gather a good amount of
+    // data before resuming.
+    constexpr size_t kMinReadSize = 64 * 1024;
+    const size_t oldSize = input.size();
+    while (input.size() - oldSize < kMinReadSize) {
+        const uint8_t* bytes = nullptr;
+        size_t size = 0;
+        if (!fSrcMgr.fSourceMgr->fillInputBuffer(bytes, size)) {
+            break;
+        }
+        const size_t skip = std::min(fSrcMgr.fPendingSkip, size);
+        fSrcMgr.fPendingSkip -= skip;
+        input.insert(input.end(), bytes + skip, bytes + size);
+    }
+
+    fSrcMgr.next_input_byte = input.data();
+    fSrcMgr.bytes_in_buffer = input.size();
+    return input.size() > oldSize;
+}
+
 JpegDecoderMgr::JpegDecoderMgr(SkStream* stream)
         : fSrcMgr(SkJpegSourceMgr::Make(stream)), fInit(false) {
     // An error manager must be set before any calls to libjpeg, in order to handle failures.
@@ -127,6 +170,14 @@ void JpegDecoderMgr::SourceMgr::InitSource(j_decompress_ptr dinfo) {
 void JpegDecoderMgr::SourceMgr::SkipInputData(j_decompress_ptr dinfo, long num_bytes_long) {
     JpegDecoderMgr::SourceMgr* src = (JpegDecoderMgr::SourceMgr*)dinfo->src;
     size_t num_bytes = static_cast<size_t>(num_bytes_long);
+    if (src->fSuspending) {
+        // Skip whatever is not in the buffer yet as it arrives.
+        const size_t skip = std::min(num_bytes, src->bytes_in_buffer);
+        src->next_input_byte += skip;
+        src->bytes_in_buffer -= skip;
+        src->fPendingSkip += num_bytes - skip;
+        return;
+    }
     if (!src->fSourceMgr->skipInputBytes(num_bytes, src->next_input_byte, src->bytes_in_buffer)) {
         SkCodecPrintf("Failure to skip.\n");
         src->next_input_byte = nullptr;
@@ -138,6 +189,10 @@ void JpegDecoderMgr::SourceMgr::SkipInputData(j_decompress_ptr dinfo, long num_b
 // static
 boolean JpegDecoderMgr::SourceMgr::FillInputBuffer(j_decompress_ptr dinfo) {
     JpegDecoderMgr::SourceMgr* src = (JpegDecoderMgr::SourceMgr*)dinfo->src;
+    if (src->fSuspending) {
+        // Suspend, leaving the input libjpeg will back up to in place.
+        return false;
+    }
     if (!src->fSourceMgr->fillInputBuffer(src->next_input_byte, src->bytes_in_buffer)) {
         SkCodecPrintf("Failure to fill input buffer.\n");
         src->next_input_byte = nullptr;
@@ -18,7 +18,10 @@ extern "C" {
     #include "jpeglib.h"  // NO_G3_REWRITE
 }
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 class SkStream;
 
@@ -71,6 +74,21 @@ public:
     // Get the source manager.
     SkJpegSourceMgr* getSourceMgr();
 
+    /*
+     * Makes libjpeg suspend, rather than fail, when it runs out of input, so that the decode can
+     * resume where it stopped once the stream has more data. From then on the input that libjpeg
+     * has not consumed is kept in a growable buffer, which readAvailableInput() appends to.
+     *
+     * Must be called between calls into libjpeg.
+     */
+    void setSuspending();
+
+    /*
+     * Appends what the stream has available to the input of a suspended decode. Returns false if
+     * the stream has no more data yet, or setSuspending() has not been called.
+     */
+    bool readAvailableInput();
+
 private:
     // Wrapper that calls into the full SkJpegSourceMgr interface.
     struct SourceMgr : jpeg_source_mgr {
@@ -81,6 +99,12 @@ private:
 
         explicit SourceMgr(std::unique_ptr<SkJpegSourceMgr> mgr);
         std::unique_ptr<SkJpegSourceMgr> fSourceMgr;
+
+        // Used once setSuspending() has been called. libjpeg backs up to next_input_byte when it
+        // suspends, so everything from there on is kept in fSuspendedInput.
+        bool                 fSuspending = false;
+        std::vector<uint8_t> fSuspendedInput;
+        size_t               fPendingSkip = 0;
     };
 
     jpeg_decompress_struct fDInfo;
@@ -0,0 +1,782 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkJpegEntropyIndex.h"
+
+#include "include/core/SkData.h"
+#include "include/core/SkFourByteTag.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkAssert.h"
+#include "src/base/SkMathPriv.h"
+#include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkJpegConstants.h"
+#include "src/codec/SkJpegSegmentScan.h"
+#include "src/core/SkChecksum.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace {
+constexpr uint32_t kMagic = SkSetFourByteTag('s', 'k', 'j', 'i');
+constexpr uint32_t kVersion = 1;
+
+constexpr uint8_t kJpegMarkerDefineHuffmanTables = 0xC4;
+constexpr uint8_t kJpegMarkerDefineRestartInterval = 0xDD;
+
+// The width and height of a block of samples.
+constexpr int kBlockSize = 8;
+constexpr int kCoefficientsPerBlock = kBlockSize * kBlockSize;
+// The limits of libjpeg-turbo are used for the number of components and of blocks in an MCU,
+// except that only up to four components are supported.
+constexpr int kMaxComponents = 4;
+constexpr int kMaxBlocksPerMcu = 10;
+// A difference of DC coefficients of 8-bit samples has at most 11 bits.
+constexpr int kMaxDcCategory = 11;
+
+uint16_t read_be16(const uint8_t* bytes) { return (bytes[0] << 8) | bytes[1]; }
+
+bool is_start_of_frame(uint8_t marker) {
+    // SOF0 through SOF15, except DHT, JPG and DAC.
+    return marker >= 0xC0 && marker <= 0xCF && marker != kJpegMarkerDefineHuffmanTables &&
+           marker != 0xC8 && marker != 0xCC;
+}
+
+// Reads the bits of entropy-coded data, removing the zero bytes stuffed after each 0xFF. Like
+// libjpeg-turbo, it reads zeros past a marker or the end of the data.
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t position, size_t end)
+            : fData(data), fPosition(position), fEnd(end) {}
+
+    // Return the next count bits, with count at most 16, without consuming them.
+    uint32_t peek(int count) {
+        SkASSERT(count > 0 && count <= 16);
+        this->fill();
+        return (fBuffer >> (fBitCount - count)) & ((1u << count) - 1);
+    }
+
+    void skip(int count) {
+        SkASSERT(count <= fBitCount);
+        fBitCount -= count;
+    }
+
+    uint32_t read(int count) {
+        const uint32_t bits = this->peek(count);
+        this->skip(count);
+        return bits;
+    }
+
+    // The number of bits left before the end of the data or the next marker.
+    int availableBits() {
+        this->fill();
+        return std::max(fBitCount - fPaddingBitCount, 0);
+    }
+
+    // True if zeros past the end of the data or a marker have been read.
+    bool overran() const { return fBitCount < fPaddingBitCount; }
+
+    // Return the offset of the byte holding the next bit, and the index of the bit in that byte.
+    void position(uint64_t* offset, uint32_t* bit) const {
+        SkASSERT(!this->overran());
+        const int bitsLeft = fBitCount - fPaddingBitCount;
+        size_t bytePosition = fPosition;
+        for (int bytesLeft = (bitsLeft + 7) / 8; bytesLeft > 0;) {
+            bytePosition--;
+            if (fData[bytePosition] != 0x00 || fData[bytePosition - 1] != 0xFF) {
+                bytesLeft--;
+            }
+        }
+        *offset = bytePosition;
+        *bit = (8 - bitsLeft % 8) % 8;
+    }
+
+    // Discard the rest of the restart interval, as libjpeg-turbo does, and read the marker that
+    // ends it. Returns false if that marker is not RST<number>.
+    bool readRestartMarker(int number) {
+        fBuffer = 0;
+        fBitCount = 0;
+        fPaddingBitCount = 0;
+        while (fPosition + 1 < fEnd &&
+               (fData[fPosition] != 0xFF || fData[fPosition + 1] == 0x00 ||
+                fData[fPosition + 1] == 0xFF)) {
+            fPosition++;
+        }
+        if (fPosition + 1 >= fEnd || fData[fPosition + 1] != kJpegMarkerRestart0 + number) {
+            return false;
+        }
+        fPosition += kJpegMarkerCodeSize;
+        return true;
+    }
+
+private:
+    void fill() {
+        while (fBitCount <= 56) {
+            fBuffer <<= 8;
+            fBitCount += 8;
+            if (fPaddingBitCount > 0 || !this->loadByte()) {
+                fPaddingBitCount += 8;
+            }
+        }
+    }
+
+    bool loadByte() {
+        if (fPosition >= fEnd) {
+            return false;
+        }
+        const uint8_t byte = fData[fPosition];
+        if (byte == 0xFF) {
+            if (fPosition + 1 >= fEnd || fData[fPosition + 1] != 0x00) {
+                return false;
+            }
+            fPosition += 2;
+        } else {
+            fPosition += 1;
+        }
+        fBuffer |= byte;
+        return true;
+    }
+
+    const uint8_t* const fData;
+    size_t fPosition;
+    const size_t fEnd;
+    uint64_t fBuffer = 0;
+    // The number of bits in fBuffer, of which the last fPaddingBitCount are zeros read past the
+    // end of the data.
+    int fBitCount = 0;
+    int fPaddingBitCount = 0;
+};
+
+// Writes entropy-coded data, stuffing a zero byte after each 0xFF.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>* bytes) : fBytes(bytes) {}
+
+    void write(uint32_t bits, int count) {
+        SkASSERT(count >= 0 && count <= 24);
+        fBuffer = (fBuffer << count) | (bits & ((1u << count) - 1));
+        fBitCount += count;
+        while (fBitCount >= 8) {
+            fBitCount -= 8;
+            const uint8_t byte = fBuffer >> fBitCount;
+            fBytes->push_back(byte);
+            if (byte == 0xFF) {
+                fBytes->push_back(0x00);
+            }
+        }
+    }
+
+    // Pad the last byte with ones, as encoders do.
+    void flush() {
+        if (fBitCount > 0) {
+            this->write(0xFF, 8 - fBitCount);
+        }
+    }
+
+private:
+    std::vector<uint8_t>* const fBytes;
+    uint32_t fBuffer = 0;
+    int fBitCount = 0;
+};
+
+class HuffmanTable {
+public:
+    bool isDefined() const { return fDefined; }
+
+    // Build the table from the code counts and symbols of a DefineHuffmanTables segment.
+    bool init(const uint8_t counts[16], const uint8_t symbols[]) {
+        fDefined = false;
+        std::fill(std::begin(fLookup), std::end(fLookup), 0);
+        std::fill(std::begin(fLengths), std::end(fLengths), 0);
+
+        int index = 0;
+        uint32_t code = 0;
+        for (int length = 1; length <= 16; length++) {
+            const int count = counts[length - 1];
+            fValueOffset[length] = index - static_cast<int32_t>(code);
+            for (int i = 0; i < count; i++, index++, code++) {
+                if (code >= (1u << length)) {
+                    return false;
+                }
+                const uint8_t symbol = symbols[index];
+                fSymbols[index] = symbol;
+                fCodes[symbol] = code;
+                fLengths[symbol] = length;
+                if (length <= kLookupBits) {
+                    const int shift = kLookupBits - length;
+                    for (uint32_t low = 0; low < (1u << shift); low++) {
+                        fLookup[(code << shift) | low] = (length << 8) | symbol;
+                    }
+                }
+            }
+            fMaxCode[length] = count > 0 ? static_cast<int32_t>(code) - 1 : -1;
+            code <<= 1;
+        }
+        fDefined = true;
+        return true;
+    }
+
+    // Return the next symbol, or -1 if the bits are not a code of this table.
+    int decode(BitReader* reader) const {
+        const uint32_t bits = reader->peek(16);
+        if (const uint16_t entry = fLookup[bits >> (16 - kLookupBits)]) {
+            reader->skip(entry >> 8);
+            return entry & 0xFF;
+        }
+        for (int length = kLookupBits + 1; length <= 16; length++) {
+            const int32_t code = bits >> (16 - length);
+            if (code <= fMaxCode[length]) {
+                reader->skip(length);
+                return fSymbols[code + fValueOffset[length]];
+            }
+        }
+        return -1;
+    }
+
+    // Write the code of symbol. Returns false if the table has no code for it.
+    bool encode(uint8_t symbol, BitWriter* writer) const {
+        if (fLengths[symbol] == 0) {
+            return false;
+        }
+        writer->write(fCodes[symbol], fLengths[symbol]);
+        return true;
+    }
+
+private:
+    // Codes of up to this many bits are decoded with a single lookup.
+    static constexpr int kLookupBits = 9;
+
+    bool fDefined = false;
+    // The length of the code in the high byte and the symbol in the low byte, or zero if the code
+    // is longer than kLookupBits.
+    uint16_t fLookup[1 << kLookupBits];
+    // For each code length, the largest code and the offset from a code to its symbol's index.
+    int32_t fMaxCode[17];
+    int32_t fValueOffset[17];
+    uint8_t fSymbols[256];
+    uint16_t fCodes[256];
+    uint8_t fLengths[256];
+};
+
+int extend(uint32_t bits, int count) {
+    return bits < (1u << (count - 1)) ? static_cast<int>(bits) - (1 << count) + 1
+                                      : static_cast<int>(bits);
+}
+}  // namespace
+
+struct SkJpegEntropyIndex::Frame {
+    int fWidth = 0;
+    int fHeight = 0;
+    // The offset of the StartOfFrame marker, and the size of everything up to the end of the
+    // StartOfScan segment.
+    size_t fFrameOffset = 0;
+    size_t fHeaderSize = 0;
+    uint64_t fHeaderHash = 0;
+    int fRestartInterval = 0;
+
+    int fMcuWidth = 0;
+    int fMcuHeight = 0;
+    int fMcusPerRow = 0;
+    int fMcuRows = 0;
+
+    // The components in the order of the scan.
+    struct Component {
+        int fBlocksPerMcu;
+        int fDcTable;
+        int fAcTable;
+    };
+    int fComponentCount = 0;
+    std::array<Component, kMaxComponents> fComponents;
+
+    HuffmanTable fDcTables[4];
+    HuffmanTable fAcTables[4];
+
+    static std::unique_ptr<Frame> Make(SkSpan<const uint8_t> data);
+
+    bool decodeMcu(BitReader* reader, int predictors[]) const;
+};
+
+std::unique_ptr<SkJpegEntropyIndex::Frame> SkJpegEntropyIndex::Frame::Make(
+        SkSpan<const uint8_t> data) {
+    SkJpegSegmentScanner scanner(kJpegMarkerStartOfScan);
+    scanner.onBytes(data.data(), data.size());
+    if (!scanner.isDone()) {
+        return nullptr;
+    }
+
+    auto frame = std::make_unique<Frame>();
+    struct FrameComponent {
+        uint8_t fId;
+        int fHorizontalSampling;
+        int fVerticalSampling;
+    };
+    std::array<FrameComponent, kMaxComponents> frameComponents;
+    int frameComponentCount = 0;
+
+    for (const SkJpegSegment& segment : scanner.getSegments()) {
+        const uint8_t* params = data.data() + segment.offset + kJpegMarkerCodeSize +
+                                kJpegSegmentParameterLengthSize;
+        const size_t size = segment.parameterLength > kJpegSegmentParameterLengthSize
+                                    ? segment.parameterLength - kJpegSegmentParameterLengthSize
+                                    : 0;
+        if (segment.marker == kJpegMarkerStartOfFrameBaseline ||
+            segment.marker == kJpegMarkerStartOfFrameExtended) {
+            // Only 8-bit samples are supported.
+            if (frameComponentCount > 0 || size < 6 || params[0] != 8) {
+                return nullptr;
+            }
+            frame->fFrameOffset = segment.offset;
+            frame->fHeight = read_be16(params + 1);
+            frame->fWidth = read_be16(params + 3);
+            frameComponentCount = params[5];
+            if (frameComponentCount < 1 || frameComponentCount > kMaxComponents ||
+                size < 6 + 3 * (size_t)frameComponentCount) {
+                return nullptr;
+            }
+            for (int i = 0; i < frameComponentCount; i++) {
+                const uint8_t* component = params + 6 + 3 * i;
+                frameComponents[i] = {component[0], component[1] >> 4, component[1] & 0xF};
+                if (frameComponents[i].fHorizontalSampling < 1 ||
+                    frameComponents[i].fHorizontalSampling > 4 ||
+                    frameComponents[i].fVerticalSampling < 1 ||
+                    frameComponents[i].fVerticalSampling > 4) {
+                    return nullptr;
+                }
+            }
+        } else if (is_start_of_frame(segment.marker)) {
+            // Progressive, lossless and arithmetic-coded images are not supported.
+            return nullptr;
+        } else if (segment.marker == kJpegMarkerDefineHuffmanTables) {
+            for (size_t offset = 0; offset < size;) {
+                if (size - offset < 17) {
+                    return nullptr;
+                }
+                const int tableClass = params[offset] >> 4;
+                const int tableIndex = params[offset] & 0xF;
+                const uint8_t* counts = params + offset + 1;
+                size_t symbolCount = 0;
+                for (int i = 0; i < 16; i++) {
+                    symbolCount += counts[i];
+                }
+                if (tableClass > 1 || tableIndex > 3 || symbolCount > 256 ||
+                    size - offset - 17 < symbolCount) {
+                    return nullptr;
+                }
+                HuffmanTable& table = tableClass == 0 ? frame->fDcTables[tableIndex]
+                                                      : frame->fAcTables[tableIndex];
+                if (!table.init(counts, counts + 16)) {
+                    return nullptr;
+                }
+                offset += 17 + symbolCount;
+            }
+        } else if (segment.marker == kJpegMarkerDefineRestartInterval) {
+            if (size < 2) {
+                return nullptr;
+            }
+            frame->fRestartInterval = read_be16(params);
+        }
+    }
+
+    // The scanner stops at the StartOfScan marker, before reading its length.
+    const SkJpegSegment& scan = scanner.getSegments().back();
+    SkASSERT(scan.marker == kJpegMarkerStartOfScan);
+    const size_t paramsOffset = scan.offset + kJpegMarkerCodeSize;
+    if (frameComponentCount == 0 || frame->fWidth == 0 || frame->fHeight == 0 ||
+        data.size() < paramsOffset + kJpegSegmentParameterLengthSize) {
+        return nullptr;
+    }
+    const size_t scanSize = read_be16(data.data() + paramsOffset);
+    frame->fHeaderSize = paramsOffset + scanSize;
+    if (data.size() < frame->fHeaderSize || scanSize < kJpegSegmentParameterLengthSize + 1) {
+        return nullptr;
+    }
+
+    // The scan must be the only one, so hold all the components and all the coefficients.
+    const uint8_t* params = data.data() + paramsOffset + kJpegSegmentParameterLengthSize;
+    frame->fComponentCount = params[0];
+    if (frame->fComponentCount != frameComponentCount ||
+        scanSize != kJpegSegmentParameterLengthSize + 1 + 2 * (size_t)frameComponentCount + 3) {
+        return nullptr;
+    }
+    const uint8_t* spectralSelection = params + 1 + 2 * frameComponentCount;
+    if (spectralSelection[0] != 0 || spectralSelection[1] != kCoefficientsPerBlock - 1 ||
+        spectralSelection[2] != 0) {
+        return nullptr;
+    }
+
+    int maxHorizontalSampling = 1;
+    int maxVerticalSampling = 1;
+    for (int i = 0; i < frameComponentCount; i++) {
+        maxHorizontalSampling =
+                std::max(maxHorizontalSampling, frameComponents[i].fHorizontalSampling);
+        maxVerticalSampling = std::max(maxVerticalSampling, frameComponents[i].fVerticalSampling);
+    }
+
+    int blocksPerMcu = 0;
+    for (int i = 0; i < frameComponentCount; i++) {
+        const uint8_t id = params[1 + 2 * i];
+        const uint8_t tables = params[2 + 2 * i];
+        const FrameComponent* component = nullptr;
+        for (int j = 0; j < frameComponentCount; j++) {
+            if (frameComponents[j].fId == id) {
+                component = &frameComponents[j];
+            }
+        }
+        Component& scanComponent = frame->fComponents[i];
+        scanComponent.fDcTable = tables >> 4;
+        scanComponent.fAcTable = tables & 0xF;
+        if (!component || scanComponent.fDcTable > 3 || scanComponent.fAcTable > 3 ||
+            !frame->fDcTables[scanComponent.fDcTable].isDefined() ||
+            !frame->fAcTables[scanComponent.fAcTable].isDefined()) {
+            return nullptr;
+        }
+        // The MCU of an image with one component is a single block, whatever its sampling.
+        scanComponent.fBlocksPerMcu =
+                frameComponentCount == 1
+                        ? 1
+                        : component->fHorizontalSampling * component->fVerticalSampling;
+        blocksPerMcu += scanComponent.fBlocksPerMcu;
+    }
+    if (blocksPerMcu > kMaxBlocksPerMcu) {
+        return nullptr;
+    }
+
+    frame->fMcuWidth = frameComponentCount == 1 ? kBlockSize : maxHorizontalSampling * kBlockSize;
+    frame->fMcuHeight = frameComponentCount == 1 ? kBlockSize : maxVerticalSampling * kBlockSize;
+    frame->fMcusPerRow = (frame->fWidth + frame->fMcuWidth - 1) / frame->fMcuWidth;
+    frame->fMcuRows = (frame->fHeight + frame->fMcuHeight - 1) / frame->fMcuHeight;
+    frame->fHeaderHash = SkChecksum::Hash64(data.data(), frame->fHeaderSize);
+    return frame;
+}
+
+bool SkJpegEntropyIndex::Frame::decodeMcu(BitReader* reader, int predictors[]) const {
+    for (int i = 0; i < fComponentCount; i++) {
+        const Component& component = fComponents[i];
+        const HuffmanTable& dcTable = fDcTables[component.fDcTable];
+        const HuffmanTable& acTable = fAcTables[component.fAcTable];
+        for (int block = 0; block < component.fBlocksPerMcu; block++) {
+            const int category = dcTable.decode(reader);
+            if (category < 0 || category > kMaxDcCategory) {
+                return false;
+            }
+            if (category > 0) {
+                predictors[i] += extend(reader->read(category), category);
+            }
+
+            // Only the DC coefficients are needed, so the AC coefficients are skipped.
+            for (int k = 1; k < kCoefficientsPerBlock;) {
+                const int symbol = acTable.decode(reader);
+                if (symbol < 0) {
+                    return false;
+                }
+                const int run = symbol >> 4;
+                const int size = symbol & 0xF;
+                if (size > 0) {
+                    k += run + 1;
+                    reader->read(size);
+                } else if (run == 15) {
+                    k += 16;
+                } else {
+                    break;
+                }
+                if (k > kCoefficientsPerBlock) {
+                    return false;
+                }
+            }
+        }
+    }
+    return !reader->overran();
+}
+
+SkJpegEntropyIndex::SkJpegEntropyIndex(std::unique_ptr<Frame> frame,
+                                       int mcuRowsPerCheckpoint,
+                                       size_t dataSize,
+                                       size_t entropyEnd,
+                                       std::vector<Checkpoint> checkpoints)
+        : fFrame(std::move(frame))
+        , fMcuRowsPerCheckpoint(mcuRowsPerCheckpoint)
+        , fDataSize(dataSize)
+        , fEntropyEnd(entropyEnd)
+        , fCheckpoints(std::move(checkpoints)) {}
+
+SkJpegEntropyIndex::~SkJpegEntropyIndex() = default;
+
+std::unique_ptr<SkJpegEntropyIndex> SkJpegEntropyIndex::Make(SkSpan<const uint8_t> data,
+                                                             int mcuRowsPerCheckpoint) {
+    if (mcuRowsPerCheckpoint < 1) {
+        return nullptr;
+    }
+    std::unique_ptr<Frame> frame = Frame::Make(data);
+    if (!frame) {
+        return nullptr;
+    }
+
+    BitReader reader(data.data(), frame->fHeaderSize, data.size());
+    std::vector<Checkpoint> checkpoints;
+    int predictors[kMaxComponents] = {};
+    uint32_t interval = 0;
+    int mcusLeftInInterval = frame->fRestartInterval;
+    int nextCheckpointRow = 0;
+    for (int row = 0; row < frame->fMcuRows; row++) {
+        for (int column = 0; column < frame->fMcusPerRow; column++) {
+            if (frame->fRestartInterval > 0 && mcusLeftInInterval == 0) {
+                if (!reader.readRestartMarker(interval & 7)) {
+                    return nullptr;
+                }
+                interval++;
+                std::fill(std::begin(predictors), std::end(predictors), 0);
+                mcusLeftInInterval = frame->fRestartInterval;
+            }
+
+            // A band can only start at a restart marker, when there are any, since the restart
+            // intervals of the band are counted from its start.
+            if (column == 0 && row >= nextCheckpointRow &&
+                mcusLeftInInterval == frame->fRestartInterval) {
+                Checkpoint checkpoint;
+                checkpoint.fMcuRow = row;
+                reader.position(&checkpoint.fOffset, &checkpoint.fBit);
+                checkpoint.fInterval = interval;
+                for (int i = 0; i < kMaxComponents; i++) {
+                    checkpoint.fPredictors[i] = predictors[i];
+                }
+                checkpoints.push_back(checkpoint);
+                nextCheckpointRow = row + mcuRowsPerCheckpoint;
+            }
+
+            if (!frame->decodeMcu(&reader, predictors)) {
+                return nullptr;
+            }
+            for (int i = 0; i < frame->fComponentCount; i++) {
+                // The predictors of valid data stay within the range of DC coefficients.
+                if (predictors[i] < -(1 << kMaxDcCategory) || predictors[i] >= 1 << kMaxDcCategory) {
+                    return nullptr;
+                }
+            }
+            if (frame->fRestartInterval > 0) {
+                mcusLeftInInterval--;
+            }
+        }
+    }
+
+    // Bands end with the byte after the one that holds the last bit, in case that byte is 0xFF
+    // and is followed by a stuffed zero.
+    uint64_t endOffset;
+    uint32_t endBit;
+    reader.position(&endOffset, &endBit);
+    const size_t entropyEnd = std::min<size_t>(endOffset + 2, data.size());
+
+    return std::unique_ptr<SkJpegEntropyIndex>(new SkJpegEntropyIndex(std::move(frame),
+                                                                      mcuRowsPerCheckpoint,
+                                                                      data.size(),
+                                                                      entropyEnd,
+                                                                      std::move(checkpoints)));
+}
+
+sk_sp<SkData> SkJpegEntropyIndex::serialize() const {
+    SkDynamicMemoryWStream stream;
+    stream.write32(kMagic);
+    stream.write32(kVersion);
+    stream.write64(fDataSize);
+    stream.write64(fFrame->fHeaderHash);
+    stream.write64(fEntropyEnd);
+    stream.write32(fMcuRowsPerCheckpoint);
+    stream.write32(fCheckpoints.size());
+    for (const Checkpoint& checkpoint : fCheckpoints) {
+        stream.write32(checkpoint.fMcuRow);
+        stream.write64(checkpoint.fOffset);
+        stream.write32(checkpoint.fBit);
+        stream.write32(checkpoint.fInterval);
+        for (int16_t predictor : checkpoint.fPredictors) {
+            stream.write16(static_cast<uint16_t>(predictor));
+        }
+    }
+    return stream.detachAsData();
+}
+
+std::unique_ptr<SkJpegEntropyIndex> SkJpegEntropyIndex::Deserialize(const SkData& index,
+                                                                    SkSpan<const uint8_t> data) {
+    SkMemoryStream stream(index.data(), index.size());
+    uint32_t magic, version, mcuRowsPerCheckpoint, checkpointCount;
+    uint64_t dataSize, headerHash, entropyEnd;
+    if (!stream.readU32(&magic) || magic != kMagic ||
+        !stream.readU32(&version) || version != kVersion ||
+        !stream.readU64(&dataSize) || dataSize != data.size() ||
+        !stream.readU64(&headerHash) ||
+        !stream.readU64(&entropyEnd) || entropyEnd > data.size() ||
+        !stream.readU32(&mcuRowsPerCheckpoint) || mcuRowsPerCheckpoint < 1 ||
+        !stream.readU32(&checkpointCount)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Frame> frame = Frame::Make(data);
+    if (!frame || frame->fHeaderHash != headerHash || checkpointCount < 1 ||
+        checkpointCount > (uint32_t)frame->fMcuRows) {
+        return nullptr;
+    }
+
+    std::vector<Checkpoint> checkpoints(checkpointCount);
+    for (uint32_t i = 0; i < checkpointCount; i++) {
+        Checkpoint& checkpoint = checkpoints[i];
+        if (!stream.readU32(&checkpoint.fMcuRow) ||
+            !stream.readU64(&checkpoint.fOffset) ||
+            !stream.readU32(&checkpoint.fBit) ||
+            !stream.readU32(&checkpoint.fInterval)) {
+            return nullptr;
+        }
+        for (int16_t& predictor : checkpoint.fPredictors) {
+            if (!stream.readS16(&predictor)) {
+                return nullptr;
+            }
+        }
+        const bool ordered = i == 0 ? checkpoint.fMcuRow == 0
+                                    : checkpoint.fMcuRow > checkpoints[i - 1].fMcuRow &&
+                                      checkpoint.fOffset >= checkpoints[i - 1].fOffset;
+        if (!ordered || checkpoint.fMcuRow >= (uint32_t)frame->fMcuRows ||
+            checkpoint.fOffset < frame->fHeaderSize || checkpoint.fOffset >= entropyEnd ||
+            checkpoint.fBit > 7 ||
+            (frame->fRestartInterval > 0 && checkpoint.fBit != 0)) {
+            return nullptr;
+        }
+    }
+    if (!stream.isAtEnd()) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SkJpegEntropyIndex>(new SkJpegEntropyIndex(std::move(frame),
+                                                                      mcuRowsPerCheckpoint,
+                                                                      data.size(),
+                                                                      entropyEnd,
+                                                                      std::move(checkpoints)));
+}
+
+int SkJpegEntropyIndex::mcuWidth() const { return fFrame->fMcuWidth; }
+
+sk_sp<SkData> SkJpegEntropyIndex::makeBand(SkSpan<const uint8_t> data,
+                                           int top,
+                                           int bottom,
+                                           int* rowsToSkip) const {
+    const Frame& frame = *fFrame;
+    SkASSERT(data.size() == fDataSize);
+    SkASSERT(0 <= top && top < bottom && bottom <= frame.fHeight);
+
+    // Chroma upsampling reads the rows above and below, so the band starts a row of MCUs above
+    // the subset and ends a row of MCUs below it, to decode the subset as a full decode would.
+    const int firstMcuRow = std::max(top / frame.fMcuHeight - 1, 0);
+    const int lastMcuRow =
+            std::min((bottom + frame.fMcuHeight - 1) / frame.fMcuHeight + 1, frame.fMcuRows);
+    auto start = std::upper_bound(fCheckpoints.begin(), fCheckpoints.end(), firstMcuRow,
+                                  [](int row, const Checkpoint& checkpoint) {
+                                      return row < (int)checkpoint.fMcuRow;
+                                  });
+    auto end = std::lower_bound(fCheckpoints.begin(), fCheckpoints.end(), lastMcuRow,
+                                [](const Checkpoint& checkpoint, int row) {
+                                    return (int)checkpoint.fMcuRow < row;
+                                });
+    const Checkpoint* endCheckpoint = end != fCheckpoints.end() ? &*end : nullptr;
+
+    // A checkpoint whose predictors cannot be encoded with the image's Huffman tables is
+    // skipped for an earlier one. The first checkpoint can always be used.
+    while (start != fCheckpoints.begin()) {
+        --start;
+        if (sk_sp<SkData> band =
+                    this->makeBand(data, *start, endCheckpoint, top, lastMcuRow, rowsToSkip)) {
+            return band;
+        }
+    }
+    return nullptr;
+}
+
+sk_sp<SkData> SkJpegEntropyIndex::makeBand(SkSpan<const uint8_t> data,
+                                           const Checkpoint& start,
+                                           const Checkpoint* end,
+                                           int top,
+                                           int lastMcuRow,
+                                           int* rowsToSkip) const {
+    const Frame& frame = *fFrame;
+    const int bandTop = start.fMcuRow * frame.fMcuHeight;
+    const int bandRows = std::min(lastMcuRow * frame.fMcuHeight, frame.fHeight) - bandTop;
+    // The band ends before the restart marker of the next checkpoint. Without restarts, it ends
+    // after the byte that holds the next checkpoint's first bit, like the last band.
+    size_t entropyEnd = fEntropyEnd;
+    if (end) {
+        entropyEnd = frame.fRestartInterval > 0 ? end->fOffset - kJpegMarkerCodeSize
+                                                : std::min<size_t>(end->fOffset + 2, fEntropyEnd);
+    }
+    if (entropyEnd <= start.fOffset) {
+        return nullptr;
+    }
+
+    std::vector<uint8_t> bytes(data.begin(), data.begin() + frame.fHeaderSize);
+    bytes.reserve(frame.fHeaderSize + (entropyEnd - start.fOffset) + kJpegMarkerCodeSize);
+    // The StartOfFrame parameters hold the precision, followed by the height.
+    const size_t heightOffset =
+            frame.fFrameOffset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize + 1;
+    int height = bandRows;
+
+    if (frame.fRestartInterval > 0 || start.fMcuRow == 0) {
+        // The band starts the image or a restart interval, so its data is byte aligned and its
+        // predictors are zero. Its restart markers are renumbered to start from RST0.
+        SkASSERT(start.fBit == 0);
+        const size_t entropyStart = bytes.size();
+        bytes.insert(bytes.end(), data.begin() + start.fOffset, data.begin() + entropyEnd);
+        for (size_t i = entropyStart; frame.fRestartInterval > 0 && i + 1 < bytes.size(); i++) {
+            if (bytes[i] == 0xFF && bytes[i + 1] >= kJpegMarkerRestart0 &&
+                bytes[i + 1] <= kJpegMarkerRestart7) {
+                const uint32_t number = bytes[i + 1] - kJpegMarkerRestart0;
+                bytes[i + 1] = kJpegMarkerRestart0 + ((number - start.fInterval) & 7);
+            }
+        }
+        *rowsToSkip = top - bandTop;
+    } else {
+        // The band starts with a made-up row of MCUs that sets the DC predictors to those of the
+        // checkpoint. Each block has just a DC coefficient, so the row is a few bits per block.
+        // It is followed by the bits of the band, which are shifted to the checkpoint's bit.
+        BitWriter writer(&bytes);
+        for (int column = 0; column < frame.fMcusPerRow; column++) {
+            for (int i = 0; i < frame.fComponentCount; i++) {
+                const Frame::Component& component = frame.fComponents[i];
+                for (int block = 0; block < component.fBlocksPerMcu; block++) {
+                    const int difference = column == 0 && block == 0 ? start.fPredictors[i] : 0;
+                    const uint32_t magnitude = std::abs(difference);
+                    const int category = magnitude == 0 ? 0 : 32 - SkCLZ(magnitude);
+                    if (!frame.fDcTables[component.fDcTable].encode(category, &writer)) {
+                        return nullptr;
+                    }
+                    writer.write(difference < 0 ? difference - 1 : difference, category);
+                    // End of block.
+                    if (!frame.fAcTables[component.fAcTable].encode(0x00, &writer)) {
+                        return nullptr;
+                    }
+                }
+            }
+        }
+
+        BitReader reader(data.data(), start.fOffset, entropyEnd);
+        if (start.fBit > 0) {
+            reader.read(start.fBit);
+        }
+        for (int bits = reader.availableBits(); bits > 0; bits = reader.availableBits()) {
+            const int count = std::min(bits, 16);
+            writer.write(reader.read(count), count);
+        }
+        writer.flush();
+
+        height += frame.fMcuHeight;
+        *rowsToSkip = frame.fMcuHeight + top - bandTop;
+    }
+
+    if (height > 0xFFFF) {
+        return nullptr;
+    }
+    bytes[heightOffset] = height >> 8;
+    bytes[heightOffset + 1] = height & 0xFF;
+    bytes.push_back(0xFF);
+    bytes.push_back(kJpegMarkerEndOfImage);
+    return SkData::MakeWithCopy(bytes.data(), bytes.size());
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegEntropyIndex_codec_DEFINED
+#define SkJpegEntropyIndex_codec_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkData;
+
+/*
+ * An index of the entropy-coded data of a sequential Huffman-coded JPEG image, in the spirit of
+ * zran for gzip. A checkpoint is recorded at the start of every few rows of MCUs. It holds the
+ * position of the row's first bit and the DC predictors of the components at that point.
+ *
+ * makeBand() uses the checkpoints to write a small JPEG that holds only the rows of a subset
+ * (plus the rows around it), which can be decoded without reading the data above it.
+ */
+class SkJpegEntropyIndex {
+public:
+    // Decode the entropy-coded data of the JPEG in data, recording a checkpoint every
+    // mcuRowsPerCheckpoint rows of MCUs. Returns nullptr if the image is not a single sequential
+    // Huffman-coded scan, or if its data is invalid.
+    static std::unique_ptr<SkJpegEntropyIndex> Make(SkSpan<const uint8_t> data,
+                                                    int mcuRowsPerCheckpoint);
+
+    // Read an index written by serialize(). Returns nullptr if the index is invalid, or was not
+    // made from data.
+    static std::unique_ptr<SkJpegEntropyIndex> Deserialize(const SkData& index,
+                                                           SkSpan<const uint8_t> data);
+
+    sk_sp<SkData> serialize() const;
+
+    // Return a JPEG of the full width of the image, whose rows include the rows [top, bottom) of
+    // the image in data, starting at row *rowsToSkip. The rows above and below are decoded only
+    // as context for upsampling. Returns nullptr if the JPEG could not be written.
+    sk_sp<SkData> makeBand(SkSpan<const uint8_t> data, int top, int bottom, int* rowsToSkip) const;
+
+    // The width of an MCU in pixels.
+    int mcuWidth() const;
+
+    // The layout of the image and its Huffman tables, parsed from the header.
+    struct Frame;
+
+    ~SkJpegEntropyIndex();
+
+private:
+    struct Checkpoint {
+        uint32_t fMcuRow;
+        // The offset of the byte holding the first bit of the row, and the index of that bit,
+        // counting from the most significant.
+        uint64_t fOffset;
+        uint32_t fBit;
+        // The number of restart intervals before the row.
+        uint32_t fInterval;
+        int16_t fPredictors[4];
+    };
+
+    SkJpegEntropyIndex(std::unique_ptr<Frame>, int mcuRowsPerCheckpoint, size_t dataSize,
+                       size_t entropyEnd, std::vector<Checkpoint>);
+
+    // Write a band from start to the end of the MCU row before lastMcuRow, or nullptr if start
+    // cannot be used. The band ends at end, or at the end of the data if end is null.
+    sk_sp<SkData> makeBand(SkSpan<const uint8_t> data, const Checkpoint& start,
+                           const Checkpoint* end, int top, int lastMcuRow, int* rowsToSkip) const;
+
+    std::unique_ptr<Frame> fFrame;
+    const int fMcuRowsPerCheckpoint;
+    const size_t fDataSize;
+    // The end of the entropy-coded data, after its last bit.
+    const size_t fEntropyEnd;
+    // The checkpoints, in order of rows. When the image has restart intervals, only rows that
+    // start a restart interval have checkpoints.
+    const std::vector<Checkpoint> fCheckpoints;
+};
+
+#endif
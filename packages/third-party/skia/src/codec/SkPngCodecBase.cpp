@@ -46,6 +46,8 @@ skcms_PixelFormat ToPixelFormat(const SkEncodedInfo& info) {
         } else if (SkEncodedInfo::kRGB_Color == info.color()) {
             return skcms_PixelFormat_RGB_161616BE;
         }
+    } else if (SkEncodedInfo::kRGB_Color == info.color()) {
+        return skcms_PixelFormat_RGB_888;
     } else if (SkEncodedInfo::kGray_Color == info.color()) {
         return skcms_PixelFormat_G_8;
     }
@@ -53,6 +55,31 @@ skcms_PixelFormat ToPixelFormat(const SkEncodedInfo& info) {
     return skcms_PixelFormat_RGBA_8888;
 }
 
+// The format in which skcms reads the decoded rows directly, if there is one. Such rows are
+// swizzled, sampled and color transformed in one pass.
+std::optional<skcms_PixelFormat> xform_src_format(const SkEncodedInfo& info) {
+    const int bitsPerComponent = info.bitsPerComponent();
+    switch (info.color()) {
+        case SkEncodedInfo::kRGB_Color:
+            if (8 == bitsPerComponent) { return skcms_PixelFormat_RGB_888; }
+            if (16 == bitsPerComponent) { return skcms_PixelFormat_RGB_161616BE; }
+            break;
+        case SkEncodedInfo::kRGBA_Color:
+            if (8 == bitsPerComponent) { return skcms_PixelFormat_RGBA_8888; }
+            if (16 == bitsPerComponent) { return skcms_PixelFormat_RGBA_16161616BE; }
+            break;
+        case SkEncodedInfo::kGray_Color:
+            if (8 == bitsPerComponent) { return skcms_PixelFormat_G_8; }
+            break;
+        case SkEncodedInfo::kGrayAlpha_Color:
+            if (8 == bitsPerComponent) { return skcms_PixelFormat_GA_88; }
+            break;
+        default:
+            break;
+    }
+    return std::nullopt;
+}
+
 }  // namespace
 
 SkPngCodecBase::~SkPngCodecBase() = default;
@@ -120,10 +147,6 @@ SkCodec::Result SkPngCodecBase::initializeXforms(const SkImageInfo& dstInfo,
     bool skipFormatConversion = false;
     switch (this->getEncodedInfo().color()) {
         case SkEncodedInfo::kRGB_Color:
-            if (this->getEncodedInfo().bitsPerComponent() != 16) {
-                break;
-            }
-            [[fallthrough]];
         case SkEncodedInfo::kRGBA_Color:
         case SkEncodedInfo::kGray_Color:
             skipFormatConversion = this->colorXform();
@@ -176,7 +199,8 @@ void SkPngCodecBase::allocateStorage(const SkImageInfo& dstInfo) {
             const int bitsPerPixel = this->getEncodedInfo().bitsPerPixel();
 
             // If we have more than 8-bits (per component) of precision, we will keep that
-            // extra precision.  Otherwise, we will swizzle to RGBA_8888 before transforming.
+            // extra precision.  Otherwise, we will swizzle to RGBA_8888 before transforming
+            // (or sample RGB_888, which needs less space).
             const size_t bytesPerPixel = (bitsPerPixel > 32) ? bitsPerPixel / 8 : 4;
             const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
             fStorage.reset(colorXformBytes);
@@ -189,10 +213,30 @@ SkCodec::Result SkPngCodecBase::initializeSwizzler(const SkImageInfo& dstInfo,
                                                    const Options& options,
                                                    bool skipFormatConversion,
                                                    int frameWidth) {
+    SkIRect frameRect = SkIRect::MakeWH(frameWidth, 1);
+    const SkIRect* frameRectPtr = nullptr;
+    if (options.fSubset) {
+        SkASSERT_RELEASE(frameWidth == dstInfo.width());
+    } else {
+        frameRectPtr = &frameRect;
+    }
+
     SkImageInfo swizzlerInfo = dstInfo;
     Options swizzlerOptions = options;
     fXformMode = kSwizzleOnly_XformMode;
-    if (this->colorXform() && this->xformOnDecode()) {
+    if (this->colorXform() && this->xformOnDecode() && !this->hasF16ColorTable(dstInfo)) {
+        if (std::optional<skcms_PixelFormat> srcFormat =
+                    xform_src_format(this->getEncodedInfo())) {
+            fSwizzler = SkSwizzler::MakeXform(*srcFormat,
+                                              SkCodecPriv::GetColorXform(this),
+                                              dstInfo,
+                                              options,
+                                              frameRectPtr);
+            if (fSwizzler) {
+                return kSuccess;
+            }
+        }
+
         if (SkEncodedInfo::kGray_Color == this->getEncodedInfo().color()) {
             swizzlerInfo = swizzlerInfo.makeColorType(kGray_8_SkColorType);
         } else {
@@ -210,22 +254,13 @@ SkCodec::Result SkPngCodecBase::initializeSwizzler(const SkImageInfo& dstInfo,
         swizzlerOptions.fZeroInitialized = kNo_ZeroInitialized;
     }
 
-    SkIRect frameRect = SkIRect::MakeWH(frameWidth, 1);
-    const SkIRect* frameRectPtr = nullptr;
-    if (options.fSubset) {
-        SkASSERT_RELEASE(frameWidth == dstInfo.width());
-    } else {
-        frameRectPtr = &frameRect;
-    }
-
     if (skipFormatConversion) {
         // We cannot skip format conversion when there is a color table.
         SkASSERT_RELEASE(!fColorTable);
         int srcBPP = 0;
         switch (this->getEncodedInfo().color()) {
             case SkEncodedInfo::kRGB_Color:
-                SkASSERT_RELEASE(this->getEncodedInfo().bitsPerComponent() == 16);
-                srcBPP = 6;
+                srcBPP = this->getEncodedInfo().bitsPerComponent() == 16 ? 6 : 3;
                 break;
             case SkEncodedInfo::kRGBA_Color:
                 srcBPP = this->getEncodedInfo().bitsPerComponent() / 2;
@@ -240,6 +275,9 @@ SkCodec::Result SkPngCodecBase::initializeSwizzler(const SkImageInfo& dstInfo,
         fSwizzler = SkSwizzler::MakeSimple(srcBPP, swizzlerInfo, swizzlerOptions, frameRectPtr);
     } else {
         const SkPMColor* colors = SkCodecPriv::GetColorPtr(fColorTable.get());
+        if (this->hasF16ColorTable(dstInfo)) {
+            colors = reinterpret_cast<const SkPMColor*>(fF16ColorTable.get());
+        }
         fSwizzler = SkSwizzler::Make(
                 this->getEncodedInfo(), colors, swizzlerInfo, swizzlerOptions, frameRectPtr);
     }
@@ -282,6 +320,12 @@ void SkPngCodecBase::applyXformRow(void* dstRow, const uint8_t* srcRow) {
     }
 }
 
+bool SkPngCodecBase::hasF16ColorTable(const SkImageInfo& dstInfo) const {
+    return SkEncodedInfo::kPalette_Color == this->getEncodedInfo().color() &&
+           this->colorXform() && this->xformOnDecode() &&
+           kRGBA_F16_SkColorType == dstInfo.colorType();
+}
+
 // Note: SkColorPalette claims to store SkPMColors, which is not necessarily the case here.
 bool SkPngCodecBase::createColorTable(const SkImageInfo& dstInfo) {
     if (fDstInfoOfPreviousColorTableCreation.has_value() &&
@@ -289,6 +333,7 @@ bool SkPngCodecBase::createColorTable(const SkImageInfo& dstInfo) {
         return !!fColorTable;
     }
     fColorTable.reset();
+    fF16ColorTable.reset();
     fDstInfoOfPreviousColorTableCreation = dstInfo;
 
     std::optional<SkSpan<const PaletteColorEntry>> maybePlteChunk = this->onTryGetPlteChunk();
@@ -314,9 +359,11 @@ bool SkPngCodecBase::createColorTable(const SkImageInfo& dstInfo) {
         numColorsWithAlpha = std::min(numColorsWithAlpha, numColors);
     }
 
+    // An F16 table is transformed from the unpremultiplied colors below, after padding.
+    const bool f16ColorTable = this->hasF16ColorTable(dstInfo);
     bool shouldApplyColorXformToColorTable = this->colorXform() && !this->xformOnDecode();
     if (alphas) {
-        bool premultiply = !shouldApplyColorXformToColorTable &&
+        bool premultiply = !shouldApplyColorXformToColorTable && !f16ColorTable &&
                            needs_premul(dstInfo.alphaType(), this->getEncodedInfo().alpha());
 
         // Choose which function to use to create the color table. If the final destination's
@@ -364,6 +411,13 @@ bool SkPngCodecBase::createColorTable(const SkImageInfo& dstInfo) {
         SkOpts::memset32(colorTable + numColors, lastColor, maxColors - numColors);
     }
 
+    if (f16ColorTable) {
+        // Transforming the palette once, rather than every pixel of every row, lets the
+        // swizzler write F16 pixels straight from the table.
+        fF16ColorTable.reset(maxColors);
+        this->applyColorXform(fF16ColorTable.get(), colorTable, maxColors);
+    }
+
     fColorTable.reset(new SkColorPalette(colorTable, maxColors));
     return true;
 }
@@ -84,8 +84,12 @@ private:
                               int frameWidth);
     bool createColorTable(const SkImageInfo& dstInfo);
 
+    // Whether a palette is decoded through fF16ColorTable, which holds the palette already
+    // transformed to the destination's color space.
+    bool hasF16ColorTable(const SkImageInfo& dstInfo) const;
+
     enum XformMode {
-        // Requires only a swizzle pass.
+        // Requires only a swizzle pass, which may also do the color xform.
         kSwizzleOnly_XformMode,
 
         // Requires only a color xform pass.
@@ -100,6 +104,7 @@ private:
     skia_private::AutoTMalloc<uint8_t> fStorage;
     int fXformWidth = -1;
     sk_sp<SkColorPalette> fColorTable;
+    skia_private::AutoTMalloc<uint64_t> fF16ColorTable;
 
     size_t fEncodedRowBytes = 0;  // Size of encoded/source row in bytes.
     size_t fDstRowBytes = 0;      // Size of destination row in bytes.
@@ -26,6 +26,7 @@
     #include "include/android/SkAndroidFrameworkUtils.h"
 #endif
 
+#include <algorithm>
 #include <cstring>
 
 static void copy(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
@@ -57,6 +58,17 @@ static void sample2(void* dst, const uint8_t* src, int width, int bpp, int delta
     }
 }
 
+static void sample3(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+    src += offset;
+    uint8_t* dst8 = (uint8_t*) dst;
+    for (int x = 0; x < width; x++) {
+        memcpy(dst8, src, 3);
+        dst8 += 3;
+        src += deltaSrc;
+    }
+}
+
 static void sample4(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
     src += offset;
@@ -88,6 +100,130 @@ static void sample8(void* dst, const uint8_t* src, int width, int bpp, int delta
     }
 }
 
+// Color transforming rows
+// skcms reads the source format and writes the destination format, so it swizzles, premultiplies
+// and transforms in one pass. Unsampled rows are transformed in place. Sampled pixels are first
+// gathered into a chunk that stays in L1, instead of into a row of scratch memory.
+
+// skcms_Transform() has a setup cost per call, which makes chunks much narrower than this
+// slower than a whole row.
+static constexpr int kXformChunkWidth = 1024;
+
+// Matches SkSwizzler::XformProc.
+typedef void (*XformProc)(void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src,
+                          int dstWidth, int deltaSrc, int offset,
+                          const SkCodecPriv::ColorXform& xform);
+
+static constexpr int xform_bytes_per_pixel(skcms_PixelFormat format) {
+    switch (format) {
+        case skcms_PixelFormat_G_8:             return 1;
+        case skcms_PixelFormat_GA_88:           return 2;
+        case skcms_PixelFormat_BGR_565:         return 2;
+        case skcms_PixelFormat_RGB_888:         return 3;
+        case skcms_PixelFormat_RGBA_8888:       return 4;
+        case skcms_PixelFormat_BGRA_8888:       return 4;
+        case skcms_PixelFormat_RGBA_1010102:    return 4;
+        case skcms_PixelFormat_BGR_101010x_XR:  return 4;
+        case skcms_PixelFormat_RGB_161616BE:    return 6;
+        case skcms_PixelFormat_RGBA_16161616BE: return 8;
+        case skcms_PixelFormat_RGBA_hhhh:       return 8;
+        default:                                return 0;
+    }
+}
+
+// kSampleX is the sample factor, or 0 if it is only known at runtime (from deltaSrc).
+template <skcms_PixelFormat kSrc, skcms_PixelFormat kDst, int kSampleX>
+static void xform_row(void* dst, const uint8_t* src, int width, int deltaSrc, int offset,
+                      const SkCodecPriv::ColorXform& xform) {
+    constexpr int kSrcBPP = xform_bytes_per_pixel(kSrc);
+    constexpr int kDstBPP = xform_bytes_per_pixel(kDst);
+    static_assert(kSrcBPP > 0 && kDstBPP > 0);
+    SkASSERT(kSampleX == 0 || deltaSrc == kSampleX * kSrcBPP);
+
+    auto transform = [&xform](void* dstPixels, const void* srcPixels, int count) {
+        SkAssertResult(skcms_Transform(srcPixels, kSrc, skcms_AlphaFormat_Unpremul,
+                                       xform.fSrcProfile, dstPixels, kDst,
+                                       xform.fDstAlphaFormat, xform.fDstProfile, count));
+    };
+
+    src += offset;
+    if constexpr (kSampleX == 1) {
+        transform(dst, src, width);
+    } else {
+        const int step = kSampleX > 0 ? kSampleX * kSrcBPP : deltaSrc;
+        // 16-bit formats need 16-bit alignment.
+        alignas(8) uint8_t chunk[kXformChunkWidth * kSrcBPP];
+        for (int x = 0; x < width; x += kXformChunkWidth) {
+            const int count = std::min(kXformChunkWidth, width - x);
+            for (int i = 0; i < count; i++) {
+                memcpy(chunk + i * kSrcBPP, src, kSrcBPP);
+                src += step;
+            }
+            transform(SkTAddOffset<void>(dst, x * kDstBPP), chunk, count);
+        }
+    }
+}
+
+// The procs for one pair of formats, indexed by xform_sample_index().
+template <skcms_PixelFormat kSrc, skcms_PixelFormat kDst>
+static constexpr XformProc kXformProcs[] = {
+    &xform_row<kSrc, kDst, 0>,
+    &xform_row<kSrc, kDst, 1>,
+    &xform_row<kSrc, kDst, 2>,
+    &xform_row<kSrc, kDst, 4>,
+    &xform_row<kSrc, kDst, 8>,
+};
+
+static int xform_sample_index(int sampleX) {
+    switch (sampleX) {
+        case 1:  return 1;
+        case 2:  return 2;
+        case 4:  return 3;
+        case 8:  return 4;
+        default: return 0;
+    }
+}
+
+template <skcms_PixelFormat kSrc>
+static const XformProc* choose_xform_procs(skcms_PixelFormat dst) {
+    switch (dst) {
+        case skcms_PixelFormat_RGBA_8888:
+            return kXformProcs<kSrc, skcms_PixelFormat_RGBA_8888>;
+        case skcms_PixelFormat_BGRA_8888:
+            return kXformProcs<kSrc, skcms_PixelFormat_BGRA_8888>;
+        case skcms_PixelFormat_BGR_565:
+            return kXformProcs<kSrc, skcms_PixelFormat_BGR_565>;
+        case skcms_PixelFormat_RGBA_hhhh:
+            return kXformProcs<kSrc, skcms_PixelFormat_RGBA_hhhh>;
+        case skcms_PixelFormat_RGBA_1010102:
+            return kXformProcs<kSrc, skcms_PixelFormat_RGBA_1010102>;
+        case skcms_PixelFormat_BGR_101010x_XR:
+            return kXformProcs<kSrc, skcms_PixelFormat_BGR_101010x_XR>;
+        default:
+            return nullptr;
+    }
+}
+
+static const XformProc* choose_xform_procs(skcms_PixelFormat src,
+                                                       skcms_PixelFormat dst) {
+    switch (src) {
+        case skcms_PixelFormat_G_8:
+            return choose_xform_procs<skcms_PixelFormat_G_8>(dst);
+        case skcms_PixelFormat_GA_88:
+            return choose_xform_procs<skcms_PixelFormat_GA_88>(dst);
+        case skcms_PixelFormat_RGB_888:
+            return choose_xform_procs<skcms_PixelFormat_RGB_888>(dst);
+        case skcms_PixelFormat_RGBA_8888:
+            return choose_xform_procs<skcms_PixelFormat_RGBA_8888>(dst);
+        case skcms_PixelFormat_RGB_161616BE:
+            return choose_xform_procs<skcms_PixelFormat_RGB_161616BE>(dst);
+        case skcms_PixelFormat_RGBA_16161616BE:
+            return choose_xform_procs<skcms_PixelFormat_RGBA_16161616BE>(dst);
+        default:
+            return nullptr;
+    }
+}
+
 // kBit
 // These routines exclusively choose between white and black
 
@@ -240,6 +376,28 @@ static void swizzle_small_index_to_n32(
     }
 }
 
+static void swizzle_small_index_to_f16(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
+        int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
+
+    uint64_t* dst = (uint64_t*) dstRow;
+    const uint64_t* colors = (const uint64_t*) ctable;
+    src += offset / 8;
+    int bitIndex = offset % 8;
+    uint8_t currByte = *src;
+    const uint8_t mask = (1 << bpp) - 1;
+    uint8_t index = (currByte >> (8 - bpp - bitIndex)) & mask;
+    dst[0] = colors[index];
+
+    for (int x = 1; x < dstWidth; x++) {
+        int bitOffset = bitIndex + deltaSrc;
+        bitIndex = bitOffset % 8;
+        currByte = *(src += bitOffset / 8);
+        index = (currByte >> (8 - bpp - bitIndex)) & mask;
+        dst[x] = colors[index];
+    }
+}
+
 // kIndex
 
 static void swizzle_index_to_n32(
@@ -281,6 +439,19 @@ static void swizzle_index_to_565(
     }
 }
 
+static void swizzle_index_to_f16(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
+        int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
+
+    src += offset;
+    uint64_t* SK_RESTRICT dst = (uint64_t*)dstRow;
+    const uint64_t* colors = (const uint64_t*)ctable;
+    for (int x = 0; x < dstWidth; x++) {
+        dst[x] = colors[*src];
+        src += deltaSrc;
+    }
+}
+
 // kGray
 
 static void swizzle_gray_to_n32(
@@ -801,6 +972,9 @@ std::unique_ptr<SkSwizzler> SkSwizzler::MakeSimple(int srcBPP,
         case 2:     // kRGB_565_SkColorType
             proc = &sample2;
             break;
+        case 3:     // 8 bit PNG no alpha
+            proc = &sample3;
+            break;
         case 4:     // kRGBA_8888_SkColorType
                     // kBGRA_8888_SkColorType
                     // kRGBA_1010102_SkColorType
@@ -826,6 +1000,30 @@ std::unique_ptr<SkSwizzler> SkSwizzler::MakeSimple(int srcBPP,
                 frame);
 }
 
+std::unique_ptr<SkSwizzler> SkSwizzler::MakeXform(skcms_PixelFormat srcFormat,
+                                                  const SkCodecPriv::ColorXform& xform,
+                                                  const SkImageInfo& dstInfo,
+                                                  const SkCodec::Options& options,
+                                                  const SkIRect* frame) {
+    const XformProc* procs = choose_xform_procs(srcFormat, xform.fDstFormat);
+    if (!procs) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkSwizzler> swizzler = Make(dstInfo,
+                                                nullptr /*fastProc*/,
+                                                nullptr /*proc*/,
+                                                nullptr /*ctable*/,
+                                                xform_bytes_per_pixel(srcFormat),
+                                                dstInfo.bytesPerPixel(),
+                                                options,
+                                                frame);
+    swizzler->fXformProcs = procs;
+    swizzler->fActualXformProc = procs[xform_sample_index(1)];
+    swizzler->fColorXform = xform;
+    return swizzler;
+}
+
 std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                                              const SkPMColor* ctable,
                                              const SkImageInfo& dstInfo,
@@ -934,6 +1132,9 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                         case kRGB_565_SkColorType:
                             proc = &swizzle_small_index_to_565;
                             break;
+                        case kRGBA_F16_SkColorType:
+                            proc = &swizzle_small_index_to_f16;
+                            break;
                         default:
                             return nullptr;
                     }
@@ -952,6 +1153,9 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                         case kRGB_565_SkColorType:
                             proc = &swizzle_index_to_565;
                             break;
+                        case kRGBA_F16_SkColorType:
+                            proc = &swizzle_index_to_f16;
+                            break;
                         default:
                             return nullptr;
                     }
@@ -1248,12 +1452,20 @@ int SkSwizzler::onSetSampleX(int sampleX) {
     } else {
         fActualProc = fSlowProc;
     }
+    if (fXformProcs) {
+        fActualXformProc = fXformProcs[xform_sample_index(fSampleX)];
+    }
 
     return fAllocatedWidth;
 }
 
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
+    if (fActualXformProc) {
+        fActualXformProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth,
+                         fSampleX * fSrcBPP, fSrcOffsetUnits, fColorXform);
+        return;
+    }
     fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
             fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
 }
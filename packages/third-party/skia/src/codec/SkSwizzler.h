@@ -11,6 +11,8 @@
 #include "include/codec/SkCodec.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkTypes.h"
+#include "modules/skcms/skcms.h"
+#include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkSampler.h"
 
 #include <cstddef>
@@ -33,6 +35,8 @@ public:
      *                2) in the `dstInfo`-requested RGBA vs BGRA order
      *                (this requirement can be met by building the entires using
      *                `SkCodecPriv::ChoosePackColorProc`).
+     *                For a kRGBA_F16 `dstInfo`, the entries are instead F16
+     *                colors (uint64_t), already in the destination's color space.
      *  @param dstInfo Describes the destination.
      *  @param options Contains partial scanline information and whether the dst is zero-
      *                 initialized.
@@ -64,6 +68,26 @@ public:
                                                   const SkCodec::Options&,
                                                   const SkIRect* frame = nullptr);
 
+    /**
+     *  Create a swizzler that color transforms each pixel as it swizzles it. The swizzle,
+     *  sampling, premultiplication and transform are done in one pass: skcms reads the encoded
+     *  pixels, or when sampling, chunks of the sampled pixels small enough to stay in cache.
+     *  The row procs are specialized for each source format, destination format and common
+     *  sample factor.
+     *
+     *  @param srcFormat The skcms format of the encoded pixels. They are unpremultiplied.
+     *  @param xform     The transform to the destination, from SkCodecPriv::GetColorXform().
+     *  @param dstInfo   Describes the destination.
+     *  @param options   Contains partial scanline information and whether the dst is zero-
+     *                   initialized.
+     *  @return A new SkSwizzler, or nullptr if either format is not supported.
+     */
+    static std::unique_ptr<SkSwizzler> MakeXform(skcms_PixelFormat srcFormat,
+                                                 const SkCodecPriv::ColorXform& xform,
+                                                 const SkImageInfo& dstInfo,
+                                                 const SkCodec::Options&,
+                                                 const SkIRect* frame = nullptr);
+
     /**
      *  Swizzle a line. Generally this will be called height times, once
      *  for each row of source.
@@ -131,14 +155,29 @@ private:
     static void SkipLeadingGrayAlphaZerosThen(void* dst, const uint8_t* src, int width, int bpp,
                                               int deltaSrc, int offset, const SkPMColor ctable[]);
 
+    /**
+     *  Method for color transforming raw data into Skia pixels. The arguments are as for
+     *  RowProc, with the transform in place of the color table.
+     */
+    typedef void (*XformProc)(void* SK_RESTRICT dstRow,
+                              const uint8_t* SK_RESTRICT src,
+                              int dstWidth, int deltaSrc, int offset,
+                              const SkCodecPriv::ColorXform& xform);
+
     // May be NULL.  We have not implemented optimized functions for all supported transforms.
     const RowProc       fFastProc;
-    // Always non-NULL.  Supports sampling.
+    // Non-NULL unless this swizzler color transforms.  Supports sampling.
     const RowProc       fSlowProc;
     // The actual RowProc we are using.  This depends on if fFastProc is non-NULL and
     // whether or not we are sampling.
     RowProc             fActualProc;
 
+    // Set by MakeXform(). The procs for the source and destination formats, indexed by sample
+    // factor, and the one that fSampleX selects.
+    const XformProc*        fXformProcs = nullptr;
+    XformProc               fActualXformProc = nullptr;
+    SkCodecPriv::ColorXform fColorXform = {};
+
     const SkPMColor*    fColorTable;      // Unowned pointer
 
     // Subset Swizzles
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkThumbnail.h"
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/encode/SkEncoder.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTPin.h"
+#include "src/base/SkVx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// The Mitchell-Netravali cubic with B = C = 1/3, as in SkCubicResampler::Mitchell().
+float mitchell(float x) {
+    constexpr float B = 1 / 3.f, C = 1 / 3.f;
+    x = std::abs(x);
+    if (x < 1) {
+        return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) /
+               6;
+    }
+    if (x < 2) {
+        return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x +
+                (8 * B + 24 * C)) /
+               6;
+    }
+    return 0;
+}
+
+// The taps of a polyphase filter along one axis. Destination pixel i is the weighted sum of the
+// fTaps source pixels that start at fStarts[i]. Taps past the edges are folded onto the edge.
+struct Filter {
+    int fTaps = 0;
+    std::vector<int> fStarts;
+    std::vector<float> fWeights;
+
+    const float* weights(int i) const { return fWeights.data() + i * fTaps; }
+};
+
+Filter make_filter(int srcSize, int dstSize) {
+    // When shrinking, the kernel is stretched to cover every source pixel under the destination
+    // pixel, so it filters as well as interpolates.
+    const float scale = static_cast<float>(srcSize) / dstSize;
+    const float stretch = std::max(scale, 1.f);
+    const float radius = 2 * stretch;
+
+    Filter filter;
+    filter.fTaps = std::min(static_cast<int>(std::ceil(2 * radius)) + 1, srcSize);
+    filter.fStarts.resize(dstSize);
+    filter.fWeights.assign(static_cast<size_t>(dstSize) * filter.fTaps, 0.f);
+    for (int i = 0; i < dstSize; i++) {
+        const float center = (i + 0.5f) * scale;
+        const int first = static_cast<int>(std::ceil(center - radius - 0.5f));
+        const int last = static_cast<int>(std::floor(center + radius - 0.5f));
+        const int start = SkTPin(first, 0, srcSize - filter.fTaps);
+        filter.fStarts[i] = start;
+
+        float* weights = filter.fWeights.data() + static_cast<size_t>(i) * filter.fTaps;
+        float sum = 0;
+        for (int j = first; j <= last; j++) {
+            const float w = mitchell((j + 0.5f - center) / stretch);
+            const int tap = SkTPin(j, 0, srcSize - 1) - start;
+            SkASSERT(0 <= tap && tap < filter.fTaps);
+            weights[tap] += w;
+            sum += w;
+        }
+        for (int t = 0; t < filter.fTaps; t++) {
+            weights[t] /= sum;
+        }
+    }
+    return filter;
+}
+
+// Choose the smallest size the codec can decode to natively that still covers dstSize.
+SkISize choose_decode_size(SkCodec* codec, SkISize dstSize) {
+    for (int eighths = 1; eighths < 8; eighths++) {
+        const SkISize size = codec->getScaledDimensions(eighths / 8.f);
+        if (size.width() >= dstSize.width() && size.height() >= dstSize.height()) {
+            return size;
+        }
+    }
+    return codec->dimensions();
+}
+
+void filter_horizontally(const uint32_t* src, const Filter& filter, skvx::float4* dst) {
+    for (size_t x = 0; x < filter.fStarts.size(); x++) {
+        const uint32_t* pixels = src + filter.fStarts[x];
+        const float* weights = filter.weights(x);
+        skvx::float4 sum = 0;
+        for (int t = 0; t < filter.fTaps; t++) {
+            sum += weights[t] * skvx::cast<float>(skvx::byte4::Load(pixels + t));
+        }
+        dst[x] = sum * (1 / 255.f);
+    }
+}
+
+}  // namespace
+
+namespace SkThumbnail {
+
+bool Encode(SkCodec* codec, SkISize dstSize, SkWStream* dst, const EncoderFactory& makeEncoder) {
+    if (!codec || !dst || !makeEncoder || dstSize.isEmpty()) {
+        return false;
+    }
+
+    const bool opaque = codec->getInfo().isOpaque();
+    const SkImageInfo dstInfo =
+            SkImageInfo::Make(dstSize,
+                              kN32_SkColorType,
+                              opaque ? kOpaque_SkAlphaType : kPremul_SkAlphaType,
+                              codec->getInfo().refColorSpace());
+
+    SkImageInfo srcInfo = dstInfo.makeDimensions(choose_decode_size(codec, dstSize));
+    bool scanlines = SkCodec::kSuccess == codec->startScanlineDecode(srcInfo);
+    if (!scanlines && srcInfo.dimensions() != codec->dimensions()) {
+        srcInfo = srcInfo.makeDimensions(codec->dimensions());
+        scanlines = SkCodec::kSuccess == codec->startScanlineDecode(srcInfo);
+    }
+
+    // Only used when the rows cannot be decoded one at a time from the top.
+    SkBitmap decoded;
+    if (!scanlines || codec->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder) {
+        scanlines = false;
+        if (!decoded.tryAllocPixels(srcInfo)) {
+            return false;
+        }
+        switch (codec->getPixels(decoded.pixmap())) {
+            case SkCodec::kSuccess:
+            case SkCodec::kIncompleteInput:
+            case SkCodec::kErrorInInput:
+                break;
+            default:
+                return false;
+        }
+    }
+
+    const int width = dstSize.width();
+    const Filter filterX = make_filter(srcInfo.width(), width);
+    const Filter filterY = make_filter(srcInfo.height(), dstSize.height());
+
+    // The source rows under the vertical filter, already filtered horizontally. Source row y is
+    // kept in slot y % filterY.fTaps.
+    std::vector<skvx::float4> window(static_cast<size_t>(filterY.fTaps) * width);
+    std::vector<skvx::float4> sums(width);
+    std::vector<uint32_t> srcRow(scanlines ? srcInfo.width() : 0);
+    std::vector<uint32_t> dstRow(width);
+
+    // The encoder reads the size and color info of the thumbnail from this; the rows themselves
+    // are passed one at a time through row.
+    const SkPixmap thumbnail(dstInfo, dstRow.data(), dstInfo.minRowBytes());
+    const SkPixmap row(dstInfo.makeDimensions({width, 1}), dstRow.data(), dstInfo.minRowBytes());
+    std::unique_ptr<SkEncoder> encoder = makeEncoder(dst, thumbnail);
+    if (!encoder) {
+        return false;
+    }
+
+    int nextSrcY = 0;
+    for (int y = 0; y < dstSize.height(); y++) {
+        const int start = filterY.fStarts[y];
+        for (; nextSrcY < start + filterY.fTaps; nextSrcY++) {
+            const uint32_t* src;
+            if (scanlines) {
+                // A short read has already been filled in by the codec.
+                codec->getScanlines(srcRow.data(), 1, srcInfo.minRowBytes());
+                src = srcRow.data();
+            } else {
+                src = decoded.getAddr32(0, nextSrcY);
+            }
+            filter_horizontally(
+                    src, filterX, window.data() + (nextSrcY % filterY.fTaps) * width);
+        }
+
+        const float* weights = filterY.weights(y);
+        std::fill(sums.begin(), sums.end(), skvx::float4(0));
+        for (int t = 0; t < filterY.fTaps; t++) {
+            const skvx::float4* filtered =
+                    window.data() + ((start + t) % filterY.fTaps) * width;
+            for (int x = 0; x < width; x++) {
+                sums[x] += weights[t] * filtered[x];
+            }
+        }
+
+        for (int x = 0; x < width; x++) {
+            // The negative lobes of the filter can overshoot, and premultiplied colors must not
+            // exceed their alpha.
+            skvx::float4 color = skvx::max(sums[x], 0);
+            const float alpha = opaque ? 1 : std::min(color[3], 1.f);
+            color = skvx::min(color, alpha);
+            color[3] = alpha;
+            skvx::cast<uint8_t>(color * 255 + 0.5f).store(dstRow.data() + x);
+        }
+
+        if (!encoder->encodeRows(row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace SkThumbnail
@@ -195,8 +195,10 @@ bool SkWebpCodec::ensureAllData() {
     if (fOnlyHeaderParsed) {
         SkDynamicMemoryWStream newData;
         newData.write(fData->data(), fData->size());
+        newData.write(fStreamedData.data(), fStreamedData.size());
         SkStreamPriv::Copy(&newData, this->stream());
         fData = newData.detachAsData();
+        fStreamedData = {};
         fOnlyHeaderParsed = false;
 
         WebPData webpData = { fData->bytes(), fData->size() };
@@ -766,6 +768,159 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     return result;
 }
 
+struct SkWebpCodec::IncrementalDecode {
+    ~IncrementalDecode() {
+        // The decoder refers to fConfig.output, so it must go first.
+        fDecoder.reset();
+        WebPFreeDecBuffer(&fConfig.output);
+    }
+
+    WebPDecoderConfig fConfig;
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> fDecoder;
+    VP8StatusCode fStatus = VP8_STATUS_SUSPENDED;
+
+    // libwebp decodes here when the color transform cannot be applied in place.
+    SkBitmap fBuffer;
+
+    void*  fDst = nullptr;
+    size_t fRowBytes = 0;
+    int    fRowsOutput = 0;
+};
+
+SkCodec::Result SkWebpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    fIncremental.reset();
+
+    // Animation frames are composed by onGetPixels(), which also handles subsets.
+    if (options.fSubset || (WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS) & ANIMATION_FLAG)) {
+        return kUnimplemented;
+    }
+
+    auto incremental = std::make_unique<IncrementalDecode>();
+    WebPDecoderConfig& config = incremental->fConfig;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    if (!WebPDemuxGetFrame(fDemux, 1, &frame)) {
+        return kInvalidInput;
+    }
+
+    if (dstInfo.dimensions() != this->dimensions()) {
+        config.options.use_scaling = 1;
+        config.options.scaled_width = dstInfo.width();
+        config.options.scaled_height = dstInfo.height();
+    }
+
+    // As in onGetPixels(), for a single frame that covers the canvas.
+    auto webpInfo = dstInfo;
+    if (!frame.has_alpha) {
+        webpInfo = webpInfo.makeAlphaType(kOpaque_SkAlphaType);
+    } else if (this->colorXform()) {
+        webpInfo = webpInfo.makeAlphaType(kUnpremul_SkAlphaType);
+    }
+    if (this->colorXform()) {
+        webpInfo = webpInfo.makeColorType(kBGRA_8888_SkColorType);
+    }
+
+    SkPixmap webpDst(webpInfo, dst, rowBytes);
+    if (this->colorXform() && !is_8888(dstInfo.colorType())) {
+        if (!incremental->fBuffer.tryAllocPixels(webpInfo)) {
+            return kInternalError;
+        }
+        webpDst = incremental->fBuffer.pixmap();
+    }
+
+    config.output.colorspace = webp_decode_mode(webpInfo.colorType(),
+            webpInfo.alphaType() == kPremul_SkAlphaType);
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = static_cast<uint8_t*>(webpDst.writable_addr());
+    config.output.u.RGBA.stride = static_cast<int>(webpDst.rowBytes());
+    config.output.u.RGBA.size = webpDst.computeByteSize();
+
+    incremental->fDecoder.reset(WebPIDecode(nullptr, 0, &config));
+    if (!incremental->fDecoder) {
+        return kInvalidInput;
+    }
+
+    // Start with the data read so far. Unless only the header has been read, that is all of it.
+    WebPIDecoder* decoder = incremental->fDecoder.get();
+    VP8StatusCode status;
+    if (fOnlyHeaderParsed) {
+        status = WebPIAppend(decoder, fData->bytes(), fData->size());
+        if (status == VP8_STATUS_SUSPENDED && !fStreamedData.empty()) {
+            status = WebPIAppend(decoder, fStreamedData.data(), fStreamedData.size());
+        }
+    } else {
+        status = WebPIUpdate(decoder, fData->bytes(), fData->size());
+    }
+    if (status != VP8_STATUS_OK && status != VP8_STATUS_SUSPENDED) {
+        return kInvalidInput;
+    }
+
+    incremental->fStatus = status;
+    incremental->fDst = dst;
+    incremental->fRowBytes = rowBytes;
+    fIncremental = std::move(incremental);
+    return kSuccess;
+}
+
+SkCodec::Result SkWebpCodec::onIncrementalDecode(int* rowsDecoded) {
+    SkASSERT(fIncremental);
+    IncrementalDecode& incremental = *fIncremental;
+    WebPIDecoder* decoder = incremental.fDecoder.get();
+
+    // Hand libwebp whatever the stream has now. It is kept, as the rest of the codec expects
+    // fData and the stream together to hold the whole image.
+    if (incremental.fStatus == VP8_STATUS_SUSPENDED && fOnlyHeaderParsed && this->stream()) {
+        constexpr size_t kBufferSize = 4096;
+        uint8_t buffer[kBufferSize];
+        while (incremental.fStatus == VP8_STATUS_SUSPENDED) {
+            const size_t bytesRead = this->stream()->read(buffer, kBufferSize);
+            if (bytesRead == 0) {
+                break;
+            }
+            fStreamedData.insert(fStreamedData.end(), buffer, buffer + bytesRead);
+            incremental.fStatus = WebPIAppend(decoder, buffer, bytesRead);
+        }
+    }
+
+    const int height = this->dstInfo().height();
+    int lastY = 0;
+    if (incremental.fStatus == VP8_STATUS_OK) {
+        lastY = height;
+    } else {
+        WebPIDecGetRGB(decoder, &lastY, nullptr, nullptr, nullptr);
+        lastY = std::clamp(lastY, 0, height);
+    }
+
+    // libwebp never revisits the rows above lastY, so they can be color transformed now.
+    if (this->colorXform()) {
+        const WebPRGBABuffer& rgba = incremental.fConfig.output.u.RGBA;
+        for (int y = incremental.fRowsOutput; y < lastY; y++) {
+            this->applyColorXform(SkTAddOffset<void>(incremental.fDst, y * incremental.fRowBytes),
+                                  SkTAddOffset<const void>(rgba.rgba, y * rgba.stride),
+                                  this->dstInfo().width());
+        }
+    }
+    incremental.fRowsOutput = lastY;
+    if (rowsDecoded) {
+        *rowsDecoded = lastY;
+    }
+
+    switch (incremental.fStatus) {
+        case VP8_STATUS_OK:
+            return kSuccess;
+        case VP8_STATUS_SUSPENDED:
+            return kIncompleteInput;
+        default:
+            return kErrorInInput;
+    }
+}
+
 SkWebpCodec::SkWebpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
                          WebPDemuxer* demux, sk_sp<SkData> data, SkEncodedOrigin origin,
                          bool onlyHeaderParsed)
@@ -780,6 +935,8 @@ SkWebpCodec::SkWebpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
     fFrameHolder.setScreenSize(eInfo.width(), eInfo.height());
 }
 
+SkWebpCodec::~SkWebpCodec() = default;
+
 namespace SkWebpDecoder {
 bool IsWebp(const void* data, size_t len) {
     return SkWebpCodec::IsWebp(data, len);
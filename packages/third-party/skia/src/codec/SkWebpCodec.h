@@ -19,6 +19,7 @@
 #include "src/codec/SkScalingCodec.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -39,6 +40,9 @@ public:
     static bool IsWebp(const void*, size_t);
 protected:
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, int*) override;
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                    const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
     SkEncodedImageFormat onGetEncodedFormat() const override { return SkEncodedImageFormat::kWEBP; }
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
@@ -56,6 +60,7 @@ protected:
 private:
     SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, WebPDemuxer*, sk_sp<SkData>,
                 SkEncodedOrigin, bool);
+    ~SkWebpCodec() override;
     // Reads the rest of the data from this codec's 'fStream' if necessary,
     // else does nothing, returns true on success.
     bool ensureAllData();
@@ -66,6 +71,13 @@ private:
     // This should not be freed until the decode is completed.
     sk_sp<SkData> fData;
 
+    // The data that incremental decodes have read from 'fStream', which follows fData.
+    std::vector<uint8_t> fStreamedData;
+
+    // The libwebp incremental decoder, while an incremental decode is underway.
+    struct IncrementalDecode;
+    std::unique_ptr<IncrementalDecode> fIncremental;
+
     class Frame : public SkFrame {
     public:
         Frame(int i, SkEncodedInfo::Alpha alpha)
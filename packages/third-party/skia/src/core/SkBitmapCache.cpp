@@ -44,7 +44,7 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID) {
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(uint32_t imageID, const SkIRect& subset) {
     SkASSERT(imageID);
     SkASSERT(subset.width() > 0 && subset.height() > 0);
-    return { imageID, subset };
+    return { imageID, subset, {0, 0} };
 }
 
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
@@ -52,6 +52,13 @@ SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
     return Make(image->uniqueID(), bounds);
 }
 
+SkBitmapCacheDesc SkBitmapCacheDesc::MakeScaled(const SkImage* image, SkISize scaledSize) {
+    SkASSERT(!scaledSize.isEmpty());
+    SkBitmapCacheDesc desc = Make(image);
+    desc.fScaledSize = scaledSize;
+    return desc;
+}
+
 namespace {
 static unsigned gBitmapKeyNamespaceLabel;
 
@@ -110,6 +117,7 @@ public:
         SkAssertResult(this->install(static_cast<SkBitmap*>(payload)));
     }
 
+    Tier getTier() const override { return Tier::kImage; }
     const char* getCategory() const override { return "bitmap"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fDM.get();
@@ -187,9 +195,10 @@ void SkBitmapCache::PrivateDeleteRec(Rec* rec) { delete rec; }
 
 SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
                                            SkPixmap* pmap) {
-    // Ensure that the info matches the subset (i.e. the subset is the entire image)
-    SkASSERT(info.width() == desc.fSubset.width());
-    SkASSERT(info.height() == desc.fSubset.height());
+    // Ensure that the info matches the subset (i.e. the subset is the entire image), or the size
+    // it was decoded at.
+    SkASSERT(info.dimensions() == (desc.fScaledSize.isZero() ? desc.fSubset.size()
+                                                             : desc.fScaledSize));
 
     const size_t rb = info.minRowBytes();
     size_t size = info.computeByteSize(rb);
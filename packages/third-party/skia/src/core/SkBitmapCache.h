@@ -9,6 +9,7 @@
 #define SkBitmapCache_DEFINED
 
 #include "include/core/SkRect.h"
+#include "include/core/SkSize.h"
 #include "include/private/base/SkAssert.h"
 
 #include <cstdint>
@@ -29,15 +30,19 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID);
 struct SkBitmapCacheDesc {
     uint32_t    fImageID;       // != 0
     SkIRect     fSubset;        // always set to a valid rect (entire or subset)
+    SkISize     fScaledSize;    // zero unless the subset was decoded at a reduced size
 
     void validate() const {
         SkASSERT(fImageID);
         SkASSERT(fSubset.fLeft >= 0 && fSubset.fTop >= 0);
         SkASSERT(fSubset.width() > 0 && fSubset.height() > 0);
+        SkASSERT(fScaledSize.isZero() || !fScaledSize.isEmpty());
     }
 
     static SkBitmapCacheDesc Make(const SkImage*);
     static SkBitmapCacheDesc Make(uint32_t genID, const SkIRect& subset);
+    // The whole image, decoded at scaledSize rather than at its own dimensions.
+    static SkBitmapCacheDesc MakeScaled(const SkImage*, SkISize scaledSize);
 };
 
 class SkBitmapCache {
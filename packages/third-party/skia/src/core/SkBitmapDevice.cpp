@@ -22,23 +22,30 @@
 #include "include/core/SkRSXform.h"
 #include "include/core/SkRasterHandleAllocator.h"
 #include "include/core/SkRegion.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTileMode.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkCPURecorderImpl.h"
 #include "src/core/SkDraw.h"
+#include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImagePriv.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkMipmapAccessor.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/image/SkImage_Base.h"
 #include "src/text/GlyphRun.h"
 
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <utility>
 
 class SkVertices;
@@ -85,7 +92,7 @@ public:
         fDone = false;
 
         // we need fDst to be set, and if we're actually drawing, to dirty the genID
-        if (!fDevice->accessPixels(&fRootPixmap)) {
+        if (!fDevice->accessPixelsForDraw(&fRootPixmap, bounds)) {
             // NoDrawDevice uses us (why?) so we have to catch this case w/ no pixels
             fRootPixmap.reset(fDevice->imageInfo(), nullptr, 0);
         }
@@ -206,7 +213,7 @@ class SkBitmapDevice::BDDraw : public skcpu::Draw {
 public:
     BDDraw(SkBitmapDevice* dev) {
         // we need fDst to be set, and if we're actually drawing, to dirty the genID
-        if (!dev->accessPixels(&fDst)) {
+        if (!dev->accessPixelsForDraw(&fDst, nullptr)) {
             // NoDrawDevice uses us (why?) so we have to catch this case w/ no pixels
             fDst.reset(dev->imageInfo(), nullptr, 0);
         }
@@ -215,6 +222,101 @@ public:
     }
 };
 
+// Keeps the last few backdrop filters evaluated from the device. Draws mark the entries whose input
+// pixels they may have changed. A marked entry is still reused if its input turns out to have been
+// redrawn with the same values, which is checked against a copy kept with the entry; comparing the
+// pixels is much cheaper than filtering them again.
+class SkBitmapDevice::BackdropCache {
+public:
+    static constexpr int kMaxEntries = 4;
+    // Inputs larger than this are not worth keeping a copy of.
+    static constexpr int64_t kMaxInputPixels = 1 << 20;
+
+    void markDirty(const SkIRect& bounds) {
+        for (Entry& entry : fEntries) {
+            entry.fDirty |= SkIRect::Intersects(entry.fKey.fSrcSubset, bounds);
+        }
+    }
+
+    bool find(const BackdropKey& key, const SkPixmap& devicePixels, skif::FilterResult* result) {
+        for (int i = 0; i < fEntries.size(); ++i) {
+            if (!(fEntries[i].fKey == key)) {
+                continue;
+            }
+            if (fEntries[i].fDirty) {
+                SkPixmap current;
+                if (!devicePixels.extractSubset(&current, key.fSrcSubset) ||
+                    !same_pixels(current, fEntries[i].fInput.pixmap())) {
+                    this->remove(i);
+                    return false;
+                }
+                fEntries[i].fDirty = false;
+            }
+            *result = fEntries[i].fResult;
+            // Move the entry to the back, which is evicted last.
+            for (; i < fEntries.size() - 1; ++i) {
+                std::swap(fEntries[i], fEntries[i + 1]);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void add(const BackdropKey& key, const SkPixmap& devicePixels,
+             const skif::FilterResult& result) {
+        if (key.fSrcSubset.width64() * key.fSrcSubset.height64() > kMaxInputPixels) {
+            return;
+        }
+        SkPixmap subset;
+        SkBitmap input;
+        if (!devicePixels.extractSubset(&subset, key.fSrcSubset) ||
+            !input.tryAllocPixels(subset.info()) ||
+            !subset.readPixels(input.pixmap())) {
+            return;
+        }
+        input.setImmutable();
+
+        for (int i = 0; i < fEntries.size(); ++i) {
+            if (fEntries[i].fKey == key) {
+                this->remove(i);
+                break;
+            }
+        }
+        if (fEntries.size() == kMaxEntries) {
+            this->remove(0);
+        }
+        fEntries.push_back({key, std::move(input), result, /*fDirty=*/false});
+    }
+
+private:
+    // Keeps the order of the other entries, oldest first.
+    void remove(int i) {
+        for (; i < fEntries.size() - 1; ++i) {
+            std::swap(fEntries[i], fEntries[i + 1]);
+        }
+        fEntries.pop_back();
+    }
+
+    static bool same_pixels(const SkPixmap& a, const SkPixmap& b) {
+        SkASSERT(a.dimensions() == b.dimensions() && a.colorType() == b.colorType());
+        const size_t rowBytes = a.info().minRowBytes();
+        for (int y = 0; y < a.height(); ++y) {
+            if (memcmp(a.addr(0, y), b.addr(0, y), rowBytes) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Entry {
+        BackdropKey        fKey;
+        SkBitmap           fInput;
+        skif::FilterResult fResult;
+        bool               fDirty;
+    };
+    skia_private::STArray<kMaxEntries, Entry> fEntries;
+};
+
 static bool valid_for_bitmap_device(const SkImageInfo& info,
                                     SkAlphaType* newAlphaType) {
     if (info.width() < 0 || info.height() < 0 || kUnknown_SkColorType == info.colorType()) {
@@ -259,6 +361,8 @@ SkBitmapDevice::SkBitmapDevice(skcpu::RecorderImpl* recorder,
     SkASSERT(valid_for_bitmap_device(bitmap.info(), nullptr));
 }
 
+SkBitmapDevice::~SkBitmapDevice() = default;
+
 sk_sp<SkBitmapDevice> SkBitmapDevice::Create(const SkImageInfo& origInfo,
                                              const SkSurfaceProps& surfaceProps,
                                              SkRasterHandleAllocator* allocator) {
@@ -301,6 +405,7 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
     SkASSERT(bm.width() == fBitmap.width());
     SkASSERT(bm.height() == fBitmap.height());
     fBitmap = bm;   // intent is to use bm's pixelRef (and rowbytes/config)
+    this->markDirty(this->bounds());
 }
 
 sk_sp<SkDevice> SkBitmapDevice::createDevice(const CreateInfo& cinfo, const SkPaint* layerPaint) {
@@ -322,11 +427,38 @@ sk_sp<SkDevice> SkBitmapDevice::createDevice(const CreateInfo& cinfo, const SkPa
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
     if (this->onPeekPixels(pmap)) {
         fBitmap.notifyPixelsChanged();
+        // The caller may write anywhere.
+        this->markDirty(this->bounds());
         return true;
     }
     return false;
 }
 
+bool SkBitmapDevice::accessPixelsForDraw(SkPixmap* pmap, const SkRect* localBounds) {
+    if (!this->onPeekPixels(pmap)) {
+        return false;
+    }
+    fBitmap.notifyPixelsChanged();
+    if (fBackdropCache) {
+        SkIRect dirty = fRCStack.rc().getBounds();
+        if (localBounds) {
+            // Anti-aliasing can touch the pixels just outside of the rounded out bounds.
+            SkIRect devBounds = this->localToDevice().mapRect(*localBounds).roundOut();
+            if (!dirty.intersect(devBounds.makeOutset(1, 1))) {
+                return true;
+            }
+        }
+        fBackdropCache->markDirty(dirty);
+    }
+    return true;
+}
+
+void SkBitmapDevice::markDirty(const SkIRect& bounds) {
+    if (fBackdropCache) {
+        fBackdropCache->markDirty(bounds);
+    }
+}
+
 bool SkBitmapDevice::onPeekPixels(SkPixmap* pmap) {
     const SkImageInfo info = fBitmap.info();
     if (fBitmap.getPixels() && (kUnknown_SkColorType != info.colorType())) {
@@ -344,6 +476,7 @@ bool SkBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
 
     if (fBitmap.writePixels(pm, x, y)) {
         fBitmap.notifyPixelsChanged();
+        this->markDirty(SkIRect::MakeXYWH(x, y, pm.width(), pm.height()));
         return true;
     }
     return false;
@@ -378,7 +511,7 @@ void SkBitmapDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
 
 void SkBitmapDevice::drawPath(const SkPath& path, const SkPaint& paint) {
     const SkRect* bounds = nullptr;
-    if (SkDrawTiler::NeedsTiling(this) && !path.isInverseFillType()) {
+    if ((SkDrawTiler::NeedsTiling(this) || fBackdropCache) && !path.isInverseFillType()) {
         bounds = &path.getBounds();
     }
     SkDrawTiler tiler(this, bounds ? Bounder(*bounds, paint).bounds() : nullptr);
@@ -392,7 +525,7 @@ void SkBitmapDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
                                 const SkPaint& paint) {
     const SkRect* bounds = dstOrNull;
     SkRect storage;
-    if (!bounds && SkDrawTiler::NeedsTiling(this)) {
+    if (!bounds && (SkDrawTiler::NeedsTiling(this) || fBackdropCache)) {
         matrix.mapRect(&storage, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
         Bounder b(storage, paint);
         if (b.hasBounds()) {
@@ -421,10 +554,33 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkBitmap bitmap;
     // TODO: Elevate direct context requirement to public API and remove cheat.
     auto dContext = as_IB(image)->directContext();
-    if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+
+    // A filtered draw that shrinks the image only needs it at the size it is drawn, which a lazy
+    // image can often decode to directly (e.g. JPEG at 1/8, 2/8, ... of its size).
+    SkISize minDimensions = image->dimensions();
+    SkMatrix inv;
+    if (SkMatrix::Concat(this->localToDevice(),
+                         SkMatrix::RectToRectOrIdentity(src ? *src : SkRect::Make(image->bounds()),
+                                                        dst)).invert(&inv)) {
+        minDimensions = SkMipmapAccessor::MinBaseDimensions(image, inv, sampling);
+    }
+    if (minDimensions == image->dimensions()) {
+        if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+            return;
+        }
+    } else if (!as_IB(image)->getScaledROPixels(dContext, minDimensions, &bitmap)) {
         return;
     }
 
+    // The rest of this works in the coordinates of the pixels we got.
+    SkRect scaledSrc;
+    if (src && bitmap.dimensions() != image->dimensions()) {
+        scaledSrc = SkMatrix::Scale(SkIntToScalar(bitmap.width())  / image->width(),
+                                    SkIntToScalar(bitmap.height()) / image->height())
+                            .mapRect(*src);
+        src = &scaledSrc;
+    }
+
     SkRect      bitmapBounds, tmpSrc, tmpDst;
     SkBitmap    tmpBitmap;
 
@@ -576,7 +732,7 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src,
     SkBitmap resultBM;
     if (SkSpecialImages::AsBitmap(src, &resultBM)) {
         skcpu::Draw draw;
-        if (!this->accessPixels(&draw.fDst)) {
+        if (!this->accessPixelsForDraw(&draw.fDst, nullptr)) {
           return; // no pixels to draw to so skip it
         }
         draw.fCTM = &localToDevice;
@@ -598,7 +754,7 @@ void SkBitmapDevice::drawCoverageMask(const SkSpecialImage* mask,
     }
 
     skcpu::Draw draw;
-    if (!this->accessPixels(&draw.fDst)) {
+    if (!this->accessPixelsForDraw(&draw.fDst, nullptr)) {
       return; // no pixels to draw to so skip it
     }
     draw.fRC = &fRCStack.rc();
@@ -632,6 +788,23 @@ sk_sp<SkSpecialImage> SkBitmapDevice::snapSpecial(const SkIRect& bounds, bool fo
     }
 }
 
+bool SkBitmapDevice::findCachedBackdrop(const BackdropKey& key, skif::FilterResult* result) {
+    return fBackdropCache && fBackdropCache->find(key, fBitmap.pixmap(), result);
+}
+
+void SkBitmapDevice::cacheBackdrop(const BackdropKey& key, const skif::FilterResult& result) {
+    // A result that is a view of this device's pixels would change with them.
+    SkBitmap resultBM;
+    if (!result || (SkSpecialImages::AsBitmap(result.image(), &resultBM) &&
+                    resultBM.pixelRef() == fBitmap.pixelRef())) {
+        return;
+    }
+    if (!fBackdropCache) {
+        fBackdropCache = std::make_unique<BackdropCache>();
+    }
+    fBackdropCache->add(key, fBitmap.pixmap(), result);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkSurface> SkBitmapDevice::makeSurface(const SkImageInfo& info, const SkSurfaceProps& props) {
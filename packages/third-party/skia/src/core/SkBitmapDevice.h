@@ -20,6 +20,8 @@
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkRasterClipStack.h"
 
+#include <memory>
+
 class SkBlender;
 class SkImage;
 class SkMatrix;
@@ -37,6 +39,7 @@ class SkSurface;
 class SkSurfaceProps;
 class SkVertices;
 enum class SkClipOp;
+namespace skif { class FilterResult; }
 struct SkImageInfo;
 struct SkPoint;
 struct SkRSXform;
@@ -69,6 +72,8 @@ public:
     static sk_sp<SkBitmapDevice> Create(const SkImageInfo&, const SkSurfaceProps&,
                                         SkRasterHandleAllocator* = nullptr);
 
+    ~SkBitmapDevice() override;
+
     void drawPaint(const SkPaint& paint) override;
     void drawPoints(SkCanvas::PointMode, SkSpan<const SkPoint>, const SkPaint&) override;
     void drawRect(const SkRect& r, const SkPaint& paint) override;
@@ -116,6 +121,9 @@ public:
 
     sk_sp<SkSpecialImage> snapSpecial(const SkIRect&, bool forceCopy = false) override;
 
+    bool findCachedBackdrop(const BackdropKey&, skif::FilterResult*) override;
+    void cacheBackdrop(const BackdropKey&, const skif::FilterResult&) override;
+
     sk_sp<SkDevice> createDevice(const CreateInfo&, const SkPaint*) override;
 
     sk_sp<SkSurface> makeSurface(const SkImageInfo&, const SkSurfaceProps&) override;
@@ -131,6 +139,7 @@ private:
     friend class SkSurface_Raster;
 
     class BDDraw;
+    class BackdropCache;
 
     // Used to change the backend's pixels (and possibly config/rowbytes) but cannot change the
     // width/height, so there should be no change to any clip information.
@@ -145,6 +154,12 @@ private:
     bool onPeekPixels(SkPixmap*) override;
     bool onAccessPixels(SkPixmap*) override;
 
+    // Like accessPixels(), for draws that only change the pixels inside the clip and, if it is not
+    // null, 'localBounds' mapped to device space.
+    bool accessPixelsForDraw(SkPixmap*, const SkRect* localBounds);
+    // Marks the cached backdrops that read from pixels inside 'bounds' as possibly stale.
+    void markDirty(const SkIRect& bounds);
+
     void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
                     const SkSamplingOptions&, const SkPaint&);
 
@@ -153,6 +168,9 @@ private:
     SkBitmap fBitmap;
     SkRasterClipStack fRCStack;
     skcpu::GlyphRunListPainter fGlyphPainter;
+    // Created when the first backdrop is cached, so that until then draws need not track the
+    // pixels they change.
+    std::unique_ptr<BackdropCache> fBackdropCache;
 };
 
 #endif // SkBitmapDevice_DEFINED
@@ -14,6 +14,8 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h" // IWYU pragma: keep
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
@@ -36,6 +38,7 @@
 #include "src/core/SkDevice.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <array>
@@ -153,15 +156,51 @@ private:
     const float fSigma;
 };
 
+// A pass is only split across the executor when each task gets at least this many rows, or
+// columns for the vertical pass, and into no more than kMaxBlurTasks tasks.
+static constexpr int kMinBlurTaskSize = 32;
+static constexpr int kMaxBlurTasks = 64;
+// The vertical pass gives each task a whole number of these, so no two tasks write to the same
+// cache line of a row.
+static constexpr int kBlurTileBytes = 64;
+
+// Calls fn(begin, end) on ranges covering [start, end). Without an executor that is just the one
+// range. With one, the ranges are sized in multiples of 'align' and run as tasks on it. Each
+// element of the range is blurred independently, so either way produces the same pixels.
+template <typename Fn>
+static void for_each_blur_range(SkExecutor* executor, int start, int end, int align, Fn&& fn) {
+    const int count = end - start;
+    int tasks = executor ? std::min(kMaxBlurTasks, count / std::max(kMinBlurTaskSize, align)) : 1;
+    if (tasks <= 1) {
+        fn(start, end);
+        return;
+    }
+    const int size = ((count + tasks - 1) / tasks + align - 1) / align * align;
+    tasks = (count + size - 1) / size;
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(tasks, [&](int i) {
+        fn(start + i * size, std::min(end, start + (i + 1) * size));
+    });
+    taskGroup.wait();
+}
+
+// Makes a pass, and the buffers it works in, in 'alloc'. Every range of a multi-threaded blur
+// needs its own.
+static Pass* make_pass(const PassMaker* maker, size_t bufferAlign, SkArenaAlloc* alloc) {
+    void* buffer = alloc->makeBytesAlignedTo(maker->bufferSizeBytes(), bufferAlign);
+    return maker->makePass(buffer, alloc);
+}
+
 // T is type of the pixel format for the color type.
 // This should only be used for 8bit color channels.
 template <typename T>
 static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* makerY,
                                               SkBitmap src, const SkIRect& originalSrcBounds,
                                               const SkIRect& originalDstBounds,
-                                              SkArenaAlloc* alloc) {
+                                              SkExecutor* executor) {
     static constexpr int N = sizeof(T) / sizeof(uint8_t);
     static_assert(N*sizeof(uint8_t) == sizeof(T), "N must be the the size of T in bytes.");
+    static constexpr size_t kBufferAlign = alignof(skvx::Vec<N, uint32_t>);
 
     SkIRect srcBounds = originalSrcBounds;
     SkIRect dstBounds = originalDstBounds;
@@ -182,15 +221,15 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
     }
     dst.eraseColor(SK_ColorTRANSPARENT);
 
-    auto buffer = alloc->makeBytesAlignedTo(std::max(makerX->bufferSizeBytes(),
-                                            makerY->bufferSizeBytes()),
-                                            alignof(skvx::Vec<N, uint32_t>));
-
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
     //     the destination. Then, do an in-place vertical blur.
     // * Horizontal only - blur horizontally copying values from the source to the destination.
     // * Vertical only - blur vertically copying values from the source to the destination.
+    //
+    // With an executor, the horizontal pass is split into bands of rows and the vertical pass
+    // into tiles of columns. Each task has its own pass, so they share nothing but the pixels,
+    // and they write disjoint rows or columns.
 
     // Initialize these assuming the Y-only case
     int loopStart  = std::max(srcBounds.left(),  dstBounds.left());
@@ -203,20 +242,23 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
         loopStart = std::max(srcBounds.top(),    dstBounds.top());
         loopEnd   = std::min(srcBounds.bottom(), dstBounds.bottom());
 
-        auto srcAddr = reinterpret_cast<T*>(src.getAddr(0, loopStart - srcBounds.top()));
-        auto dstAddr = reinterpret_cast<T*>(dst.getAddr(0, loopStart - dstBounds.top()));
-
         // Iterate over each row to calculate 1D blur along X.
-        Pass* pass = makerX->makePass(buffer, alloc);
-        for (int y = loopStart; y < loopEnd; ++y) {
-            pass->blur<T>(srcBounds.left()  - dstBounds.left(),
-                          srcBounds.right() - dstBounds.left(),
-                          dstBounds.width(),
-                          srcAddr, 1,
-                          dstAddr, 1);
-            srcAddr += src.rowBytesAsPixels();
-            dstAddr += dst.rowBytesAsPixels();
-        }
+        for_each_blur_range(executor, loopStart, loopEnd, 1, [&](int begin, int end) {
+            auto srcAddr = reinterpret_cast<T*>(src.getAddr(0, begin - srcBounds.top()));
+            auto dstAddr = reinterpret_cast<T*>(dst.getAddr(0, begin - dstBounds.top()));
+
+            SkSTArenaAlloc<1024> alloc;
+            Pass* pass = make_pass(makerX, kBufferAlign, &alloc);
+            for (int y = begin; y < end; ++y) {
+                pass->blur<T>(srcBounds.left()  - dstBounds.left(),
+                              srcBounds.right() - dstBounds.left(),
+                              dstBounds.width(),
+                              srcAddr, 1,
+                              dstAddr, 1);
+                srcAddr += src.rowBytesAsPixels();
+                dstAddr += dst.rowBytesAsPixels();
+            }
+        });
 
         // Set up the Y pass to blur from the full dst into the non-outset portion of dst
         src = dst;
@@ -235,19 +277,42 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
     // into dst for a 1D blur; or it's blurring from dst into dst for the second pass of a 2D
     // blur.
     if (makerY->window() > 1) {
-        auto srcAddr = reinterpret_cast<T*>(src.getAddr(loopStart - srcBounds.left(), 0));
-        auto dstAddr = reinterpret_cast<T*>(dst.getAddr(loopStart - dstBounds.left(), dstYOffset));
-
-        Pass* pass = makerY->makePass(buffer, alloc);
-        for (int x = loopStart; x < loopEnd; ++x) {
-            pass->blur<T>(srcBounds.top()    - dstBounds.top(),
-                          srcBounds.bottom() - dstBounds.top(),
-                          dstBounds.height(),
-                          srcAddr, src.rowBytesAsPixels(),
-                          dstAddr, dst.rowBytesAsPixels());
-            srcAddr += 1;
-            dstAddr += 1;
-        }
+        // The columns are blurred a tile at a time. Each tile is copied into contiguous columns,
+        // blurred there with unit strides, and copied back, so every row of the image is read and
+        // written once per tile, a cache line at a time, instead of once per column.
+        static constexpr int kTileColumns = kBlurTileBytes / sizeof(T);
+        const int srcHeight = srcBounds.height(),
+                  dstHeight = dstBounds.height();
+        for_each_blur_range(executor, loopStart, loopEnd, kTileColumns, [&](int begin, int end) {
+            SkSTArenaAlloc<1024> alloc;
+            Pass* pass = make_pass(makerY, kBufferAlign, &alloc);
+            T* srcColumns = alloc.makeArrayDefault<T>(kTileColumns * srcHeight);
+            T* dstColumns = alloc.makeArrayDefault<T>(kTileColumns * dstHeight);
+            for (int tile = begin; tile < end; tile += kTileColumns) {
+                const int width = std::min(kTileColumns, end - tile);
+                for (int y = 0; y < srcHeight; ++y) {
+                    auto srcAddr = reinterpret_cast<const T*>(
+                            src.getAddr(tile - srcBounds.left(), y));
+                    for (int i = 0; i < width; ++i) {
+                        srcColumns[i * srcHeight + y] = srcAddr[i];
+                    }
+                }
+                for (int i = 0; i < width; ++i) {
+                    pass->blur<T>(srcBounds.top()    - dstBounds.top(),
+                                  srcBounds.bottom() - dstBounds.top(),
+                                  dstHeight,
+                                  srcColumns + i * srcHeight, 1,
+                                  dstColumns + i * dstHeight, 1);
+                }
+                for (int y = 0; y < dstHeight; ++y) {
+                    auto dstAddr = reinterpret_cast<T*>(
+                            dst.getAddr(tile - dstBounds.left(), dstYOffset + y));
+                    for (int i = 0; i < width; ++i) {
+                        dstAddr[i] = dstColumns[i * dstHeight + y];
+                    }
+                }
+            }
+        });
     }
 
 #if defined(SK_AVOID_SLOW_RASTER_PIPELINE_BLURS)
@@ -1193,7 +1258,8 @@ public:
         PassMaker* makerY = makeMaker(sigma.height());
 
         return eval_blur_passes<uint8_t>(makerX, makerY, src, originalSrcBounds,
-                                         originalDstBounds, &alloc);
+                                         originalDstBounds,
+                                         SkGraphics::GetRasterExecutor());
     }
 };
 
@@ -1261,7 +1327,8 @@ public:
         PassMaker* makerY = makeMaker(sigma.height());
 
         return eval_blur_passes<uint32_t>(makerX, makerY, src, originalSrcBounds,
-                                          originalDstBounds, &alloc);
+                                          originalDstBounds,
+                                          SkGraphics::GetRasterExecutor());
     }
 
 };
@@ -24,13 +24,16 @@
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkScalar.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkAutoMalloc.h"
 #include "src/base/SkTLazy.h"
+#include "src/core/SkBlitter.h"
 #include "src/core/SkBlitter_A8.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkCachedData.h"
@@ -38,7 +41,11 @@
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskCache.h"
 #include "src/core/SkMaskFilterBase.h"
+#include "src/core/SkRRectPriv.h"
 #include "src/core/SkRasterClip.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/core/SkRasterPipelineOpList.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkWriteBuffer.h"
@@ -259,6 +266,78 @@ static SkCachedData* add_cached_rects(SkMaskBuilder* mask,
     return cached;
 }
 
+bool SkBlurMaskFilterImpl::filterRRectAnalytic(const SkRRect& devRRect,
+                                               const SkMatrix& matrix,
+                                               const SkRasterClip& clip,
+                                               SkBlitter* blitter) const {
+    // Small blurs are left to the mask path, where the antialiased edge of the shape is still a
+    // large part of the result.
+    constexpr SkScalar kMinAnalyticSigma = 1;
+    SkScalar sigma = this->computeXformedSigma(matrix);
+    if (kNormal_SkBlurStyle != fBlurStyle || sigma < kMinAnalyticSigma ||
+        !SkRRectPriv::EqualRadii(devRRect) || rect_exceeds(devRRect.rect(), 32767)) {
+        return false;
+    }
+
+    // The mask path blurs the area coverage of each pixel, which is the shape convolved with a
+    // one pixel box. That box adds 1/12 to the variance of the Gaussian.
+    sigma = SkScalarSqrt(sigma * sigma + 1.f / 12);
+
+    const SkRect& rect = devRRect.rect();
+    SkIRect bounds = rect.makeOutset(3 * sigma, 3 * sigma).roundOut();
+    if (!bounds.intersect(clip.getBounds())) {
+        return true;
+    }
+
+    SkRasterPipelineContexts::RRectBlurCtx ctx;
+    ctx.centerX = rect.centerX();
+    ctx.centerY = rect.centerY();
+    ctx.halfWidth = rect.width() / 2;
+    ctx.halfHeight = rect.height() / 2;
+    ctx.cornerRadius = devRRect.isRect() ? 0 : SkRRectPriv::GetSimpleRadii(devRRect).fX;
+    ctx.sigma = sigma;
+    ctx.invSigmaSqrt2 = 1 / (sigma * SK_ScalarSqrt2);
+
+    // Coverage is evaluated one row at a time into this buffer, which is indexed by device x.
+    SkAutoSMalloc<1024> storage(bounds.width());
+    uint8_t* row = static_cast<uint8_t*>(storage.get());
+    SkRasterPipelineContexts::MemoryCtx rowCtx = {row - bounds.left(), 0};
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipelineOp::seed_shader);
+    p.append(SkRasterPipelineOp::rrect_blur_coverage, &ctx);
+    p.append(SkRasterPipelineOp::store_a8, &rowCtx);
+    auto coverage = p.compile();
+
+    // Rows further than 4 sigma from the corners and the top and bottom edges only see the
+    // straight sides, so they share one coverage row. It is always evaluated at the top of the
+    // band, which keeps clipped draws identical to unclipped ones.
+    int bandTop = bounds.bottom(),
+        bandBottom = bounds.bottom();
+    const SkScalar bandHalfHeight = ctx.halfHeight - ctx.cornerRadius - 4 * sigma;
+    if (bandHalfHeight >= 0) {
+        bandTop = SkScalarCeilToInt(ctx.centerY - bandHalfHeight - 0.5f);
+        bandBottom = SkScalarFloorToInt(ctx.centerY + bandHalfHeight - 0.5f) + 1;
+    }
+
+    SkAAClipBlitterWrapper wrapper(clip, blitter);
+    blitter = wrapper.getBlitter();
+    for (SkRegion::Cliperator clipper(wrapper.getRgn(), bounds); !clipper.done(); clipper.next()) {
+        const SkIRect& cr = clipper.rect();
+        const uint8_t* image = row + (cr.left() - bounds.left());
+        for (int y = cr.top(); y < cr.bottom();) {
+            const bool inBand = bandTop <= y && y < bandBottom;
+            const int height = inBand ? std::min(cr.bottom(), bandBottom) - y : 1;
+            coverage(cr.left(), inBand ? bandTop : y, cr.width(), 1);
+            // A row stride of zero repeats the row over the band.
+            const SkIRect rows = SkIRect::MakeLTRB(cr.left(), y, cr.right(), y + height);
+            blitter->blitMask(SkMask(image, rows, 0, SkMask::kA8_Format), rows);
+            y += height;
+        }
+    }
+    return true;
+}
+
 std::optional<SkMaskFilterBase::NinePatch> SkBlurMaskFilterImpl::filterRRectToNine(
         const SkRRect& rrect,
         const SkMatrix& matrix,
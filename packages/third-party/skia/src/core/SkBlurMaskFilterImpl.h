@@ -17,10 +17,12 @@
 #include <optional>
 #include <utility>
 
+class SkBlitter;
 class SkImageFilter;
 class SkMatrix;
 class SkPaint;
 class SkRRect;
+class SkRasterClip;
 class SkReadBuffer;
 class SkResourceCache;
 class SkWriteBuffer;
@@ -62,6 +64,11 @@ private:
                                                const SkIRect& clipBounds,
                                                SkResourceCache*) const override;
 
+    bool filterRRectAnalytic(const SkRRect& devRRect,
+                             const SkMatrix&,
+                             const SkRasterClip&,
+                             SkBlitter*) const override;
+
     bool filterRectMask(SkMaskBuilder* dstM,
                         const SkRect& r,
                         const SkMatrix& matrix,
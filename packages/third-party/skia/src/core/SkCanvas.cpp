@@ -783,6 +783,12 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
                       filterColorSpace.get(),
                       &stats};
 
+    // A backdrop filter's result can come from the src device, if it has evaluated the same filter
+    // over the same pixels before.
+    const skif::LayerSpace<SkIRect> desiredOutput = mapping.deviceToLayer(outputBounds);
+    std::optional<SkDevice::BackdropKey> backdropKey;
+    skif::FilterResult cachedResult;
+
     skif::FilterResult source;
     if (src && !requiredInput.isEmpty()) {
         skif::LayerSpace<SkIRect> srcSubset;
@@ -803,9 +809,24 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
             auto requiredSubset = srcToLayer.mapRect(availSrc);
             if (requiredSubset.width() == availSrc.width() &&
                 requiredSubset.height() == availSrc.height()) {
+                if (compat == DeviceCompatibleWithFilter::kUnknown && filters.size() == 1 &&
+                    filters[0] && !srcIsCoverageLayer) {
+                    backdropKey = SkDevice::BackdropKey{as_IFB(filters[0])->uniqueID(),
+                                                        mapping.layerMatrix(),
+                                                        SkIRect(availSrc),
+                                                        SkIPoint(requiredSubset.topLeft()),
+                                                        SkIRect(requiredInput),
+                                                        SkIRect(desiredOutput),
+                                                        srcTileMode,
+                                                        filterColorType,
+                                                        filterColorSpace};
+                    src->findCachedBackdrop(*backdropKey, &cachedResult);
+                }
                 // Unlike snapSpecialScaled(), snapSpecial() can avoid a copy when the underlying
                 // representation permits it.
-                source = {src->snapSpecial(SkIRect(availSrc)), requiredSubset.topLeft()};
+                if (!cachedResult) {
+                    source = {src->snapSpecial(SkIRect(availSrc)), requiredSubset.topLeft()};
+                }
             } else {
                 SkASSERT(compat == DeviceCompatibleWithFilter::kUnknown);
                 source = {src->snapSpecialScaled(SkIRect(availSrc),
@@ -827,7 +848,7 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
             // A backdrop filter that succeeded in snapSpecial() or snapSpecialScaled(), but since
             // the 'src' device wasn't prepared with 'requiredInput' in mind, add clamping.
             source = source.applyCrop(ctx, source.layerBounds(), srcTileMode);
-        } else if (!requiredInput.isEmpty()) {
+        } else if (!cachedResult && !requiredInput.isEmpty()) {
             // Otherwise snapSpecialScaled() failed or the transform was complex, so snap the source
             // image at its original resolution and then apply srcToLayer to map to the effective
             // layer coordinate space.
@@ -845,7 +866,7 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
 
     // Evaluate the image filter, with a context pointing to the source snapped from 'src' and
     // possibly transformed into the intermediate layer coordinate space.
-    ctx = ctx.withNewDesiredOutput(mapping.deviceToLayer(outputBounds))
+    ctx = ctx.withNewDesiredOutput(desiredOutput)
              .withNewSource(source);
 
     // Here, we allow a single-element FilterSpan with a null entry, to simplify the loop:
@@ -853,7 +874,12 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
     FilterSpan filtersOrNull = filters.empty() ? FilterSpan{&nullFilter, 1} : filters;
 
     for (const sk_sp<SkImageFilter>& filter : filtersOrNull) {
-        auto result = filter ? as_IFB(filter)->filterImage(ctx) : source;
+        auto result = cachedResult ? cachedResult
+                    : filter       ? as_IFB(filter)->filterImageTiled(ctx)
+                                   : source;
+        if (backdropKey && !cachedResult) {
+            src->cacheBackdrop(*backdropKey, result);
+        }
 
         if (srcIsCoverageLayer) {
             SkASSERT(dst->useDrawCoverageMaskForMaskFilters());
@@ -2336,7 +2362,7 @@ void SkCanvas::onDrawImageRect2(const SkImage* image, const SkRect& src, const S
         // and a desired output matching the device clip bounds.
         ctx = ctx.withNewDesiredOutput(mapping.deviceToLayer(outputBounds))
                  .withNewSource(source);
-        auto result = as_IFB(realPaint.getImageFilter())->filterImage(ctx);
+        auto result = as_IFB(realPaint.getImageFilter())->filterImageTiled(ctx);
         result.draw(ctx, device, realPaint.getBlender());
         stats.reportStats();
         return;
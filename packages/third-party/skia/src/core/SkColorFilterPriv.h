@@ -9,6 +9,7 @@
 #define SkColorFilterPriv_DEFINED
 
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkString.h"
 
 class SkColorSpace;
 struct skcms_Matrix3x3;
@@ -29,6 +30,10 @@ public:
                                                   const skcms_TransferFunction* tf,
                                                   const skcms_Matrix3x3* gamut,
                                                   const SkAlphaType* at);
+
+    // Describes the structure of a filter for debugging, e.g. "Compose(Table, Matrix)". Compose
+    // folds what it can when filters are composed, and this shows what is left.
+    static SkString Describe(const SkColorFilter*);
 };
 
 #endif
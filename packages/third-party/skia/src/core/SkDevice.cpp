@@ -319,6 +319,18 @@ sk_sp<SkSpecialImage> SkDevice::snapSpecial() {
     return this->snapSpecial(SkIRect::MakeWH(this->width(), this->height()));
 }
 
+bool SkDevice::BackdropKey::operator==(const BackdropKey& o) const {
+    return fFilterID == o.fFilterID &&
+           fLayerMatrix == o.fLayerMatrix &&
+           fSrcSubset == o.fSrcSubset &&
+           fSrcOrigin == o.fSrcOrigin &&
+           fRequiredInput == o.fRequiredInput &&
+           fDesiredOutput == o.fDesiredOutput &&
+           fTileMode == o.fTileMode &&
+           fColorType == o.fColorType &&
+           SkColorSpace::Equals(fColorSpace.get(), o.fColorSpace.get());
+}
+
 sk_sp<skif::Backend> SkDevice::createImageFilteringBackend(const SkSurfaceProps& surfaceProps,
                                                            SkColorType colorType) const {
     return skif::MakeRasterBackend(surfaceProps, colorType);
@@ -367,7 +379,8 @@ void SkDevice::drawFilteredImage(const skif::Mapping& mapping,
                       &stats};
 
     SkIPoint offset;
-    sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(ctx).imageAndOffset(ctx, &offset);
+    sk_sp<SkSpecialImage> result =
+            as_IFB(filter)->filterImageTiled(ctx).imageAndOffset(ctx, &offset);
     stats.reportStats();
     if (result) {
         SkMatrix deviceMatrixWithOffset = mapping.layerToDevice().asM33();
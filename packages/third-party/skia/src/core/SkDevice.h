@@ -24,6 +24,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTArray.h"
@@ -62,6 +63,7 @@ class GlyphRunList;
 
 namespace skif {
 class Backend;
+class FilterResult;
 class Mapping;
 }
 namespace skgpu::ganesh {
@@ -425,6 +427,27 @@ public:
     // Get a view of the entire device's current contents as an image.
     sk_sp<SkSpecialImage> snapSpecial();
 
+    // Identifies a backdrop filter evaluation that read the 'fSrcSubset' pixels of this device.
+    // Two evaluations with equal keys produce the same result if those pixels are the same.
+    struct BackdropKey {
+        uint32_t            fFilterID;
+        SkM44               fLayerMatrix;    // The filter's parameter-to-layer transform
+        SkIRect             fSrcSubset;      // In this device's pixels
+        SkIPoint            fSrcOrigin;      // Where 'fSrcSubset' was placed in layer space
+        SkIRect             fRequiredInput;  // In layer space
+        SkIRect             fDesiredOutput;  // In layer space
+        SkTileMode          fTileMode;
+        SkColorType         fColorType;
+        sk_sp<SkColorSpace> fColorSpace;
+
+        bool operator==(const BackdropKey&) const;
+    };
+    // Devices that can tell when their pixels change may keep filtered backdrops and return them
+    // for an equal key while the pixels under the key's subset are unchanged. 'result' must not
+    // alias this device's pixels. The defaults keep nothing.
+    virtual bool findCachedBackdrop(const BackdropKey&, skif::FilterResult*) { return false; }
+    virtual void cacheBackdrop(const BackdropKey&, const skif::FilterResult& result) {}
+
     /**
      * The SkDevice passed will be an SkDevice which was returned by a call to
      * createDevice on this device with kNeverTile_TileExpectation.
@@ -830,6 +830,14 @@ void Draw::drawOval(const SkRect& oval, const SkPaint& paint) const {
         return;
     }
 
+    // A blurred circle can be drawn analytically, like a blurred round rect.
+    if (paint.getMaskFilter() && paint.getStyle() == SkPaint::kFill_Style &&
+        !paint.getPathEffect() && oval.width() == oval.height()) {
+        if (this->drawRRectNinePatch(SkRRect::MakeOval(oval), paint)) {
+            return;
+        }
+    }
+
     this->drawPath(SkPath::Oval(oval), paint, nullptr);
 }
 
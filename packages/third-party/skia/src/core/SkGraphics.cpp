@@ -7,18 +7,26 @@
 
 #include "include/core/SkGraphics.h"
 
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
 #include "src/core/SkBitmapProcState.h"
 #include "src/core/SkBlitMask.h"
 #include "src/core/SkBlitRow.h"
 #include "src/core/SkCpu.h"
+#include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkPersistentStrikeCache.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkSwizzlePriv.h"
 #include "src/core/SkTypefaceCache.h"
 
+#include <atomic>
+
 void SkGraphics::Init() {
     // SkGraphics::Init() must be thread-safe and idempotent.
     SkCpu::CacheRuntimeFeatures();
@@ -65,6 +73,24 @@ int SkGraphics::SetFontCacheCountLimit(int count) {
     return SkStrikeCache::GlobalStrikeCache()->setCacheCountLimit(count);
 }
 
+bool SkGraphics::SaveFontCacheToFile(const char path[], size_t byteBudget) {
+    SkFILEWStream stream(path);
+    if (!stream.isValid()) {
+        return false;
+    }
+    return SkPersistentStrikeCache::Write(
+                   SkStrikeCache::GlobalStrikeCache(), byteBudget, &stream) >= 0;
+}
+
+int SkGraphics::LoadFontCacheFromFile(const char path[],
+                                      SkSpan<const sk_sp<SkTypeface>> typefaces) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(path);
+    if (!data) {
+        return 0;
+    }
+    return SkPersistentStrikeCache::Read(SkStrikeCache::GlobalStrikeCache(), *data, typefaces);
+}
+
 int SkGraphics::GetFontCacheCountUsed() {
     return SkStrikeCache::GlobalStrikeCache()->getCacheCountUsed();
 }
@@ -99,6 +125,31 @@ void SkGraphics::PurgeResourceCache() {
     return SkResourceCache::PurgeAll();
 }
 
+size_t SkGraphics::PurgeResourceCacheToTarget(size_t targetBytes) {
+    return SkResourceCache::PurgeToTarget(targetBytes);
+}
+
+bool SkGraphics::SetImageFilterCacheTranslationInvariant(bool enabled) {
+    using KeyMode = SkImageFilterCache::KeyMode;
+    return SkImageFilterCache::Get()->setKeyMode(enabled ? KeyMode::kTranslationInvariant
+                                                         : KeyMode::kExact) ==
+           KeyMode::kTranslationInvariant;
+}
+
+size_t SkGraphics::SetImageFilterScratchLimit(size_t bytes) {
+    return skif::SetRasterScratchLimit(bytes);
+}
+
+static std::atomic<SkExecutor*> gRasterExecutor{nullptr};
+
+SkExecutor* SkGraphics::GetRasterExecutor() {
+    return gRasterExecutor.load(std::memory_order_acquire);
+}
+
+SkExecutor* SkGraphics::SetRasterExecutor(SkExecutor* executor) {
+    return gRasterExecutor.exchange(executor, std::memory_order_acq_rel);
+}
+
 static int gTypefaceCacheCountLimit = 1024; // historical default value
 
 int SkGraphics::GetTypefaceCacheCountLimit() {
@@ -24,12 +24,14 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTHash.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
 #include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <cstdint>
 #include <optional>
 #include <utility>
@@ -229,6 +231,48 @@ void SkImageFilter_Base::flatten(SkWriteBuffer& buffer) const {
 }
 
 skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context) const {
+    SkImageFilterCache* cache = context.cache();
+    if (cache && cache->keyMode() == SkImageFilterCache::KeyMode::kTranslationInvariant) {
+        // Evaluate, key and cache the filter in a layer space whose origin has absorbed the whole
+        // pixels of the layer matrix's translation, then move the result back. A translation
+        // invariant graph produces the same pixels either way, and a layer that has only moved by
+        // whole pixels since the last evaluation finds the result keyed by the same residual.
+        const SkMatrix layerMatrix = context.mapping().layerMatrix().asM33();
+        const skif::LayerSpace<SkIPoint> origin({sk_float_floor2int(layerMatrix.getTranslateX()),
+                                                 sk_float_floor2int(layerMatrix.getTranslateY())});
+        if ((origin.x() || origin.y()) && !layerMatrix.hasPerspective() &&
+            this->isTranslationInvariant()) {
+            skif::Mapping mapping = context.mapping();
+            mapping.applyOrigin(origin);
+            skif::LayerSpace<SkIRect> desiredOutput = context.desiredOutput();
+            desiredOutput.offset(-origin);
+            const skif::FilterResult movedSource = context.source().applyTransform(
+                    context.withNewMapping(mapping).withNewDesiredOutput(desiredOutput),
+                    skif::LayerSpace<SkMatrix>(SkMatrix::Translate(-origin.x(), -origin.y())),
+                    skif::FilterResult::kDefaultSampling);
+            // The desired output is usually the clip, which does not move with the layer. Limit
+            // it to what the graph can output so the key stays the same while the layer is fully
+            // visible.
+            const skif::LayerSpace<SkIRect> content =
+                    movedSource ? movedSource.layerBounds()
+                                : skif::LayerSpace<SkIRect>(SkIRect::MakeEmpty());
+            if (auto output = this->onGetOutputLayerBounds(mapping, content)) {
+                if (!desiredOutput.intersect(*output)) {
+                    desiredOutput = skif::LayerSpace<SkIRect>(SkIRect::MakeEmpty());
+                }
+            }
+            const skif::Context moved =
+                    context.withNewMapping(mapping).withNewDesiredOutput(desiredOutput);
+
+            // The moved evaluation marks this filter as visited.
+            return this->filterImage(moved.withNewSource(movedSource))
+                    .applyTransform(
+                            context,
+                            skif::LayerSpace<SkMatrix>(SkMatrix::Translate(origin.x(), origin.y())),
+                            skif::FilterResult::kDefaultSampling);
+        }
+    }
+
     context.markVisitedImageFilter();
 
     skif::FilterResult result;
@@ -248,20 +292,85 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
                               context.mapping().layerMatrix().asM33(),
                               SkIRect(context.desiredOutput()),
                               srcGenID, srcSubset);
-    if (context.backend()->cache() && context.backend()->cache()->get(key, &result)) {
+    if (cache && cache->get(key, &result)) {
         context.markCacheHit();
         return result;
     }
 
     result = this->onFilterImage(context);
 
-    if (context.backend()->cache()) {
-        context.backend()->cache()->set(key, this, result);
+    if (cache) {
+        cache->set(key, this, result);
     }
 
     return result;
 }
 
+// Adds the filters in the DAG rooted at 'filter' that are not yet in 'visited' to it. A filter that
+// is the input of several others is only counted once, which also keeps DAGs that reuse their
+// inputs from being walked once per path.
+static void collect_filters(const SkImageFilter* filter,
+                            skia_private::THashSet<const SkImageFilter*>* visited) {
+    if (visited->contains(filter)) {
+        return;
+    }
+    visited->add(filter);
+    for (int i = 0; i < filter->countInputs(); ++i) {
+        if (const SkImageFilter* input = filter->getInput(i)) {
+            collect_filters(input, visited);
+        }
+    }
+}
+
+// The number of distinct filters in the DAG rooted at 'filter'.
+static int count_filters(const SkImageFilter* filter) {
+    skia_private::THashSet<const SkImageFilter*> visited;
+    collect_filters(filter, &visited);
+    return visited.count();
+}
+
+skif::FilterResult SkImageFilter_Base::filterImageTiled(const skif::Context& context) const {
+    // Smaller tiles spend more time on the margins that the filters read around them than on the
+    // tiles themselves.
+    static constexpr int kMinTileSize = 256;
+    static constexpr int kMaxTilesInFlight = 4;
+
+    const size_t scratchLimit = context.backend()->scratchLimit();
+    const size_t bytesPerPixel = SkColorTypeBytesPerPixel(context.backend()->colorType());
+    skif::LayerSpace<SkIRect> bounds = context.desiredOutput();
+    if (!scratchLimit || !bytesPerPixel || bounds.isEmpty()) {
+        return this->filterImage(context);
+    }
+
+    // Only the part of the desired output that the DAG can draw to is split into tiles.
+    const skif::LayerSpace<SkIRect> content =
+            context.source() ? context.source().layerBounds()
+                             : skif::LayerSpace<SkIRect>(SkIRect::MakeEmpty());
+    if (auto output = this->onGetOutputLayerBounds(context.mapping(), content)) {
+        if (!bounds.intersect(*output)) {
+            return {};
+        }
+    }
+
+    // Each filter may hold an intermediate image about the size of its output, and each tile in
+    // flight holds its own.
+    const int tilesInFlight = context.backend()->tileExecutor() ? kMaxTilesInFlight : 1;
+    const size_t tilePixels =
+            scratchLimit / (bytesPerPixel * count_filters(this) * tilesInFlight);
+    if (SkToU64(bounds.width()) * SkToU64(bounds.height()) <= tilePixels) {
+        return this->filterImage(context);
+    }
+
+    const int tileSize =
+            std::max(kMinTileSize, sk_double_saturate2int(std::sqrt((double) tilePixels)));
+    return skif::FilterResult::MakeFromTiles(
+            context,
+            bounds,
+            skif::LayerSpace<SkISize>({tileSize, tileSize}),
+            tilesInFlight,
+            [this](const skif::Context& tileContext) { return this->filterImage(tileContext); });
+}
+
 sk_sp<SkImage> SkImageFilter_Base::makeImageWithFilter(sk_sp<skif::Backend> backend,
                                                        sk_sp<SkImage> src,
                                                        const SkIRect& subset,
@@ -286,7 +395,8 @@ sk_sp<SkImage> SkImageFilter_Base::makeImageWithFilter(sk_sp<skif::Backend> back
                                 src->imageInfo().colorSpace(),
                                 &stats};
 
-    sk_sp<SkSpecialImage> result = this->filterImage(context).imageAndOffset(context, offset);
+    sk_sp<SkSpecialImage> result =
+            this->filterImageTiled(context).imageAndOffset(context, offset);
     stats.reportStats();
 
     if (!result) {
@@ -345,6 +455,31 @@ SkImageFilter_Base::MatrixCapability SkImageFilter_Base::getCTMCapability() cons
     return result;
 }
 
+bool SkImageFilter_Base::isTranslationInvariant() const {
+    skia_private::THashSet<const SkImageFilter*> visited;
+    return this->isTranslationInvariant(&visited);
+}
+
+bool SkImageFilter_Base::isTranslationInvariant(
+        skia_private::THashSet<const SkImageFilter*>* visited) const {
+    // The walk stops at the first filter that is not invariant, so any filter seen before is.
+    if (visited->contains(this)) {
+        return true;
+    }
+    visited->add(this);
+    if (!this->onIsTranslationInvariant()) {
+        return false;
+    }
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        const SkImageFilter_Base* input = as_IFB(this->getInput(i));
+        if (input && !input->isTranslationInvariant(visited)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 skif::LayerSpace<SkIRect> SkImageFilter_Base::getChildInputLayerBounds(
         int index,
         const skif::Mapping& mapping,
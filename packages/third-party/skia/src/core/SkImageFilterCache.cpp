@@ -31,7 +31,8 @@ namespace {
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes, KeyMode keyMode)
+            : SkImageFilterCache(keyMode), fMaxBytes(maxBytes), fCurrentBytes(0) { }
     ~CacheImpl() override {
         fLookup.foreach([&](Value* v) { delete v; });
     }
@@ -152,8 +153,8 @@ private:
 
 } // namespace
 
-sk_sp<SkImageFilterCache> SkImageFilterCache::Create(size_t maxBytes) {
-    return sk_make_sp<CacheImpl>(maxBytes);
+sk_sp<SkImageFilterCache> SkImageFilterCache::Create(size_t maxBytes, KeyMode keyMode) {
+    return sk_make_sp<CacheImpl>(maxBytes, keyMode);
 }
 
 sk_sp<SkImageFilterCache> SkImageFilterCache::Get(CreateIfNecessary createIfNecessary) {
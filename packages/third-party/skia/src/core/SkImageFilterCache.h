@@ -14,6 +14,7 @@
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -58,8 +59,19 @@ class SkImageFilterCache : public SkRefCnt {
 public:
     static constexpr size_t kDefaultTransientSize = 32 * 1024 * 1024;
 
+    // How SkImageFilter_Base::filterImage() keys its results.
+    enum class KeyMode : bool {
+        // The key holds the full layer matrix, so a result is only reused at the same position.
+        kExact,
+        // A filter graph that is invariant to translation is evaluated, keyed and cached with the
+        // integer part of the layer matrix's translation moved into the layer origin, so a layer
+        // that only moved by whole pixels (e.g. while scrolling) reuses the result at its new
+        // offset. Such keys are exact keys of the moved evaluation, so both modes share entries.
+        kTranslationInvariant,
+    };
+
     ~SkImageFilterCache() override {}
-    static sk_sp<SkImageFilterCache> Create(size_t maxBytes);
+    static sk_sp<SkImageFilterCache> Create(size_t maxBytes, KeyMode = KeyMode::kExact);
 
     // Whether to create the cache if it doesn't yet exist.
     enum class CreateIfNecessary : bool { kNo, kYes };
@@ -76,6 +88,18 @@ public:
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
+
+    KeyMode keyMode() const { return fKeyMode.load(std::memory_order_relaxed); }
+    // Returns the previous mode.
+    KeyMode setKeyMode(KeyMode mode) {
+        return fKeyMode.exchange(mode, std::memory_order_relaxed);
+    }
+
+protected:
+    explicit SkImageFilterCache(KeyMode keyMode) : fKeyMode(keyMode) {}
+
+private:
+    std::atomic<KeyMode> fKeyMode;
 };
 
 #endif
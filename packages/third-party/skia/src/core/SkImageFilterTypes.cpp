@@ -8,20 +8,25 @@
 #include "src/core/SkImageFilterTypes.h"
 
 #include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkBlender.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"  // IWYU pragma: keep
+#include "include/core/SkPixmap.h"
 #include "include/core/SkShader.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkMalloc.h"
 #include "src/base/SkMathPriv.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkBitmapDevice.h"
@@ -35,12 +40,15 @@
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 namespace skif {
 
@@ -180,20 +188,63 @@ std::optional<LayerSpace<SkMatrix>> periodic_axis_transform(
     }
 }
 
+static std::atomic<size_t> gRasterScratchLimit{0};
+
+static std::atomic<size_t> gRasterScratchBytes{0};
+static std::atomic<size_t> gRasterScratchPeak{0};
+
+void add_raster_scratch(size_t bytes) {
+    const size_t total = gRasterScratchBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = gRasterScratchPeak.load(std::memory_order_relaxed);
+    while (total > peak &&
+           !gRasterScratchPeak.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {}
+}
+
+void release_raster_scratch(void* pixels, void* byteSize) {
+    gRasterScratchBytes.fetch_sub(reinterpret_cast<size_t>(byteSize), std::memory_order_relaxed);
+    sk_free(pixels);
+}
+
 class RasterBackend : public Backend {
 public:
 
     RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType)
-            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType) {}
+            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType) {
+        SkExecutor* executor = SkGraphics::GetRasterExecutor();
+        this->setTiling(gRasterScratchLimit.load(std::memory_order_relaxed), executor);
+        this->setKernelExecutor(executor);
+    }
 
     sk_sp<SkDevice> makeDevice(SkISize size,
                                sk_sp<SkColorSpace> colorSpace,
                                const SkSurfaceProps* props) const override {
+        SkAlphaType alphaType;
+        if (!SkColorTypeValidateAlphaType(this->colorType(), kPremul_SkAlphaType, &alphaType)) {
+            return nullptr;
+        }
         SkImageInfo imageInfo = SkImageInfo::Make(size,
                                                   this->colorType(),
-                                                  kPremul_SkAlphaType,
+                                                  alphaType,
                                                   std::move(colorSpace));
-        return SkBitmapDevice::Create(imageInfo, props ? *props : this->surfaceProps());
+
+        // Allocate the pixels here instead of in SkBitmapDevice::Create() so that they are
+        // counted by RasterScratchBytes() until the last image made from them is released.
+        const size_t rowBytes = imageInfo.minRowBytes();
+        const size_t byteSize = imageInfo.computeByteSize(rowBytes);
+        if (SkImageInfo::ByteSizeOverflowed(byteSize)) {
+            return nullptr;
+        }
+        void* pixels = sk_calloc_canfail(byteSize);
+        if (!pixels) {
+            return nullptr;
+        }
+        add_raster_scratch(byteSize);
+        SkBitmap bitmap;
+        if (!bitmap.installPixels(imageInfo, pixels, rowBytes, release_raster_scratch,
+                                  reinterpret_cast<void*>(byteSize))) {
+            return nullptr;
+        }
+        return sk_make_sp<SkBitmapDevice>(bitmap, props ? *props : this->surfaceProps());
     }
 
     sk_sp<SkSpecialImage> makeImage(const SkIRect& subset, sk_sp<SkImage> image) const override {
@@ -226,6 +277,19 @@ sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType
     return sk_make_sp<RasterBackend>(surfaceProps, colorType);
 }
 
+size_t SetRasterScratchLimit(size_t bytes) {
+    return gRasterScratchLimit.exchange(bytes, std::memory_order_relaxed);
+}
+
+size_t RasterScratchBytes() {
+    return gRasterScratchBytes.load(std::memory_order_relaxed);
+}
+
+size_t ResetRasterScratchPeak() {
+    return gRasterScratchPeak.exchange(gRasterScratchBytes.load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+}
+
 void Stats::dumpStats() const {
     SkDebugf("ImageFilter Stats:\n"
              "      # visited filters: %d\n"
@@ -1945,6 +2009,157 @@ FilterResult FilterResult::MakeFromShader(const Context& ctx,
     return surface.snap();
 }
 
+FilterResult FilterResult::MakeFromTiles(const Context& ctx,
+                                         LayerSpace<SkIRect> bounds,
+                                         const LayerSpace<SkISize>& tileSize,
+                                         int maxTilesInFlight,
+                                         const std::function<FilterResult(const Context&)>& eval) {
+    SkASSERT(tileSize.width() > 0 && tileSize.height() > 0 && maxTilesInFlight > 0);
+    if (!bounds.intersect(ctx.desiredOutput())) {
+        return {};
+    }
+
+    std::vector<LayerSpace<SkIRect>> tiles;
+    for (int top = bounds.top(); top < bounds.bottom();
+         top = Sk32_sat_add(top, tileSize.height())) {
+        for (int left = bounds.left(); left < bounds.right();
+             left = Sk32_sat_add(left, tileSize.width())) {
+            tiles.emplace_back(SkIRect::MakeLTRB(
+                    left,
+                    top,
+                    std::min(Sk32_sat_add(left, tileSize.width()), bounds.right()),
+                    std::min(Sk32_sat_add(top, tileSize.height()), bounds.bottom())));
+        }
+    }
+    if (tiles.size() == 1) {
+        return eval(ctx.withNewDesiredOutput(bounds));
+    }
+
+    AutoSurface surface{ctx, bounds, PixelBoundary::kTransparent,
+                        /*renderInParameterSpace=*/false};
+    if (!surface) {
+        return {};
+    }
+
+    SkExecutor* executor = ctx.backend()->tileExecutor();
+    const int batchSize = executor ? std::min(maxTilesInFlight, SkToInt(tiles.size())) : 1;
+    std::vector<FilterResult> results(batchSize);
+    std::vector<Stats> stats(batchSize);
+    for (int first = 0; first < SkToInt(tiles.size()); first += batchSize) {
+        const int count = std::min(batchSize, SkToInt(tiles.size()) - first);
+        auto evalTile = [&](int i) {
+            results[i] = eval(ctx.withoutCache()
+                                 .withNewStats(&stats[i])
+                                 .withNewDesiredOutput(tiles[first + i]));
+        };
+        if (count > 1) {
+            SkTaskGroup tasks(*executor);
+            tasks.batch(count, evalTile);
+            tasks.wait();
+        } else {
+            evalTile(0);
+        }
+
+        // Drawing to the surface is not thread safe, so the tiles are assembled here. A tile's
+        // result may reach past the tile, so it's clipped to it.
+        SkDevice* device = surface.device();
+        for (int i = 0; i < count; ++i) {
+            device->pushClipStack();
+            device->clipRect(SkRect::Make(SkIRect(tiles[first + i])), SkClipOp::kIntersect,
+                             /*aa=*/false);
+            results[i].draw(ctx, device, /*preserveDeviceState=*/true);
+            device->popClipStack();
+
+            results[i] = {};
+            ctx.addStats(stats[i]);
+            stats[i] = {};
+        }
+    }
+    return surface.snap();
+}
+
+// A kernel's output is only split across the executor when each task gets at least this many rows
+// or columns, and into no more than kMaxKernelTasks tasks. Tiles of columns are a whole number of
+// kKernelTileBytes wide, so no two tasks write to the same cache line of a row.
+static constexpr int kMinKernelTaskSize = 32;
+static constexpr int kMaxKernelTasks = 64;
+static constexpr int kKernelTileBytes = 64;
+
+std::optional<FilterResult> FilterResult::MakeFromRasterKernel(
+        const Context& ctx,
+        const FilterResult& input,
+        const LayerSpace<SkIRect>& sampleBounds,
+        KernelSplit split,
+        const RasterKernel& kernel) {
+    if (ctx.backend()->colorType() != kN32_SkColorType) {
+        return std::nullopt;
+    }
+    const LayerSpace<SkIRect>& dstBounds = ctx.desiredOutput();
+    if (dstBounds.isEmpty() || sampleBounds.isEmpty()) {
+        return FilterResult{};
+    }
+
+    Context sampleCtx = ctx.withNewDesiredOutput(sampleBounds);
+    auto [image, origin] =
+            input.applyCrop(sampleCtx, sampleBounds, SkTileMode::kDecal).imageAndOffset(sampleCtx);
+    SkBitmap inputBitmap;
+    if (!image || !SkSpecialImages::AsBitmap(image.get(), &inputBitmap) ||
+        inputBitmap.colorType() != kN32_SkColorType ||
+        inputBitmap.alphaType() == kUnpremul_SkAlphaType) {
+        return std::nullopt;
+    }
+
+    // Kernels index 'src' without bounds checks, so pad the input with transparent black unless it
+    // already covers all of 'sampleBounds'.
+    const SkIRect inputRect = SkIRect::MakeXYWH(origin.x(), origin.y(),
+                                                inputBitmap.width(), inputBitmap.height());
+    SkIRect sampleRect = SkIRect(sampleBounds);
+    SkPixmap src;
+    SkBitmap padded;
+    if (inputRect.contains(sampleRect)) {
+        SkAssertResult(inputBitmap.pixmap().extractSubset(
+                &src, sampleRect.makeOffset(-inputRect.x(), -inputRect.y())));
+    } else {
+        if (!padded.tryAllocPixels(inputBitmap.info().makeDimensions(sampleRect.size()))) {
+            return std::nullopt;
+        }
+        padded.eraseColor(SK_ColorTRANSPARENT);
+        padded.writePixels(inputBitmap.pixmap(),
+                           inputRect.x() - sampleRect.x(),
+                           inputRect.y() - sampleRect.y());
+        src = padded.pixmap();
+    }
+
+    sk_sp<SkDevice> device = ctx.backend()->makeDevice(SkISize(dstBounds.size()),
+                                                       ctx.refColorSpace());
+    SkPixmap dst;
+    if (!device || !device->accessPixels(&dst)) {
+        return std::nullopt;
+    }
+    ctx.markNewSurface();
+
+    const int count = split == KernelSplit::kRows ? dst.height() : dst.width();
+    const int align =
+            split == KernelSplit::kRows ? 1 : kKernelTileBytes / dst.info().bytesPerPixel();
+    SkExecutor* executor = ctx.backend()->kernelExecutor();
+    int tasks = executor ? std::min(kMaxKernelTasks, count / std::max(kMinKernelTaskSize, align))
+                         : 1;
+    if (tasks <= 1) {
+        kernel(src, dst, 0, count);
+    } else {
+        const int size = ((count + tasks - 1) / tasks + align - 1) / align * align;
+        tasks = (count + size - 1) / size;
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.batch(tasks, [&](int i) {
+            kernel(src, dst, i * size, std::min(count, (i + 1) * size));
+        });
+        taskGroup.wait();
+    }
+
+    return FilterResult(device->snapSpecial(SkIRect::MakeSize(dst.dimensions())),
+                        dstBounds.topLeft());
+}
+
 FilterResult FilterResult::MakeFromImage(const Context& ctx,
                                          sk_sp<SkImage> image,
                                          SkRect srcRect,
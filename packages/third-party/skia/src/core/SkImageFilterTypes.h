@@ -30,6 +30,7 @@
 #include "src/core/SkSpecialImage.h"
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <utility>
 
@@ -38,10 +39,12 @@ class SkBitmap;
 class SkBlender;
 class SkBlurEngine;
 class SkDevice;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageFilterCache;
 class SkPicture;
+class SkPixmap;
 class SkShader;
 enum SkColorType : int;
 
@@ -745,6 +748,35 @@ public:
                                       ParameterSpace<SkRect> dstRect,
                                       const SkSamplingOptions& sampling);
 
+    // Evaluates 'eval' once per tile of 'bounds', intersected with the context's desired output,
+    // with a context whose desired output is just that tile, and draws the results into a single
+    // surface. Tiles are evaluated on the backend's tile executor if it has one, at most
+    // 'maxTilesInFlight' at a time, and without caching their results, so only that many tiles'
+    // intermediate images are alive at once.
+    static FilterResult MakeFromTiles(const Context& ctx,
+                                      LayerSpace<SkIRect> bounds,
+                                      const LayerSpace<SkISize>& tileSize,
+                                      int maxTilesInFlight,
+                                      const std::function<FilterResult(const Context&)>& eval);
+
+    // A CPU kernel that reads 'src' and writes the rows, or columns, [begin, end) of 'dst'. See
+    // MakeFromRasterKernel().
+    enum class KernelSplit { kRows, kColumns };
+    using RasterKernel = std::function<void(const SkPixmap& src, const SkPixmap& dst,
+                                            int begin, int end)>;
+
+    // Fills the context's desired output with 'kernel' instead of drawing a shader. 'src' holds
+    // the N32 pixels of 'input' over 'sampleBounds', transparent black where 'input' has none, and
+    // 'dst' covers the desired output. The output is split into bands of rows or tiles of columns
+    // that run on the backend's kernel executor, if it has one; each call only writes its own.
+    // Returns std::nullopt, so the caller can fall back to shaders, unless the backend is raster
+    // with an N32 color type and 'input' is not empty.
+    static std::optional<FilterResult> MakeFromRasterKernel(const Context& ctx,
+                                                            const FilterResult& input,
+                                                            const LayerSpace<SkIRect>& sampleBounds,
+                                                            KernelSplit split,
+                                                            const RasterKernel& kernel);
+
     // Bilinear is used as the default because it can be downgraded to nearest-neighbor when the
     // final transform is pixel-aligned, and chaining multiple bilinear samples and transforms is
     // assumed to be visually close enough to sampling once at highest quality and final transform.
@@ -1123,19 +1155,47 @@ public:
 
     SkImageFilterCache* cache() const { return fCache.get(); }
 
+    // The most memory that the intermediate images of one DAG evaluation should hold at once, or 0
+    // for no limit. SkImageFilter_Base::filterImageTiled() splits larger evaluations into tiles,
+    // which it runs on the tile executor, if there is one.
+    size_t scratchLimit() const { return fScratchLimit; }
+    SkExecutor* tileExecutor() const { return fTileExecutor; }
+
+    // The executor that FilterResult::MakeFromRasterKernel() splits CPU kernels across, if any.
+    SkExecutor* kernelExecutor() const { return fKernelExecutor; }
+
 protected:
     Backend(sk_sp<SkImageFilterCache> cache,
             const SkSurfaceProps& surfaceProps,
             const SkColorType colorType);
 
+    void setTiling(size_t scratchLimit, SkExecutor* tileExecutor) {
+        fScratchLimit = scratchLimit;
+        fTileExecutor = tileExecutor;
+    }
+
+    void setKernelExecutor(SkExecutor* kernelExecutor) { fKernelExecutor = kernelExecutor; }
+
 private:
     sk_sp<SkImageFilterCache> fCache;
     SkSurfaceProps fSurfaceProps;
     SkColorType fColorType;
+    size_t fScratchLimit = 0;
+    SkExecutor* fTileExecutor = nullptr;
+    SkExecutor* fKernelExecutor = nullptr;
 };
 
 sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType);
 
+// The scratch limit of raster backends made after this is set. Returns the previous value. Their
+// tile and kernel executor is SkGraphics::GetRasterExecutor() when they are made.
+size_t SetRasterScratchLimit(size_t bytes);
+
+// The bytes of pixels that intermediate images of raster backends hold now, including those kept
+// by the image filter cache, and the most they have held at once since the last reset.
+size_t RasterScratchBytes();
+size_t ResetRasterScratchPeak();
+
 // Stats for a single image filter evaluation
 struct Stats {
     int fNumVisitedImageFilters = 0; // size of the filter dag
@@ -1144,6 +1204,14 @@ struct Stats {
     int fNumShaderClampedDraws = 0; // shader-emulated clamp is fairly cheap but HW tiling is best
     int fNumShaderBasedTilingDraws = 0; // shader-emulated decal, mirror, repeat are expensive
 
+    void add(const Stats& other) {
+        fNumVisitedImageFilters += other.fNumVisitedImageFilters;
+        fNumCacheHits += other.fNumCacheHits;
+        fNumOffscreenSurfaces += other.fNumOffscreenSurfaces;
+        fNumShaderClampedDraws += other.fNumShaderClampedDraws;
+        fNumShaderBasedTilingDraws += other.fNumShaderBasedTilingDraws;
+    }
+
     void dumpStats() const;   // log to std out
     void reportStats() const; // trace event counters
 };
@@ -1170,6 +1238,9 @@ public:
 
     const Backend* backend() const { return fBackend.get(); }
 
+    // The cache that filters evaluated in this context store their results in, if any.
+    SkImageFilterCache* cache() const { return fCacheResults ? fBackend->cache() : nullptr; }
+
     // The mapping that defines the transformation from local parameter space of the filters to the
     // layer space where the image filters are evaluated, as well as the remaining transformation
     // from the layer space to the final device space. The layer space defined by the returned
@@ -1225,8 +1296,29 @@ public:
         return c;
     }
 
+    // Create a new context that matches this context, but does not cache results. The tiles of a
+    // large output would otherwise fill the cache with pieces that are unlikely to be reused.
+    Context withoutCache() const {
+        Context c = *this;
+        c.fCacheResults = false;
+        return c;
+    }
+
+    // Create a new context that matches this context, but records into other stats. Contexts used
+    // on different threads can't share stats.
+    Context withNewStats(Stats* stats) const {
+        Context c = *this;
+        c.fStats = stats;
+        return c;
+    }
+
 
     // Stats tracking
+    void addStats(const Stats& stats) const {
+        if (fStats) {
+            fStats->add(stats);
+        }
+    }
     void markVisitedImageFilter() const {
         if (fStats) {
             fStats->fNumVisitedImageFilters++;
@@ -1266,6 +1358,8 @@ private:
     sk_sp<SkColorSpace> fColorSpace;
 
     Stats* fStats;
+
+    bool fCacheResults = true;
 };
 
 } // end namespace skif
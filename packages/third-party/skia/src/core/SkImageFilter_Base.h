@@ -15,6 +15,7 @@
 #include "include/private/base/SkTemplates.h"
 
 #include "src/core/SkImageFilterTypes.h"
+#include "src/core/SkTHash.h"
 
 #include <optional>
 
@@ -35,6 +36,14 @@ public:
      */
     skif::FilterResult filterImage(const skif::Context& context) const;
 
+    /**
+     *  Like filterImage(), for the root of a DAG. If evaluating the whole desired output at once
+     *  could exceed the scratch limit of the context's backend, the output is split into tiles
+     *  that are evaluated separately, possibly in parallel, and then assembled, so that only the
+     *  intermediate images of the tiles in flight are alive at once.
+     */
+    skif::FilterResult filterImageTiled(const skif::Context& context) const;
+
     /**
      * Create a filtered version of the 'src' image using this filter. This is basically a wrapper
      * around filterImage that prepares the skif::Context to filter the 'src' image directly,
@@ -127,6 +136,10 @@ public:
     using MatrixCapability = skif::MatrixCapability;
     MatrixCapability getCTMCapability() const;
 
+    // Returns true if this filter and all of its inputs produce the same pixels, moved by the same
+    // amount, when the layer space they are evaluated in is moved by a whole number of pixels.
+    bool isTranslationInvariant() const;
+
     uint32_t uniqueID() const { return fUniqueID; }
 
     static SkFlattenable::Type GetFlattenableType() {
@@ -206,6 +219,10 @@ private:
 
     static void PurgeCache();
 
+    // The walk behind isTranslationInvariant(). Filters in 'visited' have already been found to
+    // be invariant, so a DAG that reuses its inputs is walked once per filter.
+    bool isTranslationInvariant(skia_private::THashSet<const SkImageFilter*>* visited) const;
+
     // Configuration points for the filter implementation, marked private since they should not
     // need to be invoked by the subclasses. These refer to the node's specific behavior and are
     // not responsible for aggregating the behavior of the entire filter DAG.
@@ -239,6 +256,13 @@ private:
      */
     virtual bool ignoreInputsAffectsTransparentBlack() const { return false; }
 
+    /**
+     *  Return false if this filter's output depends on where it is in layer space beyond what the
+     *  mapping of its parameters accounts for. Filters are evaluated in surfaces placed relative
+     *  to their desired output, so this is rarely the case.
+     */
+    virtual bool onIsTranslationInvariant() const { return true; }
+
     /**
      *  This is the virtual which should be overridden by the derived class to perform image
      *  filtering. Subclasses are responsible for recursing to their input filters, although the
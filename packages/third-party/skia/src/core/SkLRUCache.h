@@ -123,6 +123,12 @@ public:
         delete entry;
     }
 
+    // Removes the least recently used entry; the cache must not be empty.
+    void removeLeastRecentlyUsed() {
+        SkASSERT(fLRU.tail());
+        this->remove(fLRU.tail()->fKey);
+    }
+
 private:
     struct Traits {
         static const K& GetKey(Entry* e) {
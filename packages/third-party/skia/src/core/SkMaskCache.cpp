@@ -64,6 +64,7 @@ struct RRectBlurRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    Tier getTier() const override { return Tier::kMask; }
     const char* getCategory() const override { return "rrect-blur"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
@@ -152,6 +153,7 @@ struct RectsBlurRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    Tier getTier() const override { return Tier::kMask; }
     const char* getCategory() const override { return "rects-blur"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
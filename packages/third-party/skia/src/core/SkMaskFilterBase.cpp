@@ -10,6 +10,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkRegion.h"
@@ -30,7 +31,6 @@
 #include <optional>
 
 class SkPaint;
-class SkRRect;
 
 SkMaskFilterBase::NinePatch::~NinePatch() {
     if (fCache) {
@@ -219,6 +219,10 @@ bool SkMaskFilterBase::filterRRect(const SkRRect& devRRect,
                                    const SkRasterClip& clip,
                                    SkBlitter* blitter,
                                    SkResourceCache* cache) const {
+    if (this->filterRRectAnalytic(devRRect, matrix, clip, blitter)) {
+        return true;
+    }
+
     // Attempt to speed up drawing by creating a nine patch. If a nine patch
     // cannot be used, return false to allow our caller to recover and perform
     // the drawing another way.
@@ -237,6 +241,11 @@ SkMaskFilterBase::FilterReturn SkMaskFilterBase::filterRects(SkSpan<const SkRect
                                                              const SkRasterClip& clip,
                                                              SkBlitter* blitter,
                                                              SkResourceCache* cache) const {
+    if (devRects.size() == 1 &&
+        this->filterRRectAnalytic(SkRRect::MakeRect(devRects[0]), matrix, clip, blitter)) {
+        return FilterReturn::kTrue;
+    }
+
     std::optional<NinePatch> patch;
 
     FilterReturn filterReturn = this->filterRectsToNine(
@@ -321,6 +330,13 @@ bool SkMaskFilterBase::filterPath(const SkPathRaw& devRaw,
     return true;
 }
 
+bool SkMaskFilterBase::filterRRectAnalytic(const SkRRect&,
+                                           const SkMatrix&,
+                                           const SkRasterClip&,
+                                           SkBlitter*) const {
+    return false;
+}
+
 std::optional<SkMaskFilterBase::NinePatch> SkMaskFilterBase::filterRRectToNine(
         const SkRRect&, const SkMatrix&, const SkIRect&, SkResourceCache*) const {
     return std::nullopt;
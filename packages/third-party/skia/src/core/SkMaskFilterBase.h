@@ -173,6 +173,17 @@ protected:
                                                        const SkIRect& clipBounds,
                                                        SkResourceCache*) const;
 
+    /**
+     *  Some filters can compute the filtered coverage of a rect or round rect in device space
+     *  directly, pixel by pixel, without building a mask. Override to do that and blit the
+     *  result through the clip, returning true. Returning false (the default) makes the caller
+     *  fall back to the nine-patch and mask paths.
+     */
+    virtual bool filterRRectAnalytic(const SkRRect& devRRect,
+                                     const SkMatrix&,
+                                     const SkRasterClip&,
+                                     SkBlitter*) const;
+
 private:
     friend class skcpu::Draw;
 
@@ -18,6 +18,8 @@
 #include "src/core/SkMipmap.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
+
 class SkImage;
 
 // Try to load from the base image, or from the cache
@@ -33,7 +35,8 @@ static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
 }
 
 SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& inv,
-                                   SkMipmapMode requestedMode) {
+                                   const SkSamplingOptions& sampling) {
+    const SkMipmapMode requestedMode = sampling.mipmap;
     SkMipmapMode resolvedMode = requestedMode;
     fLowerWeight = 0;
 
@@ -41,7 +44,12 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
         // only do this once
         if (fBaseStorage.getPixels() == nullptr) {
             auto dContext = as_IB(image)->directContext();
-            (void)image->getROPixels(dContext, &fBaseStorage);
+            const SkISize minDimensions = MinBaseDimensions(image, inv, sampling);
+            if (minDimensions == image->dimensions()) {
+                (void)image->getROPixels(dContext, &fBaseStorage);
+            } else {
+                (void)image->getScaledROPixels(dContext, minDimensions, &fBaseStorage);
+            }
             fUpper.reset(fBaseStorage.info(), fBaseStorage.getPixels(), fBaseStorage.rowBytes());
         }
     };
@@ -109,8 +117,26 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
 }
 
 SkMipmapAccessor* SkMipmapAccessor::Make(SkArenaAlloc* alloc, const SkImage* image,
-                                         const SkMatrix& inv, SkMipmapMode mipmap) {
-    auto* access = alloc->make<SkMipmapAccessor>(as_IB(image), inv, mipmap);
+                                         const SkMatrix& inv, const SkSamplingOptions& sampling) {
+    auto* access = alloc->make<SkMipmapAccessor>(as_IB(image), inv, sampling);
     // return null if we failed to get the level (so the caller won't try to use it)
     return access->fUpper.addr() ? access : nullptr;
 }
+
+SkISize SkMipmapAccessor::MinBaseDimensions(const SkImage* image, const SkMatrix& inv,
+                                            const SkSamplingOptions& sampling) {
+    // Nearest sampling picks individual texels, and mipmaps are built from the full base.
+    SkSize scale;
+    if (sampling.mipmap != SkMipmapMode::kNone ||
+        (!sampling.useCubic && sampling.filter != SkFilterMode::kLinear) ||
+        !inv.decomposeScale(&scale, nullptr)) {
+        return image->dimensions();
+    }
+    // The axes of the decomposition need not be the image's, so use the lesser shrink for both.
+    const float shrink = std::min(scale.width(), scale.height());
+    if (!(shrink > 1)) {
+        return image->dimensions();
+    }
+    return {std::min(sk_float_ceil2int(image->width()  / shrink), image->width()),
+            std::min(sk_float_ceil2int(image->height() / shrink), image->height())};
+}
@@ -21,12 +21,19 @@
 class SkArenaAlloc;
 class SkImage;
 class SkImage_Base;
-enum class SkMipmapMode;
+struct SkSamplingOptions;
 
 class SkMipmapAccessor : ::SkNoncopyable {
 public:
-    // Returns null on failure
-    static SkMipmapAccessor* Make(SkArenaAlloc*, const SkImage*, const SkMatrix& inv, SkMipmapMode);
+    // Returns null on failure. When the sampling filters without mipmaps and inv shrinks the
+    // image, the upper level may be a reduced-size decode of a lazy image rather than its base.
+    static SkMipmapAccessor* Make(SkArenaAlloc*, const SkImage*, const SkMatrix& inv,
+                                  const SkSamplingOptions&);
+
+    // The smallest size the image can be sampled from under inv (device to image) without losing
+    // detail, or the image's own dimensions if inv does not shrink it or the sampling needs them.
+    static SkISize MinBaseDimensions(const SkImage*, const SkMatrix& inv,
+                                     const SkSamplingOptions&);
 
     std::pair<SkPixmap, SkMatrix> level() const {
         SkASSERT(fUpper.addr() != nullptr);
@@ -54,7 +61,7 @@ private:
 
 public:
     // Don't call publicly -- this is only public for SkArenaAlloc to access it inside Make()
-    SkMipmapAccessor(const SkImage_Base*, const SkMatrix& inv, SkMipmapMode requestedMode);
+    SkMipmapAccessor(const SkImage_Base*, const SkMatrix& inv, const SkSamplingOptions&);
 };
 
 #endif
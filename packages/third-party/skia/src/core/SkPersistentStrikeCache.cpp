@@ -0,0 +1,288 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkPersistentStrikeCache.h"
+
+#include "include/core/SkData.h"
+#include "include/core/SkFontArguments.h"
+#include "include/core/SkFontMetrics.h"
+#include "include/core/SkFontStyle.h"
+#include "include/core/SkMilestone.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkDescriptor.h"
+#include "src/core/SkFontMetricsPriv.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkScalerContext.h"
+#include "src/core/SkStrike.h"
+#include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTHash.h"
+#include "src/core/SkWriteBuffer.h"
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace {
+constexpr uint32_t kMagic = SkSetFourByteTag('s', 'k', 's', 'c');
+constexpr uint32_t kVersion = 2;
+
+#if defined(SK_CPU_BENDIAN)
+constexpr uint32_t kByteOrder = 1;
+#else
+constexpr uint32_t kByteOrder = 0;
+#endif
+
+// The header is written field by field in little-endian order, so that any reader can check it.
+// The payload is written by SkWriteBuffer in the writer's native byte order, which the header
+// records; a reader with a different byte order rejects the file.
+struct Header {
+    uint32_t fMagic;
+    uint32_t fVersion;
+    uint32_t fByteOrder;
+    uint32_t fMilestone;
+    uint32_t fStrikeCount;
+    uint64_t fPayloadSize;
+    uint64_t fPayloadChecksum;
+
+    static constexpr size_t kSize = 5 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+    void write(uint8_t bytes[kSize]) const {
+        auto put = [&](uint64_t value, int size) {
+            for (int i = 0; i < size; i++) {
+                *bytes++ = static_cast<uint8_t>(value >> (8 * i));
+            }
+        };
+        put(fMagic, 4);
+        put(fVersion, 4);
+        put(fByteOrder, 4);
+        put(fMilestone, 4);
+        put(fStrikeCount, 4);
+        put(fPayloadSize, 8);
+        put(fPayloadChecksum, 8);
+    }
+
+    static Header Read(const uint8_t bytes[kSize]) {
+        auto get = [&](int size) {
+            uint64_t value = 0;
+            for (int i = 0; i < size; i++) {
+                value |= static_cast<uint64_t>(*bytes++) << (8 * i);
+            }
+            return value;
+        };
+        Header header;
+        header.fMagic = static_cast<uint32_t>(get(4));
+        header.fVersion = static_cast<uint32_t>(get(4));
+        header.fByteOrder = static_cast<uint32_t>(get(4));
+        header.fMilestone = static_cast<uint32_t>(get(4));
+        header.fStrikeCount = static_cast<uint32_t>(get(4));
+        header.fPayloadSize = get(8);
+        header.fPayloadChecksum = get(8);
+        return header;
+    }
+};
+
+// Replace the typeface ID recorded in the descriptor with the ID of the typeface in this process.
+bool rewrite_typeface_id(SkDescriptor* descriptor, SkTypefaceID typefaceID) {
+    uint32_t size;
+    void* ptr = const_cast<void*>(descriptor->findEntry(kRec_SkDescriptorTag, &size));
+    SkScalerContextRec rec;
+    if (!ptr || size != sizeof(rec)) { return false; }
+    std::memcpy((void*)&rec, ptr, size);
+    rec.fTypefaceID = typefaceID;
+    std::memcpy(ptr, &rec, size);
+    descriptor->computeChecksum();
+    return true;
+}
+}  // namespace
+
+uint64_t SkPersistentStrikeCache::TypefaceKey(const SkTypeface& typeface) {
+    // The 'head' table carries the font revision, creation and modification dates, and the
+    // checksum adjustment of the whole font, which together identify the font file.
+    static constexpr SkFontTableTag kHeadTag = SkSetFourByteTag('h', 'e', 'a', 'd');
+    const size_t headSize = typeface.getTableSize(kHeadTag);
+    if (headSize == 0) {
+        return 0;
+    }
+
+    SkDynamicMemoryWStream key;
+    skia_private::AutoTMalloc<uint8_t> head(headSize);
+    if (typeface.getTableData(kHeadTag, 0, headSize, head.get()) != headSize) {
+        return 0;
+    }
+    key.write(head.get(), headSize);
+
+    SkString familyName;
+    typeface.getFamilyName(&familyName);
+    key.write(familyName.c_str(), familyName.size());
+
+    const SkFontStyle style = typeface.fontStyle();
+    key.write32(style.weight());
+    key.write32(style.width());
+    key.write32(style.slant());
+    key.write32(typeface.countGlyphs());
+
+    // Named instances and variations of one font file share its tables.
+    using Coordinate = SkFontArguments::VariationPosition::Coordinate;
+    const int axisCount = typeface.getVariationDesignPosition({});
+    if (axisCount > 0) {
+        std::vector<Coordinate> coordinates(axisCount);
+        if (typeface.getVariationDesignPosition(coordinates) == axisCount) {
+            for (const Coordinate& coordinate : coordinates) {
+                key.write32(coordinate.axis);
+                key.writeScalar(coordinate.value);
+            }
+        }
+    }
+
+    sk_sp<SkData> bytes = key.detachAsData();
+    // Zero is reserved for typefaces without a key.
+    const uint64_t hash = SkChecksum::Hash64(bytes->data(), bytes->size());
+    return hash != 0 ? hash : 1;
+}
+
+int SkPersistentStrikeCache::Write(SkStrikeCache* cache, size_t byteBudget, SkWStream* stream) {
+    // Collect the strikes in most recently used order. They are serialized after the cache lock
+    // is released, because flattening a strike takes its own lock.
+    std::vector<sk_sp<SkStrike>> strikes;
+    {
+        SkAutoMutexExclusive lock{cache->fLock};
+        for (SkStrike* strike = cache->fHead; strike != nullptr; strike = strike->fNext) {
+            if (strike->fPinner == nullptr) {
+                strikes.push_back(sk_ref_sp(strike));
+            }
+        }
+    }
+
+    SkBinaryWriteBuffer payload{{}};
+    SkBinaryWriteBuffer strikeBuffer{{}};
+    uint32_t strikeCount = 0;
+    for (const sk_sp<SkStrike>& strike : strikes) {
+        const uint64_t typefaceKey = TypefaceKey(strike->strikeSpec().typeface());
+        if (typefaceKey == 0) {
+            continue;
+        }
+
+        strikeBuffer.reset();
+        strike->getDescriptor().flatten(strikeBuffer);
+        SkFontMetricsPriv::Flatten(strikeBuffer, strike->getFontMetrics());
+        strike->flattenCachedGlyphs(strikeBuffer);
+
+        if (payload.bytesWritten() + strikeBuffer.bytesWritten() > byteBudget) {
+            break;
+        }
+        sk_sp<SkData> strikeData = strikeBuffer.snapshotAsData();
+        payload.writeUInt(static_cast<uint32_t>(typefaceKey));
+        payload.writeUInt(static_cast<uint32_t>(typefaceKey >> 32));
+        payload.writeDataAsByteArray(strikeData.get());
+        strikeCount++;
+    }
+
+    sk_sp<SkData> payloadData = payload.snapshotAsData();
+    Header header;
+    header.fMagic = kMagic;
+    header.fVersion = kVersion;
+    header.fByteOrder = kByteOrder;
+    header.fMilestone = SK_MILESTONE;
+    header.fStrikeCount = strikeCount;
+    header.fPayloadSize = payloadData->size();
+    header.fPayloadChecksum = SkChecksum::Hash64(payloadData->data(), payloadData->size());
+    uint8_t headerBytes[Header::kSize];
+    header.write(headerBytes);
+    if (!stream->write(headerBytes, sizeof(headerBytes)) ||
+        !stream->write(payloadData->data(), payloadData->size())) {
+        return -1;
+    }
+    return strikeCount;
+}
+
+int SkPersistentStrikeCache::Read(SkStrikeCache* cache,
+                                  const SkData& data,
+                                  SkSpan<const sk_sp<SkTypeface>> typefaces) {
+    if (data.size() < Header::kSize) {
+        return 0;
+    }
+    const Header header = Header::Read(data.bytes());
+    const uint8_t* payloadBytes = data.bytes() + Header::kSize;
+    if (header.fMagic != kMagic ||
+        header.fVersion != kVersion ||
+        header.fByteOrder != kByteOrder ||
+        header.fMilestone != SK_MILESTONE ||
+        header.fPayloadSize != data.size() - Header::kSize ||
+        header.fPayloadChecksum != SkChecksum::Hash64(payloadBytes, header.fPayloadSize)) {
+        return 0;
+    }
+
+    skia_private::THashMap<uint64_t, SkTypeface*> typefaceForKey;
+    for (const sk_sp<SkTypeface>& typeface : typefaces) {
+        if (typeface != nullptr) {
+            if (uint64_t key = TypefaceKey(*typeface); key != 0) {
+                typefaceForKey.set(key, typeface.get());
+            }
+        }
+    }
+
+    SkReadBuffer payload{payloadBytes, header.fPayloadSize};
+    int strikesAdded = 0;
+    for (uint32_t i = 0; i < header.fStrikeCount && payload.isValid(); i++) {
+        uint64_t typefaceKey = payload.readUInt();
+        typefaceKey |= static_cast<uint64_t>(payload.readUInt()) << 32;
+        size_t strikeSize;
+        const void* strikeBytes = payload.skipByteArray(&strikeSize);
+        if (!payload.isValid()) {
+            break;
+        }
+
+        SkTypeface** typeface = typefaceForKey.find(typefaceKey);
+        if (typeface == nullptr) {
+            continue;
+        }
+
+        SkReadBuffer strikeBuffer{strikeBytes, strikeSize};
+        std::optional<SkAutoDescriptor> descriptor = SkAutoDescriptor::MakeFromBuffer(strikeBuffer);
+        if (!strikeBuffer.validate(descriptor.has_value())) {
+            continue;
+        }
+        std::optional<SkFontMetrics> fontMetrics = SkFontMetricsPriv::MakeFromBuffer(strikeBuffer);
+        if (!strikeBuffer.validate(fontMetrics.has_value())) {
+            continue;
+        }
+        if (!rewrite_typeface_id(descriptor->getDesc(), (*typeface)->uniqueID())) {
+            continue;
+        }
+
+        // The strike is filled before it is published, so no draw can install a glyph that the
+        // buffer also carries. It counts as removed until then, which keeps the merge from adding
+        // its memory to the cache twice.
+        SkStrikeSpec strikeSpec{*descriptor->getDesc(), sk_ref_sp(*typeface)};
+        auto strike = sk_make_sp<SkStrike>(
+                cache, strikeSpec, strikeSpec.createScalerContext(), &fontMetrics.value(), nullptr);
+        strike->fRemoved = true;
+        // Glyphs merged before a failure are complete, so the strike is kept even then.
+        const bool merged = strike->mergeFromBuffer(strikeBuffer);
+
+        // A strike that is already in use has glyphs that would collide with the saved ones. The
+        // lookup and the insert are done under one lock so that a strike created by another
+        // thread in between is not replaced.
+        SkAutoMutexExclusive lock{cache->fLock};
+        if (cache->internalFindStrikeOrNull(*descriptor->getDesc()) != nullptr) {
+            continue;
+        }
+        strike->fRemoved = false;
+        cache->internalAttachToHead(std::move(strike));
+        if (merged) {
+            strikesAdded++;
+        }
+    }
+    return strikesAdded;
+}
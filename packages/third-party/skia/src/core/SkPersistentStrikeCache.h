@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPersistentStrikeCache_DEFINED
+#define SkPersistentStrikeCache_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class SkData;
+class SkStrikeCache;
+class SkTypeface;
+class SkWStream;
+
+// SkPersistentStrikeCache saves the glyph metrics, images and paths of the hot strikes of an
+// SkStrikeCache so a later process can start with warm strikes instead of rasterizing again.
+// Strikes are written with the same glyph serialization used by the remote glyph cache, keyed by
+// a hash of their typeface's data and by their descriptor.
+//
+// The file starts with a little-endian header that records the format version, the byte order of
+// the payload, the Skia milestone and a checksum of the payload. Files that do not validate are
+// ignored as a whole.
+class SkPersistentStrikeCache {
+public:
+    // Write the most recently used strikes of cache, until about byteBudget bytes have been
+    // written. Strikes owned by a remote glyph cache client are skipped. Returns the number of
+    // strikes written, or -1 if the stream could not be written.
+    static int Write(SkStrikeCache* cache, size_t byteBudget, SkWStream* stream);
+
+    // Add the strikes in data whose typeface matches one of typefaces to cache. Strikes that
+    // already exist in cache are left alone. Returns the number of strikes added.
+    static int Read(SkStrikeCache* cache,
+                    const SkData& data,
+                    SkSpan<const sk_sp<SkTypeface>> typefaces);
+
+    // A hash of the typeface that is stable between processes. Returns 0 if the typeface has no
+    // data that identifies it.
+    static uint64_t TypefaceKey(const SkTypeface& typeface);
+};
+
+#endif  // SkPersistentStrikeCache_DEFINED
@@ -202,6 +202,23 @@ struct TablesCtx {
     const uint8_t *r, *g, *b, *a;
 };
 
+// A 3D table of size^3 RGB entries, with red varying fastest and blue slowest. 'scale' is size-1.
+struct Lut3DCtx {
+    const float* table;
+    uint32_t size;
+    float scale;
+};
+
+// A rect or round rect with circular corners, centered on (centerX, centerY), blurred by a
+// Gaussian with standard deviation sigma. invSigmaSqrt2 is 1 / (sigma * sqrt(2)).
+struct RRectBlurCtx {
+    float centerX, centerY;
+    float halfWidth, halfHeight;
+    float cornerRadius;
+    float sigma;
+    float invSigmaSqrt2;
+};
+
 using SkRPOffset = uint32_t;
 
 struct InitLaneMasksCtx {
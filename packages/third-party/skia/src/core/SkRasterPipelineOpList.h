@@ -178,6 +178,7 @@
     M(gather_10101010_xr) M(load_10101010_xr)    M(load_10101010_xr_dst) M(store_10101010_xr) \
     M(store_src_rg)       M(load_src_rg)                                       \
     M(byte_tables)                                                             \
+    M(lut_3d_trilinear) M(lut_3d_tetrahedral)                                  \
     M(colorburn) M(colordodge) M(softlight)                                    \
     M(hue) M(saturation) M(color) M(luminosity)                                \
     M(matrix_3x3) M(matrix_3x4) M(matrix_4x5) M(matrix_4x3)                    \
@@ -188,6 +189,7 @@
     M(css_hcl_to_lab)                                                          \
     M(css_hsl_to_srgb) M(css_hwb_to_srgb)                                      \
     M(gauss_a_to_rgba)                                                         \
+    M(rrect_blur_coverage)                                                     \
     M(mirror_x)   M(repeat_x)                                                  \
     M(mirror_y)   M(repeat_y)                                                  \
     M(negate_x)                                                                \
@@ -84,6 +84,17 @@ namespace {
 class SkResourceCache::Hash :
     public THashTable<SkResourceCache::Rec*, SkResourceCache::Key, HashTraits> {};
 
+static int tier_index(SkResourceCache::Tier tier) { return static_cast<int>(tier); }
+
+const char* SkResourceCache::TierName(Tier tier) {
+    switch (tier) {
+        case Tier::kMask:    return "mask";
+        case Tier::kDefault: return "default";
+        case Tier::kImage:   return "image";
+    }
+    SkUNREACHABLE;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -94,6 +105,11 @@ void SkResourceCache::init() {
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
+    for (int i = 0; i < kTierCount; ++i) {
+        fTierBytesUsed[i] = 0;
+        fTierByteLimit[i] = 0;
+        fTierCount[i] = 0;
+    }
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
@@ -196,6 +212,10 @@ void SkResourceCache::remove(Rec* rec) {
 
     fTotalBytesUsed -= used;
     fCount -= 1;
+    const int tier = tier_index(rec->getTier());
+    SkASSERT(used <= fTierBytesUsed[tier]);
+    fTierBytesUsed[tier] -= used;
+    fTierCount[tier] -= 1;
 
     //SkDebugf("-RC count [%3d] bytes %d\n", fCount, fTotalBytesUsed);
 
@@ -222,20 +242,51 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         byteLimit = fTotalByteLimit;
     }
 
+    auto overAnyTierLimit = [this] {
+        for (int i = 0; i < kTierCount; ++i) {
+            if (this->isOverTierLimit(static_cast<Tier>(i))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        const bool overTotal = forcePurge || fTotalBytesUsed >= byteLimit || fCount >= countLimit;
+        if (!overTotal && !overAnyTierLimit()) {
             break;
         }
 
         Rec* prev = rec->fPrev;
-        if (rec->canBePurged()) {
+        if ((overTotal || this->isOverTierLimit(rec->getTier())) && rec->canBePurged()) {
             this->remove(rec);
         }
         rec = prev;
     }
 }
 
+bool SkResourceCache::isOverTierLimit(Tier tier) const {
+    const size_t limit = fTierByteLimit[tier_index(tier)];
+    return limit > 0 && fTierBytesUsed[tier_index(tier)] > limit;
+}
+
+size_t SkResourceCache::purgeToTarget(size_t targetBytes) {
+    this->checkMessages();
+
+    for (int tier = 0; tier < kTierCount && fTotalBytesUsed > targetBytes; ++tier) {
+        Rec* rec = fTail;
+        while (rec && fTotalBytesUsed > targetBytes) {
+            Rec* prev = rec->fPrev;
+            if (tier_index(rec->getTier()) == tier && rec->canBePurged()) {
+                this->remove(rec);
+            }
+            rec = prev;
+        }
+    }
+    return fTotalBytesUsed;
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -301,6 +352,27 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
+size_t SkResourceCache::getTierBytesUsed(Tier tier) const {
+    return fTierBytesUsed[tier_index(tier)];
+}
+
+int SkResourceCache::getTierRecCount(Tier tier) const {
+    return fTierCount[tier_index(tier)];
+}
+
+size_t SkResourceCache::getTierByteLimit(Tier tier) const {
+    return fTierByteLimit[tier_index(tier)];
+}
+
+size_t SkResourceCache::setTierByteLimit(Tier tier, size_t newLimit) {
+    size_t prevLimit = fTierByteLimit[tier_index(tier)];
+    fTierByteLimit[tier_index(tier)] = newLimit;
+    if (newLimit && (!prevLimit || newLimit < prevLimit)) {
+        this->purgeAsNeeded();
+    }
+    return prevLimit;
+}
+
 SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
     this->checkMessages();
 
@@ -367,6 +439,8 @@ void SkResourceCache::addToHead(Rec* rec) {
     }
     fTotalBytesUsed += rec->bytesUsed();
     fCount += 1;
+    fTierBytesUsed[tier_index(rec->getTier())] += rec->bytesUsed();
+    fTierCount[tier_index(rec->getTier())] += 1;
 
     this->validate();
 }
@@ -395,14 +469,22 @@ void SkResourceCache::validate() const {
 
     size_t used = 0;
     int count = 0;
+    size_t tierUsed[kTierCount] = {};
+    int tierCount[kTierCount] = {};
     const Rec* rec = fHead;
     while (rec) {
         count += 1;
         used += rec->bytesUsed();
         SkASSERT(used <= fTotalBytesUsed);
+        tierUsed[tier_index(rec->getTier())] += rec->bytesUsed();
+        tierCount[tier_index(rec->getTier())] += 1;
         rec = rec->fNext;
     }
     SkASSERT(fCount == count);
+    for (int i = 0; i < kTierCount; ++i) {
+        SkASSERT(tierUsed[i] == fTierBytesUsed[i]);
+        SkASSERT(tierCount[i] == fTierCount[i]);
+    }
 
     rec = fTail;
     while (rec) {
@@ -423,6 +505,10 @@ void SkResourceCache::dump() const {
 
     SkDebugf("SkResourceCache: count=%d bytes=%zu %s\n",
              fCount, fTotalBytesUsed, fDiscardableFactory ? "discardable" : "malloc");
+    for (int i = 0; i < kTierCount; ++i) {
+        SkDebugf("    %-7s count=%d bytes=%zu limit=%zu\n", TierName(static_cast<Tier>(i)),
+                 fTierCount[i], fTierBytesUsed[i], fTierByteLimit[i]);
+    }
 }
 
 size_t SkResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
@@ -510,6 +596,22 @@ size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
     return get_cache()->getEffectiveSingleAllocationByteLimit();
 }
 
+size_t SkResourceCache::GetTierBytesUsed(Tier tier) {
+    return get_cache()->getTierBytesUsed(tier);
+}
+
+size_t SkResourceCache::GetTierByteLimit(Tier tier) {
+    return get_cache()->getTierByteLimit(tier);
+}
+
+size_t SkResourceCache::SetTierByteLimit(Tier tier, size_t newLimit) {
+    return get_cache()->setTierByteLimit(tier, newLimit);
+}
+
+size_t SkResourceCache::PurgeToTarget(size_t targetBytes) {
+    return get_cache()->purgeToTarget(targetBytes);
+}
+
 void SkResourceCache::PurgeAll() {
     return get_cache()->purgeAll();
 }
@@ -567,4 +669,17 @@ void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
     // Since resource could be backed by malloc or discardable, the cache always dumps detailed
     // stats to be accurate.
     VisitAll(sk_trace_dump_visitor, dump);
+
+    // The totals per tier count the same memory again, so they are not dumped as "size".
+    SkSynchronizedResourceCache* cache = get_cache();
+    for (int i = 0; i < kTierCount; ++i) {
+        const Tier tier = static_cast<Tier>(i);
+        SkString dumpName = SkStringPrintf("skia/sk_resource_cache_tiers/%s", TierName(tier));
+        dump->dumpNumericValue(dumpName.c_str(), "used_bytes", "bytes",
+                               cache->getTierBytesUsed(tier));
+        dump->dumpNumericValue(dumpName.c_str(), "limit_bytes", "bytes",
+                               cache->getTierByteLimit(tier));
+        dump->dumpNumericValue(dumpName.c_str(), "object_count", "objects",
+                               cache->getTierRecCount(tier));
+    }
 }
@@ -73,8 +73,24 @@ public:
         const uint32_t* as32() const { return (const uint32_t*)this; }
     };
 
+    /**
+     *  Recs are grouped into tiers by how costly they are to recreate. Under memory pressure
+     *  (see purgeToTarget()) every purgeable rec of a lower tier is purged before any of a higher
+     *  one. Each tier may also have a byte limit of its own, enforced like the total limit.
+     */
+    enum class Tier {
+        kMask,      // blur and shadow masks, which are quick to redraw
+        kDefault,   // other data derived from images, such as mipmaps
+        kImage,     // decoded images and their planes
+
+        kLast = kImage,
+    };
+    static constexpr int kTierCount = static_cast<int>(Tier::kLast) + 1;
+    static const char* TierName(Tier);
+
     struct Rec {
         typedef SkResourceCache::Key Key;
+        typedef SkResourceCache::Tier Tier;
 
         Rec() {}
         virtual ~Rec() {}
@@ -100,6 +116,9 @@ public:
         // happen during the add.
         virtual void postAddInstall(void*) {}
 
+        // The tier this rec is purged with. It must not change while the rec is in the cache.
+        virtual Tier getTier() const { return Tier::kDefault; }
+
         // for memory usage diagnostics
         virtual const char* getCategory() const = 0;
         virtual SkDiscardableMemory* diagnostic_only_getDiscardable() const { return nullptr; }
@@ -166,6 +185,12 @@ public:
     static size_t GetSingleAllocationByteLimit();
     static size_t GetEffectiveSingleAllocationByteLimit();
 
+    static size_t GetTierBytesUsed(Tier);
+    static size_t GetTierByteLimit(Tier);
+    static size_t SetTierByteLimit(Tier, size_t newLimit);
+
+    static size_t PurgeToTarget(size_t targetBytes);
+
     static void PurgeAll();
     static void CheckMessages();
 
@@ -244,6 +269,26 @@ public:
      */
     virtual size_t setTotalByteLimit(size_t newLimit);
 
+    /**
+     *  Bytes used by, and the number of, the recs in a tier.
+     */
+    virtual size_t getTierBytesUsed(Tier) const;
+    virtual int getTierRecCount(Tier) const;
+
+    /**
+     *  Set the maximum number of bytes the recs in a tier may use, in addition to the total
+     *  limit, and return the previous value. Zero, the default, means no limit of its own.
+     */
+    virtual size_t getTierByteLimit(Tier) const;
+    virtual size_t setTierByteLimit(Tier, size_t newLimit);
+
+    /**
+     *  For memory pressure: purge recs until no more than targetBytes are used, lowest tier
+     *  first and least recently used first within a tier. Recs that cannot be purged are kept,
+     *  so this may stop above the target. Returns the bytes used afterwards.
+     */
+    virtual size_t purgeToTarget(size_t targetBytes);
+
     virtual void purgeSharedID(uint64_t sharedID);
 
     virtual void purgeAll() {
@@ -273,10 +318,15 @@ private:
     size_t  fSingleAllocationByteLimit;
     int     fCount;
 
+    size_t  fTierBytesUsed[kTierCount];
+    size_t  fTierByteLimit[kTierCount];
+    int     fTierCount[kTierCount];
+
     SkMessageBus<PurgeSharedIDMessage, uint32_t>::Inbox fPurgeSharedIDInbox;
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    bool isOverTierLimit(Tier) const;
 
     // linklist management
     void moveToHead(Rec*);
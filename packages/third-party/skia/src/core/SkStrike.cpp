@@ -9,6 +9,7 @@
 
 #include "include/core/SkDrawable.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkString.h"
@@ -16,14 +17,17 @@
 #include "include/core/SkTypeface.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTFitsIn.h"
+#include "include/private/base/SkTo.h"
 #include "src/core/SkGlyph.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrikeCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <algorithm>
 #include <cctype>
 #include <new>
 #include <optional>
@@ -114,6 +118,20 @@ SkStrike::FlattenGlyphsByType(SkWriteBuffer& buffer,
     }
 }
 
+void SkStrike::flattenCachedGlyphs(SkWriteBuffer& buffer) {
+    std::vector<SkGlyph> images, paths;
+    SkAutoMutexExclusive lock{fStrikeLock};
+    for (SkGlyph* glyph : fGlyphForIndex) {
+        if (glyph->setImageHasBeenCalled()) {
+            images.push_back(*glyph);
+        }
+        if (glyph->setPathHasBeenCalled()) {
+            paths.push_back(*glyph);
+        }
+    }
+    FlattenGlyphsByType(buffer, images, paths, {});
+}
+
 bool SkStrike::mergeFromBuffer(SkReadBuffer& buffer) {
     // Read glyphs with images for the current strike.
     const int imagesCount = buffer.readInt();
@@ -231,15 +249,87 @@ SkSpan<const SkGlyph*> SkStrike::prepareImages(
         SkSpan<const SkPackedGlyphID> glyphIDs, const SkGlyph* results[]) {
     const SkGlyph** cursor = results;
     Monitor m{this};
+
+    // Remote strikes get their images from the server, so they are always prepared serially.
+    SkExecutor* executor = fStrikeCache != nullptr && fPinner == nullptr
+                                   ? SkGraphics::GetRasterExecutor()
+                                   : nullptr;
+    if (executor == nullptr || glyphIDs.size() < 2 * kMinGlyphsPerImageTask) {
+        for (auto glyphID : glyphIDs) {
+            SkGlyph* glyph = this->glyph(glyphID);
+            this->prepareForImage(glyph);
+            *cursor++ = glyph;
+        }
+        return {results, glyphIDs.size()};
+    }
+
+    std::vector<SkGlyph*> coldGlyphs;
     for (auto glyphID : glyphIDs) {
         SkGlyph* glyph = this->glyph(glyphID);
-        this->prepareForImage(glyph);
+        if (!glyph->setImageHasBeenCalled()) {
+            coldGlyphs.push_back(glyph);
+        }
         *cursor++ = glyph;
     }
 
+    // A run usually repeats glyphs; rasterize each of them once.
+    std::sort(coldGlyphs.begin(), coldGlyphs.end());
+    coldGlyphs.erase(std::unique(coldGlyphs.begin(), coldGlyphs.end()), coldGlyphs.end());
+
+    if (coldGlyphs.size() < 2 * kMinGlyphsPerImageTask) {
+        for (SkGlyph* glyph : coldGlyphs) {
+            this->prepareForImage(glyph);
+        }
+    } else {
+        this->prepareImagesInParallel(coldGlyphs, executor);
+    }
+
     return {results, glyphIDs.size()};
 }
 
+void SkStrike::prepareImagesInParallel(SkSpan<SkGlyph*> glyphs, SkExecutor* executor) {
+    const int taskCount = std::min<int>(kMaxImageTasks,
+                                        SkTo<int>(glyphs.size() / kMinGlyphsPerImageTask));
+
+    // The tasks only see copies of the glyphs, so the strike is never touched off this thread.
+    std::vector<SkGlyph> scratchGlyphs;
+    scratchGlyphs.reserve(glyphs.size());
+    for (const SkGlyph* glyph : glyphs) {
+        scratchGlyphs.push_back(*glyph);
+    }
+    std::vector<std::unique_ptr<SkArenaAlloc>> scratchAllocs(taskCount);
+
+    // Besides the copies, the tasks only read the strike spec, which never changes, so the lock
+    // can be released while they run.
+    this->unlock();
+    SkTaskGroup tasks{*executor};
+    tasks.batch(taskCount, [&](int task) {
+        // SkScalerContexts are not thread safe, so each task rasterizes with its own.
+        std::unique_ptr<SkScalerContext> scaler = fStrikeSpec.createScalerContext();
+        scratchAllocs[task] = std::make_unique<SkArenaAlloc>(kMinAllocAmount);
+        // Interleave the glyphs so large and small ones are spread over the tasks.
+        for (size_t i = task; i < scratchGlyphs.size(); i += taskCount) {
+            scratchGlyphs[i].setImage(scratchAllocs[task].get(), scaler.get());
+        }
+    });
+    tasks.wait();
+    this->lock();
+
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        // Another thread may have prepared the glyph while the lock was released.
+        if (glyphs[i]->setImageHasBeenCalled()) {
+            continue;
+        }
+        const SkGlyph& scratch = scratchGlyphs[i];
+        if (scratch.setImageHasBeenCalled() && scratch.image() != nullptr &&
+            glyphs[i]->setImage(&fAlloc, scratch.image())) {
+            fMemoryIncrease += glyphs[i]->imageSize();
+        } else {
+            this->prepareForImage(glyphs[i]);
+        }
+    }
+}
+
 SkSpan<const SkGlyph*> SkStrike::prepareDrawables(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
     const SkGlyph** cursor = results;
@@ -27,6 +27,7 @@
 
 class SkDescriptor;
 class SkDrawable;
+class SkExecutor;
 class SkPath;
 class SkReadBuffer;
 class SkStrikeCache;
@@ -62,6 +63,10 @@ public:
                                     SkSpan<SkGlyph> paths,
                                     SkSpan<SkGlyph> drawables);
 
+    // Write the glyphs of this strike that already have images or paths in the format read by
+    // mergeFromBuffer. Drawables are not written because they may refer to other typefaces.
+    void flattenCachedGlyphs(SkWriteBuffer& buffer) SK_EXCLUDES(fStrikeLock);
+
     // Lookup (or create if needed) the returned glyph using toID. If that glyph is not initialized
     // with an image, then use the information in fromGlyph to initialize the width, height top,
     // left, format and image of the glyph. This is mainly used preserving the glyph if it was
@@ -134,6 +139,7 @@ public:
     SkGlyph* glyph(SkGlyphDigest) SK_REQUIRES(fStrikeLock);
 
 private:
+    friend class SkPersistentStrikeCache;
     friend class SkStrikeCache;
     friend class SkStrikeTestingPeer;
     class Monitor;
@@ -158,6 +164,13 @@ private:
         kMetricsAndPath
     };
 
+    // Rasterize the images of glyphs that have none yet. Each task uses its own scaler context
+    // and scratch memory. The lock is released while the tasks run, since waiting may borrow work
+    // from the executor that draws with this strike, and the images are then copied into the
+    // strike under the lock.
+    void prepareImagesInParallel(SkSpan<SkGlyph*> glyphs,
+                                 SkExecutor* executor) SK_REQUIRES(fStrikeLock);
+
     // internalPrepare will only be called with a mutex already held.
     SkSpan<const SkGlyph*> internalPrepare(
             SkSpan<const SkGlyphID> glyphIDs,
@@ -195,6 +208,11 @@ private:
     inline static constexpr size_t kMinGlyphImageSize = 16 /* height */ * 8 /* width */;
     inline static constexpr size_t kMinAllocAmount = kMinGlyphImageSize * kMinGlyphCount;
 
+    // Parallel rasterization only pays for the extra scaler contexts when there are
+    // enough uncached glyphs in a run.
+    inline static constexpr size_t kMinGlyphsPerImageTask = 8;
+    inline static constexpr int kMaxImageTasks = 16;
+
     SkArenaAlloc            fAlloc SK_GUARDED_BY(fStrikeLock) {kMinAllocAmount};
 
     // The following are protected by the SkStrikeCache's mutex.
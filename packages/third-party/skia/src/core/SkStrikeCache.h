@@ -75,6 +75,7 @@ public:
     size_t getTotalMemoryUsed() const SK_EXCLUDES(fLock);
 
 private:
+    friend class SkPersistentStrikeCache;
     friend class SkStrike;  // for SkStrike::updateDelta
     static constexpr char kGlyphCacheDumpName[] = "skia/sk_glyph_cache";
     sk_sp<SkStrike> internalFindStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
@@ -112,6 +113,7 @@ private:
     int32_t fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
     int32_t fCacheCount SK_GUARDED_BY(fLock) {0};
     int32_t fPinnerCount SK_GUARDED_BY(fLock) {0};
+
 };
 
 #endif  // SkStrikeCache_DEFINED
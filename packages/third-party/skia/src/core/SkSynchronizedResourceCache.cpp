@@ -60,6 +60,31 @@ size_t SkSynchronizedResourceCache::getEffectiveSingleAllocationByteLimit() cons
     return SkResourceCache::getEffectiveSingleAllocationByteLimit();
 }
 
+size_t SkSynchronizedResourceCache::getTierBytesUsed(Tier tier) const {
+    SkAutoMutexExclusive am(fMutex);
+    return SkResourceCache::getTierBytesUsed(tier);
+}
+
+int SkSynchronizedResourceCache::getTierRecCount(Tier tier) const {
+    SkAutoMutexExclusive am(fMutex);
+    return SkResourceCache::getTierRecCount(tier);
+}
+
+size_t SkSynchronizedResourceCache::getTierByteLimit(Tier tier) const {
+    SkAutoMutexExclusive am(fMutex);
+    return SkResourceCache::getTierByteLimit(tier);
+}
+
+size_t SkSynchronizedResourceCache::setTierByteLimit(Tier tier, size_t newLimit) {
+    SkAutoMutexExclusive am(fMutex);
+    return SkResourceCache::setTierByteLimit(tier, newLimit);
+}
+
+size_t SkSynchronizedResourceCache::purgeToTarget(size_t targetBytes) {
+    SkAutoMutexExclusive am(fMutex);
+    return SkResourceCache::purgeToTarget(targetBytes);
+}
+
 void SkSynchronizedResourceCache::purgeAll() {
     SkAutoMutexExclusive am(fMutex);
     return SkResourceCache::purgeAll();
@@ -31,6 +31,12 @@ public:
     size_t getSingleAllocationByteLimit() const override;
     size_t getEffectiveSingleAllocationByteLimit() const override;
 
+    size_t getTierBytesUsed(Tier) const override;
+    int getTierRecCount(Tier) const override;
+    size_t getTierByteLimit(Tier) const override;
+    size_t setTierByteLimit(Tier, size_t newLimit) override;
+
+    size_t purgeToTarget(size_t targetBytes) override;
     void purgeAll() override;
 
     DiscardableFactory discardableFactory() const override;
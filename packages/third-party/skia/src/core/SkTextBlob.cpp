@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <limits>
 #include <new>
 #include <vector>
@@ -44,8 +45,37 @@ struct RunFontStorageEquivalent {
     uint32_t fFlags;
 };
 static_assert(sizeof(SkFont) == sizeof(RunFontStorageEquivalent), "runfont_should_stay_packed");
+
+// Blob storage holds the SkTextBlob, then a pointer to the slab that owns the storage (nullptr if
+// the storage was allocated for the blob alone), then the runs.
+constexpr size_t kSlabOffset = SkAlignPtr(sizeof(SkTextBlob));
+constexpr size_t kFirstRunOffset = kSlabOffset + sizeof(void*);
+static_assert(alignof(SkTextBlob) <= alignof(void*), "blob_storage_is_pointer_aligned");
 }  // namespace
 
+struct SkTextBlob::Slab {
+    static Slab* Make(size_t capacity) {
+        return new (sk_malloc_throw(SkAlignPtr(sizeof(Slab)) + capacity)) Slab(capacity);
+    }
+
+    explicit Slab(size_t capacity) : fCapacity(capacity) {}
+
+    uint8_t* storage() { return reinterpret_cast<uint8_t*>(this) + SkAlignPtr(sizeof(Slab)); }
+
+    void ref() { fRefCnt.fetch_add(1, std::memory_order_relaxed); }
+    void unref() {
+        if (1 == fRefCnt.fetch_sub(1, std::memory_order_acq_rel)) {
+            this->~Slab();
+            sk_free(this);
+        }
+    }
+
+    // One reference for the builder while it places blobs here, and one for each blob.
+    std::atomic<int32_t> fRefCnt{1};
+    const size_t         fCapacity;
+    size_t               fUsed = 0;
+};
+
 size_t SkTextBlob::RunRecord::StorageSize(uint32_t glyphCount, uint32_t textSize,
                                           SkTextBlob::GlyphPositioning positioning,
                                           SkSafeMath* safe) {
@@ -69,9 +99,9 @@ size_t SkTextBlob::RunRecord::StorageSize(uint32_t glyphCount, uint32_t textSize
 }
 
 const SkTextBlob::RunRecord* SkTextBlob::RunRecord::First(const SkTextBlob* blob) {
-    // The first record (if present) is stored following the blob object.
-    // (aligned up to make the RunRecord aligned too)
-    return reinterpret_cast<const RunRecord*>(SkAlignPtr((uintptr_t)(blob + 1)));
+    // The first record (if present) is stored following the blob object and its slab pointer.
+    return reinterpret_cast<const RunRecord*>(reinterpret_cast<const uint8_t*>(blob) +
+                                              kFirstRunOffset);
 }
 
 const SkTextBlob::RunRecord* SkTextBlob::RunRecord::Next(const RunRecord* run) {
@@ -207,7 +237,14 @@ unsigned SkTextBlob::ScalarsPerGlyph(GlyphPositioning pos) {
 }
 
 void SkTextBlob::operator delete(void* p) {
-    sk_free(p);
+    // The slab pointer is outside the blob object, so it is still readable here.
+    Slab* slab;
+    memcpy(&slab, static_cast<const uint8_t*>(p) + kSlabOffset, sizeof(slab));
+    if (slab) {
+        slab->unref();
+    } else {
+        sk_free(p);
+    }
 }
 
 void* SkTextBlob::operator new(size_t) {
@@ -259,16 +296,25 @@ SkTextBlobBuilder::SkTextBlobBuilder()
     , fStorageUsed(0)
     , fRunCount(0)
     , fDeferredBounds(false)
-    , fLastRun(0) {
+    , fLastRun(0)
+    , fSlabSize(0)
+    , fSlab(nullptr) {
     fBounds.setEmpty();
 }
 
+SkTextBlobBuilder::SkTextBlobBuilder(size_t slabSize) : SkTextBlobBuilder() {
+    fSlabSize = SkAlignPtr(slabSize);
+}
+
 SkTextBlobBuilder::~SkTextBlobBuilder() {
-    if (nullptr != fStorage.get()) {
+    if (0 != fRunCount) {
         // We are abandoning runs and must destruct the associated font data.
         // The easiest way to accomplish that is to use the blob destructor.
         this->make();
     }
+    if (fSlab) {
+        fSlab->unref();
+    }
 }
 
 static SkRect map_quad_to_rect(const SkRSXform& xform, const SkRect& rect) {
@@ -388,7 +434,7 @@ void SkTextBlobBuilder::updateDeferredBounds() {
         return;
     }
 
-    SkASSERT(fLastRun >= SkAlignPtr(sizeof(SkTextBlob)));
+    SkASSERT(fLastRun >= kFirstRunOffset);
     SkTextBlob::RunRecord* run = reinterpret_cast<SkTextBlob::RunRecord*>(fStorage.get() +
                                                                           fLastRun);
 
@@ -402,19 +448,18 @@ void SkTextBlobBuilder::updateDeferredBounds() {
 void SkTextBlobBuilder::reserve(size_t size) {
     SkSafeMath safe;
 
-    // We don't currently pre-allocate, but maybe someday...
-    if (safe.add(fStorageUsed, size) <= fStorageSize && safe) {
-        return;
-    }
-
     if (0 == fRunCount) {
-        SkASSERT(nullptr == fStorage.get());
-        SkASSERT(0 == fStorageSize);
+        // Only slab builders keep their storage between blobs.
+        SkASSERT(nullptr == fStorage.get() || fSlabSize > 0);
         SkASSERT(0 == fStorageUsed);
 
         // the first allocation also includes blob storage
-        // aligned up to a pointer alignment so SkTextBlob::RunRecords after it stay aligned.
-        fStorageUsed = SkAlignPtr(sizeof(SkTextBlob));
+        fStorageUsed = kFirstRunOffset;
+    }
+
+    // We don't currently pre-allocate, but maybe someday...
+    if (safe.add(fStorageUsed, size) <= fStorageSize && safe) {
+        return;
     }
 
     fStorageSize = safe.add(fStorageUsed, size);
@@ -431,7 +476,7 @@ bool SkTextBlobBuilder::mergeRun(const SkFont& font, SkTextBlob::GlyphPositionin
         return false;
     }
 
-    SkASSERT(fLastRun >= SkAlignPtr(sizeof(SkTextBlob)));
+    SkASSERT(fLastRun >= kFirstRunOffset);
     SkTextBlob::RunRecord* run = reinterpret_cast<SkTextBlob::RunRecord*>(fStorage.get() +
                                                                           fLastRun);
     SkASSERT(run->glyphCount() > 0);
@@ -505,7 +550,7 @@ void SkTextBlobBuilder::allocInternal(const SkFont& font,
 
         this->reserve(runSize);
 
-        SkASSERT(fStorageUsed >= SkAlignPtr(sizeof(SkTextBlob)));
+        SkASSERT(fStorageUsed >= kFirstRunOffset);
         SkASSERT(fStorageUsed + runSize <= fStorageSize);
 
         SkTextBlob::RunRecord* run = new (fStorage.get() + fStorageUsed)
@@ -613,12 +658,37 @@ const SkTextBlobBuilder::RunBuffer& SkTextBlobBuilder::allocRunTextRSXform(const
     return fCurrentRunBuffer;
 }
 
+uint8_t* SkTextBlobBuilder::detachStorage() {
+    SkTextBlob::Slab* slab = nullptr;
+    uint8_t* storage;
+    if (fStorageUsed <= fSlabSize) {
+        if (!fSlab || fSlab->fCapacity - fSlab->fUsed < fStorageUsed) {
+            if (fSlab) {
+                fSlab->unref();
+            }
+            fSlab = SkTextBlob::Slab::Make(fSlabSize);
+        }
+        storage = fSlab->storage() + fSlab->fUsed;
+        fSlab->fUsed += fStorageUsed;
+        fSlab->ref();
+        slab = fSlab;
+
+        // The runs are relocatable (see reserve()), so move them to the slab and keep fStorage
+        // for the next blob.
+        memcpy(storage, fStorage.get(), fStorageUsed);
+    } else {
+        storage = fStorage.release();
+        fStorageSize = 0;
+    }
+    memcpy(storage + kSlabOffset, &slab, sizeof(slab));
+    return storage;
+}
+
 sk_sp<SkTextBlob> SkTextBlobBuilder::make() {
     if (!fRunCount) {
         // We don't instantiate empty blobs.
-        SkASSERT(!fStorage.get());
+        SkASSERT(!fStorage.get() || fSlabSize > 0);
         SkASSERT(fStorageUsed == 0);
-        SkASSERT(fStorageSize == 0);
         SkASSERT(fLastRun == 0);
         SkASSERT(fBounds.isEmpty());
         return nullptr;
@@ -630,12 +700,12 @@ sk_sp<SkTextBlob> SkTextBlobBuilder::make() {
     auto* lastRun = reinterpret_cast<SkTextBlob::RunRecord*>(fStorage.get() + fLastRun);
     lastRun->fFlags |= SkTextBlob::RunRecord::kLast_Flag;
 
-    SkTextBlob* blob = new (fStorage.release()) SkTextBlob(fBounds);
-    SkDEBUGCODE(const_cast<SkTextBlob*>(blob)->fStorageSize = fStorageSize;)
+    SkTextBlob* blob = new (this->detachStorage()) SkTextBlob(fBounds);
+    SkDEBUGCODE(const_cast<SkTextBlob*>(blob)->fStorageSize = fStorageUsed;)
 
     SkDEBUGCODE(
         SkSafeMath safe;
-        size_t validateSize = SkAlignPtr(sizeof(SkTextBlob));
+        size_t validateSize = kFirstRunOffset;
         for (const auto* run = SkTextBlob::RunRecord::First(blob); run;
              run = SkTextBlob::RunRecord::Next(run)) {
             validateSize += SkTextBlob::RunRecord::StorageSize(
@@ -649,7 +719,6 @@ sk_sp<SkTextBlob> SkTextBlobBuilder::make() {
     )
 
     fStorageUsed = 0;
-    fStorageSize = 0;
     fRunCount = 0;
     fLastRun = 0;
     fBounds.setEmpty();
@@ -784,6 +853,29 @@ sk_sp<SkTextBlob> SkTextBlobPriv::MakeFromBuffer(SkReadBuffer& reader) {
     return blobBuilder.make();
 }
 
+size_t SkTextBlobPriv::StorageSize(const SkTextBlob& blob) {
+    SkSafeMath safe;
+    size_t size = kFirstRunOffset;
+    for (const auto* run = SkTextBlob::RunRecord::First(&blob); run;
+         run = SkTextBlob::RunRecord::Next(run)) {
+        size = safe.add(size, SkTextBlob::RunRecord::StorageSize(
+                run->glyphCount(), run->textSize(), run->positioning(), &safe));
+    }
+    SkASSERT(safe);
+    return size;
+}
+
+const void* SkTextBlobPriv::Slab(const SkTextBlob& blob) {
+    SkTextBlob::Slab* slab;
+    memcpy(&slab, reinterpret_cast<const uint8_t*>(&blob) + kSlabOffset, sizeof(slab));
+    return slab;
+}
+
+size_t SkTextBlobPriv::SlabSize(const SkTextBlob& blob) {
+    auto slab = static_cast<const SkTextBlob::Slab*>(Slab(blob));
+    return slab ? SkAlignPtr(sizeof(SkTextBlob::Slab)) + slab->fCapacity : 0;
+}
+
 sk_sp<SkTextBlob> SkTextBlob::MakeFromText(const void* text, size_t byteLength, const SkFont& font,
                                            SkTextEncoding encoding) {
     // Note: we deliberately promote this to fully positioned blobs, since we'd have to pay the
@@ -39,14 +39,33 @@ public:
     static sk_sp<SkTextBlob> MakeFromBuffer(SkReadBuffer&);
 
     static bool HasRSXForm(const SkTextBlob& blob);
+
+    /**
+     *  The number of bytes of storage used by the blob and its runs.
+     */
+    static size_t StorageSize(const SkTextBlob& blob);
+
+    /**
+     *  The slab that holds the blob's storage, or nullptr if the storage is its own. This only
+     *  identifies the slab; blobs with the same slab share its allocation.
+     */
+    static const void* Slab(const SkTextBlob& blob);
+
+    /**
+     *  The number of bytes allocated for the slab that holds the blob, or 0 if it has none.
+     */
+    static size_t SlabSize(const SkTextBlob& blob);
 };
 
 //
 // Textblob data is laid out into externally-managed storage as follows:
 //
-//    -----------------------------------------------------------------------------
-//   | SkTextBlob | RunRecord | Glyphs[] | Pos[] | RunRecord | Glyphs[] | Pos[] | ...
-//    -----------------------------------------------------------------------------
+//    ------------------------------------------------------------------------------------
+//   | SkTextBlob | Slab* | RunRecord | Glyphs[] | Pos[] | RunRecord | Glyphs[] | Pos[] | ...
+//    ------------------------------------------------------------------------------------
+//
+//  The Slab* is the shared allocation that holds the storage, or nullptr if the storage is
+//  allocated for the blob alone.
 //
 //  Each run record describes a text blob run, and can be used to determine the (implicit)
 //  location of the following record.
@@ -55,6 +55,7 @@ struct YUVPlanesRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    Tier getTier() const override { return Tier::kImage; }
     const char* getCategory() const override { return "yuv-planes"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
@@ -27,6 +27,7 @@ struct SkStageRec;
     M(ColorSpaceXform)          \
     M(Compose)                  \
     M(Gaussian)                 \
+    M(Lut3D)                    \
     M(Matrix)                   \
     M(Runtime)                  \
     M(Table)                    \
@@ -104,6 +105,7 @@ static inline sk_sp<SkColorFilterBase> as_CFB_sp(sk_sp<SkColorFilter> filter) {
 }
 
 void SkRegisterComposeColorFilterFlattenable();
+void SkRegisterLut3DColorFilterFlattenable();
 void SkRegisterMatrixColorFilterFlattenable();
 void SkRegisterModeColorFilterFlattenable();
 void SkRegisterSkColorSpaceXformColorFilterFlattenable();
@@ -7,26 +7,48 @@
 
 #include "src/effects/colorfilters/SkComposeColorFilter.h"
 
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkColorTable.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
 #include "include/private/base/SkAssert.h"
+#include "src/core/SkColorFilterPriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/effects/colorfilters/SkBlendModeColorFilter.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
+#include "src/effects/colorfilters/SkLut3DColorFilter.h"
+#include "src/effects/colorfilters/SkMatrixColorFilter.h"
+#include "src/effects/colorfilters/SkTableColorFilter.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <utility>
 struct SkStageRec;
 
-SkComposeColorFilter::SkComposeColorFilter(sk_sp<SkColorFilter> outer, sk_sp<SkColorFilter> inner)
-        : fOuter(as_CFB_sp(std::move(outer))), fInner(as_CFB_sp(std::move(inner))) {
+SkComposeColorFilter::SkComposeColorFilter(sk_sp<SkColorFilter> outer,
+                                           sk_sp<SkColorFilter> inner,
+                                           sk_sp<SkColorFilter> folded)
+        : fOuter(as_CFB_sp(std::move(outer)))
+        , fInner(as_CFB_sp(std::move(inner)))
+        , fFolded(as_CFB_sp(std::move(folded))) {
     SkASSERT(fOuter && fInner);
 }
 
 bool SkComposeColorFilter::onIsAlphaUnchanged() const {
+    if (fFolded) {
+        return fFolded->isAlphaUnchanged();
+    }
     // Can only claim alphaunchanged support if both our proxys do.
     return fOuter->isAlphaUnchanged() && fInner->isAlphaUnchanged();
 }
 
 bool SkComposeColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaque) const {
+    if (fFolded) {
+        return fFolded->appendStages(rec, shaderIsOpaque);
+    }
     bool innerIsOpaque = shaderIsOpaque;
     if (!fInner->isAlphaUnchanged()) {
         innerIsOpaque = false;
@@ -34,6 +56,20 @@ bool SkComposeColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaq
     return fInner->appendStages(rec, shaderIsOpaque) && fOuter->appendStages(rec, innerIsOpaque);
 }
 
+SkPMColor4f SkComposeColorFilter::onFilterColor4f(const SkPMColor4f& color,
+                                                  SkColorSpace* dstCS) const {
+    return fFolded ? fFolded->onFilterColor4f(color, dstCS)
+                   : this->SkColorFilterBase::onFilterColor4f(color, dstCS);
+}
+
+bool SkComposeColorFilter::onAsAColorMatrix(float matrix[20]) const {
+    return fFolded && fFolded->asAColorMatrix(matrix);
+}
+
+bool SkComposeColorFilter::onAsAColorMode(SkColor* color, SkBlendMode* mode) const {
+    return fFolded && fFolded->asAColorMode(color, mode);
+}
+
 void SkComposeColorFilter::flatten(SkWriteBuffer& buffer) const {
     buffer.writeFlattenable(fOuter.get());
     buffer.writeFlattenable(fInner.get());
@@ -45,12 +81,242 @@ sk_sp<SkFlattenable> SkComposeColorFilter::CreateProc(SkReadBuffer& buffer) {
     return outer ? outer->makeComposed(std::move(inner)) : inner;
 }
 
+namespace {
+
+using Type = SkColorFilterBase::Type;
+
+// A filter that maps unpremultiplied colors through a row-major RGBA matrix, then clamps rgb to
+// [0,1] if fClamp is set. This is an RGBA matrix filter, or one of the blend filters that happens
+// to be affine in unpremultiplied space.
+struct AffineForm {
+    float fMatrix[20];
+    bool fClamp;
+};
+
+// Which blend filters are affine in unpremul space depends on the blend color. It is stored in
+// sRGB and converted to the destination color space when drawing, so only modes that read just
+// its alpha, or black, whose conversion is exact everywhere, have a fixed matrix.
+bool blend_as_affine(const SkBlendModeColorFilter* filter, AffineForm* form) {
+    const SkColor4f c = filter->color();
+    const bool black = c.fR == 0 && c.fG == 0 && c.fB == 0;
+    float* m = form->fMatrix;
+    std::fill_n(m, 20, 0.f);
+    form->fClamp = false;
+
+    switch (filter->mode()) {
+        case SkBlendMode::kSrc:       // [Sa, Sc]
+            m[19] = c.fA;
+            return black;
+        case SkBlendMode::kSrcIn:     // [Sa * Da, Sc * Da]
+        case SkBlendMode::kModulate:  // [Sa * Da, Sc * Dc]
+            m[18] = c.fA;
+            return black;
+        case SkBlendMode::kSrcOut:    // [Sa * (1 - Da), Sc * (1 - Da)]
+            m[18] = -c.fA;
+            m[19] = c.fA;
+            return black;
+        case SkBlendMode::kSrcATop:   // [Da, Sc * Da + Dc * (1 - Sa)]
+            m[0] = m[6] = m[12] = 1 - c.fA;
+            m[18] = 1;
+            return black;
+        case SkBlendMode::kDstIn:     // [Da * Sa, Dc * Sa]
+            m[0] = m[6] = m[12] = 1;
+            m[18] = c.fA;
+            return true;
+        case SkBlendMode::kDstOut:    // [Da * (1 - Sa), Dc * (1 - Sa)]
+            m[0] = m[6] = m[12] = 1;
+            m[18] = 1 - c.fA;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool as_affine(const SkColorFilterBase* filter, AffineForm* form) {
+    switch (filter->type()) {
+        case Type::kMatrix: {
+            auto matrix = static_cast<const SkMatrixColorFilter*>(filter);
+            if (matrix->domain() != SkMatrixColorFilter::Domain::kRGBA) {
+                return false;
+            }
+            std::copy_n(matrix->matrix(), 20, form->fMatrix);
+            form->fClamp = matrix->clamp() == SkColorFilters::Clamp::kYes;
+            return true;
+        }
+        case Type::kBlendMode:
+            return blend_as_affine(static_cast<const SkBlendModeColorFilter*>(filter), form);
+        default:
+            return false;
+    }
+}
+
+// Between two filters the color is premultiplied and then unpremultiplied again, which zeroes rgb
+// wherever the intermediate alpha is zero, and the inner filter may clamp. The product of the two
+// matrices only matches when neither can make a difference.
+sk_sp<SkColorFilter> fold_affine(const AffineForm& outer, const AffineForm& inner) {
+    const float* o = outer.fMatrix;
+    const float* i = inner.fMatrix;
+
+    // A clamping inner matrix changes colors outside [0,1], which F16 and other extended range
+    // destinations can carry, even when it maps [0,1] into itself. The product can't reproduce
+    // that, whether or not the outer matrix clamps too.
+    if (inner.fClamp) {
+        return nullptr;
+    }
+
+    // The inner filter must scale alpha by a factor in (0,1], so alpha becomes zero only when it
+    // was zero to begin with. Those colors are transparent black, which the inner filter maps to
+    // its rgb translation; that must be zero too, unless the outer filter keeps them transparent.
+    const float alphaScale = i[18];
+    if (i[15] != 0 || i[16] != 0 || i[17] != 0 || i[19] != 0 ||
+        !(alphaScale > 0 && alphaScale <= 1)) {
+        return nullptr;
+    }
+    const bool innerKeepsZero = i[4] == 0 && i[9] == 0 && i[14] == 0;
+    const bool outerKeepsTransparent = o[15] == 0 && o[16] == 0 && o[17] == 0 && o[19] == 0;
+    if (!innerKeepsZero && !outerKeepsTransparent) {
+        return nullptr;
+    }
+
+    float product[20];
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 5; ++col) {
+            float sum = col == 4 ? o[5 * row + 4] : 0;
+            for (int k = 0; k < 4; ++k) {
+                sum += o[5 * row + k] * i[5 * k + col];
+            }
+            product[5 * row + col] = sum;
+        }
+    }
+    return SkColorFilters::Matrix(product,
+                                  outer.fClamp ? SkColorFilters::Clamp::kYes
+                                               : SkColorFilters::Clamp::kNo);
+}
+
+// The table filter rounds its input to the nearest byte, so composed tables are exact, except that
+// an inner alpha of zero hides rgb from the outer tables. That only matters if the outer alpha
+// table makes zero alpha visible again.
+sk_sp<SkColorFilter> fold_tables(const SkTableColorFilter* outer, const SkTableColorFilter* inner) {
+    const SkColorTable* o = outer->table();
+    const SkColorTable* i = inner->table();
+    if (o->alphaTable()[0] != 0 &&
+        std::find(i->alphaTable(), i->alphaTable() + 256, 0) != i->alphaTable() + 256) {
+        return nullptr;
+    }
+
+    uint8_t tables[4][256];
+    const uint8_t* outerTables[4] = {
+            o->alphaTable(), o->redTable(), o->greenTable(), o->blueTable()};
+    const uint8_t* innerTables[4] = {
+            i->alphaTable(), i->redTable(), i->greenTable(), i->blueTable()};
+    for (int channel = 0; channel < 4; ++channel) {
+        for (int v = 0; v < 256; ++v) {
+            tables[channel][v] = outerTables[channel][innerTables[channel][v]];
+        }
+    }
+    return SkColorFilters::Table(SkColorTable::Make(tables[0], tables[1], tables[2], tables[3]));
+}
+
+// Returns a single filter equivalent to outer applied after inner, or null if there isn't one.
+sk_sp<SkColorFilter> fold(const SkColorFilterBase* outer, const SkColorFilterBase* inner) {
+    AffineForm innerAffine;
+    if (!as_affine(inner, &innerAffine)) {
+        if (outer->type() == Type::kTable && inner->type() == Type::kTable) {
+            return fold_tables(static_cast<const SkTableColorFilter*>(outer),
+                               static_cast<const SkTableColorFilter*>(inner));
+        }
+        return nullptr;
+    }
+
+    // A 3D LUT clamps its input itself and ignores alpha, so it absorbs any matrix that neither
+    // reads nor writes alpha.
+    if (outer->type() == Type::kLut3D) {
+        return static_cast<const SkLut3DColorFilter*>(outer)->makeWithInnerMatrix(
+                innerAffine.fMatrix);
+    }
+
+    AffineForm outerAffine;
+    if (as_affine(outer, &outerAffine)) {
+        return fold_affine(outerAffine, innerAffine);
+    }
+    return nullptr;
+}
+
+// Looks through compose filters to the filter that the raster backend runs in their place.
+const SkColorFilterBase* resolve_folded(const SkColorFilterBase* filter) {
+    while (filter->type() == Type::kCompose) {
+        auto compose = static_cast<const SkComposeColorFilter*>(filter);
+        if (!compose->folded()) {
+            break;
+        }
+        filter = compose->folded().get();
+    }
+    return filter;
+}
+
+// Returns a chain equivalent to outer applied after inner in which the last filter of outer and the
+// first filter of inner are folded into one, or null if they don't fold. Composition is
+// associative, so the rest of each chain is composed around the folded filter, which may fold again.
+sk_sp<SkColorFilter> fold_chains(const SkColorFilterBase* outer, const SkColorFilterBase* inner) {
+    outer = resolve_folded(outer);
+    inner = resolve_folded(inner);
+    if (outer->type() == Type::kCompose) {
+        auto compose = static_cast<const SkComposeColorFilter*>(outer);
+        sk_sp<SkColorFilter> folded = fold_chains(compose->inner().get(), inner);
+        return folded ? compose->outer()->makeComposed(std::move(folded)) : nullptr;
+    }
+    if (inner->type() == Type::kCompose) {
+        auto compose = static_cast<const SkComposeColorFilter*>(inner);
+        sk_sp<SkColorFilter> folded = fold_chains(outer, compose->outer().get());
+        return folded ? folded->makeComposed(compose->inner()) : nullptr;
+    }
+    return fold(outer, inner);
+}
+
+void describe(const SkColorFilterBase* filter, SkString* out) {
+    filter = resolve_folded(filter);
+    if (filter->type() == Type::kCompose) {
+        auto compose = static_cast<const SkComposeColorFilter*>(filter);
+        out->append("Compose(");
+        describe(compose->outer().get(), out);
+        out->append(", ");
+        describe(compose->inner().get(), out);
+        out->append(")");
+        return;
+    }
+    switch (filter->type()) {
+        case Type::kNoop:
+            out->append("Noop");
+            return;
+#define M(type)                 \
+        case Type::k##type:     \
+            out->append(#type); \
+            return;
+        SK_ALL_COLOR_FILTERS(M)
+#undef M
+    }
+    SkUNREACHABLE;
+}
+
+}  // namespace
+
 sk_sp<SkColorFilter> SkColorFilter::makeComposed(sk_sp<SkColorFilter> inner) const {
     if (!inner) {
         return sk_ref_sp(this);
     }
 
-    return sk_sp<SkColorFilter>(new SkComposeColorFilter(sk_ref_sp(this), std::move(inner)));
+    sk_sp<SkColorFilter> folded = fold_chains(as_CFB(this), as_CFB(inner));
+    return sk_sp<SkColorFilter>(
+            new SkComposeColorFilter(sk_ref_sp(this), std::move(inner), std::move(folded)));
+}
+
+SkString SkColorFilterPriv::Describe(const SkColorFilter* filter) {
+    if (!filter) {
+        return SkString("null");
+    }
+    SkString out;
+    describe(as_CFB(filter), &out);
+    return out;
 }
 
 void SkRegisterComposeColorFilterFlattenable() { SK_REGISTER_FLATTENABLE(SkComposeColorFilter); }
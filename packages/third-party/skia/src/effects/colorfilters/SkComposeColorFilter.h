@@ -22,22 +22,36 @@ public:
 
     bool appendStages(const SkStageRec& rec, bool shaderIsOpaque) const override;
 
+    SkPMColor4f onFilterColor4f(const SkPMColor4f& color, SkColorSpace* dstCS) const override;
+
     SkColorFilterBase::Type type() const override { return SkColorFilterBase::Type::kCompose; }
 
     sk_sp<SkColorFilterBase> outer() const { return fOuter; }
     sk_sp<SkColorFilterBase> inner() const { return fInner; }
 
+    // A single filter, or a shorter chain, that gives the same result as outer applied after
+    // inner, or null if nothing folds. The raster and Ganesh backends use it in place of the pair.
+    // Graphite builds its keys from outer and inner so that they match the combinations that
+    // PrecompileColorFilters::Compose lists.
+    sk_sp<SkColorFilterBase> folded() const { return fFolded; }
+
 protected:
     void flatten(SkWriteBuffer& buffer) const override;
 
+    bool onAsAColorMatrix(float matrix[20]) const override;
+    bool onAsAColorMode(SkColor* color, SkBlendMode* mode) const override;
+
 private:
     friend void ::SkRegisterComposeColorFilterFlattenable();
     SK_FLATTENABLE_HOOKS(SkComposeColorFilter)
 
-    SkComposeColorFilter(sk_sp<SkColorFilter> outer, sk_sp<SkColorFilter> inner);
+    SkComposeColorFilter(sk_sp<SkColorFilter> outer,
+                         sk_sp<SkColorFilter> inner,
+                         sk_sp<SkColorFilter> folded);
 
     sk_sp<SkColorFilterBase> fOuter;
     sk_sp<SkColorFilterBase> fInner;
+    sk_sp<SkColorFilterBase> fFolded;
 
     friend class SkColorFilter;
 
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/effects/colorfilters/SkLut3DColorFilter.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAssert.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/base/SkHalf.h"
+#include "src/core/SkEffectPriv.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/core/SkRasterPipelineOpList.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkRuntimeEffectPriv.h"
+#include "src/core/SkWriteBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+SkLut3DColorFilter::SkLut3DColorFilter(sk_sp<SkData> lut, int size, Interpolation interpolation)
+        : fLut(std::move(lut)), fSize(size), fInterpolation(interpolation) {
+    SkASSERT(kMinSize <= fSize && fSize <= kMaxSize);
+    SkASSERT(fLut && fLut->size() >= sizeof(float) * 3 * fSize * fSize * fSize);
+    SkASSERT(reinterpret_cast<uintptr_t>(fLut->data()) % alignof(float) == 0);
+}
+
+bool SkLut3DColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaque) const {
+    SkRasterPipeline* p = rec.fPipeline;
+    if (!shaderIsOpaque) {
+        p->append(SkRasterPipelineOp::unpremul);
+    }
+
+    auto ctx = rec.fAlloc->make<SkRasterPipelineContexts::Lut3DCtx>();
+    ctx->table = this->table();
+    ctx->size = fSize;
+    ctx->scale = fSize - 1;
+    p->append(fInterpolation == Interpolation::kTetrahedral
+                      ? SkRasterPipelineOp::lut_3d_tetrahedral
+                      : SkRasterPipelineOp::lut_3d_trilinear,
+              ctx);
+
+    if (!shaderIsOpaque) {
+        p->append(SkRasterPipelineOp::premul);
+    }
+    return true;
+}
+
+void SkLut3DColorFilter::lookup(const float rgb[3], float out[3]) const {
+    // This follows lut_3d_cell, lut_3d_trilinear and lut_3d_tetrahedral step by step.
+    const float scale = fSize - 1;
+    float frac[3];
+    uint32_t cell = 0;
+    const uint32_t strides[3] = {1, static_cast<uint32_t>(fSize),
+                                 static_cast<uint32_t>(fSize * fSize)};
+    for (int i = 0; i < 3; ++i) {
+        const float v = std::min(rgb[i] > 0 ? rgb[i] : 0.f, 1.f) * scale;
+        const float v0 = std::min(std::floor(v), scale - 1);
+        frac[i] = v - v0;
+        cell += static_cast<uint32_t>(v0) * strides[i];
+    }
+
+    const float* table = this->table();
+    out[0] = out[1] = out[2] = 0;
+    auto accumulate = [&](uint32_t ix, float w) {
+        for (int c = 0; c < 3; ++c) {
+            out[c] += w * table[3 * ix + c];
+        }
+    };
+
+    if (fInterpolation == Interpolation::kTrilinear) {
+        for (int corner = 0; corner < 8; ++corner) {
+            uint32_t ix = cell;
+            float w = 1;
+            for (int i = 0; i < 3; ++i) {
+                const bool high = corner & (1 << i);
+                ix += high ? strides[i] : 0;
+                w *= high ? frac[i] : 1 - frac[i];
+            }
+            accumulate(ix, w);
+        }
+        return;
+    }
+
+    const float fr = frac[0], fg = frac[1], fb = frac[2];
+    const float hi = std::max(fr, std::max(fg, fb)),
+                lo = std::min(fr, std::min(fg, fb)),
+                mid = fr + fg + fb - hi - lo;
+    const uint32_t all = strides[0] + strides[1] + strides[2],
+                   first = fr == hi ? strides[0] : fg == hi ? strides[1] : strides[2],
+                   second = all - (fb == lo ? strides[2] : fg == lo ? strides[1] : strides[0]);
+    accumulate(cell, 1 - hi);
+    accumulate(cell + first, hi - mid);
+    accumulate(cell + second, mid - lo);
+    accumulate(cell + all, lo);
+}
+
+sk_sp<SkColorFilter> SkLut3DColorFilter::makeWithInnerMatrix(const float m[20]) const {
+    const bool readsAlpha = m[3] != 0 || m[8] != 0 || m[13] != 0;
+    const bool writesAlpha =
+            m[15] != 0 || m[16] != 0 || m[17] != 0 || m[18] != 1 || m[19] != 0;
+    if (readsAlpha || writesAlpha) {
+        return nullptr;
+    }
+
+    const int n = fSize;
+    sk_sp<SkData> lut = SkData::MakeUninitialized(sizeof(float) * 3 * n * n * n);
+    float* dst = static_cast<float*>(lut->writable_data());
+    for (int b = 0; b < n; ++b) {
+        for (int g = 0; g < n; ++g) {
+            for (int r = 0; r < n; ++r) {
+                const float in[3] = {r / float(n - 1), g / float(n - 1), b / float(n - 1)};
+                float mapped[3];
+                for (int c = 0; c < 3; ++c) {
+                    const float* row = m + 5 * c;
+                    mapped[c] = row[0] * in[0] + row[1] * in[1] + row[2] * in[2] + row[4];
+                }
+                this->lookup(mapped, dst);
+                dst += 3;
+            }
+        }
+    }
+    return sk_make_sp<SkLut3DColorFilter>(std::move(lut), n, fInterpolation);
+}
+
+sk_sp<SkColorFilter> SkLut3DColorFilter::runtimeFilter() const {
+    fRuntimeOnce([this] {
+        static const SkRuntimeEffect* effect = SkMakeRuntimeEffect(
+                SkRuntimeEffect::MakeForColorFilter,
+                "uniform shader lut;"
+                "uniform float n;"
+                "uniform float cols;"
+
+                "float2 slice(float b) {"
+                    "float row = floor((b + 0.5) / cols);"
+                    "return float2(b - row * cols, row) * n;"
+                "}"
+
+                "half4 main(half4 color) {"
+                    "float4 c = unpremul(color);"
+                    "float3 p = saturate(c.rgb) * (n - 1);"
+                    "float b0 = min(floor(p.b), n - 2);"
+                    "float2 uv = p.rg + 0.5;"
+                    "half3 lo = lut.eval(slice(b0) + uv).rgb;"
+                    "half3 hi = lut.eval(slice(b0 + 1) + uv).rgb;"
+                    "return half4(mix(lo, hi, half(p.b - b0)) * color.a, color.a);"
+                "}");
+
+        // Blue slice b is the n x n block at column b % cols and row b / cols.
+        const int n = fSize;
+        const int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(n))));
+        const int rows = (n + cols - 1) / cols;
+        SkBitmap bitmap;
+        if (!bitmap.tryAllocPixels(SkImageInfo::Make(
+                    cols * n, rows * n, kRGBA_F16_SkColorType, kOpaque_SkAlphaType))) {
+            return;
+        }
+        bitmap.eraseColor(SkColors::kBlack);
+        const float* src = this->table();
+        for (int b = 0; b < n; ++b) {
+            for (int g = 0; g < n; ++g) {
+                auto dst = static_cast<uint16_t*>(
+                        bitmap.getAddr((b % cols) * n, (b / cols) * n + g));
+                for (int r = 0; r < n; ++r, src += 3, dst += 4) {
+                    dst[0] = SkFloatToHalf(src[0]);
+                    dst[1] = SkFloatToHalf(src[1]);
+                    dst[2] = SkFloatToHalf(src[2]);
+                    dst[3] = SK_Half1;
+                }
+            }
+        }
+        bitmap.setImmutable();
+
+        const float uniforms[] = {static_cast<float>(n), static_cast<float>(cols)};
+        const SkRuntimeEffect::ChildPtr children[] = {bitmap.asImage()->makeShader(
+                SkTileMode::kClamp, SkTileMode::kClamp, SkSamplingOptions(SkFilterMode::kLinear))};
+        fRuntimeFilter = effect->makeColorFilter(SkData::MakeWithCopy(uniforms, sizeof(uniforms)),
+                                                 children);
+    });
+    return fRuntimeFilter;
+}
+
+void SkLut3DColorFilter::flatten(SkWriteBuffer& buffer) const {
+    buffer.writeInt(fSize);
+    buffer.writeUInt(static_cast<uint32_t>(fInterpolation));
+    buffer.writeDataAsByteArray(fLut.get());
+}
+
+sk_sp<SkFlattenable> SkLut3DColorFilter::CreateProc(SkReadBuffer& buffer) {
+    const int size = buffer.readInt();
+    const Interpolation interpolation = buffer.read32LE(Interpolation::kTetrahedral);
+    sk_sp<SkData> lut = buffer.readByteArrayAsData();
+    if (!buffer.isValid()) {
+        return nullptr;
+    }
+    sk_sp<SkColorFilter> filter = SkColorFilters::Lut3D(std::move(lut), size, interpolation);
+    buffer.validate(filter != nullptr);
+    return filter;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkColorFilter> SkColorFilters::Lut3D(sk_sp<SkData> lut,
+                                           int size,
+                                           Lut3DInterpolation interpolation) {
+    if (!lut || size < SkLut3DColorFilter::kMinSize || size > SkLut3DColorFilter::kMaxSize ||
+        lut->size() < sizeof(float) * 3 * size * size * size) {
+        return nullptr;
+    }
+    if (reinterpret_cast<uintptr_t>(lut->data()) % alignof(float) != 0) {
+        lut = SkData::MakeWithCopy(lut->data(), lut->size());
+    }
+    return sk_make_sp<SkLut3DColorFilter>(std::move(lut), size, interpolation);
+}
+
+void SkRegisterLut3DColorFilterFlattenable() {
+    SK_REGISTER_FLATTENABLE(SkLut3DColorFilter);
+}
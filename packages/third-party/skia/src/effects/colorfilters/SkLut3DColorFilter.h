@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkLut3DColorFilter_DEFINED
+#define SkLut3DColorFilter_DEFINED
+
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
+#include "include/core/SkFlattenable.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/base/SkOnce.h"
+#include "src/effects/colorfilters/SkColorFilterBase.h"
+
+class SkReadBuffer;
+class SkWriteBuffer;
+struct SkStageRec;
+
+class SkLut3DColorFilter final : public SkColorFilterBase {
+public:
+    using Interpolation = SkColorFilters::Lut3DInterpolation;
+
+    static constexpr int kMinSize = 2;
+    static constexpr int kMaxSize = 256;
+
+    // The caller has checked that size is in range and that lut holds size^3 RGB floats.
+    SkLut3DColorFilter(sk_sp<SkData> lut, int size, Interpolation);
+
+    SkColorFilterBase::Type type() const override { return SkColorFilterBase::Type::kLut3D; }
+
+    bool appendStages(const SkStageRec& rec, bool shaderIsOpaque) const override;
+
+    bool onIsAlphaUnchanged() const override { return true; }
+
+    const sk_sp<SkData>& lut() const { return fLut; }
+    int size() const { return fSize; }
+    Interpolation interpolation() const { return fInterpolation; }
+
+    // Maps one unpremultiplied rgb triple the same way the raster stages do.
+    void lookup(const float rgb[3], float out[3]) const;
+
+    // Returns a filter equivalent to this one applied after an RGBA color matrix, or null if the
+    // matrix reads or writes alpha. The new table samples the matrix and this table at its grid
+    // points, so it is exact there and interpolates linearly between them.
+    sk_sp<SkColorFilter> makeWithInnerMatrix(const float rowMajor[20]) const;
+
+    // An equivalent runtime color filter for the GPU backends, which read the table as an F16
+    // texture with its blue slices side by side. It always interpolates trilinearly.
+    sk_sp<SkColorFilter> runtimeFilter() const;
+
+private:
+    friend void ::SkRegisterLut3DColorFilterFlattenable();
+    SK_FLATTENABLE_HOOKS(SkLut3DColorFilter)
+
+    void flatten(SkWriteBuffer&) const override;
+
+    const float* table() const { return static_cast<const float*>(fLut->data()); }
+
+    sk_sp<SkData> fLut;
+    int fSize;
+    Interpolation fInterpolation;
+
+    mutable SkOnce fRuntimeOnce;
+    mutable sk_sp<SkColorFilter> fRuntimeFilter;
+};
+
+#endif
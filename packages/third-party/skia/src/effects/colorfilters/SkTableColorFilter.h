@@ -32,6 +32,7 @@ public:
     void flatten(SkWriteBuffer& buffer) const override;
 
     const SkBitmap& bitmap() const { return fTable->bitmap(); }
+    const SkColorTable* table() const { return fTable.get(); }
 
 private:
     friend void ::SkRegisterTableColorFilterFlattenable();
@@ -11,6 +11,7 @@
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkPoint3.h"
 #include "include/core/SkRect.h"
@@ -22,6 +23,8 @@
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTPin.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
@@ -30,8 +33,12 @@
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
 struct SkISize;
 
@@ -282,6 +289,146 @@ sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap,
     return builder.makeShader();
 }
 
+// The layer-space parameters of make_normal_shader() and make_lighting_shader(), for the CPU
+// kernel that replaces them.
+struct RasterLighting {
+    Light::Type fLightType;
+    skvx::float4 fLightColor; // r, g, b and 0, with the material's k already applied
+    SkV3 fLightPos;
+    SkV3 fLightDir;           // Normalized
+    float fFalloffExponent;
+    float fCosCutoffAngle;
+
+    Material::Type fMaterialType;
+    float fSurfaceDepth;
+    float fShininess;
+
+    SkIPoint fOrigin;         // Layer-space position of the top left output pixel
+    SkIPoint fSrcOffset;      // Position of the top left output pixel in the alpha map
+};
+
+// Lane-wise pow() that treats negative bases as 0, where the shader's result is undefined.
+skvx::float4 pow_clamped(const skvx::float4& x, float y) {
+    return skvx::map([y](float v) { return std::pow(std::max(v, 0.f), y); }, x);
+}
+
+// Lights the output rows [begin, end), four pixels at a time. This follows sk_normal() and
+// sk_lighting() in sksl_rt_shader.sksl, with the normal map computed from alpha rows that are
+// clamped to the edges of 'src' like the normal shader clamps to its edge bounds.
+void light_rows(const RasterLighting& lighting, const SkPixmap& src, const SkPixmap& dst,
+                int begin, int end) {
+    using float4 = skvx::float4;
+    const int width = dst.width();
+
+    // Alpha of src columns sx - 1 through sx + width, clamped, where sx is the column under the
+    // first output pixel. Padded so the last group of four can be loaded whole.
+    const int alphaWidth = width + 2 + 3;
+    std::vector<float> alphaRows(3 * alphaWidth, 0.f);
+    auto loadAlphaRow = [&](int srcY, float* alpha) {
+        srcY = SkTPin(srcY, 0, src.height() - 1);
+        for (int i = 0; i < width + 2; ++i) {
+            const int srcX = SkTPin(lighting.fSrcOffset.x() - 1 + i, 0, src.width() - 1);
+            alpha[i] = (*src.addr32(srcX, srcY) >> SK_A32_SHIFT) * (1 / 255.f);
+        }
+    };
+
+    const float negDepth = -lighting.fSurfaceDepth;
+    const bool hasPosition = lighting.fLightType != Light::Type::kDistant;
+    const SkV3& dir = lighting.fLightDir;
+    uint32_t pixels[4];
+    for (int y = begin; y < end; ++y) {
+        const int srcY = lighting.fSrcOffset.y() + y;
+        float* top = alphaRows.data();
+        float* mid = top + alphaWidth;
+        float* bot = mid + alphaWidth;
+        loadAlphaRow(srcY - 1, top);
+        loadAlphaRow(srcY, mid);
+        loadAlphaRow(srcY + 1, bot);
+
+        const float layerY = lighting.fOrigin.y() + y + 0.5f;
+        uint32_t* out = dst.writable_addr32(0, y);
+        for (int x = 0; x < width; x += 4) {
+            const float4 t0 = float4::Load(top + x), t1 = float4::Load(top + x + 1),
+                         t2 = float4::Load(top + x + 2);
+            const float4 m0 = float4::Load(mid + x), m1 = float4::Load(mid + x + 1),
+                         m2 = float4::Load(mid + x + 2);
+            const float4 b0 = float4::Load(bot + x), b1 = float4::Load(bot + x + 1),
+                         b2 = float4::Load(bot + x + 2);
+
+            // Sobel normals, normalize(-depth * (nx, ny), 1)
+            float4 nx = negDepth * 0.25f * ((t2 + 2 * m2 + b2) - (t0 + 2 * m0 + b0));
+            float4 ny = negDepth * 0.25f * ((b0 + 2 * b1 + b2) - (t0 + 2 * t1 + t2));
+            const float4 invLength = 1.f / skvx::sqrt(nx * nx + ny * ny + 1.f);
+            nx *= invLength;
+            ny *= invLength;
+            const float4 nz = invLength;
+
+            // Surface to light
+            float4 lx = dir.x, ly = dir.y, lz = dir.z;
+            if (hasPosition) {
+                const float4 layerX = float4(lighting.fOrigin.x() + x + 0.5f) +
+                                      float4(0.f, 1.f, 2.f, 3.f);
+                lx = lighting.fLightPos.x - layerX;
+                ly = lighting.fLightPos.y - layerY;
+                lz = lighting.fLightPos.z - lighting.fSurfaceDepth * m1;
+                const float4 invDistance = 1.f / skvx::sqrt(lx * lx + ly * ly + lz * lz);
+                lx *= invDistance;
+                ly *= invDistance;
+                lz *= invDistance;
+            }
+
+            float4 scale = 1.f;
+            if (lighting.fLightType == Light::Type::kSpot) {
+                static constexpr float kConeAAThreshold = 0.016f;
+                const float cutoff = lighting.fCosCutoffAngle;
+                const float4 cosAngle = -(lx * dir.x + ly * dir.y + lz * dir.z);
+                scale = pow_clamped(cosAngle, lighting.fFalloffExponent);
+                scale = skvx::if_then_else(cosAngle < cutoff + kConeAAThreshold,
+                                           scale * (cosAngle - cutoff) * (1 / kConeAAThreshold),
+                                           scale);
+                scale = skvx::if_then_else(cosAngle < cutoff, float4(0.f), scale);
+            }
+
+            float4 coeff = 0.f;
+            switch (lighting.fMaterialType) {
+                case Material::Type::kDiffuse:
+                    coeff = nx * lx + ny * ly + nz * lz;
+                    break;
+                case Material::Type::kSpecular: {
+                    const float4 hz = lz + 1.f;
+                    const float4 invHalfLength = 1.f / skvx::sqrt(lx * lx + ly * ly + hz * hz);
+                    coeff = pow_clamped((nx * lx + ny * ly + nz * hz) * invHalfLength,
+                                        lighting.fShininess);
+                    break;
+                }
+                case Material::Type::kEmbossSpecular: {
+                    const float4 hilite = (2 * (nx * lx + ny * ly + nz * lz) - lz) * lz;
+                    coeff = pow_clamped(hilite, lighting.fShininess);
+                    break;
+                }
+            }
+            coeff *= scale;
+
+            auto channel = [&](int i) {
+                return skvx::min(skvx::max(coeff * lighting.fLightColor[i], 0.f), 1.f);
+            };
+            const float4 r = channel(0), g = channel(1), b = channel(2);
+            const float4 a = lighting.fMaterialType == Material::Type::kDiffuse
+                                     ? float4(1.f)
+                                     : skvx::max(r, skvx::max(g, b));
+            auto unorm = [](const float4& v) { return skvx::cast<uint32_t>(v * 255.f + 0.5f); };
+            const skvx::uint4 packed = unorm(r) << SK_R32_SHIFT | unorm(g) << SK_G32_SHIFT |
+                                       unorm(b) << SK_B32_SHIFT | unorm(a) << SK_A32_SHIFT;
+            if (x + 4 <= width) {
+                packed.store(out + x);
+            } else {
+                packed.store(pixels);
+                std::copy(pixels, pixels + (width - x), out + x);
+            }
+        }
+    }
+}
+
 sk_sp<SkImageFilter> make_lighting(const Light& light,
                                    const Material& material,
                                    sk_sp<SkImageFilter> input,
@@ -566,6 +713,35 @@ skif::FilterResult SkLightingImageFilter::onFilterImage(const skif::Context& ctx
                 edgeClamp(inputRect.bottom(), requiredInput.bottom(), clampTo.bottom())});
     }
 
+    // On the CPU, the normal map and lighting are computed together by a kernel that reads the
+    // alpha of the child output directly.
+    SkV3 lightDir{lightDirXY.x(), lightDirXY.y(), lightDirZ.val()};
+    const float lightDirLength = lightDir.length();
+    lightDir = lightDirLength ? lightDir * (1.f / lightDirLength) : SkV3{0.f, 0.f, 0.f};
+    const float colorScale = fMaterial.fK / 255.f;
+    const RasterLighting lighting = {
+            fLight.fType,
+            skvx::float4(SkColorGetR(fLight.fLightColor) * colorScale,
+                         SkColorGetG(fLight.fLightColor) * colorScale,
+                         SkColorGetB(fLight.fLightColor) * colorScale,
+                         0.f),
+            SkV3{lightLocationXY.x(), lightLocationXY.y(), lightLocationZ.val()},
+            lightDir,
+            fLight.fFalloffExponent,
+            fLight.fCosCutoffAngle,
+            fMaterial.fType,
+            surfaceDepth.val(),
+            fMaterial.fShininess,
+            SkIPoint(ctx.desiredOutput().topLeft()),
+            SkIPoint(ctx.desiredOutput().topLeft()) - SkIPoint(clampRect.topLeft())};
+    if (auto rasterOutput = skif::FilterResult::MakeFromRasterKernel(
+                ctx, childOutput, clampRect, skif::FilterResult::KernelSplit::kRows,
+                [&lighting](const SkPixmap& src, const SkPixmap& dst, int begin, int end) {
+                    light_rows(lighting, src, dst, begin, end);
+                })) {
+        return *rasterOutput;
+    }
+
     skif::FilterResult::Builder builder{ctx};
     builder.add(childOutput, /*sampleBounds=*/clampRect, ShaderFlags::kSampledRepeatedly);
     return builder.eval([&](SkSpan<sk_sp<SkShader>> input) {
@@ -15,6 +15,7 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
@@ -29,8 +30,10 @@
 #include "include/private/base/SkMath.h"
 #include "include/private/base/SkSpan_impl.h"
 #include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkSafeMath.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
@@ -39,10 +42,13 @@
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <optional>
 #include <utility>
+#include <vector>
 
 using namespace skia_private;
 using namespace MatrixConvolutionImageFilter;
@@ -58,6 +64,9 @@ static_assert(kMaxUniformKernelSize % 4 == 0, "Must be a multiple of 4");
 SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
                               float* innerGain, float* innerBias);
 
+bool separate_kernel(const SkISize& kernelSize, const float* kernel,
+                     TArray<float>* columnWeights, TArray<float>* rowWeights);
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -78,6 +87,7 @@ public:
 
         // Does nothing for small kernels, otherwise encodes kernel into an A8 image.
         fKernelBitmap = create_kernel_bitmap(kernelSize, kernel, &fInnerGain, &fInnerBias);
+        separate_kernel(kernelSize, kernel, &fColumnWeights, &fRowWeights);
     }
 
     SkRect computeFastBounds(const SkRect& bounds) const override;
@@ -123,6 +133,11 @@ private:
 
     sk_sp<SkShader> createShader(const skif::Context& ctx, sk_sp<SkShader> input) const;
 
+    // Convolves on the CPU instead of with the shader, or returns std::nullopt if the context
+    // can't run CPU kernels.
+    std::optional<skif::FilterResult> convolveRaster(const skif::Context& ctx,
+                                                     const skif::FilterResult& input) const;
+
     // Original kernel data, preserved for serialization even if it was encoded into fKernelBitmap
     TArray<float> fKernel;
 
@@ -141,6 +156,11 @@ private:
     SkBitmap fKernelBitmap;
     float fInnerBias;
     float fInnerGain;
+
+    // Derived from fKernel when it's the outer product of a column and a row, which the CPU then
+    // applies as a horizontal and a vertical pass. Both are empty otherwise.
+    TArray<float> fColumnWeights;
+    TArray<float> fRowWeights;
 };
 
 // LayerSpace doesn't have a clean type to represent 4 separate edge deltas, but the result
@@ -223,6 +243,159 @@ SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
     return kernelBM;
 }
 
+bool separate_kernel(const SkISize& kernelSize, const float* kernel,
+                     TArray<float>* columnWeights, TArray<float>* rowWeights) {
+    const int width = kernelSize.width(), height = kernelSize.height();
+    if (width == 1 || height == 1) {
+        return false; // Already one pass
+    }
+
+    // A rank one kernel is the product of its column and its row through its largest weight,
+    // scaled by that weight.
+    int pivot = 0;
+    for (int i = 1; i < width * height; ++i) {
+        if (std::abs(kernel[i]) > std::abs(kernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const float max = std::abs(kernel[pivot]);
+    if (max == 0.f) {
+        return false;
+    }
+    const int pivotX = pivot % width, pivotY = pivot / width;
+
+    TArray<float> column(height), row(width);
+    for (int y = 0; y < height; ++y) {
+        column.push_back(kernel[y * width + pivotX]);
+    }
+    for (int x = 0; x < width; ++x) {
+        row.push_back(kernel[pivotY * width + x] / kernel[pivot]);
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (std::abs(column[y] * row[x] - kernel[y * width + x]) > 1e-5f * max) {
+                return false;
+            }
+        }
+    }
+    *columnWeights = std::move(column);
+    *rowWeights = std::move(row);
+    return true;
+}
+
+// Lane of the alpha channel when an N32 pixel is loaded into a skvx::byte4 or skvx::float4.
+static constexpr int kAlphaLane = SK_A32_SHIFT / 8;
+
+// Loads N32 pixels as floats in [0, 1], unpremultiplied if 'unpremul'.
+void load_pixels(const uint32_t* src, int count, bool unpremul, skvx::float4* dst) {
+    for (int x = 0; x < count; ++x) {
+        skvx::float4 c = skvx::cast<float>(skvx::byte4::Load(src + x)) * (1 / 255.f);
+        if (unpremul) {
+            const float a = c[kAlphaLane];
+            c = a > 0.f ? c * (1 / a) : skvx::float4(0.f);
+            c[kAlphaLane] = a;
+        }
+        dst[x] = c;
+    }
+}
+
+// The taps, gain and bias of a convolution as the CPU kernel uses them. Source pixel (x, y) is the
+// top left tap of destination pixel (x, y).
+struct RasterConvolution {
+    SkISize fSize;
+    SkIPoint fOffset;
+    const float* fKernel;
+    // Both empty unless the kernel is separable, see separate_kernel().
+    SkSpan<const float> fColumnWeights;
+    SkSpan<const float> fRowWeights;
+    float fGain;
+    float fBias; // In [0, 1]
+    bool fConvolveAlpha;
+};
+
+// Convolves the destination rows [begin, end). Columns are processed in chunks so that the rows
+// kept for the vertical taps stay small however wide the image is. Each source row is converted
+// to floats once per chunk; for separable kernels it is filtered horizontally at the same time.
+void convolve_rows(const RasterConvolution& conv, const SkPixmap& src, const SkPixmap& dst,
+                   int begin, int end) {
+    static constexpr int kChunkWidth = 256;
+    const int kw = conv.fSize.width(), kh = conv.fSize.height();
+    const bool separable = !conv.fRowWeights.empty();
+
+    // For separable kernels the kept rows are already filtered horizontally, so they are as wide
+    // as the output; otherwise they are as wide as the source under it.
+    const int keptWidth = separable ? kChunkWidth : kChunkWidth + kw - 1;
+    std::vector<skvx::float4> kept(static_cast<size_t>(kh) * keptWidth);
+    std::vector<skvx::float4> loaded(separable ? kChunkWidth + kw - 1 : 0);
+    std::vector<skvx::float4> sum(kChunkWidth);
+
+    for (int x0 = 0; x0 < dst.width(); x0 += kChunkWidth) {
+        const int width = std::min(kChunkWidth, dst.width() - x0);
+        const int srcWidth = width + kw - 1;
+
+        auto keepRow = [&](int srcY) {
+            skvx::float4* row = kept.data() + (srcY % kh) * keptWidth;
+            if (!separable) {
+                load_pixels(src.addr32(x0, srcY), srcWidth, !conv.fConvolveAlpha, row);
+                return;
+            }
+            load_pixels(src.addr32(x0, srcY), srcWidth, !conv.fConvolveAlpha, loaded.data());
+            std::fill(row, row + width, skvx::float4(0.f));
+            for (int kx = 0; kx < kw; ++kx) {
+                const float w = conv.fRowWeights[kx];
+                for (int x = 0; x < width; ++x) {
+                    row[x] += w * loaded[x + kx];
+                }
+            }
+        };
+
+        for (int srcY = begin; srcY < begin + kh - 1; ++srcY) {
+            keepRow(srcY);
+        }
+        for (int y = begin; y < end; ++y) {
+            keepRow(y + kh - 1);
+
+            std::fill(sum.begin(), sum.begin() + width, skvx::float4(0.f));
+            for (int ky = 0; ky < kh; ++ky) {
+                const skvx::float4* row = kept.data() + ((y + ky) % kh) * keptWidth;
+                if (separable) {
+                    const float w = conv.fColumnWeights[ky];
+                    for (int x = 0; x < width; ++x) {
+                        sum[x] += w * row[x];
+                    }
+                    continue;
+                }
+                for (int kx = 0; kx < kw; ++kx) {
+                    const float w = conv.fKernel[ky * kw + kx];
+                    if (w == 0.f) {
+                        continue;
+                    }
+                    for (int x = 0; x < width; ++x) {
+                        sum[x] += w * row[x + kx];
+                    }
+                }
+            }
+
+            // This follows the end of the matrix convolution shader.
+            const uint32_t* center = src.addr32(x0 + conv.fOffset.x(), y + conv.fOffset.y());
+            uint32_t* out = dst.writable_addr32(x0, y);
+            for (int x = 0; x < width; ++x) {
+                skvx::float4 color = sum[x] * conv.fGain + conv.fBias;
+                float a;
+                if (conv.fConvolveAlpha) {
+                    a = SkTPin(color[kAlphaLane], 0.f, 1.f);
+                } else {
+                    a = (center[x] >> SK_A32_SHIFT) * (1 / 255.f);
+                    color *= a;
+                }
+                color[kAlphaLane] = a;
+                color = skvx::max(skvx::min(color, a), 0.f);
+                skvx::cast<uint8_t>(color * 255.f + 0.5f).store(out + x);
+            }
+        }
+    }
+}
+
 } // anonymous namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -388,6 +561,24 @@ sk_sp<SkShader> SkMatrixConvolutionImageFilter::createShader(const skif::Context
     return builder.makeShader();
 }
 
+std::optional<skif::FilterResult> SkMatrixConvolutionImageFilter::convolveRaster(
+        const skif::Context& ctx, const skif::FilterResult& input) const {
+    const RasterConvolution conv = {SkISize(fKernelSize),
+                                    {fKernelOffset.x(), fKernelOffset.y()},
+                                    fKernel.data(),
+                                    fColumnWeights,
+                                    fRowWeights,
+                                    fGain,
+                                    fBias / 255.f,
+                                    fConvolveAlpha};
+    return skif::FilterResult::MakeFromRasterKernel(
+            ctx, input, this->boundsSampledByKernel(ctx.desiredOutput()),
+            skif::FilterResult::KernelSplit::kRows,
+            [&conv](const SkPixmap& src, const SkPixmap& dst, int begin, int end) {
+                convolve_rows(conv, src, dst, begin, end);
+            });
+}
+
 skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         const skif::Context& context) const {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
@@ -409,6 +600,11 @@ skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         }
     }
 
+    if (auto rasterOutput = this->convolveRaster(context.withNewDesiredOutput(outputBounds),
+                                                 childOutput)) {
+        return *rasterOutput;
+    }
+
     skif::FilterResult::Builder builder{context};
     builder.add(childOutput,
                 this->boundsSampledByKernel(outputBounds),
@@ -10,6 +10,7 @@
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
@@ -18,6 +19,7 @@
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
@@ -28,6 +30,7 @@
 #include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -222,6 +225,110 @@ skif::FilterResult morphology_pass(const skif::Context& ctx, const skif::FilterR
     return childOutput;
 }
 
+// Writes element i of 'dst', for i in [0, count), as the min or max of elements i through
+// i + 2 * radius of 'src', with the van Herk/Gil-Werman algorithm. 'src' is cut into blocks of
+// 2 * radius + 1 elements, so every window is a suffix of one block followed by a prefix of the
+// next. Aggregating the prefixes and suffixes of each block first makes that three min or max per
+// element, whatever the radius. Elements are vectors of bytes that are 'stride' bytes apart, so a
+// line can be a row of pixels or a column of groups of pixels. 'prefix' and 'suffix' must hold
+// count + 2 * radius elements.
+template <MorphType kType, typename V>
+void morph_line(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                int count, int radius, V* prefix, V* suffix) {
+    auto aggregate = [](const V& a, const V& b) {
+        return kType == MorphType::kDilate ? skvx::max(a, b) : skvx::min(a, b);
+    };
+    const int window = 2 * radius + 1;
+    const int length = count + 2 * radius;
+    for (int start = 0; start < length; start += window) {
+        const int end = std::min(start + window, length);
+        prefix[start] = V::Load(src + start * srcStride);
+        for (int i = start + 1; i < end; ++i) {
+            prefix[i] = aggregate(prefix[i - 1], V::Load(src + i * srcStride));
+        }
+        suffix[end - 1] = V::Load(src + (end - 1) * srcStride);
+        for (int i = end - 2; i >= start; --i) {
+            suffix[i] = aggregate(suffix[i + 1], V::Load(src + i * srcStride));
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        aggregate(suffix[i], prefix[i + 2 * radius]).store(dst + i * dstStride);
+    }
+}
+
+// The CPU equivalent of the X and Y morphology_pass() calls in onFilterImage(), which applies the
+// full radius of each direction in a single pass. Rows are filtered one pixel at a time, and
+// columns 16 pixels at a time. Returns std::nullopt when the context can't run CPU kernels.
+template <MorphType kType>
+std::optional<skif::FilterResult> morphology_raster(const skif::Context& ctx,
+                                                    skif::FilterResult input,
+                                                    skif::LayerSpace<SkISize> radii,
+                                                    const skif::LayerSpace<SkIRect>& outputX,
+                                                    const skif::LayerSpace<SkIRect>& output) {
+    using KernelSplit = skif::FilterResult::KernelSplit;
+    using Pixel = skvx::Vec<4, uint8_t>;
+    static constexpr int kGroupPixels = 16;
+    using PixelGroup = skvx::Vec<4 * kGroupPixels, uint8_t>;
+
+    if (radii.width() > 0) {
+        const int radius = radii.width();
+        skif::LayerSpace<SkIRect> sampleBounds = outputX;
+        sampleBounds.outset(skif::LayerSpace<SkISize>({radius, 0}));
+        auto pass = skif::FilterResult::MakeFromRasterKernel(
+                ctx.withNewDesiredOutput(outputX), input, sampleBounds, KernelSplit::kRows,
+                [radius](const SkPixmap& src, const SkPixmap& dst, int begin, int end) {
+                    std::vector<Pixel> prefix(src.width()), suffix(src.width());
+                    for (int y = begin; y < end; ++y) {
+                        morph_line<kType>(static_cast<const uint8_t*>(src.addr(0, y)),
+                                          sizeof(uint32_t),
+                                          static_cast<uint8_t*>(dst.writable_addr(0, y)),
+                                          sizeof(uint32_t),
+                                          dst.width(), radius, prefix.data(), suffix.data());
+                    }
+                });
+        if (!pass) {
+            return std::nullopt;
+        }
+        input = *pass;
+    }
+
+    if (radii.height() > 0) {
+        const int radius = radii.height();
+        skif::LayerSpace<SkIRect> sampleBounds = output;
+        sampleBounds.outset(skif::LayerSpace<SkISize>({0, radius}));
+        auto pass = skif::FilterResult::MakeFromRasterKernel(
+                ctx.withNewDesiredOutput(output), input, sampleBounds, KernelSplit::kColumns,
+                [radius](const SkPixmap& src, const SkPixmap& dst, int begin, int end) {
+                    auto column = [&](auto* prefix, auto* suffix, int x) {
+                        morph_line<kType>(static_cast<const uint8_t*>(src.addr(x, 0)),
+                                          src.rowBytes(),
+                                          static_cast<uint8_t*>(dst.writable_addr(x, 0)),
+                                          dst.rowBytes(),
+                                          dst.height(), radius, prefix, suffix);
+                    };
+                    int x = begin;
+                    if (end - begin >= kGroupPixels) {
+                        std::vector<PixelGroup> prefix(src.height()), suffix(src.height());
+                        for (; x + kGroupPixels <= end; x += kGroupPixels) {
+                            column(prefix.data(), suffix.data(), x);
+                        }
+                    }
+                    if (x < end) {
+                        std::vector<Pixel> prefix(src.height()), suffix(src.height());
+                        for (; x < end; ++x) {
+                            column(prefix.data(), suffix.data(), x);
+                        }
+                    }
+                });
+        if (!pass) {
+            return std::nullopt;
+        }
+        input = *pass;
+    }
+
+    return input;
+}
+
 } // end namespace
 
 sk_sp<SkImageFilter> SkImageFilters::Dilate(SkScalar radiusX, SkScalar radiusY,
@@ -286,6 +393,17 @@ skif::FilterResult SkMorphologyImageFilter::onFilterImage(const skif::Context& c
     skif::LayerSpace<SkISize> radii = this->radii(ctx.mapping());
     skif::LayerSpace<SkIRect> maxOutputX = maxOutput;
     maxOutputX.outset(skif::LayerSpace<SkISize>({0, radii.height()}));
+    // On the CPU, both passes run a van Herk/Gil-Werman kernel instead of the shaders.
+    std::optional<skif::FilterResult> rasterOutput =
+            fType == MorphType::kDilate
+                    ? morphology_raster<MorphType::kDilate>(ctx, childOutput, radii, maxOutputX,
+                                                            maxOutput)
+                    : morphology_raster<MorphType::kErode>(ctx, childOutput, radii, maxOutputX,
+                                                           maxOutput);
+    if (rasterOutput) {
+        return *rasterOutput;
+    }
+
     childOutput = morphology_pass(ctx.withNewDesiredOutput(maxOutputX), childOutput, fType,
                                   MorphDirection::kX, radii.width());
     childOutput = morphology_pass(ctx.withNewDesiredOutput(maxOutput), childOutput, fType,
@@ -69,6 +69,8 @@ private:
     // should respond to the canvas matrix. Forcing translate-only is a hammer that lets the output
     // be correct at the expense of resolution when there's a lot of scaling. See skbug.com/40044507.
     MatrixCapability onGetCTMCapability() const override { return MatrixCapability::kTranslate; }
+    // Geometric uniforms are not mapped, so they may be absolute positions in layer space.
+    bool onIsTranslationInvariant() const override { return false; }
 
     skif::FilterResult onFilterImage(const skif::Context&) const override;
 
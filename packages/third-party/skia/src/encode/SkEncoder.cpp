@@ -7,6 +7,7 @@
 
 #include "include/encode/SkEncoder.h"
 
+#include "include/core/SkImageInfo.h"
 #include "include/private/base/SkAssert.h"
 
 bool SkEncoder::encodeRows(int numRows) {
@@ -27,3 +28,28 @@ bool SkEncoder::encodeRows(int numRows) {
 
     return true;
 }
+
+bool SkEncoder::encodeRows(const SkPixmap& rows) {
+    if (!this->onSupportsRowPixmaps()) {
+        return false;
+    }
+    if (!rows.addr() || rows.height() <= 0 || rows.width() != fSrc.width() ||
+        rows.info().colorInfo() != fSrc.info().colorInfo() ||
+        fCurrRow + rows.height() > fSrc.height()) {
+        return false;
+    }
+
+    fRows = &rows;
+    fRowsTop = fCurrRow;
+    const bool result = this->encodeRows(rows.height());
+    fRows = nullptr;
+    return result;
+}
+
+const void* SkEncoder::srcRowAddr(int y) const {
+    if (fRows) {
+        SkASSERT(fRowsTop <= y && y < fRowsTop + fRows->height());
+        return fRows->addr(0, y - fRowsTop);
+    }
+    return fSrc.addr(0, y);
+}
@@ -368,8 +368,8 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
     } else {
         const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
         const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
-        const void* srcRow = fSrc.addr(0, fCurrRow);
         for (int i = 0; i < numRows; i++) {
+            const void* srcRow = this->srcRowAddr(fCurrRow + i);
             JSAMPLE* jpegSrcRow = (JSAMPLE*)(const_cast<void*>(srcRow));
             if (fEncoderMgr->shouldUseColorXform()) {
                 sk_msan_assert_initialized(srcRow, SkTAddOffset<const void>(srcRow, srcBytes));
@@ -387,7 +387,6 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
             }
 
             jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-            srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
         }
     }
 
@@ -77,6 +77,8 @@ public:
 
 protected:
     bool onEncodeRows(int numRows) override;
+    // YUVA rows are read from the planes, not through srcRowAddr().
+    bool onSupportsRowPixmaps() const override { return !fSrcYUVA.has_value(); }
 
 private:
     SkJpegEncoderImpl(std::unique_ptr<SkJpegEncoderMgr>, const SkPixmap& src);
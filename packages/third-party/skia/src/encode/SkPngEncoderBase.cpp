@@ -182,26 +182,8 @@ bool SkPngEncoderBase::onEncodeRows(int numRows) {
             return false;
         }
 
-        const void* srcRow = fSrc.addr(0, fCurrRow);
-        sk_msan_assert_initialized(srcRow,
-                                   (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
-
-        if (fSrc.colorType() == kAlpha_8_SkColorType) {
-            // This is a special case where we store kAlpha_8 images as GrayAlpha in png.
-            transform_scanline_A8_to_GrayAlpha((char*)fStorage.get(),
-                                               (const char*)srcRow,
-                                               fSrc.width(),
-                                               SkColorTypeBytesPerPixel(fSrc.colorType()));
-        } else {
-            SkASSERT(fSrc.width() == fTargetInfo.fSrcRowInfo->width());
-            if (!SkConvertPixels(fTargetInfo.fDstRowInfo.value(),
-                                 (void*)fStorage.get(),
-                                 fTargetInfo.fDstRowSize,
-                                 fTargetInfo.fSrcRowInfo.value(),
-                                 srcRow,
-                                 fTargetInfo.fSrcRowInfo->minRowBytes())) {
-                return false;
-            }
+        if (!this->convertRow(fCurrRow, fStorage.get())) {
+            return false;
         }
 
         SkSpan<const uint8_t> rowToEncode(fStorage.get(), fTargetInfo.fDstRowSize);
@@ -220,3 +202,26 @@ bool SkPngEncoderBase::onEncodeRows(int numRows) {
 
     return true;
 }
+
+bool SkPngEncoderBase::convertRow(int y, uint8_t* dst) const {
+    const void* srcRow = this->srcRowAddr(y);
+    sk_msan_assert_initialized(srcRow,
+                               (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
+
+    if (fSrc.colorType() == kAlpha_8_SkColorType) {
+        // This is a special case where we store kAlpha_8 images as GrayAlpha in png.
+        transform_scanline_A8_to_GrayAlpha((char*)dst,
+                                           (const char*)srcRow,
+                                           fSrc.width(),
+                                           SkColorTypeBytesPerPixel(fSrc.colorType()));
+        return true;
+    }
+
+    SkASSERT(fSrc.width() == fTargetInfo.fSrcRowInfo->width());
+    return SkConvertPixels(fTargetInfo.fDstRowInfo.value(),
+                           dst,
+                           fTargetInfo.fDstRowSize,
+                           fTargetInfo.fSrcRowInfo.value(),
+                           srcRow,
+                           fTargetInfo.fSrcRowInfo->minRowBytes());
+}
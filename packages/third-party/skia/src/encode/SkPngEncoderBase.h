@@ -57,6 +57,10 @@ protected:
 
     const TargetInfo& targetInfo() const { return fTargetInfo; }
 
+    // Converts row `y` of the source into `dst`, which must hold `fDstRowSize`
+    // bytes, in the format that is given to `onEncodeRow`.
+    bool convertRow(int y, uint8_t* dst) const;
+
 private:
     TargetInfo fTargetInfo;
     bool fFinishedEncoding = false;
@@ -12,6 +12,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
 #include "include/core/SkImageInfo.h"
@@ -27,8 +28,10 @@
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkNoncopyable.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/encode/SkPngEncoderBase.h"
@@ -38,6 +41,7 @@
 #include <array>
 #include <csetjmp>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <utility>
@@ -45,6 +49,7 @@
 
 #include <png.h>
 #include <pngconf.h>
+#include <zlib.h>
 
 class GrDirectContext;
 class SkImage;
@@ -469,8 +474,270 @@ bool SkPngEncoderImpl::onFinishEncoding() {
     return true;
 }
 
-namespace SkPngEncoder {
-std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+namespace {
+
+// Bands of rows are deflated separately when encoding in parallel. Smaller bands give more
+// parallelism, but each band costs a few bytes of flushing and loses matches across its start.
+constexpr size_t kParallelBandBytes = 256 * 1024;
+
+// The size of the deflate window, and so of the dictionary given to each band.
+constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+png_byte paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return (png_byte)a;
+    }
+    return pb <= pc ? (png_byte)b : (png_byte)c;
+}
+
+// Applies the PNG filter `type` to `row`, whose previous row is `prev`, and writes the result to
+// `dst`. Returns the sum of the absolute values of the filtered bytes, read as signed bytes,
+// which libpng uses to estimate how well a filtered row will compress.
+uint32_t filter_row(int type, const png_byte* row, const png_byte* prev, size_t rowBytes,
+                    size_t pixelBytes, png_byte* dst) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < rowBytes; i++) {
+        const int left = i >= pixelBytes ? row[i - pixelBytes] : 0;
+        const int up = prev[i];
+        const int upLeft = i >= pixelBytes ? prev[i - pixelBytes] : 0;
+        int predicted;
+        switch (type) {
+            case PNG_FILTER_VALUE_SUB:   predicted = left;                                break;
+            case PNG_FILTER_VALUE_UP:    predicted = up;                                  break;
+            case PNG_FILTER_VALUE_AVG:   predicted = (left + up) >> 1;                    break;
+            case PNG_FILTER_VALUE_PAETH: predicted = paeth_predictor(left, up, upLeft);   break;
+            default:                     predicted = 0;                                   break;
+        }
+        const png_byte filtered = (png_byte)(row[i] - predicted);
+        dst[i] = filtered;
+        sum += std::abs((int)(int8_t)filtered);
+    }
+    return sum;
+}
+
+// Deflates `src` as part of a larger zlib stream, with `dictionary` as the data that precedes it.
+// Unless this is the last part, it ends with a sync flush, so the parts can be joined.
+bool deflate_band(SkSpan<const png_byte> src, SkSpan<const png_byte> dictionary, bool last,
+                  int zlibLevel, int strategy, std::vector<png_byte>* dst) {
+    z_stream stream = {};
+    // A negative window size writes raw deflate data, without the zlib header and trailer.
+    if (deflateInit2(&stream, zlibLevel, Z_DEFLATED, -15, 8, strategy) != Z_OK) {
+        return false;
+    }
+    bool ok = dictionary.empty() ||
+              deflateSetDictionary(&stream, dictionary.data(), SkToUInt(dictionary.size())) ==
+                      Z_OK;
+
+    // Leave room for the flush markers as well as the worst case expansion.
+    dst->resize(deflateBound(&stream, (uLong)src.size()) + 16);
+    stream.next_in = const_cast<png_byte*>(src.data());
+    stream.avail_in = SkToUInt(src.size());
+    stream.next_out = dst->data();
+    stream.avail_out = SkToUInt(dst->size());
+    if (ok) {
+        const int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        ok = (last ? result == Z_STREAM_END : result == Z_OK) && stream.avail_in == 0 &&
+             stream.avail_out > 0;
+    }
+    dst->resize(dst->size() - stream.avail_out);
+    deflateEnd(&stream);
+    return ok;
+}
+
+// The zlib stream header that zlib itself would write for `zlibLevel`, with a 32K window.
+std::array<png_byte, 2> zlib_header(int zlibLevel, int strategy) {
+    const int cmf = 0x78;
+    int levelFlags;
+    if (strategy >= Z_HUFFMAN_ONLY || zlibLevel < 2) {
+        levelFlags = 0;
+    } else if (zlibLevel < 6) {
+        levelFlags = 1;
+    } else if (zlibLevel == 6) {
+        levelFlags = 2;
+    } else {
+        levelFlags = 3;
+    }
+    int flg = levelFlags << 6;
+    flg += 31 - ((cmf << 8) + flg) % 31;
+    return {(png_byte)cmf, (png_byte)flg};
+}
+
+struct Band {
+    int fTop;
+    int fBottom;
+    // The filter type and filtered bytes of each row.
+    std::vector<png_byte> fFiltered;
+    std::vector<png_byte> fDeflated;
+    uLong fAdler;
+    bool fSucceeded = false;
+};
+
+// Writes the deflated bands as IDAT chunks, followed by the IEND chunk.
+bool write_bands(png_structp pngPtr, const std::array<png_byte, 2>& header,
+                 const std::vector<Band>& bands, const std::array<png_byte, 4>& trailer) {
+    if (setjmp(png_jmpbuf(pngPtr))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < bands.size(); i++) {
+        const bool first = i == 0;
+        const bool last = i == bands.size() - 1;
+        const std::vector<png_byte>& deflated = bands[i].fDeflated;
+        const size_t length = (first ? header.size() : 0) + deflated.size() +
+                              (last ? trailer.size() : 0);
+        png_write_chunk_start(pngPtr, (png_const_bytep)"IDAT", SkToU32(length));
+        if (first) {
+            png_write_chunk_data(pngPtr, header.data(), header.size());
+        }
+        png_write_chunk_data(pngPtr, deflated.data(), deflated.size());
+        if (last) {
+            png_write_chunk_data(pngPtr, trailer.data(), trailer.size());
+        }
+        png_write_chunk_end(pngPtr);
+    }
+    png_write_chunk(pngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    return true;
+}
+
+}  // namespace
+
+bool SkPngEncoderImpl::encodeRowsInParallel(SkExecutor* executor,
+                                            const SkPngEncoder::Options& options) {
+    SkASSERT(fCurrRow == 0);
+    png_structp pngPtr = fEncoderMgr->pngPtr();
+    png_infop infoPtr = fEncoderMgr->infoPtr();
+
+    // The layout of the rows in the PNG, which drops the filler of opaque images that were
+    // converted to RGBX, and stores 16 bit samples in big endian order.
+    const int width = fSrc.width();
+    const int height = fSrc.height();
+    const size_t rowBytes = png_get_rowbytes(pngPtr, infoPtr);
+    const int bitDepth = png_get_bit_depth(pngPtr, infoPtr);
+    const size_t pixelBytes = png_get_channels(pngPtr, infoPtr) * (bitDepth / 8);
+    const size_t convertedPixelBytes = this->targetInfo().fDstRowSize / width;
+    SkASSERT(rowBytes == width * pixelBytes);
+
+    int filterFlags = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
+    if (filterFlags == 0) {
+        filterFlags = PNG_FILTER_NONE;
+    }
+    // libpng uses the filtered strategy unless no filtering is done.
+    const int strategy = filterFlags == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    const int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
+
+    const int rowsPerBand = std::max(1, SkToInt(kParallelBandBytes / (rowBytes + 1)));
+    std::vector<Band> bands((height + rowsPerBand - 1) / rowsPerBand);
+    for (size_t i = 0; i < bands.size(); i++) {
+        bands[i].fTop = SkToInt(i) * rowsPerBand;
+        bands[i].fBottom = std::min(height, bands[i].fTop + rowsPerBand);
+    }
+
+    // Rows are packed into PNG order, then filtered against the previous row. Each band packs the
+    // row above it again, rather than waiting on its neighbor.
+    auto filterBand = [&](Band& band) {
+        std::vector<png_byte> converted(this->targetInfo().fDstRowSize);
+        std::vector<png_byte> rows(2 * rowBytes, 0);
+        std::vector<png_byte> candidate(rowBytes);
+        png_byte* prev = rows.data();
+        png_byte* curr = rows.data() + rowBytes;
+
+        auto packRow = [&](int y, png_byte* dst) {
+            if (!this->convertRow(y, converted.data())) {
+                return false;
+            }
+            for (int x = 0; x < width; x++) {
+                const png_byte* srcPixel = converted.data() + x * convertedPixelBytes;
+                png_byte* dstPixel = dst + x * pixelBytes;
+                if (bitDepth == 16) {
+                    for (size_t j = 0; j < pixelBytes; j += 2) {
+                        dstPixel[j] = srcPixel[j + 1];
+                        dstPixel[j + 1] = srcPixel[j];
+                    }
+                } else {
+                    memcpy(dstPixel, srcPixel, pixelBytes);
+                }
+            }
+            return true;
+        };
+
+        if (band.fTop > 0 && !packRow(band.fTop - 1, prev)) {
+            return;
+        }
+        band.fFiltered.resize((band.fBottom - band.fTop) * (rowBytes + 1));
+        png_byte* dst = band.fFiltered.data();
+        for (int y = band.fTop; y < band.fBottom; y++) {
+            if (!packRow(y, curr)) {
+                return;
+            }
+            uint32_t bestSum = UINT32_MAX;
+            for (int type = PNG_FILTER_VALUE_NONE; type < PNG_FILTER_VALUE_LAST; type++) {
+                if (!(filterFlags & (PNG_FILTER_NONE << type))) {
+                    continue;
+                }
+                const uint32_t sum =
+                        filter_row(type, curr, prev, rowBytes, pixelBytes, candidate.data());
+                if (sum < bestSum) {
+                    bestSum = sum;
+                    dst[0] = (png_byte)type;
+                    memcpy(dst + 1, candidate.data(), rowBytes);
+                }
+            }
+            dst += rowBytes + 1;
+            std::swap(prev, curr);
+        }
+        band.fAdler = adler32(1, band.fFiltered.data(), SkToUInt(band.fFiltered.size()));
+        band.fSucceeded = true;
+    };
+
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(SkToInt(bands.size()), [&](int i) { filterBand(bands[i]); });
+    taskGroup.wait();
+    for (const Band& band : bands) {
+        if (!band.fSucceeded) {
+            return false;
+        }
+    }
+
+    // Each band is deflated with the end of the band before it as its dictionary, so matches may
+    // reach back across the start of the band as they would in a serial encode.
+    taskGroup.batch(SkToInt(bands.size()), [&](int i) {
+        Band& band = bands[i];
+        SkSpan<const png_byte> dictionary;
+        if (i > 0) {
+            const std::vector<png_byte>& prev = bands[i - 1].fFiltered;
+            const size_t size = std::min(prev.size(), kDeflateWindowBytes);
+            dictionary = SkSpan<const png_byte>(prev.data() + prev.size() - size, size);
+        }
+        band.fSucceeded = deflate_band(band.fFiltered, dictionary, i == SkToInt(bands.size()) - 1,
+                                       zlibLevel, strategy, &band.fDeflated);
+    });
+    taskGroup.wait();
+
+    uLong adler = bands[0].fAdler;
+    for (size_t i = 0; i < bands.size(); i++) {
+        if (!bands[i].fSucceeded) {
+            return false;
+        }
+        if (i > 0) {
+            adler = adler32_combine(adler, bands[i].fAdler, (z_off_t)bands[i].fFiltered.size());
+        }
+    }
+    const std::array<png_byte, 4> trailer = {(png_byte)(adler >> 24), (png_byte)(adler >> 16),
+                                             (png_byte)(adler >> 8), (png_byte)adler};
+
+    // The rows are all written, so the encoder cannot be asked to encode more.
+    fCurrRow = height;
+    return write_bands(pngPtr, zlib_header(zlibLevel, strategy), bands, trailer);
+}
+
+namespace {
+std::unique_ptr<SkPngEncoderImpl> make_encoder(SkWStream* dst,
+                                               const SkPixmap& src,
+                                               const SkPngEncoder::Options& options) {
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
@@ -503,10 +770,24 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
     }
     return std::make_unique<SkPngEncoderImpl>(std::move(*targetInfo), std::move(encoderMgr), src);
 }
+}  // namespace
+
+namespace SkPngEncoder {
+std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    return make_encoder(dst, src, options);
+}
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    auto encoder = Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    auto encoder = make_encoder(dst, src, options);
+    if (!encoder) {
+        return false;
+    }
+    // Parallel encoding only pays for itself when there are several bands.
+    if (options.fExecutor && src.height() > 1 &&
+        src.computeByteSize() >= 2 * kParallelBandBytes) {
+        return encoder->encodeRowsInParallel(options.fExecutor, options);
+    }
+    return encoder->encodeRows(src.height());
 }
 
 sk_sp<SkData> Encode(const SkPixmap& src, const Options& options) {
@@ -15,9 +15,14 @@
 
 #include <memory>
 
+class SkExecutor;
 class SkPixmap;
 class SkPngEncoderMgr;
 
+namespace SkPngEncoder {
+struct Options;
+}
+
 class SkPngEncoderImpl final : public SkPngEncoderBase {
 public:
     // public so it can be called from SkPngEncoder namespace. It should only be made
@@ -25,6 +30,10 @@ public:
     SkPngEncoderImpl(TargetInfo targetInfo, std::unique_ptr<SkPngEncoderMgr>, const SkPixmap& src);
     ~SkPngEncoderImpl() override;
 
+    // Encodes all of the rows, filtering and deflating bands of them on `executor`, and finishes
+    // the PNG. Must be called before any rows are encoded.
+    bool encodeRowsInParallel(SkExecutor* executor, const SkPngEncoder::Options& options);
+
 protected:
     bool onEncodeRow(SkSpan<const uint8_t> row) override;
     bool onFinishEncoding() override;
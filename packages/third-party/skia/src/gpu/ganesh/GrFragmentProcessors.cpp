@@ -46,6 +46,7 @@
 #include "src/effects/colorfilters/SkColorSpaceXformColorFilter.h"
 #include "src/effects/colorfilters/SkComposeColorFilter.h"
 #include "src/effects/colorfilters/SkGaussianColorFilter.h"
+#include "src/effects/colorfilters/SkLut3DColorFilter.h"
 #include "src/effects/colorfilters/SkMatrixColorFilter.h"
 #include "src/effects/colorfilters/SkRuntimeColorFilter.h"
 #include "src/effects/colorfilters/SkTableColorFilter.h"
@@ -324,6 +325,10 @@ static GrFPResult make_colorfilter_fp(skgpu::ganesh::SurfaceDrawContext* sdc,
                                       std::unique_ptr<GrFragmentProcessor> inputFP,
                                       const GrColorInfo& dstColorInfo,
                                       const SkSurfaceProps& props) {
+    if (filter->folded()) {
+        return Make(sdc, filter->folded().get(), std::move(inputFP), dstColorInfo, props);
+    }
+
     // Unfortunately, we need to clone the input before we know we need it. This lets us return
     // the original FP if either internal color filter fails.
     auto inputClone = inputFP ? inputFP->clone() : nullptr;
@@ -393,6 +398,14 @@ static std::unique_ptr<GrFragmentProcessor> hsl_to_rgb(std::unique_ptr<GrFragmen
             effect, "HslToRgb", std::move(child), GrSkSLFP::OptFlags::kPreservesOpaqueInput);
 }
 
+static GrFPResult make_colorfilter_fp(skgpu::ganesh::SurfaceDrawContext* sdc,
+                                      const SkLut3DColorFilter* filter,
+                                      std::unique_ptr<GrFragmentProcessor> inputFP,
+                                      const GrColorInfo& dstColorInfo,
+                                      const SkSurfaceProps& props) {
+    return Make(sdc, filter->runtimeFilter().get(), std::move(inputFP), dstColorInfo, props);
+}
+
 static GrFPResult make_colorfilter_fp(skgpu::ganesh::SurfaceDrawContext* sdc,
                                       const SkMatrixColorFilter* filter,
                                       std::unique_ptr<GrFragmentProcessor> inputFP,
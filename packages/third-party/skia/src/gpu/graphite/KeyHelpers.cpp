@@ -28,6 +28,7 @@
 #include "src/effects/colorfilters/SkColorSpaceXformColorFilter.h"
 #include "src/effects/colorfilters/SkComposeColorFilter.h"
 #include "src/effects/colorfilters/SkGaussianColorFilter.h"
+#include "src/effects/colorfilters/SkLut3DColorFilter.h"
 #include "src/effects/colorfilters/SkMatrixColorFilter.h"
 #include "src/effects/colorfilters/SkRuntimeColorFilter.h"
 #include "src/effects/colorfilters/SkTableColorFilter.h"
@@ -1571,6 +1572,17 @@ static void add_to_key(const KeyContext& keyContext, const SkGaussianColorFilter
     keyContext.paintParamsKeyBuilder()->addBlock(BuiltInCodeSnippetID::kGaussianColorFilter);
 }
 
+static void add_to_key(const KeyContext& keyContext, const SkLut3DColorFilter* filter) {
+    SkASSERT(filter);
+
+    if (sk_sp<SkColorFilter> runtimeFilter = filter->runtimeFilter()) {
+        AddToKey(keyContext, runtimeFilter.get());
+    } else {
+        SKGPU_LOG_W("Couldn't create Lut3DColorFilter's table");
+        keyContext.paintParamsKeyBuilder()->addBlock(BuiltInCodeSnippetID::kPriorOutput);
+    }
+}
+
 static void add_to_key(const KeyContext& keyContext, const SkMatrixColorFilter* filter) {
     SkASSERT(filter);
 
@@ -23,6 +23,7 @@
 #include "src/core/SkMipmap.h"
 #include "src/core/SkNextID.h"
 #include "src/image/SkImage_Base.h"
+#include "src/image/SkRescaleAndReadPixels.h"
 #include "src/shaders/SkImageShader.h"
 
 #include <utility>
@@ -108,6 +109,19 @@ void SkImage::asyncRescaleAndReadPixels(const SkImageInfo& info,
             info, srcRect, rescaleGamma, rescaleMode, callback, context);
 }
 
+bool SkImage::rescaleAndReadPixels(SkSpan<const SkPixmap> dsts,
+                                   const SkIRect& srcRect,
+                                   RescaleGamma rescaleGamma,
+                                   RescaleMode rescaleMode,
+                                   SkExecutor* executor) const {
+    SkBitmap src;
+    if (dsts.empty() || !SkIRect::MakeWH(this->width(), this->height()).contains(srcRect) ||
+        !as_IB(this)->readRescaleSource(srcRect, &src)) {
+        return false;
+    }
+    return SkRescalePixels(src.pixmap(), dsts, rescaleGamma, rescaleMode, executor);
+}
+
 void SkImage::asyncRescaleAndReadPixelsYUV420(SkYUVColorSpace yuvColorSpace,
                                               sk_sp<SkColorSpace> dstColorSpace,
                                               const SkIRect& srcRect,
@@ -32,30 +32,36 @@ SkImage_Base::~SkImage_Base() {
     }
 }
 
+bool SkImage_Base::readRescaleSource(const SkIRect& srcRect, SkBitmap* src) const {
+    SkPixmap peek;
+    if (this->peekPixels(&peek)) {
+        SkBitmap all;
+        return all.installPixels(peek) && all.extractSubset(src, srcRect);
+    }
+    // Context TODO: Elevate GrDirectContext requirement to public API.
+    auto dContext = as_IB(this)->directContext();
+    return src->tryAllocPixels(this->imageInfo().makeDimensions(srcRect.size())) &&
+           this->readPixels(dContext, src->pixmap(), srcRect.x(), srcRect.y());
+}
+
 void SkImage_Base::onAsyncRescaleAndReadPixels(const SkImageInfo& info,
-                                               SkIRect origSrcRect,
+                                               SkIRect srcRect,
                                                RescaleGamma rescaleGamma,
                                                RescaleMode rescaleMode,
                                                ReadPixelsCallback callback,
                                                ReadPixelsContext context) const {
     SkBitmap src;
-    SkPixmap peek;
-    SkIRect srcRect;
-    if (this->peekPixels(&peek)) {
-        src.installPixels(peek);
-        srcRect = origSrcRect;
-    } else {
-        // Context TODO: Elevate GrDirectContext requirement to public API.
-        auto dContext = as_IB(this)->directContext();
-        src.setInfo(this->imageInfo().makeDimensions(origSrcRect.size()));
-        src.allocPixels();
-        if (!this->readPixels(dContext, src.pixmap(), origSrcRect.x(), origSrcRect.y())) {
-            callback(context, nullptr);
-            return;
-        }
-        srcRect = SkIRect::MakeSize(src.dimensions());
+    if (!this->readRescaleSource(srcRect, &src)) {
+        callback(context, nullptr);
+        return;
     }
-    return SkRescaleAndReadPixels(src, info, srcRect, rescaleGamma, rescaleMode, callback, context);
+    return SkRescaleAndReadPixels(src,
+                                  info,
+                                  SkIRect::MakeSize(src.dimensions()),
+                                  rescaleGamma,
+                                  rescaleMode,
+                                  callback,
+                                  context);
 }
 
 bool SkImage_Base::onAsLegacyBitmap(GrDirectContext* dContext, SkBitmap* bitmap) const {
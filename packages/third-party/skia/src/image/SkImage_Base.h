@@ -11,6 +11,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "src/core/SkMipmap.h"
 
@@ -72,6 +73,12 @@ public:
         return sk_ref_sp(this->onPeekMips());
     }
 
+    /**
+     * Reads srcRect of this image into src on the CPU, sharing the pixels when they can be
+     * peeked. This is the source of the generic rescale/read implementations.
+     */
+    bool readRescaleSource(const SkIRect& srcRect, SkBitmap* src) const;
+
     /**
      * Default implementation does a rescale/read and then calls the callback.
      */
@@ -108,6 +115,14 @@ public:
     virtual bool getROPixels(GrDirectContext*, SkBitmap*,
                              CachingHint = kAllow_CachingHint) const = 0;
 
+    // Like getROPixels(), for an image that will be drawn at no more than minDimensions. The
+    // pixels may be smaller than the image, but never smaller than minDimensions, when they can
+    // be produced more cheaply at a reduced size; callers must map through their dimensions.
+    virtual bool getScaledROPixels(GrDirectContext* dContext, SkISize minDimensions,
+                                   SkBitmap* bitmap) const {
+        return this->getROPixels(dContext, bitmap);
+    }
+
     virtual sk_sp<SkImage> onMakeSubset(SkRecorder*, const SkIRect&, RequiredProperties) const = 0;
 
     virtual sk_sp<const SkData> onRefEncoded() const { return nullptr; }
@@ -23,6 +23,7 @@
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkYUVPlanesCache.h"
 
+#include <algorithm>
 #include <utility>
 
 class SkSurfaceProps;
@@ -155,6 +156,58 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
     return true;
 }
 
+bool SkImage_Lazy::getScaledROPixels(GrDirectContext* ctx, SkISize minDimensions,
+                                     SkBitmap* bitmap) const {
+    // Pick the smallest size the generator decodes to natively that still covers minDimensions.
+    // Sizes are rounded to the nearest supported scale (JPEG's eighths, for example), so step up
+    // until one covers it.
+    SkISize scaledSize = this->dimensions();
+    {
+        ScopedGenerator generator(fSharedGenerator);
+        if (generator->getInfo().dimensions() == this->dimensions()) {
+            for (float scale = std::max((float)minDimensions.width() / this->width(),
+                                        (float)minDimensions.height() / this->height());
+                 scale < 1;
+                 scale += 1 / 8.f) {
+                const SkISize size = generator->getScaledDimensions(scale);
+                if (size.width() >= minDimensions.width() &&
+                    size.height() >= minDimensions.height()) {
+                    scaledSize = size;
+                    break;
+                }
+            }
+        }
+    }
+    if (scaledSize.width() >= this->width() && scaledSize.height() >= this->height()) {
+        return this->getROPixels(ctx, bitmap, SkImage::kAllow_CachingHint);
+    }
+
+    // The full decode is no worse if it is already around.
+    if (SkBitmapCache::Find(SkBitmapCacheDesc::Make(this), bitmap)) {
+        return true;
+    }
+
+    auto desc = SkBitmapCacheDesc::MakeScaled(this, scaledSize);
+    if (SkBitmapCache::Find(desc, bitmap)) {
+        SkASSERT(bitmap->isImmutable());
+        SkASSERT(bitmap->getPixels());
+        return true;
+    }
+
+    SkPixmap pmap;
+    SkBitmapCache::RecPtr cacheRec =
+            SkBitmapCache::Alloc(desc, this->imageInfo().makeDimensions(scaledSize), &pmap);
+    if (!cacheRec) {
+        return false;
+    }
+    if (!ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
+        return this->getROPixels(ctx, bitmap, SkImage::kAllow_CachingHint);
+    }
+    SkBitmapCache::Add(std::move(cacheRec), bitmap);
+    this->notifyAddedToRasterCache();
+    return true;
+}
+
 sk_sp<SharedGenerator> SkImage_Lazy::generator() const {
     return fSharedGenerator;
 }
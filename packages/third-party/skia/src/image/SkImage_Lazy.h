@@ -73,6 +73,7 @@ public:
     sk_sp<SkSurface> onMakeSurface(SkRecorder*, const SkImageInfo&) const override;
 
     bool getROPixels(GrDirectContext*, SkBitmap*, CachingHint) const override;
+    bool getScaledROPixels(GrDirectContext*, SkISize minDimensions, SkBitmap*) const override;
     SkImage_Base::Type type() const override { return SkImage_Base::Type::kLazy; }
 
     sk_sp<SkImage> onReinterpretColorSpace(sk_sp<SkColorSpace>) const final;
@@ -12,31 +12,132 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMallocPixelRef.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPixelRef.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSurface.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <utility>
+#include <vector>
 
-void SkRescaleAndReadPixels(SkBitmap bmp,
-                            const SkImageInfo& resultInfo,
-                            const SkIRect& srcRect,
-                            SkImage::RescaleGamma rescaleGamma,
-                            SkImage::RescaleMode rescaleMode,
-                            SkImage::ReadPixelsCallback callback,
-                            SkImage::ReadPixelsContext context) {
-    int srcW = srcRect.width();
-    int srcH = srcRect.height();
+namespace {
+
+// When a pass runs on an executor, its rows are split into stripes of at least this many rows.
+constexpr int kMinStripeRows = 32;
+constexpr int kMaxStripes = 64;
+
+// Runs draw over all of dst, split into stripes of rows on the executor if there is one. Each
+// stripe draws through its own canvas clipped to its rows, so it only samples the source
+// footprint under those rows, and the stripes write disjoint pixels.
+bool draw_in_stripes(const SkPixmap& dst,
+                     SkExecutor* executor,
+                     const std::function<void(SkCanvas*)>& draw) {
+    const int stripes = executor ? std::clamp(dst.height() / kMinStripeRows, 1, kMaxStripes) : 1;
+    std::atomic<bool> ok{true};
+    auto drawStripe = [&](int i) {
+        const int top = static_cast<int>(int64_t{dst.height()} * i / stripes);
+        const int bottom = static_cast<int>(int64_t{dst.height()} * (i + 1) / stripes);
+        SkPixmap stripe;
+        std::unique_ptr<SkCanvas> canvas;
+        if (dst.extractSubset(&stripe, SkIRect::MakeLTRB(0, top, dst.width(), bottom))) {
+            canvas = SkCanvas::MakeRasterDirect(
+                    stripe.info(), stripe.writable_addr(), stripe.rowBytes());
+        }
+        if (!canvas) {
+            ok = false;
+            return;
+        }
+        canvas->translate(0, -top);
+        draw(canvas.get());
+    };
+    if (stripes == 1) {
+        drawStripe(0);
+    } else {
+        SkTaskGroup tasks(*executor);
+        tasks.batch(stripes, drawStripe);
+        tasks.wait();
+    }
+    return ok;
+}
 
-    float sx = (float)resultInfo.width() / srcW;
-    float sy = (float)resultInfo.height() / srcH;
+// Pixel memory for the intermediate levels. A buffer is handed out again once no bitmap uses it,
+// so a chain of passes that keeps no levels ping-pongs between two buffers.
+class ScratchPool {
+public:
+    bool alloc(const SkImageInfo& info, SkBitmap* bitmap) {
+        const size_t rowBytes = info.minRowBytes();
+        const size_t size = info.computeByteSize(rowBytes);
+        if (SkImageInfo::ByteSizeOverflowed(size)) {
+            return false;
+        }
+        sk_sp<SkData>* best = nullptr;
+        for (sk_sp<SkData>& buffer : fBuffers) {
+            if (buffer->unique() && buffer->size() >= size &&
+                (!best || buffer->size() < (*best)->size())) {
+                best = &buffer;
+            }
+        }
+        if (!best) {
+            fBuffers.push_back(SkData::MakeUninitialized(size));
+            best = &fBuffers.back();
+        }
+        sk_sp<SkPixelRef> pixels = SkMallocPixelRef::MakeWithData(info, rowBytes, *best);
+        if (!pixels || !bitmap->setInfo(info, rowBytes)) {
+            return false;
+        }
+        bitmap->setPixelRef(std::move(pixels), 0, 0);
+        return true;
+    }
+
+private:
+    std::vector<sk_sp<SkData>> fBuffers;
+};
+
+SkSamplingOptions rescaling_to_sampling(SkImage::RescaleMode rescaleMode) {
+    SkSamplingOptions sampling;
+    if (rescaleMode == SkImage::RescaleMode::kRepeatedLinear) {
+        sampling = SkSamplingOptions(SkFilterMode::kLinear);
+    } else if (rescaleMode == SkImage::RescaleMode::kRepeatedCubic) {
+        sampling = SkSamplingOptions({1.0f/3, 1.0f/3});
+    }
+    return sampling;
+}
+
+bool covers(const SkBitmap& level, const SkPixmap& dst) {
+    return level.width() >= dst.width() && level.height() >= dst.height();
+}
+
+int64_t area(SkISize size) { return int64_t{size.width()} * size.height(); }
+
+// Rescales all of src into dst in repeated passes. The intermediate levels are appended to
+// levels if it is not null.
+bool rescale(const SkBitmap& src,
+             const SkPixmap& dst,
+             SkImage::RescaleMode rescaleMode,
+             SkExecutor* executor,
+             ScratchPool* pool,
+             std::vector<SkBitmap>* levels) {
+    int srcW = src.width();
+    int srcH = src.height();
+
+    float sx = (float)dst.width() / srcW;
+    float sy = (float)dst.height() / srcH;
     // How many bilerp/bicubic steps to do in X and Y. + means upscaling, - means downscaling.
     int stepsX;
     int stepsY;
@@ -61,51 +162,17 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
             rescaleMode = SkImage::RescaleMode::kRepeatedLinear;
         }
     }
+    const SkSamplingOptions sampling = rescaling_to_sampling(rescaleMode);
 
-    auto rescaling_to_sampling = [](SkImage::RescaleMode rescaleMode) {
-        SkSamplingOptions sampling;
-        if (rescaleMode == SkImage::RescaleMode::kRepeatedLinear) {
-            sampling = SkSamplingOptions(SkFilterMode::kLinear);
-        } else if (rescaleMode == SkImage::RescaleMode::kRepeatedCubic) {
-            sampling = SkSamplingOptions({1.0f/3, 1.0f/3});
-        }
-        return sampling;
-    };
-    SkSamplingOptions sampling = rescaling_to_sampling(rescaleMode);
-
-    sk_sp<SkSurface> tempSurf;
-    sk_sp<SkImage> srcImage;
-    int srcX = srcRect.fLeft;
-    int srcY = srcRect.fTop;
-    SkCanvas::SrcRectConstraint constraint = SkCanvas::kStrict_SrcRectConstraint;
-    // Assume we should ignore the rescale linear request if the surface has no color space since
-    // it's unclear how we'd linearize from an unknown color space.
-    if (rescaleGamma == SkSurface::RescaleGamma::kLinear && bmp.info().colorSpace() &&
-        !bmp.info().colorSpace()->gammaIsLinear()) {
-        auto cs = bmp.info().colorSpace()->makeLinearGamma();
-        // Promote to F16 color type to preserve precision.
-        auto ii = SkImageInfo::Make(srcW, srcH, kRGBA_F16_SkColorType, bmp.info().alphaType(),
-                                    std::move(cs));
-        auto linearSurf = SkSurfaces::Raster(ii);
-        if (!linearSurf) {
-            callback(context, nullptr);
-            return;
-        }
-        linearSurf->getCanvas()->drawImage(bmp.asImage().get(), -srcX, -srcY, sampling, &paint);
-        tempSurf = std::move(linearSurf);
-        srcImage = tempSurf->makeImageSnapshot();
-        srcX = 0;
-        srcY = 0;
-        constraint = SkCanvas::kFast_SrcRectConstraint;
-    } else {
-        // MakeFromBitmap would trigger a copy if bmp is mutable.
-        srcImage = SkImages::RasterFromPixmap(bmp.pixmap(), nullptr, nullptr);
+    if (!stepsX && !stepsY) {
+        return src.readPixels(dst);
     }
+    SkBitmap current = src;
     while (stepsX || stepsY) {
-        int nextW = resultInfo.width();
-        int nextH = resultInfo.height();
+        int nextW = dst.width();
+        int nextH = dst.height();
         if (stepsX < 0) {
-            nextW = resultInfo.width() << (-stepsX - 1);
+            nextW = dst.width() << (-stepsX - 1);
             stepsX++;
         } else if (stepsX != 0) {
             if (stepsX > 1) {
@@ -114,7 +181,7 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
             --stepsX;
         }
         if (stepsY < 0) {
-            nextH = resultInfo.height() << (-stepsY - 1);
+            nextH = dst.height() << (-stepsY - 1);
             stepsY++;
         } else if (stepsY != 0) {
             if (stepsY > 1) {
@@ -122,31 +189,53 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
             }
             --stepsY;
         }
-        auto ii = srcImage->imageInfo().makeWH(nextW, nextH);
-        if (!stepsX && !stepsY) {
-            // Might as well fold conversion to final info in the last step.
-            ii = resultInfo;
+        // Might as well fold conversion to the final info into the last step.
+        const bool last = !stepsX && !stepsY;
+        SkBitmap next;
+        if (!last && !pool->alloc(current.info().makeWH(nextW, nextH), &next)) {
+            return false;
         }
-        auto next = SkSurfaces::Raster(ii);
-        if (!next) {
-            callback(context, nullptr);
-            return;
+        // MakeFromBitmap would trigger a copy if the bitmap is mutable.
+        sk_sp<SkImage> image = SkImages::RasterFromPixmap(current.pixmap(), nullptr, nullptr);
+        auto draw = [&](SkCanvas* canvas) {
+            canvas->drawImageRect(image.get(),
+                                  SkRect::MakeIWH(srcW, srcH),
+                                  SkRect::MakeIWH(nextW, nextH),
+                                  sampling,
+                                  &paint,
+                                  SkCanvas::kFast_SrcRectConstraint);
+        };
+        if (!image || !draw_in_stripes(last ? dst : next.pixmap(), executor, draw)) {
+            return false;
         }
-        next->getCanvas()->drawImageRect(
-                srcImage.get(), SkRect::Make(SkIRect::MakeXYWH(srcX, srcY, srcW, srcH)),
-                SkRect::MakeIWH(nextW, nextH), sampling, &paint, constraint);
-        tempSurf = std::move(next);
-        srcImage = tempSurf->makeImageSnapshot();
-        srcX = srcY = 0;
+        if (last) {
+            break;
+        }
+        if (levels) {
+            levels->push_back(next);
+        }
+        current = std::move(next);
         srcW = nextW;
         srcH = nextH;
-        constraint = SkCanvas::kFast_SrcRectConstraint;
     }
+    return true;
+}
+
+}  // namespace
 
+void SkRescaleAndReadPixels(SkBitmap bmp,
+                            const SkImageInfo& resultInfo,
+                            const SkIRect& srcRect,
+                            SkImage::RescaleGamma rescaleGamma,
+                            SkImage::RescaleMode rescaleMode,
+                            SkImage::ReadPixelsCallback callback,
+                            SkImage::ReadPixelsContext context) {
     size_t rowBytes = resultInfo.minRowBytes();
     std::unique_ptr<char[]> data(new char[resultInfo.height() * rowBytes]);
     SkPixmap pm(resultInfo, data.get(), rowBytes);
-    if (srcImage->readPixels(nullptr, pm, srcX, srcY)) {
+    SkPixmap src;
+    if (bmp.pixmap().extractSubset(&src, srcRect) &&
+        SkRescalePixels(src, {&pm, 1}, rescaleGamma, rescaleMode, /*executor=*/nullptr)) {
         class Result : public SkImage::AsyncReadResult {
         public:
             Result(std::unique_ptr<const char[]> data, size_t rowBytes)
@@ -164,3 +253,81 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
         callback(context, nullptr);
     }
 }
+
+bool SkRescalePixels(const SkPixmap& src,
+                     SkSpan<const SkPixmap> dsts,
+                     SkImage::RescaleGamma rescaleGamma,
+                     SkImage::RescaleMode rescaleMode,
+                     SkExecutor* executor) {
+    if (!src.addr() || src.dimensions().isEmpty()) {
+        return false;
+    }
+    for (const SkPixmap& dst : dsts) {
+        if (!dst.addr() || dst.dimensions().isEmpty()) {
+            return false;
+        }
+    }
+
+    ScratchPool pool;
+    // The levels that later dsts may start from, largest first after the source.
+    std::vector<SkBitmap> levels(1);
+    levels[0].installPixels(src);
+    // Assume we should ignore the rescale linear request if the source has no color space since
+    // it's unclear how we'd linearize from an unknown color space.
+    if (rescaleGamma == SkImage::RescaleGamma::kLinear && src.colorSpace() &&
+        !src.colorSpace()->gammaIsLinear()) {
+        // Promote to F16 color type to preserve precision.
+        auto ii = SkImageInfo::Make(src.dimensions(), kRGBA_F16_SkColorType, src.alphaType(),
+                                    src.colorSpace()->makeLinearGamma());
+        SkBitmap linear;
+        sk_sp<SkImage> image = SkImages::RasterFromPixmap(src, nullptr, nullptr);
+        if (!image || !pool.alloc(ii, &linear)) {
+            return false;
+        }
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        if (!draw_in_stripes(linear.pixmap(), executor, [&](SkCanvas* canvas) {
+                canvas->drawImage(image.get(), 0, 0, SkSamplingOptions(), &paint);
+            })) {
+            return false;
+        }
+        levels[0] = std::move(linear);
+    }
+
+    std::vector<size_t> order(dsts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return area(dsts[a].dimensions()) > area(dsts[b].dimensions());
+    });
+    for (size_t k = 0; k < order.size(); ++k) {
+        const SkPixmap& dst = dsts[order[k]];
+        // Start from the smallest level made so far that covers dst.
+        size_t from = 0;
+        for (size_t i = 1; i < levels.size(); ++i) {
+            if (covers(levels[i], dst)) {
+                from = i;
+            }
+        }
+        // The levels larger than that are not needed again once it covers every remaining dst,
+        // and their buffers go back to the pool.
+        const bool coversRest = std::all_of(order.begin() + k + 1, order.end(), [&](size_t j) {
+            return covers(levels[from], dsts[j]);
+        });
+        if (from > 1 && coversRest) {
+            levels.erase(levels.begin() + 1, levels.begin() + from);
+            from = 1;
+        }
+
+        std::vector<SkBitmap> made;
+        const bool lastDst = k + 1 == order.size();
+        if (!rescale(levels[from], dst, rescaleMode, executor, &pool, lastDst ? nullptr : &made)) {
+            return false;
+        }
+        levels.insert(levels.end(), made.begin(), made.end());
+        std::stable_sort(levels.begin() + 1, levels.end(),
+                         [](const SkBitmap& a, const SkBitmap& b) {
+                             return area(a.dimensions()) > area(b.dimensions());
+                         });
+    }
+    return true;
+}
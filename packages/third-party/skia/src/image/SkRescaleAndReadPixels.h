@@ -8,8 +8,11 @@
 #define SkRescaleAndReadPixels_DEFINED
 
 #include "include/core/SkImage.h"
+#include "include/core/SkSpan.h"
 
 class SkBitmap;
+class SkExecutor;
+class SkPixmap;
 struct SkIRect;
 struct SkImageInfo;
 
@@ -22,4 +25,16 @@ void SkRescaleAndReadPixels(SkBitmap src,
                             SkImage::ReadPixelsCallback,
                             SkImage::ReadPixelsContext);
 
+/**
+ *  Rescales all of src into each of dsts with the same repeated passes as SkRescaleAndReadPixels.
+ *  The dsts are made largest first, and each starts from the smallest level made so far that
+ *  covers it, so outputs share their intermediate levels. If executor is not null, each pass is
+ *  split into stripes of rows that run on it. Returns false if any dst could not be made.
+ */
+bool SkRescalePixels(const SkPixmap& src,
+                     SkSpan<const SkPixmap> dsts,
+                     SkImage::RescaleGamma,
+                     SkImage::RescaleMode,
+                     SkExecutor* executor);
+
 #endif  // SkRescaleAndReadPixels_DEFINED
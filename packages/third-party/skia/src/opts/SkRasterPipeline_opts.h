@@ -2756,6 +2756,91 @@ HIGHP_STAGE(byte_tables, const SkRasterPipelineContexts::TablesCtx* tables) {
     a = from_byte(gather(tables->a, to_unorm(a, 255)));
 }
 
+// Finds the cell of a 3D table that r,g,b fall in, after clamping them to [0,1], and returns the
+// index of its lowest corner, with the position within the cell in fr,fg,fb. NaN maps to 0, which
+// keeps the gathers in bounds.
+SI U32 lut_3d_cell(const SkRasterPipelineContexts::Lut3DCtx* ctx, F r, F g, F b,
+                   F* fr, F* fg, F* fb) {
+    auto axis = [&](F v, F* frac) {
+        v = min(if_then_else(v > 0, v, F0), F1) * ctx->scale;
+        F v0 = min(floor_(v), F_(ctx->scale - 1));
+        *frac = v - v0;
+        return trunc_(v0);
+    };
+    U32 ir = axis(r, fr),
+        ig = axis(g, fg),
+        ib = axis(b, fb);
+    return ir + (ig + ib*ctx->size)*ctx->size;
+}
+
+SI void lut_3d_entry(const float* table, U32 ix, F* r, F* g, F* b) {
+    ix = ix*3;
+    *r = gather(table, ix + 0);
+    *g = gather(table, ix + 1);
+    *b = gather(table, ix + 2);
+}
+
+HIGHP_STAGE(lut_3d_trilinear, const SkRasterPipelineContexts::Lut3DCtx* ctx) {
+    F fr, fg, fb;
+    const U32 cell = lut_3d_cell(ctx, r,g,b, &fr,&fg,&fb);
+    const uint32_t sg = ctx->size,
+                   sb = ctx->size*ctx->size;
+
+    F R = F0, G = F0, B = F0;
+    for (int corner = 0; corner < 8; ++corner) {
+        const U32 ix = cell + ((corner & 1) ? 1u : 0u)
+                            + ((corner & 2) ? sg : 0u)
+                            + ((corner & 4) ? sb : 0u);
+        const F w = ((corner & 1) ? fr : F1 - fr) *
+                    ((corner & 2) ? fg : F1 - fg) *
+                    ((corner & 4) ? fb : F1 - fb);
+        F cr, cg, cb;
+        lut_3d_entry(ctx->table, ix, &cr,&cg,&cb);
+        R = mad(w, cr, R);
+        G = mad(w, cg, G);
+        B = mad(w, cb, B);
+    }
+    r = R;
+    g = G;
+    b = B;
+}
+
+// Interpolates within the one of the six tetrahedra of the cell that contains r,g,b. They all
+// share the cell's lowest and highest corners, and are told apart by the order of fr,fg,fb: the
+// path from the lowest corner to the highest steps along the axis with the largest fraction
+// first, then along the next largest. This reads 4 entries instead of trilinear's 8.
+HIGHP_STAGE(lut_3d_tetrahedral, const SkRasterPipelineContexts::Lut3DCtx* ctx) {
+    F fr, fg, fb;
+    const U32 cell = lut_3d_cell(ctx, r,g,b, &fr,&fg,&fb);
+    const uint32_t sg = ctx->size,
+                   sb = ctx->size*ctx->size;
+
+    const F hi  = max(fr, max(fg, fb)),
+            lo  = min(fr, min(fg, fb)),
+            mid = fr + fg + fb - hi - lo;
+    // The first step is along the largest axis. The first two steps together cover every axis
+    // but the smallest one. Ties pick different axes for the two, so the path stays connected.
+    const U32 first  = (U32)if_then_else(fr == hi, I32_(1),
+                                         if_then_else(fg == hi, I32_(sg), I32_(sb))),
+              second = 1 + sg + sb -
+                       (U32)if_then_else(fb == lo, I32_(sb),
+                                         if_then_else(fg == lo, I32_(sg), I32_(1)));
+
+    F r0, g0, b0, r1, g1, b1, r2, g2, b2, r3, g3, b3;
+    lut_3d_entry(ctx->table, cell,               &r0,&g0,&b0);
+    lut_3d_entry(ctx->table, cell + first,       &r1,&g1,&b1);
+    lut_3d_entry(ctx->table, cell + second,      &r2,&g2,&b2);
+    lut_3d_entry(ctx->table, cell + 1 + sg + sb, &r3,&g3,&b3);
+
+    const F w0 = F1 - hi,
+            w1 = hi - mid,
+            w2 = mid - lo,
+            w3 = lo;
+    r = mad(w0, r0, mad(w1, r1, mad(w2, r2, w3*r3)));
+    g = mad(w0, g0, mad(w1, g1, mad(w2, g2, w3*g3)));
+    b = mad(w0, b0, mad(w1, b1, mad(w2, b2, w3*b3)));
+}
+
 SI F strip_sign(F x, U32* sign) {
     U32 bits = sk_bit_cast<U32>(x);
     *sign = bits & 0x80000000;
@@ -5072,6 +5157,62 @@ HIGHP_STAGE(gauss_a_to_rgba, NoCtx) {
     b = a;
 }
 
+// Abramowitz and Stegun 7.1.27, which is within 5e-4 of erf(x) everywhere.
+SI F approx_erf(F x) {
+    F t = abs_(x);
+    F d = mad(mad(mad(t*t, 0.078108f, F_(0.230389f)), t, F_(0.278393f)), t, F1);
+    d = d*d;
+    F v = F1 - F1/(d*d);
+    return if_then_else(x < 0, -v, v);
+}
+
+// The coverage of one pixel of a Gaussian blurred rect or round rect with circular corners,
+// following Evan Wallace's "Fast Rounded Rectangle Shadows". Along x, each row of the shape is a
+// span whose blur is exactly a difference of two erfs. Along y, the span widths are sampled at
+// eight points within 3 sigma of the pixel, and each sample is weighted by the exact Gaussian
+// mass of its part of the column. Rects have the same span on every row, which makes them
+// separable and exact.
+HIGHP_STAGE(rrect_blur_coverage, const SkRasterPipelineContexts::RRectBlurCtx* ctx) {
+    const F x = r - ctx->centerX,
+            y = g - ctx->centerY;
+    const float k = ctx->invSigmaSqrt2,
+                corner = ctx->cornerRadius,
+                reach = 3*ctx->sigma;
+
+    // The pixel sees rows y - t of the shape for t in [lo, hi].
+    const F lo = y - ctx->halfHeight,
+            hi = y + ctx->halfHeight;
+    auto span = [&](F halfSpan) {
+        return approx_erf((x + halfSpan)*k) - approx_erf((x - halfSpan)*k);
+    };
+
+    F coverage;
+    if (corner == 0) {
+        coverage = span(F_(ctx->halfWidth)) * (approx_erf(hi*k) - approx_erf(lo*k));
+    } else {
+        constexpr int kSamples = 8;
+        const F start = min(max(F_(-reach), lo), hi),
+                step = (min(max(F_(reach), lo), hi) - start) * (1.0f / kSamples);
+
+        coverage = F0;
+        F prev = approx_erf(lo*k);
+        for (int i = 0; i < kSamples; ++i) {
+            const F t = mad(F_(i + 0.5f), step, start);
+            const F edge = i == kSamples - 1 ? hi : mad(F_(i + 1.0f), step, start);
+            const F next = approx_erf(edge*k);
+
+            // How far row y - t is into the top or bottom corners, and the half width there.
+            const F inset = min(ctx->halfHeight - corner - abs_(y - t), F0);
+            const F halfSpan = ctx->halfWidth - corner +
+                               sqrt_(max(corner*corner - inset*inset, F0));
+            coverage = mad(span(halfSpan), next - prev, coverage);
+            prev = next;
+        }
+    }
+    a = min(max(coverage * 0.25f, F0), F1);
+    r = g = b = F0;
+}
+
 SI void bilerp_clamp_large(const SkRasterPipelineContexts::GatherCtx* ctx,
                            F* r, F* g, F* b, F* a) {
     // (cx,cy) are the center of our sample.
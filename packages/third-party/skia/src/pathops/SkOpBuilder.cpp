@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
@@ -17,6 +19,7 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkPathEnums.h"
 #include "src/core/SkPathPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pathops/SkOpContour.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
 #include "src/pathops/SkOpSegment.h"
@@ -25,7 +28,10 @@
 #include "src/pathops/SkPathOpsTypes.h"
 #include "src/pathops/SkPathWriter.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 static bool one_contour(const SkPath& path) {
     const auto raw = SkPathPriv::Raw(path, SkResolveConvexity::kNo);
@@ -142,13 +148,13 @@ void SkOpBuilder::reset() {
 /* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
-std::optional<SkPath> SkOpBuilder::resolve() {
-    int count = fOps.size();
+std::optional<SkPath> SkOpBuilder::Resolve(SkSpan<SkPath> paths, SkSpan<const SkPathOp> ops) {
+    int count = SkToInt(ops.size());
     bool allUnion = true;
     SkPathFirstDirection firstDir = SkPathFirstDirection::kUnknown;
     for (int index = 0; index < count; ++index) {
-        SkPath* test = &fPathRefs[index];
-        if (kUnion_SkPathOp != fOps[index] || test->isInverseFillType()) {
+        SkPath* test = &paths[index];
+        if (kUnion_SkPathOp != ops[index] || test->isInverseFillType()) {
             allUnion = false;
             break;
         }
@@ -170,42 +176,222 @@ std::optional<SkPath> SkOpBuilder::resolve() {
         const SkRect& testBounds = test->getBounds();
         for (int inner = 0; inner < index; ++inner) {
             // OPTIMIZE: check to see if the contour bounds do not intersect other contour bounds?
-            if (SkRect::Intersects(fPathRefs[inner].getBounds(), testBounds)) {
+            if (SkRect::Intersects(paths[inner].getBounds(), testBounds)) {
                 allUnion = false;
                 break;
             }
         }
     }
     if (!allUnion) {
-        SkPath result = fPathRefs[0];
+        SkPath result = paths[0];
         for (int index = 1; index < count; ++index) {
-            if (auto res = Op(result, fPathRefs[index], fOps[index])) {
+            if (auto res = Op(result, paths[index], ops[index])) {
                 result = *res;
             } else {
-                reset();
                 return {};
             }
         }
-        reset();
         return result;
     }
     SkPathBuilder sum;
     for (int index = 0; index < count; ++index) {
-        auto result = Simplify(fPathRefs[index]);
+        auto result = Simplify(paths[index]);
         if (!result.has_value()) {
-            reset();
             return {};
         }
-        fPathRefs[index] = *result;
-        if (!fPathRefs[index].isEmpty()) {
+        paths[index] = *result;
+        if (!paths[index].isEmpty()) {
             // convert the even odd result back to winding form before accumulating it
-            if (!FixWinding(&fPathRefs[index])) {
+            if (!FixWinding(&paths[index])) {
                 return {};
             }
-            sum.addPath(fPathRefs[index]);
+            sum.addPath(paths[index]);
         }
     }
-    reset();
 
     return Simplify(sum.detach());
 }
+
+std::optional<SkPath> SkOpBuilder::resolve() {
+    std::optional<SkPath> result = Resolve(fPathRefs, fOps);
+    this->reset();
+    return result;
+}
+
+namespace {
+
+// The parallel resolve splits the operands into groups of about this many paths.
+constexpr int kGroupSize = 64;
+
+// Interleaves the bits of x and y, so that points that are close have close codes.
+uint32_t morton_code(uint32_t x, uint32_t y) {
+    uint32_t code = 0;
+    for (int bit = 0; bit < 16; ++bit) {
+        code |= ((x >> bit) & 1) << (2 * bit) | ((y >> bit) & 1) << (2 * bit + 1);
+    }
+    return code;
+}
+
+struct Contour {
+    SkPath fPath;
+    SkRect fBounds;
+    int fSide;
+    bool fNear = false;
+};
+
+void add_contours(const SkPath& path, int side, std::vector<Contour>* contours) {
+    SkPathBuilder builder;
+    auto flush = [&] {
+        if (!builder.isEmpty()) {
+            SkPath contour = builder.detach();
+            contours->push_back({contour, contour.getBounds(), side});
+        }
+    };
+    SkPath::Iter iter(path, /*forceClose=*/false);
+    while (auto rec = iter.next()) {
+        SkSpan<const SkPoint> pts = rec->fPoints;
+        switch (rec->fVerb) {
+            case SkPathVerb::kMove:
+                flush();
+                builder.moveTo(pts[0]);
+                break;
+            case SkPathVerb::kLine:
+                builder.lineTo(pts[1]);
+                break;
+            case SkPathVerb::kQuad:
+                builder.quadTo(pts[1], pts[2]);
+                break;
+            case SkPathVerb::kConic:
+                builder.conicTo(pts[1], pts[2], rec->conicWeight());
+                break;
+            case SkPathVerb::kCubic:
+                builder.cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPathVerb::kClose:
+                builder.close();
+                break;
+        }
+    }
+    flush();
+}
+
+// Returns one op two, where op is union or xor and both paths are even-odd results of Op.
+// Concatenating even-odd paths toggles the area under each contour, so a contour whose bounds
+// do not touch any contour of the other path can be set aside and added back to the result of
+// the op on the rest unchanged: the area it toggles is either all inside or all outside of the
+// other path, and union and xor treat it the same way there.
+std::optional<SkPath> merge(const SkPath& one, const SkPath& two, SkPathOp op) {
+    SkASSERT(op == kUnion_SkPathOp || op == kXOR_SkPathOp);
+    SkASSERT(!one.isInverseFillType() && !two.isInverseFillType());
+    std::vector<Contour> contours;
+    add_contours(one, 0, &contours);
+    add_contours(two, 1, &contours);
+    std::sort(contours.begin(), contours.end(), [](const Contour& a, const Contour& b) {
+        return a.fBounds.fLeft < b.fBounds.fLeft;
+    });
+
+    // Sweep left to right, keeping the contours of each side whose bounds reach the sweep line.
+    std::vector<Contour*> active[2];
+    for (Contour& contour : contours) {
+        for (std::vector<Contour*>& side : active) {
+            side.erase(std::remove_if(side.begin(), side.end(), [&](const Contour* c) {
+                           return c->fBounds.fRight < contour.fBounds.fLeft;
+                       }), side.end());
+        }
+        for (Contour* other : active[1 - contour.fSide]) {
+            if (other->fBounds.fTop <= contour.fBounds.fBottom &&
+                contour.fBounds.fTop <= other->fBounds.fBottom) {
+                other->fNear = contour.fNear = true;
+            }
+        }
+        active[contour.fSide].push_back(&contour);
+    }
+
+    SkPathBuilder near[2] = {SkPathBuilder(SkPathFillType::kEvenOdd),
+                             SkPathBuilder(SkPathFillType::kEvenOdd)};
+    SkPathBuilder aside(SkPathFillType::kEvenOdd);
+    for (const Contour& contour : contours) {
+        (contour.fNear ? near[contour.fSide] : aside).addPath(contour.fPath);
+    }
+    if (near[0].isEmpty() && near[1].isEmpty()) {
+        return aside.detach();
+    }
+    std::optional<SkPath> result = Op(near[0].detach(), near[1].detach(), op);
+    if (!result) {
+        return {};
+    }
+    SkASSERT(result->getFillType() == SkPathFillType::kEvenOdd);
+    return SkPathBuilder(*result).addPath(aside.detach()).detach();
+}
+
+}  // namespace
+
+std::optional<SkPath> SkOpBuilder::resolve(SkExecutor& executor) {
+    const int count = fOps.size();
+    const SkPathOp op = count > 1 ? fOps[1] : kUnion_SkPathOp;
+    bool parallel = count >= 2 * kGroupSize && (op == kUnion_SkPathOp || op == kXOR_SkPathOp);
+    SkRect bounds = SkRect::MakeEmpty();
+    for (int index = 0; parallel && index < count; ++index) {
+        const SkPath& path = fPathRefs[index];
+        // This also computes the bounds of each path before they are shared across threads.
+        parallel = (index == 0 || fOps[index] == op) && !path.isInverseFillType() &&
+                   path.isFinite();
+        bounds.join(path.getBounds());
+    }
+    if (!parallel) {
+        return this->resolve();
+    }
+    SkASSERT(fOps[0] == kUnion_SkPathOp);
+
+    // Sort the paths along a Morton curve through their centers, so that each run of the sorted
+    // paths is compact and most of its contours are in the interior of its group.
+    const float scaleX = bounds.width() > 0 ? 65535 / bounds.width() : 0,
+                scaleY = bounds.height() > 0 ? 65535 / bounds.height() : 0;
+    std::vector<std::pair<uint32_t, int>> order(count);
+    for (int index = 0; index < count; ++index) {
+        const SkPoint center = fPathRefs[index].getBounds().center();
+        const float x = std::clamp((center.fX - bounds.fLeft) * scaleX, 0.f, 65535.f),
+                    y = std::clamp((center.fY - bounds.fTop) * scaleY, 0.f, 65535.f);
+        order[index] = {morton_code(static_cast<uint32_t>(x), static_cast<uint32_t>(y)), index};
+    }
+    std::sort(order.begin(), order.end());
+
+    const int groupCount = count / kGroupSize;
+    std::vector<std::optional<SkPath>> results(groupCount);
+    SkTaskGroup tasks(executor);
+    tasks.batch(groupCount, [&](int group) {
+        const int begin = group * count / groupCount,
+                  end = (group + 1) * count / groupCount;
+        skia_private::TArray<SkPath> paths(end - begin);
+        SkTDArray<SkPathOp> ops;
+        for (int index = begin; index < end; ++index) {
+            paths.push_back(fPathRefs[order[index].second]);
+            *ops.append() = index == begin ? kUnion_SkPathOp : op;
+        }
+        std::optional<SkPath> result = Resolve(paths, ops);
+        // A group of one path may not have been through Op.
+        if (result && result->getFillType() != SkPathFillType::kEvenOdd) {
+            result = Simplify(*result);
+        }
+        results[group] = std::move(result);
+    });
+    tasks.wait();
+
+    while (results.size() > 1) {
+        if (std::any_of(results.begin(), results.end(), [](const auto& r) { return !r; })) {
+            this->reset();
+            return {};
+        }
+        std::vector<std::optional<SkPath>> merged((results.size() + 1) / 2);
+        tasks.batch(SkToInt(results.size() / 2), [&](int index) {
+            merged[index] = merge(*results[2 * index], *results[2 * index + 1], op);
+        });
+        tasks.wait();
+        if (results.size() & 1) {
+            merged.back() = std::move(results.back());
+        }
+        results = std::move(merged);
+    }
+    this->reset();
+    return std::move(results[0]);
+}
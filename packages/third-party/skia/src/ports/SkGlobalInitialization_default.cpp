@@ -73,6 +73,7 @@
         SkRegisterSkColorSpaceXformColorFilterFlattenable();
         SkRegisterWorkingFormatColorFilterFlattenable();
         SkRegisterTableColorFilterFlattenable();
+        SkRegisterLut3DColorFilterFlattenable();
 
         // Blenders.
         SK_REGISTER_FLATTENABLE(SkBlendModeBlender);
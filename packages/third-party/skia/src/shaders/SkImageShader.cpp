@@ -530,7 +530,7 @@ bool SkImageShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixR
     }
 
     SkASSERT(!sampling.useCubic || sampling.mipmap == SkMipmapMode::kNone);
-    auto* access = SkMipmapAccessor::Make(alloc, fImage.get(), baseInv, sampling.mipmap);
+    auto* access = SkMipmapAccessor::Make(alloc, fImage.get(), baseInv, sampling);
     if (!access) {
         return false;
     }
@@ -286,6 +286,7 @@ public:
 
     size_t bytesUsed() const override { return fTessellations->size(); }
 
+    Tier getTier() const override { return Tier::kMask; }
     const char* getCategory() const override { return "tessellated shadow masks"; }
 
     sk_sp<CachedTessellations> refTessellations() const { return fTessellations; }
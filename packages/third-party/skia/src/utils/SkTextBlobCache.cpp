@@ -0,0 +1,303 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkTextBlobCache.h"
+
+#include "include/core/SkFont.h"
+#include "include/core/SkFontTypes.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkTraceMemoryDump.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkLRUCache.h"
+#include "src/core/SkTHash.h"
+#include "src/core/SkTextBlobPriv.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Blobs made by the cache share allocations of up to this size, and at most an eighth of the byte
+// limit, so that the slabs being filled are a small part of the budget.
+constexpr size_t kMaxSlabSize = 16 * 1024;
+
+size_t slab_size(size_t byteLimit) {
+    return std::min(kMaxSlabSize, byteLimit / 8);
+}
+
+uint32_t font_hash(const SkFont& font) {
+    struct {
+        SkTypefaceID fTypefaceID;
+        SkScalar     fSize;
+        SkScalar     fScaleX;
+        SkScalar     fSkewX;
+        uint32_t     fFlags;
+    } fields;
+    static_assert(sizeof(fields) == 5 * sizeof(uint32_t), "font_hash_fields_should_be_packed");
+
+    fields.fTypefaceID = font.getTypeface() ? font.getTypeface()->uniqueID() : 0;
+    fields.fSize = font.getSize();
+    fields.fScaleX = font.getScaleX();
+    fields.fSkewX = font.getSkewX();
+    fields.fFlags = static_cast<uint32_t>(font.getEdging())       |
+                    static_cast<uint32_t>(font.getHinting()) << 2 |
+                    font.isForceAutoHinting()                << 4 |
+                    font.isEmbeddedBitmaps()                 << 5 |
+                    font.isSubpixel()                        << 6 |
+                    font.isLinearMetrics()                   << 7 |
+                    font.isEmbolden()                        << 8 |
+                    font.isBaselineSnap()                    << 9;
+    return SkChecksum::Hash32(&fields, sizeof(fields));
+}
+
+struct Key {
+    Key(const char utf8[], size_t byteLength, const SkFont& font,
+        SkTextBlobCache::Positioning positioning)
+            : fText(utf8, byteLength)
+            , fFont(font)
+            , fPositioning(positioning)
+            , fHash(SkChecksum::Hash32(utf8, byteLength,
+                                       font_hash(font) + static_cast<uint32_t>(positioning))) {}
+
+    bool operator==(const Key& that) const {
+        return fHash == that.fHash &&
+               fPositioning == that.fPositioning &&
+               fFont == that.fFont &&
+               fText == that.fText;
+    }
+
+    struct Hash {
+        uint32_t operator()(const Key& key) const { return key.fHash; }
+    };
+
+    const SkString                     fText;
+    const SkFont                       fFont;
+    const SkTextBlobCache::Positioning fPositioning;
+    const uint32_t                     fHash;
+};
+
+struct Value {
+    sk_sp<SkTextBlob> fBlob;
+    size_t            fBytes;  // not counting the slab
+    const void*       fSlab;
+};
+
+sk_sp<SkTextBlob> make_blob(SkTextBlobBuilder* builder,
+                            const char utf8[], size_t byteLength, const SkFont& font,
+                            SkTextBlobCache::Positioning positioning) {
+    const size_t count = font.countText(utf8, byteLength, SkTextEncoding::kUTF8);
+    if (count == 0 || count > std::numeric_limits<int>::max()) {
+        return nullptr;
+    }
+
+    switch (positioning) {
+        case SkTextBlobCache::Positioning::kDefault: {
+            auto buffer = builder->allocRun(font, count, 0, 0);
+            font.textToGlyphs(utf8, byteLength, SkTextEncoding::kUTF8, {buffer.glyphs, count});
+            break;
+        }
+        case SkTextBlobCache::Positioning::kHorizontal: {
+            auto buffer = builder->allocRunPosH(font, count, 0);
+            font.textToGlyphs(utf8, byteLength, SkTextEncoding::kUTF8, {buffer.glyphs, count});
+            font.getXPos({buffer.glyphs, count}, {buffer.pos, count});
+            break;
+        }
+        case SkTextBlobCache::Positioning::kFull: {
+            auto buffer = builder->allocRunPos(font, count);
+            font.textToGlyphs(utf8, byteLength, SkTextEncoding::kUTF8, {buffer.glyphs, count});
+            font.getPos({buffer.glyphs, count}, {buffer.points(), count});
+            break;
+        }
+    }
+    return builder->make();
+}
+
+}  // namespace
+
+// A slab is freed only when all of its blobs are, so the cache charges each slab that holds one of
+// its blobs in full, once, rather than charging the blobs for their own storage. The slab that the
+// builder is filling is charged too.
+class SkTextBlobCache::Impl {
+public:
+    explicit Impl(size_t byteLimit)
+            : fLRU(std::numeric_limits<int>::max(), this)
+            , fBuilder(std::make_unique<SkTextBlobBuilder>(slab_size(byteLimit)))
+            , fByteLimit(byteLimit) {}
+
+    sk_sp<SkTextBlob> findOrMake(const char utf8[], size_t byteLength, const SkFont& font,
+                                 Positioning positioning) SK_EXCLUDES(fMutex) {
+        Key key(utf8, byteLength, font, positioning);
+
+        SkAutoMutexExclusive lock(fMutex);
+        if (Value* value = fLRU.find(key)) {
+            return value->fBlob;
+        }
+
+        sk_sp<SkTextBlob> blob = make_blob(fBuilder.get(), utf8, byteLength, font, positioning);
+        if (!blob) {
+            return nullptr;
+        }
+
+        const void* slab = SkTextBlobPriv::Slab(*blob);
+        if (slab && slab != fBuilderSlab) {
+            // The builder has moved on to a new slab.
+            this->refSlab(slab, SkTextBlobPriv::SlabSize(*blob));
+            this->releaseBuilderSlab();
+            fBuilderSlab = slab;
+        }
+
+        const size_t bytes = sizeof(Value) + sizeof(Key) + byteLength +
+                             (slab ? 0 : SkTextBlobPriv::StorageSize(*blob));
+        if (bytes <= fByteLimit) {
+            if (slab) {
+                this->refSlab(slab, SkTextBlobPriv::SlabSize(*blob));
+            }
+            fLRU.insert(std::move(key), Value{blob, bytes, slab});
+            fTotalBytesUsed += bytes;
+        }
+        this->purgeToLimit();
+        return blob;
+    }
+
+    size_t setByteLimit(size_t byteLimit) SK_EXCLUDES(fMutex) {
+        SkAutoMutexExclusive lock(fMutex);
+        const size_t previous = fByteLimit;
+        fByteLimit = byteLimit;
+        if (slab_size(byteLimit) != slab_size(previous)) {
+            this->resetBuilder();
+        }
+        this->purgeToLimit();
+        return previous;
+    }
+
+    size_t getByteLimit() const SK_EXCLUDES(fMutex) {
+        SkAutoMutexExclusive lock(fMutex);
+        return fByteLimit;
+    }
+
+    size_t getTotalBytesUsed() const SK_EXCLUDES(fMutex) {
+        SkAutoMutexExclusive lock(fMutex);
+        return fTotalBytesUsed;
+    }
+
+    int count() const SK_EXCLUDES(fMutex) {
+        SkAutoMutexExclusive lock(fMutex);
+        return fLRU.count();
+    }
+
+    void purgeAll() SK_EXCLUDES(fMutex) {
+        SkAutoMutexExclusive lock(fMutex);
+        fLRU.reset();
+        fSlabs.reset();
+        fBuilderSlab = nullptr;
+        fBuilder = std::make_unique<SkTextBlobBuilder>(slab_size(fByteLimit));
+        fTotalBytesUsed = 0;
+    }
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const SK_EXCLUDES(fMutex) {
+        static constexpr char kDumpName[] = "skia/sk_text_blob_cache";
+        SkAutoMutexExclusive lock(fMutex);
+        dump->dumpNumericValue(kDumpName, "size", "bytes", fTotalBytesUsed);
+        dump->dumpNumericValue(kDumpName, "budget_size", "bytes", fByteLimit);
+        dump->dumpNumericValue(kDumpName, "blob_count", "objects", fLRU.count());
+        dump->dumpNumericValue(kDumpName, "slab_count", "objects", fSlabs.count());
+        dump->setMemoryBacking(kDumpName, "malloc", nullptr);
+    }
+
+private:
+    struct PurgeCB {
+        void operator()(void* context, const Key&, const Value* value) const {
+            auto impl = static_cast<Impl*>(context);
+            SkASSERT(impl->fTotalBytesUsed >= value->fBytes);
+            impl->fTotalBytesUsed -= value->fBytes;
+            if (value->fSlab) {
+                impl->unrefSlab(value->fSlab);
+            }
+        }
+    };
+
+    struct SlabUse {
+        int    fRefs;  // cached blobs in the slab, plus one if the builder is filling it
+        size_t fBytes;
+    };
+
+    void refSlab(const void* slab, size_t bytes) SK_REQUIRES(fMutex) {
+        if (SlabUse* use = fSlabs.find(slab)) {
+            use->fRefs++;
+        } else {
+            fSlabs.set(slab, SlabUse{1, bytes});
+            fTotalBytesUsed += bytes;
+        }
+    }
+
+    void unrefSlab(const void* slab) SK_REQUIRES(fMutex) {
+        SlabUse* use = fSlabs.find(slab);
+        SkASSERT(use && use->fRefs > 0);
+        if (--use->fRefs == 0) {
+            SkASSERT(fTotalBytesUsed >= use->fBytes);
+            fTotalBytesUsed -= use->fBytes;
+            fSlabs.remove(slab);
+        }
+    }
+
+    void releaseBuilderSlab() SK_REQUIRES(fMutex) {
+        if (fBuilderSlab) {
+            this->unrefSlab(fBuilderSlab);
+            fBuilderSlab = nullptr;
+        }
+    }
+
+    // Makes a new builder, so that the slab it was filling is no longer held by it.
+    void resetBuilder() SK_REQUIRES(fMutex) {
+        this->releaseBuilderSlab();
+        fBuilder = std::make_unique<SkTextBlobBuilder>(slab_size(fByteLimit));
+    }
+
+    void purgeToLimit() SK_REQUIRES(fMutex) {
+        while (fTotalBytesUsed > fByteLimit && fLRU.count() > 0) {
+            fLRU.removeLeastRecentlyUsed();
+        }
+        if (fTotalBytesUsed > fByteLimit) {
+            this->resetBuilder();
+        }
+    }
+
+    mutable SkMutex fMutex;
+    SkLRUCache<Key, Value, Key::Hash, PurgeCB> fLRU SK_GUARDED_BY(fMutex);
+    skia_private::THashMap<const void*, SlabUse> fSlabs SK_GUARDED_BY(fMutex);
+    std::unique_ptr<SkTextBlobBuilder> fBuilder SK_GUARDED_BY(fMutex);
+    const void* fBuilderSlab SK_GUARDED_BY(fMutex) = nullptr;
+    size_t fByteLimit SK_GUARDED_BY(fMutex);
+    size_t fTotalBytesUsed SK_GUARDED_BY(fMutex) = 0;
+};
+
+SkTextBlobCache::SkTextBlobCache(size_t byteLimit) : fImpl(std::make_unique<Impl>(byteLimit)) {}
+
+SkTextBlobCache::~SkTextBlobCache() = default;
+
+sk_sp<SkTextBlob> SkTextBlobCache::findOrMake(const char utf8[], size_t byteLength,
+                                              const SkFont& font, Positioning positioning) {
+    return fImpl->findOrMake(utf8, byteLength, font, positioning);
+}
+
+size_t SkTextBlobCache::setByteLimit(size_t byteLimit) { return fImpl->setByteLimit(byteLimit); }
+
+size_t SkTextBlobCache::getByteLimit() const { return fImpl->getByteLimit(); }
+
+size_t SkTextBlobCache::getTotalBytesUsed() const { return fImpl->getTotalBytesUsed(); }
+
+int SkTextBlobCache::count() const { return fImpl->count(); }
+
+void SkTextBlobCache::purgeAll() { fImpl->purgeAll(); }
+
+void SkTextBlobCache::dumpMemoryStatistics(SkTraceMemoryDump* dump) const {
+    fImpl->dumpMemoryStatistics(dump);
+}
@@ -11,6 +11,8 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
@@ -21,15 +23,18 @@
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/gpu/GpuTypes.h"
 #include "include/private/base/SkTPin.h"
 #include "src/base/SkFloatBits.h"
 #include "src/base/SkMathPriv.h"
+#include "src/base/SkScopeExit.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkColorPriv.h"
 #include "src/core/SkMask.h"
@@ -52,9 +57,11 @@
 
 #include <math.h>
 #include <string.h>
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <initializer_list>
 
 struct GrContextOptions;
@@ -596,6 +603,125 @@ DEF_TEST(zero_blur, reporter) {
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
 
+// Blurs split across an executor in bands of rows and tiles of columns match blurs on the
+// drawing thread exactly, for both the 8888 and the A8 algorithms and each kind of pass.
+DEF_SERIAL_TEST(BlurImageFilter_RasterExecutor, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkExecutor* previous = SkGraphics::GetRasterExecutor();
+    SK_AT_SCOPE_EXIT(SkGraphics::SetRasterExecutor(previous));
+
+    auto blur = [](SkColorType colorType, SkSize sigma) {
+        sk_sp<SkSurface> surface =
+                SkSurfaces::Raster(SkImageInfo::Make(509, 387, colorType, kPremul_SkAlphaType));
+        SkCanvas* canvas = surface->getCanvas();
+        SkPaint layerPaint;
+        layerPaint.setImageFilter(SkImageFilters::Blur(sigma.width(), sigma.height(), nullptr));
+        canvas->saveLayer(nullptr, &layerPaint);
+        SkPaint paint;
+        for (int i = 0; i < 24; ++i) {
+            paint.setColor(SkColorSetARGB(255 - 7 * i, 37 * i, 255 - 11 * i, 91 * i));
+            canvas->drawCircle(20.f * i + 7, 13.f * i + 31, 5.f + 3 * (i % 7), paint);
+            canvas->drawRect(SkRect::MakeXYWH(480 - 19.f * i, 17.f * i, 9, 23), paint);
+        }
+        canvas->restore();
+
+        SkBitmap bitmap;
+        bitmap.allocPixels(surface->imageInfo());
+        surface->readPixels(bitmap, 0, 0);
+        return bitmap;
+    };
+
+    for (SkColorType colorType : {kN32_SkColorType, kAlpha_8_SkColorType}) {
+        for (SkSize sigma : {SkSize{1.5f, 1.5f}, SkSize{24, 9}, SkSize{0, 17}, SkSize{17, 0}}) {
+            SkGraphics::SetRasterExecutor(nullptr);
+            SkBitmap serial = blur(colorType, sigma);
+            SkGraphics::SetRasterExecutor(executor.get());
+            SkBitmap threaded = blur(colorType, sigma);
+
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(serial, threaded),
+                            "colorType %d, sigma %g x %g",
+                            colorType, sigma.width(), sigma.height());
+        }
+    }
+}
+
+// Raster rects and circular-cornered round rects with a normal blur evaluate the blurred coverage
+// in closed form. It should stay close to a true Gaussian blur of the antialiased shape, and a
+// clip should only select pixels, not change them.
+DEF_TEST(BlurAnalyticRRect, reporter) {
+    constexpr int kSize = 128;
+    const SkImageInfo info = SkImageInfo::MakeA8(kSize, kSize);
+
+    auto draw = [&](const SkRRect& rrect, SkScalar sigma, const SkRegion* clip) {
+        sk_sp<SkSurface> surface = SkSurfaces::Raster(info);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        if (sigma > 0) {
+            paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, sigma));
+        }
+        if (clip) {
+            surface->getCanvas()->clipRegion(*clip);
+        }
+        surface->getCanvas()->drawRRect(rrect, paint);
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        surface->readPixels(bitmap, 0, 0);
+        return bitmap;
+    };
+
+    struct {
+        SkRect   rect;
+        SkScalar radius;
+        SkScalar sigma;
+    } kCases[] = {
+        {SkRect::MakeLTRB(30,    28,    98,    100),    0,  4},
+        {SkRect::MakeLTRB(30.3f, 28.6f, 97.2f, 99.9f),  0,  2.5f},
+        {SkRect::MakeLTRB(30,    28,    98,    100),   12,  4},
+        {SkRect::MakeLTRB(33.5f, 35.2f, 91.7f, 80.1f),  9,  2.5f},
+        {SkRect::MakeLTRB(24,    24,    104,   104),   40,  6},  // a circle
+        {SkRect::MakeLTRB(40,    36,    88,    92),    16, 10},
+    };
+
+    for (const auto& c : kCases) {
+        const SkRRect rrect = SkRRect::MakeRectXY(c.rect, c.radius, c.radius);
+        SkBitmap analytic = draw(rrect, c.sigma, nullptr);
+
+        SkBitmap shape = draw(rrect, 0, nullptr);
+        SkMaskBuilder truth;
+        const SkMask src(shape.getAddr8(0, 0), shape.bounds(), shape.rowBytes(),
+                         SkMask::kA8_Format);
+        if (!SkBlurMask::BlurGroundTruth(c.sigma, &truth, src, kNormal_SkBlurStyle)) {
+            ERRORF(reporter, "Could not compute the ground truth blur");
+            continue;
+        }
+        SkAutoMaskFreeImage freeTruth(truth.image());
+
+        int maxDiff = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                maxDiff = std::max(maxDiff, std::abs(*analytic.getAddr8(x, y) -
+                                                     *truth.getAddr8(x, y)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 5, "radius %g, sigma %g: max diff %d",
+                        c.radius, c.sigma, maxDiff);
+
+        // A clip made of several rects crosses the constant band in the middle of the shape.
+        SkRegion clip(SkIRect::MakeLTRB(0, 10, 70, 118));
+        clip.op(SkIRect::MakeLTRB(50, 0, 128, 60), SkRegion::kUnion_Op);
+        SkBitmap clipped = draw(rrect, c.sigma, &clip);
+        bool matches = true;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                const uint8_t expected = clip.contains(x, y) ? *analytic.getAddr8(x, y) : 0;
+                matches &= *clipped.getAddr8(x, y) == expected;
+            }
+        }
+        REPORTER_ASSERT(reporter, matches, "radius %g, sigma %g: clipped pixels differ",
+                        c.radius, c.sigma);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 // b/444805331 : Fuzzer created a view matrix that did not preserveRightAngles but could still
@@ -601,8 +601,11 @@ DEF_TEST(EncodedOriginToMatrixTest, r) {
 
 #if defined(SK_ENABLE_SKOTTIE)
 
+#include "include/core/SkExecutor.h"
 #include "modules/skresources/src/SkAnimCodecPlayer.h"
 
+#include <functional>
+
 DEF_TEST(AnimCodecPlayer, r) {
     static constexpr struct {
         const char* fFile;
@@ -646,4 +649,46 @@ DEF_TEST(AnimCodecPlayer, r) {
     }
 }
 
+namespace {
+// Runs each task as soon as it is added, so decoding ahead is done by the time seek() returns.
+class InlineExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> fn) override { fn(); }
+};
+}  // namespace
+
+DEF_TEST(AnimCodecPlayer_prefetch, r) {
+    for (const char* file : {"images/alphabetAnim.gif", "images/stoplight.webp"}) {
+        auto data = GetResourceAsData(file);
+        auto codec = SkCodec::MakeFromData(data);
+        REPORTER_ASSERT(r, codec);
+        const std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+        const size_t frameBytes = codec->getInfo().computeMinByteSize();
+
+        InlineExecutor executor;
+        SkAnimCodecPlayer::Options options;
+        options.fExecutor = &executor;
+        options.fPrefetchFrames = 2;
+        options.fFrameCacheBytes = 3 * frameBytes;
+        SkAnimCodecPlayer player(std::move(codec), options);
+        SkAnimCodecPlayer expected(SkCodec::MakeFromData(data));
+
+        // Play twice through, so the second time decodes again what the budget dropped.
+        uint32_t start = 0;
+        for (int loop = 0; loop < 2; ++loop) {
+            for (const SkCodec::FrameInfo& info : frameInfos) {
+                player.seek(start);
+                expected.seek(start);
+                REPORTER_ASSERT(r, player.isFrameReady() || start == 0,
+                                "%s at %u ms was not decoded ahead", file, start);
+                auto frame = player.getFrame();
+                REPORTER_ASSERT(r, frame && ToolUtils::equal_pixels(frame.get(),
+                                                                    expected.getFrame().get()),
+                                "%s at %u ms", file, start);
+                start += info.fDuration;
+            }
+        }
+    }
+}
+
 #endif
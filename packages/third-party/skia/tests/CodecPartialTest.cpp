@@ -154,6 +154,57 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "images/box.gif");
     test_partial(r, "images/randPixels.gif", 215);
     test_partial(r, "images/color_wheel.gif");
+    test_partial(r, "images/mandrill_512_q075.jpg");
+    test_partial(r, "images/CMYK.jpg");
+    test_partial(r, "images/brickwork-texture.jpg");
+    test_partial(r, "images/flutter_logo.jpg");
+    test_partial(r, "images/yellow_rose.webp");
+    test_partial(r, "images/color_wheel.webp");
+    test_partial(r, "images/baby_tux.webp");
+}
+
+// A progressive JPEG should be shown in full once its first scan has arrived, and then be refined
+// in place by each later scan.
+DEF_TEST(Codec_partialProgressiveJpeg, r) {
+    const char* name = "images/brickwork-texture.jpg";
+    sk_sp<SkData> file = GetResourceAsData(name);
+    if (!file) {
+        SkDebugf("missing resource %s\n", name);
+        return;
+    }
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode %s", name);
+        return;
+    }
+
+    // The first of its scans ends after 9067 bytes.
+    HaltingStream* stream = new HaltingStream(file, 10000);
+    auto codec = SkCodec::MakeFromStream(std::unique_ptr<SkStream>(stream));
+    if (!codec) {
+        ERRORF(r, "Failed to create codec for %s", name);
+        return;
+    }
+
+    const SkImageInfo info = standardize_info(codec.get());
+    SkBitmap incremental;
+    incremental.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startIncrementalDecode(
+            info, incremental.getPixels(), incremental.rowBytes()));
+
+    int rowsDecoded = 0;
+    REPORTER_ASSERT(r, SkCodec::kIncompleteInput == codec->incrementalDecode(&rowsDecoded));
+    REPORTER_ASSERT(r, rowsDecoded == info.height());
+
+    SkBitmap preview;
+    preview.allocPixels(info);
+    preview.writePixels(incremental.pixmap());
+
+    stream->addNewData(file->size());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->incrementalDecode(&rowsDecoded));
+    compare_bitmaps(r, truth, incremental);
+    REPORTER_ASSERT(r, 0 != memcmp(preview.getPixels(), incremental.getPixels(),
+                                   incremental.computeByteSize()));
 }
 
 DEF_TEST(Codec_partialWuffs, r) {
@@ -12,6 +12,7 @@
 #include "include/codec/SkJpegDecoder.h"
 #include "include/codec/SkPngChunkReader.h"
 #include "include/codec/SkPngDecoder.h"
+#include "include/codec/SkThumbnail.h"
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
@@ -20,17 +21,20 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/encode/SkEncoder.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
@@ -69,6 +73,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <optional>
@@ -1381,8 +1386,8 @@ static void test_conversion_possible(skiatest::Reporter* r, const char* path,
 }
 
 DEF_TEST(Codec_F16ConversionPossible, r) {
-    test_conversion_possible(r, "images/color_wheel.webp", false, false);
-    test_conversion_possible(r, "images/mandrill_512_q075.jpg", true, false);
+    test_conversion_possible(r, "images/color_wheel.webp", false, true);
+    test_conversion_possible(r, "images/mandrill_512_q075.jpg", true, true);
     test_conversion_possible(r, "images/yellow_rose.png", false, true);
 }
 
@@ -1483,7 +1488,6 @@ DEF_TEST(Codec_fallBack, r) {
 
     // Formats that currently do not support incremental decoding
     auto files = {
-        "images/CMYK.jpg",
         "images/mandrill.wbmp",
         "images/randPixels.bmp",
 #if defined(SK_CODEC_DECODES_ICO)
@@ -1991,6 +1995,171 @@ DEF_TEST(Codec_F16_noColorSpace, r) {
     test_info(r, codec.get(), info, SkCodec::kSuccess, nullptr);
 }
 
+// SkThumbnail::Encode should match resampling the full image with the same filter. The image is
+// a smooth gradient, so a full-resolution reference sampled at the thumbnail's pixel centers is
+// close to the filtered result, even when the codec first shrinks the image with DCT scaling.
+DEF_TEST(Codec_Thumbnail, r) {
+    SkBitmap gradient;
+    gradient.allocN32Pixels(1024, 768, /*isOpaque=*/true);
+    for (int y = 0; y < gradient.height(); y++) {
+        for (int x = 0; x < gradient.width(); x++) {
+            *gradient.getAddr32(x, y) = SkPackARGB32(0xFF, x * 255 / 1023, y * 255 / 767, 0x80);
+        }
+    }
+
+    SkDynamicMemoryWStream png, jpeg;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&png, gradient.pixmap(), {}));
+    SkJpegEncoder::Options jpegOptions;
+    jpegOptions.fQuality = 100;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&jpeg, gradient.pixmap(), jpegOptions));
+    const sk_sp<SkData> pngData = png.detachAsData();
+    const sk_sp<SkData> jpegData = jpeg.detachAsData();
+
+    const struct {
+        sk_sp<SkData> fData;
+        SkISize       fSize;
+        int           fTolerance;
+    } recs[] = {
+        { pngData,  {1024, 768}, 1 },
+        { pngData,  {300, 200},  2 },
+        { jpegData, {128, 96},   8 },  // decoded at 1/8 scale
+        { jpegData, {500, 100},  8 },  // decoded at 1/2 scale
+    };
+    const SkThumbnail::EncoderFactory makePng = [](SkWStream* dst, const SkPixmap& src) {
+        return SkPngEncoder::Make(dst, src, {});
+    };
+
+    for (const auto& rec : recs) {
+        if (!rec.fData) {
+            continue;
+        }
+        SkDynamicMemoryWStream thumbnail;
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(rec.fData);
+        REPORTER_ASSERT(r, codec);
+        REPORTER_ASSERT(r, SkThumbnail::Encode(codec.get(), rec.fSize, &thumbnail, makePng));
+
+        SkBitmap actual;
+        std::unique_ptr<SkCodec> thumbnailCodec = SkCodec::MakeFromData(thumbnail.detachAsData());
+        REPORTER_ASSERT(r, thumbnailCodec && thumbnailCodec->dimensions() == rec.fSize);
+        actual.allocPixels(thumbnailCodec->getInfo().makeColorType(kN32_SkColorType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == thumbnailCodec->getPixels(actual.pixmap()));
+
+        SkBitmap expected;
+        expected.allocPixels(actual.info());
+        REPORTER_ASSERT(r, gradient.pixmap().scalePixels(
+                                   expected.pixmap(),
+                                   SkSamplingOptions(SkCubicResampler::Mitchell())));
+
+        int maxDiff = 0;
+        for (int y = 0; y < rec.fSize.height(); y++) {
+            for (int x = 0; x < rec.fSize.width(); x++) {
+                const SkPMColor a = *actual.getAddr32(x, y), e = *expected.getAddr32(x, y);
+                for (int shift : { 0, 8, 16, 24 }) {
+                    maxDiff = std::max(maxDiff,
+                                       std::abs(int((a >> shift) & 0xFF) -
+                                                int((e >> shift) & 0xFF)));
+                }
+            }
+        }
+        REPORTER_ASSERT(r, maxDiff <= rec.fTolerance, "%dx%d: max difference %d",
+                        rec.fSize.width(), rec.fSize.height(), maxDiff);
+    }
+
+    // Nothing to encode to, or nothing to encode.
+    SkDynamicMemoryWStream dst;
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(pngData);
+    REPORTER_ASSERT(r, !SkThumbnail::Encode(codec.get(), {0, 10}, &dst, makePng));
+    REPORTER_ASSERT(r, !SkThumbnail::Encode(codec.get(), {10, 10}, &dst,
+                                            [](SkWStream*, const SkPixmap&) {
+                                                return std::unique_ptr<SkEncoder>();
+                                            }));
+}
+
+// RGB, RGBA and gray PNGs are swizzled, sampled and transformed in one pass, and palette PNGs are
+// transformed through their palette. Verify that this matches transforming the decoded pixels, for
+// each specialized sample factor and one that is not, with and without a subset.
+DEF_TEST(Codec_png_colorXformMatchesReference, r) {
+    const sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                         SkNamedGamut::kDisplayP3);
+    skcms_ICCProfile dstProfile;
+    p3->toProfile(&dstProfile);
+
+    for (const char* path : { "images/mandrill_512.png", "images/index8.png",
+                              "images/yellow_rose.png", "images/grayscale.png" }) {
+        auto data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        auto codec = SkAndroidCodec::MakeFromCodec(SkCodec::MakeFromData(data));
+        if (!codec) {
+            ERRORF(r, "Could not create codec for %s", path);
+            continue;
+        }
+        const skcms_ICCProfile* srcProfile = codec->codec()->getICCProfile();
+        if (!srcProfile) {
+            srcProfile = skcms_sRGB_profile();
+        }
+
+        const SkISize size = codec->getInfo().dimensions();
+        SkIRect subset = SkIRect::MakeLTRB(size.width() / 4, size.height() / 4,
+                                           size.width() * 3 / 4, size.height() * 3 / 4);
+        if (!codec->getSupportedSubset(&subset)) {
+            ERRORF(r, "%s: no supported subset", path);
+            continue;
+        }
+
+        const SkIRect* subsets[] = { nullptr, &subset };
+        for (const SkIRect* subsetPtr : subsets) {
+            for (int sampleSize : { 1, 2, 3, 4, 8 }) {
+                SkAndroidCodec::AndroidOptions options;
+                options.fSampleSize = sampleSize;
+                options.fSubset = subsetPtr;
+                const SkISize dims = subsetPtr
+                        ? codec->getSampledSubsetDimensions(sampleSize, *subsetPtr)
+                        : codec->getSampledDimensions(sampleSize);
+
+                SkBitmap src;
+                src.allocPixels(SkImageInfo::Make(dims, kRGBA_8888_SkColorType,
+                                                  kUnpremul_SkAlphaType));
+                REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(
+                        src.info(), src.getPixels(), src.rowBytes(), &options));
+
+                const struct {
+                    SkColorType       fColorType;
+                    skcms_PixelFormat fFormat;
+                } dsts[] = {
+                    { kRGBA_8888_SkColorType, skcms_PixelFormat_RGBA_8888 },
+                    { kBGRA_8888_SkColorType, skcms_PixelFormat_BGRA_8888 },
+                    { kRGBA_F16_SkColorType,  skcms_PixelFormat_RGBA_hhhh },
+                };
+                for (const auto& dst : dsts) {
+                    SkBitmap actual, expected;
+                    actual.allocPixels(SkImageInfo::Make(dims, dst.fColorType,
+                                                         kPremul_SkAlphaType, p3));
+                    expected.allocPixels(actual.info());
+                    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(
+                            actual.info(), actual.getPixels(), actual.rowBytes(), &options));
+
+                    for (int y = 0; y < dims.height(); y++) {
+                        REPORTER_ASSERT(r, skcms_Transform(
+                                src.getAddr(0, y), skcms_PixelFormat_RGBA_8888,
+                                skcms_AlphaFormat_Unpremul, srcProfile,
+                                expected.getAddr(0, y), dst.fFormat,
+                                skcms_AlphaFormat_PremulAsEncoded, &dstProfile, dims.width()));
+                        if (0 != memcmp(actual.getAddr(0, y), expected.getAddr(0, y),
+                                        dims.width() * actual.bytesPerPixel())) {
+                            ERRORF(r, "%s: row %d differs (color type %d, sample size %d%s)",
+                                   path, y, dst.fColorType, sampleSize,
+                                   subsetPtr ? ", subset" : "");
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 // These test images have ICC profiles that do not map to an SkColorSpace.
 // Verify that decoding them with a null destination space does not perform
 // color space transformations.
@@ -2252,6 +2421,139 @@ DEF_TEST(Codec_jpeg_decode_progressive_stream_incomplete, r) {
     REPORTER_ASSERT(r, result == SkCodec::kIncompleteInput);
 }
 
+namespace {
+// Runs each task on the calling thread, counting them.
+class CountingExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> fn) override {
+        fTaskCount++;
+        fn();
+    }
+
+    int fTaskCount = 0;
+};
+}  // namespace
+
+static void check_jpeg_executor_decode(skiatest::Reporter* r, const char* path,
+                                       const SkImageInfo& info, bool expectParallel) {
+    sk_sp<SkData> data = GetResourceAsData(path);
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+
+    auto decode = [&](SkExecutor* executor, SkBitmap* bm) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        REPORTER_ASSERT(r, codec);
+        const SkImageInfo dstInfo = info.makeDimensions(codec->dimensions());
+        bm->allocPixels(dstInfo);
+        SkCodec::Options options;
+        options.fExecutor = executor;
+        REPORTER_ASSERT(r, codec->getPixels(dstInfo, bm->getPixels(), bm->rowBytes(), &options) ==
+                           SkCodec::kSuccess);
+    };
+
+    SkBitmap serial;
+    decode(nullptr, &serial);
+
+    CountingExecutor counting;
+    SkBitmap unthreaded;
+    decode(&counting, &unthreaded);
+    REPORTER_ASSERT(r, (counting.fTaskCount > 1) == expectParallel, "%s: %d tasks",
+                    path, counting.fTaskCount);
+    REPORTER_ASSERT(r, md5(unthreaded) == md5(serial), "%s", path);
+
+    std::unique_ptr<SkExecutor> threadPool = SkExecutor::MakeFIFOThreadPool(4);
+    SkBitmap parallel;
+    decode(threadPool.get(), &parallel);
+    REPORTER_ASSERT(r, md5(parallel) == md5(serial), "%s", path);
+}
+
+DEF_TEST(Codec_jpeg_restart_intervals_parallel, r) {
+    const SkImageInfo n32 = SkImageInfo::MakeN32Premul(1, 1);
+    const SkImageInfo f16 = SkImageInfo::Make(1, 1, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                                              SkColorSpace::MakeSRGB());
+
+    // Restart intervals of one MCU row each, decoded as bands.
+    check_jpeg_executor_decode(r, "images/icc-v2-gbr.jpg", n32, true);
+    check_jpeg_executor_decode(r, "images/icc-v2-gbr.jpg", f16, true);
+
+    // No restart markers, or a progressive image, are decoded serially.
+    check_jpeg_executor_decode(r, "images/dog.jpg", n32, false);
+    check_jpeg_executor_decode(r, "images/progressive_kitten_missing_eof.jpg", n32, false);
+}
+
+DEF_TEST(Codec_jpeg_tile_index, r) {
+    // A baseline image, one with restart intervals, one with a single component and a
+    // progressive one, which cannot be indexed.
+    for (const char* path : {"images/mandrill_512_q075.jpg", "images/icc-v2-gbr.jpg",
+                             "images/CMYK.jpg", "images/grayscale.jpg"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            SkDebugf("Missing resource '%s'\n", path);
+            continue;
+        }
+        sk_sp<SkData> index = SkJpegDecoder::MakeTileIndex(*data, 2);
+        if (!index) {
+            REPORTER_ASSERT(r, !strcmp(path, "images/grayscale.jpg"), "%s", path);
+            continue;
+        }
+
+        SkCodec::Result result;
+        std::unique_ptr<SkCodec> codec = SkJpegDecoder::DecodeWithTileIndex(data, *index, &result);
+        REPORTER_ASSERT(r, codec && result == SkCodec::kSuccess, "%s", path);
+        if (!codec) {
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo().makeAlphaType(kPremul_SkAlphaType);
+        SkBitmap full;
+        full.allocPixels(info);
+        REPORTER_ASSERT(r, codec->getPixels(full.pixmap()) == SkCodec::kSuccess, "%s", path);
+
+        SkRandom random;
+        for (int i = 0; i < 20; i++) {
+            SkIRect subset = generate_random_subset(&random, info.width(), info.height());
+            if (i == 0) {
+                subset = SkIRect::MakeWH(info.width(), 1);
+            } else if (i == 1) {
+                subset = SkIRect::MakeLTRB(0, info.height() - 1, info.width(), info.height());
+            }
+            REPORTER_ASSERT(r, codec->getValidSubset(&subset));
+
+            SkBitmap tile;
+            tile.allocPixels(info.makeDimensions(subset.size()));
+            SkCodec::Options options;
+            options.fSubset = &subset;
+            REPORTER_ASSERT(r, codec->getPixels(tile.info(), tile.getPixels(), tile.rowBytes(),
+                                                &options) == SkCodec::kSuccess, "%s", path);
+            for (int y = 0; y < subset.height(); y++) {
+                REPORTER_ASSERT(r, !memcmp(tile.getAddr(0, y),
+                                           full.getAddr(subset.left(), subset.top() + y),
+                                           subset.width() * info.bytesPerPixel()),
+                                "%s subset %d,%d %dx%d row %d", path, subset.left(), subset.top(),
+                                subset.width(), subset.height(), y);
+            }
+        }
+
+        // Subsets are only decoded at their own size, even where the codec can scale the image.
+        SkIRect whole = SkIRect::MakeSize(info.dimensions());
+        const SkISize scaled = codec->getScaledDimensions(0.5f);
+        REPORTER_ASSERT(r, scaled != info.dimensions(), "%s", path);
+        SkBitmap tile;
+        tile.allocPixels(info.makeDimensions(scaled));
+        SkCodec::Options options;
+        options.fSubset = &whole;
+        REPORTER_ASSERT(r, codec->getPixels(tile.info(), tile.getPixels(), tile.rowBytes(),
+                                            &options) == SkCodec::kInvalidScale, "%s", path);
+
+        // An index is only used with the image it was made from.
+        sk_sp<SkData> other = GetResourceAsData("images/dog.jpg");
+        codec = SkJpegDecoder::DecodeWithTileIndex(other, *index, &result);
+        SkIRect subset = SkIRect::MakeWH(8, 8);
+        REPORTER_ASSERT(r, codec && !codec->getValidSubset(&subset));
+    }
+}
+
 DEF_TEST(Codec_bmp_indexed_colorxform, r) {
     constexpr char path[] = "images/bmp-size-32x32-8bpp.bmp";
     std::unique_ptr<SkStream> stream(GetResourceAsStream(path));
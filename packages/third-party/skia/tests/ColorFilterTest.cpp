@@ -12,10 +12,13 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTileMode.h"
@@ -29,6 +32,8 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
+#include "src/effects/colorfilters/SkComposeColorFilter.h"
+#include "src/effects/colorfilters/SkLut3DColorFilter.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
 
@@ -37,6 +42,8 @@
 #include "include/gpu/ganesh/SkSurfaceGanesh.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <utility>
 
@@ -205,3 +212,283 @@ DEF_TEST(ColorFilter_OpaqueShaderPaintAlpha, r) {
     canvas.drawPaint(paint);
     REPORTER_ASSERT(r, bmp.getColor(0, 0) == SK_ColorWHITE);
 }
+
+static sk_sp<SkData> make_lut_3d(int size, SkRandom* rand) {
+    sk_sp<SkData> lut = SkData::MakeUninitialized(sizeof(float) * 3 * size * size * size);
+    float* entries = static_cast<float*>(lut->writable_data());
+    for (int i = 0; i < 3 * size * size * size; ++i) {
+        entries[i] = rand->nextF();
+    }
+    return lut;
+}
+
+DEF_TEST(ColorFilter_Lut3D, r) {
+    using Interpolation = SkColorFilters::Lut3DInterpolation;
+    constexpr int kSize = 17;
+    SkRandom rand;
+    sk_sp<SkData> lut = make_lut_3d(kSize, &rand);
+
+    REPORTER_ASSERT(r, !SkColorFilters::Lut3D(lut, 1));
+    REPORTER_ASSERT(r, !SkColorFilters::Lut3D(lut, kSize + 1));
+    REPORTER_ASSERT(r, !SkColorFilters::Lut3D(nullptr, kSize));
+
+    // Enough pixels to fill every SIMD width, some of them outside [0,1].
+    const SkImageInfo info = SkImageInfo::Make(64, 4, kRGBA_F32_SkColorType, kOpaque_SkAlphaType);
+    SkBitmap src;
+    src.allocPixels(info);
+    for (int y = 0; y < info.height(); ++y) {
+        for (int x = 0; x < info.width(); ++x) {
+            float* px = static_cast<float*>(src.getAddr(x, y));
+            for (int c = 0; c < 3; ++c) {
+                px[c] = rand.nextRangeF(-0.25f, 1.25f);
+            }
+            px[3] = 1;
+        }
+    }
+    src.setImmutable();
+
+    for (Interpolation interpolation : {Interpolation::kTrilinear, Interpolation::kTetrahedral}) {
+        sk_sp<SkColorFilter> cf = SkColorFilters::Lut3D(lut, kSize, interpolation);
+        REPORTER_ASSERT(r, cf && as_CFB(cf)->type() == SkColorFilterBase::Type::kLut3D);
+        REPORTER_ASSERT(r, cf->isAlphaUnchanged());
+        auto lut3D = static_cast<const SkLut3DColorFilter*>(cf.get());
+
+        // The raster stage matches the scalar reference.
+        SkBitmap dst;
+        dst.allocPixels(info);
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        paint.setColorFilter(cf);
+        SkCanvas(dst).drawImage(src.asImage(), 0, 0, SkSamplingOptions(), &paint);
+        int mismatches = 0;
+        for (int y = 0; y < info.height(); ++y) {
+            for (int x = 0; x < info.width(); ++x) {
+                const float* in = static_cast<const float*>(src.getAddr(x, y));
+                const float* out = static_cast<const float*>(dst.getAddr(x, y));
+                float expected[3];
+                lut3D->lookup(in, expected);
+                for (int c = 0; c < 3; ++c) {
+                    mismatches += std::fabs(out[c] - expected[c]) > 1e-5f;
+                }
+            }
+        }
+        REPORTER_ASSERT(r, mismatches == 0, "%d mismatched channels", mismatches);
+
+        // Round trips through serialization with the table intact.
+        sk_sp<SkColorFilter> copy = reincarnate_colorfilter(cf.get());
+        REPORTER_ASSERT(r, copy && as_CFB(copy)->type() == SkColorFilterBase::Type::kLut3D);
+        if (copy) {
+            auto lut3DCopy = static_cast<const SkLut3DColorFilter*>(copy.get());
+            REPORTER_ASSERT(r, lut3DCopy->size() == kSize);
+            REPORTER_ASSERT(r, lut3DCopy->interpolation() == interpolation);
+            REPORTER_ASSERT(r, lut3DCopy->lut()->equals(lut.get()));
+        }
+
+        // A preceding RGB matrix folds into the table, which is exact at the grid points.
+        const float matrix[20] = {0.8f, 0.1f, 0.1f, 0, 0.05f,
+                                  0.1f, 0.7f, 0.2f, 0, 0,
+                                  0.2f, 0.2f, 0.6f, 0, -0.02f,
+                                  0,    0,    0,    1, 0};
+        sk_sp<SkColorFilter> composed = cf->makeComposed(SkColorFilters::Matrix(matrix));
+        REPORTER_ASSERT(r, as_CFB(composed)->type() == SkColorFilterBase::Type::kCompose);
+        sk_sp<SkColorFilterBase> folded =
+                static_cast<const SkComposeColorFilter*>(composed.get())->folded();
+        REPORTER_ASSERT(r, folded && folded->type() == SkColorFilterBase::Type::kLut3D);
+        if (!folded || folded->type() != SkColorFilterBase::Type::kLut3D) {
+            continue;
+        }
+        auto lut3DFolded = static_cast<const SkLut3DColorFilter*>(folded.get());
+        float maxError = 0;
+        for (int i = 0; i < 64; ++i) {
+            const float grid[3] = {rand.nextULessThan(kSize) / float(kSize - 1),
+                                   rand.nextULessThan(kSize) / float(kSize - 1),
+                                   rand.nextULessThan(kSize) / float(kSize - 1)};
+            float mapped[3];
+            for (int c = 0; c < 3; ++c) {
+                const float* row = matrix + 5 * c;
+                mapped[c] = row[0] * grid[0] + row[1] * grid[1] + row[2] * grid[2] + row[4];
+            }
+            float expected[3], actual[3];
+            lut3D->lookup(mapped, expected);
+            lut3DFolded->lookup(grid, actual);
+            for (int c = 0; c < 3; ++c) {
+                maxError = std::max(maxError, std::fabs(actual[c] - expected[c]));
+            }
+        }
+        REPORTER_ASSERT(r, maxError < 1e-6f, "%g", maxError);
+
+        // ... also from the outer end of a compose chain.
+        sk_sp<SkColorFilter> chain = cf->makeComposed(SkColorFilters::Matrix(matrix)->makeComposed(
+                SkColorFilters::SRGBToLinearGamma()));
+        SkString description = SkColorFilterPriv::Describe(chain.get());
+        REPORTER_ASSERT(r, description.equals("Compose(Lut3D, ColorSpaceXform)"),
+                        "%s", description.c_str());
+
+        // A matrix that changes alpha does not fold.
+        float alphaMatrix[20];
+        std::copy(matrix, matrix + 20, alphaMatrix);
+        alphaMatrix[18] = 0.5f;
+        description = SkColorFilterPriv::Describe(
+                cf->makeComposed(SkColorFilters::Matrix(alphaMatrix)).get());
+        REPORTER_ASSERT(r, description.equals("Compose(Lut3D, Matrix)"), "%s", description.c_str());
+    }
+
+    // An identity table reproduces its (clamped) input with either interpolation.
+    sk_sp<SkData> identity = SkData::MakeUninitialized(sizeof(float) * 3 * kSize * kSize * kSize);
+    float* entries = static_cast<float*>(identity->writable_data());
+    for (int b = 0; b < kSize; ++b) {
+        for (int g = 0; g < kSize; ++g) {
+            for (int i = 0; i < kSize; ++i) {
+                *entries++ = i / float(kSize - 1);
+                *entries++ = g / float(kSize - 1);
+                *entries++ = b / float(kSize - 1);
+            }
+        }
+    }
+    for (Interpolation interpolation : {Interpolation::kTrilinear, Interpolation::kTetrahedral}) {
+        sk_sp<SkColorFilter> cf = SkColorFilters::Lut3D(identity, kSize, interpolation);
+        const SkColor4f in = {0.3f, 0.71f, 1.5f, 0.5f};
+        const SkColor4f out = cf->filterColor4f(in, nullptr, nullptr);
+        REPORTER_ASSERT(r, std::fabs(out.fR - 0.3f) < 1e-5f);
+        REPORTER_ASSERT(r, std::fabs(out.fG - 0.71f) < 1e-5f);
+        REPORTER_ASSERT(r, std::fabs(out.fB - 1.0f) < 1e-5f);
+        REPORTER_ASSERT(r, out.fA == 0.5f);
+    }
+}
+
+DEF_TEST(ColorFilter_ComposeFolding, r) {
+    // Theming-style matrices: a sepia tone and a dimming that keep colors in [0,1], and a contrast
+    // boost and brightness shift that can leave it. Clamping only changes colors outside [0,1].
+    const float sepia[20] = {0.39f, 0.50f, 0.11f, 0, 0,
+                             0.35f, 0.45f, 0.10f, 0, 0,
+                             0.27f, 0.35f, 0.08f, 0, 0,
+                             0,     0,     0,     1, 0};
+    const float contrast[20] = {1.5f, 0,    0,    0, -0.25f,
+                                0,    1.5f, 0,    0, -0.25f,
+                                0,    0,    1.5f, 0, -0.25f,
+                                0,    0,    0,    1, 0};
+    const float brighten[20] = {1, 0, 0, 0, 0.1f,
+                                0, 1, 0, 0, 0.1f,
+                                0, 0, 1, 0, 0.1f,
+                                0, 0, 0, 1, 0};
+    const float dim[20] = {0.8f, 0,    0,    0, 0.1f,
+                           0,    0.8f, 0,    0, 0.1f,
+                           0,    0,    0.8f, 0, 0.1f,
+                           0,    0,    0,    1, 0};
+    auto matrix = [](const float m[20], SkColorFilters::Clamp clamp = SkColorFilters::Clamp::kYes) {
+        return SkColorFilters::Matrix(m, clamp);
+    };
+
+    uint8_t invert[256], ramp[256];
+    for (int i = 0; i < 256; ++i) {
+        invert[i] = 255 - i;
+        ramp[i] = std::min(2 * i, 255);
+    }
+
+    struct {
+        sk_sp<SkColorFilter> fOuter, fInner;
+        const char* fExpected;
+    } cases[] = {
+        // An unclamped inner matrix multiplies into the outer one, whatever range it maps to.
+        {matrix(contrast), matrix(sepia, SkColorFilters::Clamp::kNo), "Matrix"},
+        {matrix(sepia), matrix(dim, SkColorFilters::Clamp::kNo), "Matrix"},
+        {matrix(sepia), matrix(brighten, SkColorFilters::Clamp::kNo), "Matrix"},
+        // A clamping inner matrix stays, even one that keeps [0,1] in [0,1] and an outer one
+        // that clamps too.
+        {matrix(contrast), matrix(sepia), "Compose(Matrix, Matrix)"},
+        {matrix(sepia), matrix(contrast), "Compose(Matrix, Matrix)"},
+        // Blends that scale alpha, or blend with black, are matrices in unpremul space.
+        {matrix(sepia), SkColorFilters::Blend(0x80000000, SkBlendMode::kDstIn), "Matrix"},
+        {SkColorFilters::Blend(0x40000000, SkBlendMode::kSrcATop),
+         matrix(sepia, SkColorFilters::Clamp::kNo), "Matrix"},
+        {SkColorFilters::Blend(0x80000000, SkBlendMode::kDstOut),
+         SkColorFilters::Blend(0x80000000, SkBlendMode::kDstIn), "Matrix"},
+        // A colored blend depends on the destination color space, so it does not fold.
+        {matrix(sepia), SkColorFilters::Blend(0x80FF0000, SkBlendMode::kSrcATop),
+         "Compose(Matrix, BlendMode)"},
+        {matrix(sepia), SkColorFilters::Blend(0x80FF0000, SkBlendMode::kSrcOver),
+         "Compose(Matrix, BlendMode)"},
+        // Tables compose into one table.
+        {SkColorFilters::TableARGB(nullptr, invert, ramp, nullptr),
+         SkColorFilters::TableARGB(nullptr, ramp, nullptr, invert), "Table"},
+        {SkColorFilters::Table(ramp), SkColorFilters::Table(invert), "Table"},
+        // Different kinds of filter stay composed.
+        {matrix(sepia), SkColorFilters::Table(invert), "Compose(Matrix, Table)"},
+    };
+
+    SkRandom rand;
+    for (const auto& c : cases) {
+        sk_sp<SkColorFilter> folded = c.fOuter->makeComposed(c.fInner);
+        SkString description = SkColorFilterPriv::Describe(folded.get());
+        REPORTER_ASSERT(r, description.equals(c.fExpected),
+                        "%s, expected %s", description.c_str(), c.fExpected);
+
+        // Folding must not change the result, including for transparent colors and for the colors
+        // outside [0,1] that an F16 destination can hold.
+        float maxError = 0;
+        for (int i = 0; i < 100; ++i) {
+            SkColor4f color = {rand.nextF(), rand.nextF(), rand.nextF(), rand.nextF()};
+            if (i == 0) {
+                color = SkColors::kTransparent;
+            } else if (i == 1) {
+                color.fA = 0;
+            } else if (i % 2 == 0) {
+                color.fR = rand.nextRangeF(-0.5f, 2.f);
+                color.fG = rand.nextRangeF(-0.5f, 2.f);
+                color.fB = rand.nextRangeF(-0.5f, 2.f);
+            }
+            SkColor4f expected = c.fOuter->filterColor4f(
+                    c.fInner->filterColor4f(color, nullptr, nullptr), nullptr, nullptr);
+            SkColor4f actual = folded->filterColor4f(color, nullptr, nullptr);
+            // Only the premultiplied result is meaningful.
+            expected = expected.premul().unpremul();
+            actual = actual.premul().unpremul();
+            for (int ch = 0; ch < 4; ++ch) {
+                maxError = std::max(maxError, std::fabs(expected[ch] - actual[ch]));
+            }
+        }
+        // Tables round to bytes, so small differences in the matrix path can shift an entry.
+        REPORTER_ASSERT(r, maxError < 1e-4f, "%s: %g", c.fExpected, maxError);
+    }
+
+    // A deep chain collapses to a single stage whichever way it is associated.
+    sk_sp<SkColorFilter> leftToRight = matrix(contrast)
+            ->makeComposed(matrix(sepia, SkColorFilters::Clamp::kNo))
+            ->makeComposed(SkColorFilters::Blend(0x80000000, SkBlendMode::kDstIn))
+            ->makeComposed(matrix(dim, SkColorFilters::Clamp::kNo));
+    sk_sp<SkColorFilter> rightToLeft = matrix(contrast)->makeComposed(
+            matrix(sepia, SkColorFilters::Clamp::kNo)->makeComposed(
+                    SkColorFilters::Blend(0x80000000, SkBlendMode::kDstIn)
+                            ->makeComposed(matrix(dim, SkColorFilters::Clamp::kNo))));
+    REPORTER_ASSERT(r, SkColorFilterPriv::Describe(leftToRight.get()).equals("Matrix"));
+    REPORTER_ASSERT(r, SkColorFilterPriv::Describe(rightToLeft.get()).equals("Matrix"));
+
+    // Folding reaches across the ends of chains that can't fold as a whole.
+    sk_sp<SkColorFilter> chain = matrix(sepia)
+            ->makeComposed(SkColorFilters::Table(invert))
+            ->makeComposed(SkColorFilters::Table(ramp))
+            ->makeComposed(matrix(brighten, SkColorFilters::Clamp::kNo));
+    SkString description = SkColorFilterPriv::Describe(chain.get());
+    REPORTER_ASSERT(r, description.equals("Compose(Compose(Matrix, Table), Matrix)"),
+                    "%s", description.c_str());
+
+    // ... including when the end of the outer chain is nested in another compose.
+    sk_sp<SkColorFilter> nested = matrix(sepia)
+            ->makeComposed(SkColorFilters::Table(invert)->makeComposed(matrix(sepia)))
+            ->makeComposed(matrix(dim, SkColorFilters::Clamp::kNo));
+    description = SkColorFilterPriv::Describe(nested.get());
+    REPORTER_ASSERT(r, description.equals("Compose(Matrix, Compose(Table, Matrix))"),
+                    "%s", description.c_str());
+
+    // Graphite keys come from the filters as they were composed, which is what
+    // PrecompileColorFilters::Compose describes, so the pair is kept alongside the fold.
+    sk_sp<SkColorFilter> outer = matrix(contrast);
+    sk_sp<SkColorFilter> inner = matrix(sepia, SkColorFilters::Clamp::kNo);
+    sk_sp<SkColorFilter> composed = outer->makeComposed(inner);
+    REPORTER_ASSERT(r, as_CFB(composed)->type() == SkColorFilterBase::Type::kCompose);
+    auto compose = static_cast<const SkComposeColorFilter*>(composed.get());
+    REPORTER_ASSERT(r, compose->outer() == outer && compose->inner() == inner);
+    REPORTER_ASSERT(r, compose->folded() &&
+                               compose->folded()->type() == SkColorFilterBase::Type::kMatrix);
+    REPORTER_ASSERT(r, composed->asAColorMatrix(nullptr));
+}
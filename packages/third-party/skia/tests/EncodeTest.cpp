@@ -15,13 +15,17 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/encode/SkEncoder.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -30,6 +34,7 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
 #include "modules/skcms/src/skcms_public.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkColorPriv.h"
 #include "src/core/SkConvertPixels.h"
 #include "src/core/SkImageInfoPriv.h"
@@ -115,12 +120,39 @@ static void test_encode(skiatest::Reporter* r, SkEncodedImageFormat format) {
     success = encoder3->encodeRows(200);
     REPORTER_ASSERT(r, success);
 
+    // Pass the rows in separately, from a copy, so the src the encoder was made with is only
+    // used for its dimensions and color info.
+    SkDynamicMemoryWStream dst4;
+    SkBitmap rowsCopy;
+    rowsCopy.allocPixels(src.info().makeWH(src.width(), 5));
+    auto encoder4 = make(format, &dst4, src);
+    for (int y = 0; y < src.height(); y += rowsCopy.height()) {
+        const int count = std::min(rowsCopy.height(), src.height() - y);
+        SkPixmap rows;
+        SkAssertResult(rowsCopy.pixmap().extractSubset(&rows,
+                                                       SkIRect::MakeWH(src.width(), count)));
+        SkAssertResult(src.readPixels(rows, 0, y));
+        success = encoder4->encodeRows(rows);
+        REPORTER_ASSERT(r, success);
+    }
+
+    // Rows that do not match the src, or that run past its end, are rejected.
+    SkDynamicMemoryWStream dst5;
+    auto encoder5 = make(format, &dst5, src);
+    REPORTER_ASSERT(r, !encoder5->encodeRows(SkPixmap(rowsCopy.info().makeWH(src.width() - 1, 1),
+                                                      rowsCopy.getPixels(),
+                                                      rowsCopy.rowBytes())));
+    REPORTER_ASSERT(r, encoder5->encodeRows(src.height() - 1));
+    REPORTER_ASSERT(r, !encoder5->encodeRows(rowsCopy.pixmap()));
+
     sk_sp<SkData> data1 = dst1.detachAsData();
     sk_sp<SkData> data2 = dst2.detachAsData();
     sk_sp<SkData> data3 = dst3.detachAsData();
+    sk_sp<SkData> data4 = dst4.detachAsData();
     REPORTER_ASSERT(r, data0->equals(data1.get()));
     REPORTER_ASSERT(r, data0->equals(data2.get()));
     REPORTER_ASSERT(r, data0->equals(data3.get()));
+    REPORTER_ASSERT(r, data0->equals(data4.get()));
 }
 
 DEF_TEST(Encode, r) {
@@ -357,6 +389,29 @@ DEF_TEST(Encode_JPG, r) {
     }
 }
 
+// Encoders made from YUVA planes do not read rows from a pixmap, so they reject them and leave
+// the image to be encoded from the planes.
+DEF_TEST(Encode_JpegYUVARowPixmap, r) {
+    const SkYUVAInfo yuvaInfo({16, 16}, SkYUVAInfo::PlaneConfig::kY_U_V,
+                              SkYUVAInfo::Subsampling::k420, kJPEG_Full_SkYUVColorSpace);
+    const SkYUVAPixmapInfo pixmapInfo(yuvaInfo, SkYUVAPixmapInfo::DataType::kUnorm8, nullptr);
+    SkYUVAPixmaps pixmaps = SkYUVAPixmaps::Allocate(pixmapInfo);
+    REPORTER_ASSERT(r, pixmaps.isValid());
+    for (int i = 0; i < pixmaps.numPlanes(); ++i) {
+        pixmaps.plane(i).erase(SkColors::kGray);
+    }
+
+    SkDynamicMemoryWStream dst;
+    auto encoder = SkJpegEncoder::Make(&dst, pixmaps, nullptr, SkJpegEncoder::Options());
+    REPORTER_ASSERT(r, encoder);
+    if (!encoder) {
+        return;
+    }
+    REPORTER_ASSERT(r, !encoder->encodeRows(pixmaps.plane(0)));
+    REPORTER_ASSERT(r, encoder->encodeRows(yuvaInfo.height()));
+    REPORTER_ASSERT(r, SkJpegDecoder::Decode(dst.detachAsData(), nullptr, nullptr));
+}
+
 DEF_TEST(Encode_JpegDownsample, r) {
     SkBitmap bitmap;
     bool success = ToolUtils::GetResourceAsBitmap("images/mandrill_128.png", &bitmap);
@@ -505,6 +560,55 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+DEF_TEST(Encode_PngParallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (SkAlphaType alphaType : {kOpaque_SkAlphaType, kUnpremul_SkAlphaType}) {
+        // Large enough to be split into several bands, with enough noise that the filters of
+        // the rows differ.
+        SkBitmap source;
+        source.allocPixels(SkImageInfo::Make(1200, 700, kRGBA_8888_SkColorType, alphaType));
+        SkRandom random;
+        for (int y = 0; y < source.height(); y++) {
+            for (int x = 0; x < source.width(); x++) {
+                const int noise = random.nextULessThan(8);
+                uint8_t* pixel = static_cast<uint8_t*>(source.getAddr(x, y));
+                pixel[0] = x + noise;
+                pixel[1] = y + noise;
+                pixel[2] = x ^ y;
+                pixel[3] = alphaType == kOpaque_SkAlphaType ? 0xFF : x + y;
+            }
+        }
+
+        for (SkColorType colorType : {kRGBA_8888_SkColorType, kRGBA_F16_SkColorType,
+                                      kAlpha_8_SkColorType}) {
+            SkBitmap bitmap;
+            bitmap.allocPixels(source.info().makeColorType(colorType));
+            REPORTER_ASSERT(r, source.readPixels(bitmap.pixmap()));
+
+            for (auto filters : {SkPngEncoder::FilterFlag::kAll, SkPngEncoder::FilterFlag::kNone,
+                                 SkPngEncoder::FilterFlag::kPaeth}) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = filters;
+                sk_sp<SkData> serial = SkPngEncoder::Encode(bitmap.pixmap(), options);
+                options.fExecutor = executor.get();
+                sk_sp<SkData> parallel = SkPngEncoder::Encode(bitmap.pixmap(), options);
+                if (!serial || !parallel) {
+                    ERRORF(r, "Failed to encode color type %d", colorType);
+                    continue;
+                }
+
+                SkBitmap serialBitmap, parallelBitmap;
+                SkImages::DeferredFromEncodedData(serial)->asLegacyBitmap(&serialBitmap);
+                SkImages::DeferredFromEncodedData(parallel)->asLegacyBitmap(&parallelBitmap);
+                REPORTER_ASSERT(r, almost_equals(serialBitmap, parallelBitmap, 0),
+                                "color type %d, alpha type %d, filters %d",
+                                colorType, alphaType, (int)filters);
+            }
+        }
+    }
+}
+
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
     bm.allocN32Pixels(100, 100);
@@ -8,6 +8,7 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorSpace.h"
@@ -17,15 +18,21 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkString.h"
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkImageFilters.h"
+#include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/gpu/ganesh/GrTypesPriv.h"
+#include "src/base/SkScopeExit.h"
 #include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkSpecialImage.h"
 #include "tests/CtsEnforcement.h"
@@ -361,3 +368,81 @@ DEF_SERIAL_TEST(PurgeImageFilterCache, r) {
         REPORTER_ASSERT(r, cache);
     }
 }
+
+// With translation-invariant keys, an image drawn again with a drop shadow after moving by whole
+// pixels reuses the cached shadow, and draws the same pixels as an exact key would.
+DEF_SERIAL_TEST(ImageFilterCache_TranslationInvariant, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(40, 30);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    bm.erase(SK_ColorRED, SkIRect::MakeLTRB(5, 5, 35, 25));
+    bm.setImmutable();
+    sk_sp<SkImage> image = bm.asImage();
+
+    SkPaint paint;
+    paint.setImageFilter(SkImageFilters::DropShadow(4, 6, 3, 3, SK_ColorBLACK, nullptr));
+
+    auto draw = [&](SkIPoint at) {
+        sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(160, 120));
+        surface->getCanvas()->drawImage(image, at.fX, at.fY, SkSamplingOptions(), &paint);
+        SkBitmap result;
+        result.allocPixels(surface->imageInfo());
+        surface->readPixels(result, 0, 0);
+        return result;
+    };
+    auto equal = [](const SkBitmap& a, const SkBitmap& b) {
+        for (int y = 0; y < a.height(); ++y) {
+            for (int x = 0; x < a.width(); ++x) {
+                if (a.getColor(x, y) != b.getColor(x, y)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    sk_sp<SkImageFilterCache> cache = SkImageFilterCache::Get();
+    const bool wasInvariant = SkGraphics::SetImageFilterCacheTranslationInvariant(false);
+    SK_AT_SCOPE_EXIT(SkGraphics::SetImageFilterCacheTranslationInvariant(wasInvariant);
+                     cache->purge());
+    cache->purge();
+    SkBitmap expected = draw({77, 43});
+
+    SkGraphics::SetImageFilterCacheTranslationInvariant(true);
+    cache->purge();
+    draw({20, 10});
+#if defined(SK_DEBUG)
+    const int count = cache->count();
+    REPORTER_ASSERT(r, count > 0);
+#endif
+    SkBitmap actual = draw({77, 43});
+#if defined(SK_DEBUG)
+    REPORTER_ASSERT(r, cache->count() == count);
+#endif
+    REPORTER_ASSERT(r, equal(expected, actual));
+}
+
+// A DAG whose filters all take the previous filter as every input is walked once per filter when
+// checking whether its cache keys can be translation invariant, not once per path.
+DEF_TEST(ImageFilterCache_TranslationInvariantSharedInputs, r) {
+    auto deepDAG = [](sk_sp<SkImageFilter> filter) {
+        for (int i = 0; i < 64; ++i) {
+            filter = SkImageFilters::Merge(filter, filter);
+        }
+        return filter;
+    };
+
+    sk_sp<SkImageFilter> invariant = deepDAG(SkImageFilters::Offset(1, 2, nullptr));
+    REPORTER_ASSERT(r, as_IFB(invariant)->isTranslationInvariant());
+
+    sk_sp<SkRuntimeEffect> effect = SkRuntimeEffect::MakeForShader(SkString(R"(
+        uniform shader child;
+        half4 main(float2 coord) {
+            return child.eval(coord);
+        }
+    )")).effect;
+    SkRuntimeShaderBuilder builder(effect);
+    sk_sp<SkImageFilter> variant =
+            deepDAG(SkImageFilters::RuntimeShader(builder, /*childShaderName=*/"child", nullptr));
+    REPORTER_ASSERT(r, !as_IFB(variant)->isTranslationInvariant());
+}
@@ -14,8 +14,10 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkFont.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
@@ -45,6 +47,7 @@
 #include "include/gpu/ganesh/GrTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkScopeExit.h"
 #include "src/core/SkBitmapDevice.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkImageFilterTypes.h"
@@ -94,6 +97,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <utility>
 #include <limits>
 
@@ -2448,3 +2452,253 @@ DEF_TEST(ImageFilter_DrawExtremeMatrixTransform_DoesNotAssert, reporter) {
     surface->getCanvas()->clear(SK_ColorWHITE);
     surface->getCanvas()->drawRRect(rr, p);
 }
+
+// A scratch limit too small for any filter splits the output into the smallest tiles, which must
+// assemble into the same pixels as evaluating the whole output at once, with or without a thread
+// pool running the tiles.
+DEF_SERIAL_TEST(ImageFilterTiledEvaluation, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(600, 500);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(bm);
+        SkPaint paint;
+        for (int i = 0; i < 12; ++i) {
+            paint.setColor(SkColorSetARGB(255, 20 * i, 255 - 20 * i, 128));
+            canvas.drawCircle(50 * i + 25, 40 * i + 30, 20 + 3 * i, paint);
+        }
+    }
+    bm.setImmutable();
+    sk_sp<SkImage> image = bm.asImage();
+
+    sk_sp<SkImageFilter> chain = SkImageFilters::DropShadow(7, -5, 3, 3, SK_ColorBLUE, nullptr);
+    chain = SkImageFilters::Offset(3, 4, std::move(chain));
+    chain = SkImageFilters::Merge(std::move(chain), SkImageFilters::Blur(2, 1, nullptr));
+    SkPaint paint;
+    paint.setImageFilter(std::move(chain));
+
+    auto draw = [&]() {
+        sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(640, 540));
+        surface->getCanvas()->drawImage(image, 10, 15, SkSamplingOptions(), &paint);
+        SkBitmap result;
+        result.allocPixels(surface->imageInfo());
+        surface->readPixels(result, 0, 0);
+        return result;
+    };
+    auto equal = [](const SkBitmap& a, const SkBitmap& b) {
+        for (int y = 0; y < a.height(); ++y) {
+            if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    const size_t prevLimit = SkGraphics::SetImageFilterScratchLimit(0);
+    SkExecutor* prevExecutor = SkGraphics::SetRasterExecutor(nullptr);
+    SK_AT_SCOPE_EXIT(SkGraphics::SetImageFilterScratchLimit(prevLimit);
+                     SkGraphics::SetRasterExecutor(prevExecutor));
+    SkBitmap expected = draw();
+
+    SkGraphics::SetImageFilterScratchLimit(1);
+    REPORTER_ASSERT(reporter, equal(expected, draw()));
+
+    SkGraphics::SetRasterExecutor(executor.get());
+    REPORTER_ASSERT(reporter, equal(expected, draw()));
+}
+
+// The CPU kernels of the morphology, matrix convolution and lighting filters run on N32 layers.
+// F16 layers still use the shaders, so the two must agree up to rounding. The kernels must also
+// produce the same pixels when their output is split across a thread pool.
+DEF_SERIAL_TEST(ImageFilterRasterKernels, reporter) {
+    const SkScalar kBlur5[25] = {1,  4,  6,  4, 1,
+                                 4, 16, 24, 16, 4,
+                                 6, 24, 36, 24, 6,
+                                 4, 16, 24, 16, 4,
+                                 1,  4,  6,  4, 1};
+    const SkScalar kEdges[9] = {1,  1, 1,
+                                1, -7, 1,
+                                1,  2, 1};
+    const SkScalar kSmear[7] = {1, 2, 3, 4, 3, 2, 1};
+    const SkPoint3 kDirection = SkPoint3::Make(-0.6f, -0.4f, 0.7f);
+    const SkPoint3 kLocation = SkPoint3::Make(120, 40, 60);
+    const SkPoint3 kTarget = SkPoint3::Make(90, 110, 0);
+
+    struct {
+        const char* fName;
+        sk_sp<SkImageFilter> fFilter;
+    } filters[] = {
+        {"erode 3x5", SkImageFilters::Erode(3, 5, nullptr)},
+        {"erode 20x0", SkImageFilters::Erode(20, 0, nullptr)},
+        {"dilate 2x1", SkImageFilters::Dilate(2, 1, nullptr)},
+        {"dilate 40x17", SkImageFilters::Dilate(40, 17, nullptr)},
+        {"separable convolution",
+         SkImageFilters::MatrixConvolution({5, 5}, kBlur5, 1 / 256.f, 0, {2, 2},
+                                           SkTileMode::kDecal, false, nullptr)},
+        {"convolution",
+         SkImageFilters::MatrixConvolution({3, 3}, kEdges, 0.3f, 40, {1, 0},
+                                           SkTileMode::kDecal, true, nullptr)},
+        {"row convolution",
+         SkImageFilters::MatrixConvolution({7, 1}, kSmear, 1 / 16.f, 0, {3, 0},
+                                           SkTileMode::kDecal, true, nullptr)},
+        {"distant diffuse",
+         SkImageFilters::DistantLitDiffuse(kDirection, SK_ColorWHITE, 2, 1.5f, nullptr)},
+        {"point specular",
+         SkImageFilters::PointLitSpecular(kLocation, 0xFFFFC080, 3, 1, 8, nullptr)},
+        {"spot diffuse",
+         SkImageFilters::SpotLitDiffuse(kLocation, kTarget, 2, 30, 0xFF80C0FF, 2, 1, nullptr)},
+    };
+
+    auto draw = [](SkColorType colorType, const sk_sp<SkImageFilter>& filter) {
+        sk_sp<SkSurface> surface = SkSurfaces::Raster(
+                SkImageInfo::Make(211, 163, colorType, kPremul_SkAlphaType));
+        SkCanvas* canvas = surface->getCanvas();
+        SkPaint layerPaint;
+        layerPaint.setImageFilter(filter);
+        canvas->saveLayer(nullptr, &layerPaint);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 9; ++i) {
+            paint.setColor(SkColorSetARGB(255 - 20 * i, 30 * i, 255 - 25 * i, 90 + 15 * i));
+            canvas->drawCircle(23.f * i + 12, 17.f * i + 9, 6.f + 2 * i, paint);
+            canvas->drawRect(SkRect::MakeXYWH(190 - 21.f * i, 11.f * i + 3, 13, 7), paint);
+        }
+        canvas->restore();
+
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeN32Premul(surface->width(), surface->height()));
+        surface->readPixels(bitmap, 0, 0);
+        return bitmap;
+    };
+    auto maxDifference = [](const SkBitmap& a, const SkBitmap& b) {
+        int diff = 0;
+        for (int y = 0; y < a.height(); ++y) {
+            for (int x = 0; x < a.width(); ++x) {
+                const uint32_t pa = *a.getAddr32(x, y), pb = *b.getAddr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    diff = std::max(diff, std::abs(int((pa >> shift) & 0xFF) -
+                                                   int((pb >> shift) & 0xFF)));
+                }
+            }
+        }
+        return diff;
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkExecutor* previous = SkGraphics::GetRasterExecutor();
+    SK_AT_SCOPE_EXIT(SkGraphics::SetRasterExecutor(previous));
+    for (const auto& [name, filter] : filters) {
+        SkGraphics::SetRasterExecutor(nullptr);
+        SkBitmap kernel = draw(kN32_SkColorType, filter);
+        SkBitmap shader = draw(kRGBA_F16_SkColorType, filter);
+        const int diff = maxDifference(kernel, shader);
+        REPORTER_ASSERT(reporter, diff <= 2, "%s: differs from the shader by %d", name, diff);
+
+        SkGraphics::SetRasterExecutor(executor.get());
+        SkBitmap threaded = draw(kN32_SkColorType, filter);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(kernel, threaded), "%s", name);
+    }
+}
+
+namespace {
+
+// Tints its input and counts how often it has been evaluated.
+class CountingImageFilter : public SkImageFilter_Base {
+public:
+    CountingImageFilter() : SkImageFilter_Base(nullptr, 0) {}
+
+    int count() const { return fCount; }
+
+private:
+    Factory getFactory() const override {
+        SK_ABORT("Does not participate in serialization");
+        return nullptr;
+    }
+    const char* getTypeName() const override { return "CountingImageFilter"; }
+
+    skif::FilterResult onFilterImage(const skif::Context& ctx) const override {
+        ++fCount;
+        // Resolve the tint into a new image, like a blur would produce one.
+        auto [image, origin] =
+                ctx.source()
+                        .applyColorFilter(ctx, SkColorFilters::Blend(SK_ColorRED,
+                                                                     SkBlendMode::kModulate))
+                        .imageAndOffset(ctx);
+        return skif::FilterResult(std::move(image), origin);
+    }
+
+    skif::LayerSpace<SkIRect> onGetInputLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& desiredOutput,
+            std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override {
+        return desiredOutput;
+    }
+
+    std::optional<skif::LayerSpace<SkIRect>> onGetOutputLayerBounds(
+            const skif::Mapping& mapping,
+            std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override {
+        return contentBounds;
+    }
+
+    mutable int fCount = 0;
+};
+
+}  // anonymous namespace
+
+DEF_TEST(ImageFilterBackdropCache, reporter) {
+    auto drawFrame = [](SkCanvas* canvas, const SkImageFilter* backdrop, SkColor inside,
+                        SkColor outside) {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor(inside);
+        canvas->drawRect(SkRect::MakeLTRB(20, 20, 50, 50), paint);
+        paint.setColor(outside);
+        canvas->drawRect(SkRect::MakeLTRB(70, 70, 90, 90), paint);
+
+        canvas->save();
+        canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(16, 24, 48, 16), 8, 8), true);
+        canvas->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, backdrop, 0));
+        canvas->restore();
+        canvas->restore();
+    };
+    auto expected = [&](SkColor inside, SkColor outside) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(100, 100);
+        SkCanvas canvas(bitmap);
+        CountingImageFilter filter;
+        drawFrame(&canvas, &filter, inside, outside);
+        return bitmap;
+    };
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    SkCanvas canvas(bitmap);
+    CountingImageFilter filter;
+
+    drawFrame(&canvas, &filter, SK_ColorBLUE, SK_ColorRED);
+    REPORTER_ASSERT(reporter, filter.count() == 1);
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(bitmap, expected(SK_ColorBLUE, SK_ColorRED)));
+
+    // Redrawing the same backdrop reuses the filtered result.
+    drawFrame(&canvas, &filter, SK_ColorBLUE, SK_ColorRED);
+    REPORTER_ASSERT(reporter, filter.count() == 1);
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(bitmap, expected(SK_ColorBLUE, SK_ColorRED)));
+
+    // So does changing pixels that the filter does not read.
+    drawFrame(&canvas, &filter, SK_ColorBLUE, SK_ColorGREEN);
+    REPORTER_ASSERT(reporter, filter.count() == 1);
+    REPORTER_ASSERT(reporter,
+                    ToolUtils::equal_pixels(bitmap, expected(SK_ColorBLUE, SK_ColorGREEN)));
+
+    // Changing the pixels under the overlay filters them again.
+    drawFrame(&canvas, &filter, SK_ColorYELLOW, SK_ColorGREEN);
+    REPORTER_ASSERT(reporter, filter.count() == 2);
+    REPORTER_ASSERT(reporter,
+                    ToolUtils::equal_pixels(bitmap, expected(SK_ColorYELLOW, SK_ColorGREEN)));
+
+    // A different filter is never served another filter's result.
+    CountingImageFilter other;
+    drawFrame(&canvas, &other, SK_ColorYELLOW, SK_ColorGREEN);
+    REPORTER_ASSERT(reporter, other.count() == 1);
+}
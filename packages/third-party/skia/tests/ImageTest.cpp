@@ -14,6 +14,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
@@ -1516,6 +1517,91 @@ DEF_TEST(ImageScalePixels, reporter) {
     test_scale_pixels(reporter, codecImage.get(), pmRed);
 }
 
+// Drawing a lazy JPEG at 1/8 of its size with linear sampling decodes (and caches) it at 1/8,
+// not at full size. Nearest sampling still needs every texel.
+DEF_TEST(Image_LazyScaledDecode, reporter) {
+    sk_sp<SkImage> image =
+            SkImages::DeferredFromEncodedData(GetResourceAsData("images/mandrill_512_q075.jpg"));
+    if (!image) {
+        return;
+    }
+    const auto fullDesc = SkBitmapCacheDesc::Make(image.get());
+    const auto scaledDesc = SkBitmapCacheDesc::MakeScaled(image.get(), {64, 64});
+
+    sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(64, 64));
+    surface->getCanvas()->drawImageRect(image, SkRect::MakeWH(64, 64),
+                                        SkSamplingOptions(SkFilterMode::kLinear));
+    SkBitmap cached;
+    REPORTER_ASSERT(reporter, !SkBitmapCache::Find(fullDesc, &cached));
+    if (SkBitmapCache::Find(scaledDesc, &cached)) {
+        REPORTER_ASSERT(reporter, cached.dimensions() == SkISize::Make(64, 64));
+        REPORTER_ASSERT(reporter, cached.isImmutable());
+    } else {
+        // The cache is global, and may have been purged by another test.
+        SkDebugf("Image_LazyScaledDecode : scaled decode was already purged\n");
+    }
+
+    // A scale the codec cannot reach exactly is decoded at the next larger size.
+    surface->getCanvas()->drawImageRect(image, SkRect::MakeWH(50, 50),
+                                        SkSamplingOptions(SkFilterMode::kLinear));
+    REPORTER_ASSERT(reporter, !SkBitmapCache::Find(fullDesc, &cached));
+
+    surface->getCanvas()->drawImageRect(image, SkRect::MakeWH(64, 64), SkSamplingOptions());
+    REPORTER_ASSERT(reporter, SkBitmapCache::Find(fullDesc, &cached));
+}
+
+// Several sizes rescaled in one call, striped across an executor, match rescaling each size on
+// its own. The sizes are chosen so the shared halving levels are the ones each size would make.
+DEF_TEST(Image_rescaleAndReadPixels, reporter) {
+    sk_sp<SkImage> image = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+    if (!image) {
+        return;
+    }
+    const SkIRect srcRect = SkIRect::MakeXYWH(16, 32, 400, 400);
+    const SkISize sizes[] = {{50, 50}, {200, 200}, {100, 100}, {400, 800}};
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (auto gamma : {SkImage::RescaleGamma::kSrc, SkImage::RescaleGamma::kLinear}) {
+        for (auto mode : {SkImage::RescaleMode::kNearest,
+                          SkImage::RescaleMode::kRepeatedLinear,
+                          SkImage::RescaleMode::kRepeatedCubic}) {
+            std::vector<SkBitmap> serial, striped;
+            std::vector<SkPixmap> serialPms, stripedPms;
+            for (SkISize size : sizes) {
+                SkImageInfo info = SkImageInfo::MakeN32Premul(size, SkColorSpace::MakeSRGB());
+                serial.emplace_back().allocPixels(info);
+                striped.emplace_back().allocPixels(info);
+                serialPms.push_back(serial.back().pixmap());
+                stripedPms.push_back(striped.back().pixmap());
+            }
+            REPORTER_ASSERT(reporter,
+                            image->rescaleAndReadPixels(serialPms, srcRect, gamma, mode));
+            REPORTER_ASSERT(reporter,
+                            image->rescaleAndReadPixels(
+                                    stripedPms, srcRect, gamma, mode, executor.get()));
+
+            for (size_t i = 0; i < std::size(sizes); ++i) {
+                REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(serial[i], striped[i]));
+
+                SkBitmap single;
+                single.allocPixels(serial[i].info());
+                REPORTER_ASSERT(reporter,
+                                image->rescaleAndReadPixels({&single.pixmap(), 1},
+                                                            srcRect, gamma, mode));
+                REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(serial[i], single),
+                                "size %d x %d", sizes[i].width(), sizes[i].height());
+            }
+        }
+    }
+
+    SkBitmap tooLarge;
+    tooLarge.allocN32Pixels(10, 10);
+    REPORTER_ASSERT(reporter, !image->rescaleAndReadPixels({&tooLarge.pixmap(), 1},
+                                                           SkIRect::MakeWH(1000, 10),
+                                                           SkImage::RescaleGamma::kSrc,
+                                                           SkImage::RescaleMode::kRepeatedLinear));
+}
+
 #if defined(SK_GANESH)
 DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(ImageScalePixels_Gpu,
                                        reporter,
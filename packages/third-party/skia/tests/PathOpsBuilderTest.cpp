@@ -5,15 +5,19 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathBuilder.h"
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkRect.h"
 #include "include/pathops/SkPathOps.h"
 #include "src/base/SkFloatBits.h"
+#include "src/base/SkRandom.h"
 #include "tests/PathOpsExtendedTest.h"
 #include "tests/Test.h"
 
+#include <memory>
+
 DEF_TEST(PathOpsBuilder, reporter) {
     SkOpBuilder builder;
     auto result = builder.resolve();
@@ -370,3 +374,55 @@ DEF_TEST(SkOpBuilderKFuzz1, reporter) {
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     (void)builder.resolve();
 }
+
+static void add_random_shapes(SkRandom* rand, int count, SkPathOp op, SkOpBuilder* builder) {
+    for (int i = 0; i < count; ++i) {
+        const SkRect r = SkRect::MakeXYWH(rand->nextRangeF(0, 400), rand->nextRangeF(0, 400),
+                                          rand->nextRangeF(2, 20), rand->nextRangeF(2, 20));
+        switch (i % 3) {
+            case 0:
+                builder->add(SkPath::Rect(r), op);
+                break;
+            case 1:
+                builder->add(SkPath::Oval(r, SkPathDirection::kCCW), op);
+                break;
+            case 2:
+                builder->add(SkPath::Polygon({{r.fLeft, r.fTop}, {r.fRight, r.centerY()},
+                                              {r.fLeft, r.fBottom}}, /*isClosed=*/true), op);
+                break;
+        }
+    }
+}
+
+DEF_TEST(SkOpBuilderParallel, reporter) {
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* executor : {pool.get(), &SkExecutor::GetDefault()}) {
+        for (SkPathOp op : {kUnion_SkPathOp, kXOR_SkPathOp}) {
+            // Few enough operands to fall back to resolve(), and enough to split into groups.
+            for (int count : {20, 200}) {
+                SkRandom rand;
+                SkOpBuilder serialBuilder, parallelBuilder;
+                add_random_shapes(&rand, count, op, &serialBuilder);
+                rand.setSeed(0);
+                add_random_shapes(&rand, count, op, &parallelBuilder);
+                std::optional<SkPath> serial = serialBuilder.resolve(),
+                                      parallel = parallelBuilder.resolve(*executor);
+                REPORTER_ASSERT(reporter, serial && parallel);
+                if (serial && parallel) {
+                    REPORTER_ASSERT(reporter, serial->getBounds() == parallel->getBounds());
+                    REPORTER_ASSERT(reporter,
+                                    !comparePaths(reporter, __FUNCTION__, *serial, *parallel));
+                }
+            }
+        }
+    }
+
+    // An inverse operand also falls back to resolve().
+    SkOpBuilder builder;
+    SkRandom rand;
+    add_random_shapes(&rand, 200, kUnion_SkPathOp, &builder);
+    builder.add(SkPath::Rect({0, 0, 10, 10}).makeFillType(SkPathFillType::kInverseWinding),
+                kUnion_SkPathOp);
+    std::optional<SkPath> result = builder.resolve(*pool);
+    REPORTER_ASSERT(reporter, result && result->isInverseFillType());
+}
@@ -306,3 +306,63 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+struct TierRec : SkResourceCache::Rec {
+    TestKey               fKey;
+    SkResourceCache::Tier fTier;
+    bool                  fCanBePurged = true;
+
+    TierRec(int32_t data, SkResourceCache::Tier tier) : fKey(0, data), fTier(tier) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return 1024; }
+    bool canBePurged() override { return fCanBePurged; }
+    Tier getTier() const override { return fTier; }
+    const char* getCategory() const override { return "test-tier"; }
+};
+
+static bool find_tier_rec(const SkResourceCache::Rec&, void*) { return true; }
+
+DEF_TEST(ResourceCache_tiers, reporter) {
+    using Tier = SkResourceCache::Tier;
+    SkResourceCache cache(1024 * 1024);
+
+    // Added oldest first: image 0, mask 1, image 2, mask 3, default 4.
+    const Tier tiers[] = {Tier::kImage, Tier::kMask, Tier::kImage, Tier::kMask, Tier::kDefault};
+    TierRec* unpurgeable = nullptr;
+    for (int i = 0; i < 5; ++i) {
+        auto* rec = new TierRec(i, tiers[i]);
+        if (i == 3) {
+            unpurgeable = rec;
+            rec->fCanBePurged = false;
+        }
+        cache.add(rec);
+    }
+    REPORTER_ASSERT(reporter, cache.getTierBytesUsed(Tier::kImage) == 2048);
+    REPORTER_ASSERT(reporter, cache.getTierRecCount(Tier::kMask) == 2);
+    REPORTER_ASSERT(reporter, cache.getTierRecCount(Tier::kDefault) == 1);
+
+    auto has = [&](int data) { return cache.find(TestKey(0, data), find_tier_rec, nullptr); };
+
+    // Masks go first, but the one in use stays; then the default tier; then the older image.
+    REPORTER_ASSERT(reporter, cache.purgeToTarget(4 * 1024) == 4 * 1024);
+    REPORTER_ASSERT(reporter, !has(1) && has(3));
+    REPORTER_ASSERT(reporter, cache.purgeToTarget(2 * 1024) == 2 * 1024);
+    REPORTER_ASSERT(reporter, !has(4) && !has(0) && has(2));
+    REPORTER_ASSERT(reporter, cache.purgeToTarget(0) == 1024);
+    REPORTER_ASSERT(reporter, !has(2) && has(3));
+    REPORTER_ASSERT(reporter, cache.getTierBytesUsed(Tier::kImage) == 0);
+    REPORTER_ASSERT(reporter, cache.getTierRecCount(Tier::kMask) == 1);
+    unpurgeable->fCanBePurged = true;
+
+    // A tier over its own limit purges only itself, least recently used first.
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.setTierByteLimit(Tier::kMask, 2 * 1024) == 0);
+    for (int i = 0; i < 4; ++i) {
+        cache.add(new TierRec(i, Tier::kMask));
+        cache.add(new TierRec(10 + i, Tier::kImage));
+    }
+    REPORTER_ASSERT(reporter, cache.getTierBytesUsed(Tier::kMask) == 2 * 1024);
+    REPORTER_ASSERT(reporter, cache.getTierRecCount(Tier::kImage) == 4);
+    REPORTER_ASSERT(reporter, !has(0) && !has(1) && has(2) && has(3));
+}
@@ -11,6 +11,7 @@
 #include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
@@ -18,6 +19,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
@@ -25,9 +27,11 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/base/SkScopeExit.h"
 #include "src/base/SkZip.h"
 #include "src/core/SkGlyph.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkPersistentStrikeCache.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrike.h"
@@ -43,6 +47,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <memory>
@@ -172,6 +177,55 @@ DEF_TEST(SkStrikeMultiThread, Reporter) {
     }
 }
 
+DEF_SERIAL_TEST(SkStrike_ParallelPrepareImages, reporter) {
+    SkFont font(ToolUtils::CreatePortableTypeface("serif", SkFontStyle()), 48);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+
+    // Repeat the glyphs so that duplicates within a run are exercised too.
+    std::vector<SkPackedGlyphID> packedIDs;
+    for (int repeat = 0; repeat < 2; repeat++) {
+        for (SkUnichar c = ' '; c < 'z'; c++) {
+            packedIDs.emplace_back(font.unicharToGlyph(c));
+        }
+    }
+
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+
+    SkStrikeCache serialCache;
+    SkStrikeCache parallelCache;
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkExecutor* previous = SkGraphics::SetRasterExecutor(nullptr);
+    SK_AT_SCOPE_EXIT(SkGraphics::SetRasterExecutor(previous));
+
+    sk_sp<SkStrike> serialStrike = serialCache.findOrCreateStrike(strikeSpec);
+    sk_sp<SkStrike> parallelStrike = parallelCache.findOrCreateStrike(strikeSpec);
+
+    std::vector<const SkGlyph*> serialGlyphs(packedIDs.size());
+    std::vector<const SkGlyph*> parallelGlyphs(packedIDs.size());
+    serialStrike->prepareImages(packedIDs, serialGlyphs.data());
+    SkGraphics::SetRasterExecutor(executor.get());
+    parallelStrike->prepareImages(packedIDs, parallelGlyphs.data());
+
+    for (size_t i = 0; i < packedIDs.size(); i++) {
+        const SkGlyph* serial = serialGlyphs[i];
+        const SkGlyph* parallel = parallelGlyphs[i];
+        REPORTER_ASSERT(reporter, serial->getPackedID() == parallel->getPackedID());
+        REPORTER_ASSERT(reporter, serial->iRect() == parallel->iRect());
+        REPORTER_ASSERT(reporter, serial->setImageHasBeenCalled());
+        REPORTER_ASSERT(reporter, parallel->setImageHasBeenCalled());
+        REPORTER_ASSERT(reporter, (serial->image() == nullptr) == (parallel->image() == nullptr));
+        if (serial->image() != nullptr && parallel->image() != nullptr) {
+            REPORTER_ASSERT(reporter, serial->imageSize() == parallel->imageSize());
+            REPORTER_ASSERT(reporter,
+                            memcmp(serial->image(), parallel->image(), serial->imageSize()) == 0);
+        }
+    }
+    REPORTER_ASSERT(reporter, serialCache.getTotalMemoryUsed() ==
+                              parallelCache.getTotalMemoryUsed());
+}
+
 class SkGlyphTestPeer {
 public:
     static void SetGlyph(SkGlyph* glyph) {
@@ -193,6 +247,10 @@ public:
         SkAutoMutexExclusive m{strike->fStrikeLock};
         return strike->glyph(packedID);
     }
+
+    static size_t MemoryUsed(const SkStrike* strike) {
+        return strike->fMemoryUsed;
+    }
 };
 
 DEF_TEST(SkStrike_FlattenByType, reporter) {
@@ -291,3 +349,92 @@ DEF_TEST(SkStrike_FlattenByType, reporter) {
     REPORTER_ASSERT(reporter, dstDrawableGlyph->setDrawableHasBeenCalled());
     REPORTER_ASSERT(reporter, dstDrawableGlyph->drawable() != nullptr);
 }
+
+DEF_TEST(SkStrike_PersistentCacheRoundTrip, reporter) {
+    sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, SkPersistentStrikeCache::TypefaceKey(*typeface) != 0);
+    SkFont font(typeface, 24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+
+    std::vector<SkPackedGlyphID> packedIDs;
+    for (SkUnichar c = 'a'; c <= 'z'; c++) {
+        packedIDs.emplace_back(font.unicharToGlyph(c));
+    }
+
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+
+    SkStrikeCache savedCache;
+    std::vector<const SkGlyph*> savedGlyphs(packedIDs.size());
+    savedCache.findOrCreateStrike(strikeSpec)->prepareImages(packedIDs, savedGlyphs.data());
+
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(reporter, SkPersistentStrikeCache::Write(&savedCache, SIZE_MAX, &stream) == 1);
+    sk_sp<SkData> data = stream.detachAsData();
+
+    // Only strikes of the given typefaces are loaded.
+    SkStrikeCache otherCache;
+    REPORTER_ASSERT(reporter, SkPersistentStrikeCache::Read(&otherCache, *data, {}) == 0);
+    REPORTER_ASSERT(reporter, otherCache.getCacheCountUsed() == 0);
+
+    // A damaged file is rejected as a whole.
+    sk_sp<SkData> damaged = SkData::MakeWithCopy(data->data(), data->size());
+    static_cast<uint8_t*>(damaged->writable_data())[damaged->size() - 1] ^= 0xFF;
+    const sk_sp<SkTypeface> typefaces[] = {typeface};
+    REPORTER_ASSERT(reporter, SkPersistentStrikeCache::Read(&otherCache, *damaged, typefaces) == 0);
+    REPORTER_ASSERT(reporter, otherCache.getCacheCountUsed() == 0);
+
+    // So is a file with another version or byte order. The header is little-endian: the version
+    // is the second 32-bit field and the byte order is the third.
+    for (size_t offset : {4, 8}) {
+        sk_sp<SkData> mismatched = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint8_t*>(mismatched->writable_data())[offset] ^= 0x01;
+        REPORTER_ASSERT(reporter,
+                        SkPersistentStrikeCache::Read(&otherCache, *mismatched, typefaces) == 0);
+        REPORTER_ASSERT(reporter, otherCache.getCacheCountUsed() == 0);
+    }
+
+    SkStrikeCache loadedCache;
+    REPORTER_ASSERT(reporter, SkPersistentStrikeCache::Read(&loadedCache, *data, typefaces) == 1);
+    sk_sp<SkStrike> loadedStrike = loadedCache.findStrike(strikeSpec.descriptor());
+    REPORTER_ASSERT(reporter, loadedStrike != nullptr);
+    if (loadedStrike == nullptr) {
+        return;
+    }
+
+    // The glyphs merged before the strike was published are counted once.
+    const size_t memoryUsed = loadedCache.getTotalMemoryUsed();
+    REPORTER_ASSERT(reporter, memoryUsed ==
+                              SkStrikeTestingPeer::MemoryUsed(loadedStrike.get()));
+
+    // The loaded glyphs are already rasterized, so preparing them uses no more memory.
+    std::vector<const SkGlyph*> loadedGlyphs(packedIDs.size());
+    loadedStrike->prepareImages(packedIDs, loadedGlyphs.data());
+    REPORTER_ASSERT(reporter, loadedCache.getTotalMemoryUsed() == memoryUsed);
+
+    for (size_t i = 0; i < packedIDs.size(); i++) {
+        const SkGlyph* saved = savedGlyphs[i];
+        const SkGlyph* loaded = loadedGlyphs[i];
+        REPORTER_ASSERT(reporter, saved->iRect() == loaded->iRect());
+        REPORTER_ASSERT(reporter, saved->advanceX() == loaded->advanceX());
+        REPORTER_ASSERT(reporter, (saved->image() == nullptr) == (loaded->image() == nullptr));
+        if (saved->image() != nullptr && loaded->image() != nullptr) {
+            REPORTER_ASSERT(reporter,
+                            memcmp(saved->image(), loaded->image(), saved->imageSize()) == 0);
+        }
+    }
+    // A strike that draws have already filled is left as it is.
+    SkStrikeCache busyCache;
+    sk_sp<SkStrike> busyStrike = busyCache.findOrCreateStrike(strikeSpec);
+    std::vector<const SkGlyph*> busyGlyphs(packedIDs.size());
+    busyStrike->prepareImages(packedIDs, busyGlyphs.data());
+    const size_t busyMemoryUsed = busyCache.getTotalMemoryUsed();
+    REPORTER_ASSERT(reporter, SkPersistentStrikeCache::Read(&busyCache, *data, typefaces) == 0);
+    REPORTER_ASSERT(reporter, busyCache.getCacheCountUsed() == 1);
+    REPORTER_ASSERT(reporter, busyCache.findStrike(strikeSpec.descriptor()) == busyStrike);
+    REPORTER_ASSERT(reporter, busyCache.getTotalMemoryUsed() == busyMemoryUsed);
+}
@@ -19,6 +19,7 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSerialProcs.h"
+#include "include/core/SkString.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
@@ -26,6 +27,7 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "include/utils/SkTextBlobCache.h"
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "tests/Test.h"
@@ -35,7 +37,9 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <string>
+#include <vector>
 
 using namespace skia_private;
 
@@ -539,3 +543,134 @@ DEF_TEST(TextBlob_getIntercepts, reporter) {
     // raised 'y' should not intersect
     REPORTER_ASSERT(reporter, blobHighY->getIntercepts(bounds, nullptr) == 0);
 }
+
+DEF_TEST(TextBlob_slabBuilder, reporter) {
+    sk_sp<SkTypeface> tf = ToolUtils::CreateTestTypeface(nullptr, SkFontStyle());
+    const char* texts[] = { "Hello", "World!", "Slabs hold many small blobs" };
+
+    // A small slab makes the builder start new slabs, and place the long text on its own.
+    SkTextBlobBuilder slabBuilder(256);
+    SkTextBlobBuilder builder;
+    std::vector<sk_sp<SkTextBlob>> slabBlobs, blobs;
+    for (int i = 0; i < 20; ++i) {
+        const char* text = texts[i % std::size(texts)];
+        add_run(&slabBuilder, text, 10, 20, tf);
+        add_run(&slabBuilder, text, 10, 40, tf);
+        slabBlobs.push_back(slabBuilder.make());
+        add_run(&builder, text, 10, 20, tf);
+        add_run(&builder, text, 10, 40, tf);
+        blobs.push_back(builder.make());
+    }
+
+    // Release every other blob first, so that slabs are kept alive by their remaining blobs.
+    for (size_t i = 0; i < slabBlobs.size(); i += 2) {
+        slabBlobs[i].reset();
+        blobs[i].reset();
+    }
+    for (size_t i = 1; i < slabBlobs.size(); i += 2) {
+        REPORTER_ASSERT(reporter, slabBlobs[i]->bounds() == blobs[i]->bounds());
+        SkTextBlobRunIterator slabIt(slabBlobs[i].get());
+        SkTextBlobRunIterator it(blobs[i].get());
+        for (; !slabIt.done() && !it.done(); slabIt.next(), it.next()) {
+            REPORTER_ASSERT(reporter, slabIt.glyphCount() == it.glyphCount());
+            REPORTER_ASSERT(reporter, slabIt.offset() == it.offset());
+            REPORTER_ASSERT(reporter, slabIt.font() == it.font());
+            REPORTER_ASSERT(reporter, 0 == memcmp(slabIt.glyphs(), it.glyphs(),
+                                                  it.glyphCount() * sizeof(SkGlyphID)));
+        }
+        REPORTER_ASSERT(reporter, slabIt.done() && it.done());
+    }
+
+    // Abandoned runs are released with the builder.
+    add_run(&slabBuilder, texts[0], 10, 20, tf);
+}
+
+DEF_TEST(TextBlob_cache, reporter) {
+    SkFont font = ToolUtils::DefaultFont();
+    SkTextBlobCache cache;
+
+    auto blob = cache.findOrMake("Hello", font);
+    REPORTER_ASSERT(reporter, blob);
+    REPORTER_ASSERT(reporter, cache.findOrMake("Hello", font) == blob);
+    REPORTER_ASSERT(reporter, cache.count() == 1);
+
+    // The font and positioning are part of the key.
+    SkFont biggerFont = font;
+    biggerFont.setSize(font.getSize() * 2);
+    REPORTER_ASSERT(reporter, cache.findOrMake("Hello", biggerFont) != blob);
+    auto horizontal = cache.findOrMake("Hello", font, SkTextBlobCache::Positioning::kHorizontal);
+    REPORTER_ASSERT(reporter, horizontal != blob);
+    REPORTER_ASSERT(reporter, cache.count() == 3);
+
+    // The cached blob matches the uncached one.
+    auto expected = SkTextBlob::MakeFromString("Hello", font);
+    REPORTER_ASSERT(reporter, blob->bounds() == expected->bounds());
+    SkTextBlobRunIterator it(blob.get());
+    SkTextBlobRunIterator expectedIt(expected.get());
+    REPORTER_ASSERT(reporter, it.positioning() == expectedIt.positioning());
+    REPORTER_ASSERT(reporter, it.glyphCount() == expectedIt.glyphCount());
+    REPORTER_ASSERT(reporter, 0 == memcmp(it.pos(), expectedIt.pos(),
+                                          it.glyphCount() * 2 * sizeof(SkScalar)));
+    for (SkTextBlobRunIterator hIt(horizontal.get()); !hIt.done(); hIt.next()) {
+        REPORTER_ASSERT(reporter,
+                        hIt.positioning() == SkTextBlobRunIterator::kHorizontal_Positioning);
+        for (uint32_t i = 0; i < hIt.glyphCount(); ++i) {
+            REPORTER_ASSERT(reporter, hIt.pos()[i] == expectedIt.pos()[2 * i]);
+        }
+    }
+
+    // Text without glyphs makes no blob.
+    REPORTER_ASSERT(reporter, !cache.findOrMake("", font));
+    REPORTER_ASSERT(reporter, cache.count() == 3);
+
+    // Lowering the limit drops the least recently used blobs, but not the blobs held elsewhere.
+    const size_t used = cache.getTotalBytesUsed();
+    REPORTER_ASSERT(reporter, cache.setByteLimit(used - 1) == SkTextBlobCache::kDefaultByteLimit);
+    REPORTER_ASSERT(reporter, cache.count() == 2);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() < used);
+    REPORTER_ASSERT(reporter, blob->bounds() == expected->bounds());
+    REPORTER_ASSERT(reporter, cache.findOrMake("Hello", font) != blob);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.count() == 0);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+}
+
+DEF_TEST(TextBlob_cacheSlabBudget, reporter) {
+    SkFont font = ToolUtils::DefaultFont();
+    constexpr size_t kLimit = 64 * 1024;
+    SkTextBlobCache cache(kLimit);
+
+    // The first blob is charged for the whole slab it is placed in, an eighth of the limit.
+    REPORTER_ASSERT(reporter, cache.findOrMake("0", font));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() >= kLimit / 8);
+
+    // Many small blobs share slabs. The slabs held by the cached blobs and the builder fit in the
+    // limit throughout, even while the least recently used blobs are dropped.
+    std::vector<sk_sp<SkTextBlob>> blobs;
+    for (int i = 0; i < 2000; ++i) {
+        SkString text;
+        text.printf("label %d", i);
+        blobs.push_back(cache.findOrMake(text.c_str(), font));
+        REPORTER_ASSERT(reporter, blobs.back());
+        REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() <= kLimit);
+    }
+    REPORTER_ASSERT(reporter, cache.count() < 2000);
+
+    // Blobs that left the cache are still usable, though they may keep their slabs alive.
+    REPORTER_ASSERT(reporter, blobs.front()->bounds() ==
+                              SkTextBlob::MakeFromString("label 0", font)->bounds());
+
+    // A limit smaller than a slab keeps the cache within it too.
+    cache.setByteLimit(1024);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() <= 1024);
+    for (int i = 0; i < 100; ++i) {
+        SkString text;
+        text.printf("small %d", i);
+        REPORTER_ASSERT(reporter, cache.findOrMake(text.c_str(), font));
+        REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() <= 1024);
+    }
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+}